@@ -82,6 +82,13 @@ absl::Status FileLineWriter::WriteLine(std::string_view line) {
   return absl::OkStatus();
 }
 
+absl::Status FileLineWriter::Flush() {
+  if (fflush(file_.get()) != 0) {
+    return absl::InternalError("Error flushing file");
+  }
+  return absl::OkStatus();
+}
+
 /* static */ absl::StatusOr<NamedPipe> NamedPipe::Create(
     const std::filesystem::path& path) {
   // Create with RW permissions for the user only.
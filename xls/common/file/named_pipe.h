@@ -59,6 +59,9 @@ class FileLineWriter {
   // is automatically added.
   absl::Status WriteLine(std::string_view line);
 
+  // Flushes any buffered lines to the file.
+  absl::Status Flush();
+
   // FileLineWriter is movable but not copyable.
   FileLineWriter(FileLineWriter&& other) = default;
   FileLineWriter& operator=(FileLineWriter&& other) = default;
@@ -0,0 +1,240 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/no_destructor.h"
+#include "absl/flags/flag.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xls/common/thread.h"
+
+ABSL_FLAG(int64_t, xls_threads, 0,
+          "Number of threads used by XLS tools for parallel work (e.g. netlist "
+          "interpretation, fuzzing and FDO synthesis). Zero or negative uses "
+          "one thread per available CPU.");
+
+namespace xls {
+namespace {
+
+// The pool and queue index of the worker running on the current thread, if
+// any.
+thread_local const void* current_pool = nullptr;
+thread_local int64_t current_worker = -1;
+
+// While waiting on a TaskGroup, how long to block before checking again for
+// queued tasks to help with. Tasks of the group may schedule more tasks after
+// the waiter found the queues empty, so the waiter cannot block indefinitely.
+constexpr absl::Duration kHelpPollInterval = absl::Milliseconds(1);
+
+}  // namespace
+
+int64_t DefaultThreadCount() {
+  int64_t flag_value = absl::GetFlag(FLAGS_xls_threads);
+  if (flag_value > 0) {
+    return flag_value;
+  }
+  return std::max(AvailableCPUs(), 1);
+}
+
+ThreadPool::ThreadPool(int64_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = DefaultThreadCount();
+  }
+  CHECK_GT(thread_count, 0);
+  queues_.reserve(thread_count + 1);
+  for (int64_t i = 0; i < thread_count + 1; ++i) {
+    queues_.push_back(std::make_unique<TaskQueue>());
+  }
+  threads_.reserve(thread_count);
+  for (int64_t i = 0; i < thread_count; ++i) {
+    threads_.push_back(
+        std::make_unique<Thread>([this, i]() { WorkerLoop(i); }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&sleep_mu_);
+    stopping_ = true;
+  }
+  for (std::unique_ptr<Thread>& thread : threads_) {
+    thread->Join();
+  }
+}
+
+void ThreadPool::Schedule(absl::AnyInvocable<void() &&> task) {
+  int64_t index = CurrentQueueIndex();
+  {
+    TaskQueue& queue = *queues_[index];
+    absl::MutexLock lock(&queue.mu);
+    queue.tasks.push_back(std::move(task));
+  }
+  // Releasing the mutex re-evaluates the wake-up condition of the sleeping
+  // workers.
+  absl::MutexLock lock(&sleep_mu_);
+  queued_.fetch_add(1, std::memory_order_release);
+}
+
+int64_t ThreadPool::CurrentQueueIndex() const {
+  return current_pool == this ? current_worker
+                               : static_cast<int64_t>(queues_.size()) - 1;
+}
+
+absl::AnyInvocable<void() &&> ThreadPool::PopTask(int64_t index) {
+  int64_t queue_count = queues_.size();
+  if (index < queue_count - 1) {
+    TaskQueue& own = *queues_[index];
+    absl::MutexLock lock(&own.mu);
+    if (!own.tasks.empty()) {
+      absl::AnyInvocable<void() &&> task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued_.fetch_sub(1, std::memory_order_acq_rel);
+      return task;
+    }
+  }
+  // Steal, starting with the injection queue so that external work is not
+  // starved by workers feeding themselves.
+  for (int64_t i = 0; i < queue_count; ++i) {
+    int64_t victim = (queue_count - 1 + i) % queue_count;
+    if (victim == index) {
+      continue;
+    }
+    TaskQueue& queue = *queues_[victim];
+    absl::MutexLock lock(&queue.mu);
+    if (!queue.tasks.empty()) {
+      absl::AnyInvocable<void() &&> task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      queued_.fetch_sub(1, std::memory_order_acq_rel);
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+bool ThreadPool::TryRunOneTask() {
+  if (queued_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  int64_t index = CurrentQueueIndex();
+  absl::AnyInvocable<void() &&> task = PopTask(index);
+  if (task == nullptr) {
+    return false;
+  }
+  std::move(task)();
+  return true;
+}
+
+void ThreadPool::WorkerLoop(int64_t index) {
+  current_pool = this;
+  current_worker = index;
+  while (true) {
+    if (TryRunOneTask()) {
+      continue;
+    }
+    absl::MutexLock lock(&sleep_mu_);
+    sleep_mu_.Await(absl::Condition(this, &ThreadPool::HasTasksOrStopping));
+    if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+  }
+  current_pool = nullptr;
+  current_worker = -1;
+}
+
+absl::Status ThreadPool::ParallelFor(
+    int64_t count, absl::FunctionRef<absl::Status(int64_t)> fn,
+    int64_t min_chunk_size) {
+  if (count <= 0) {
+    return absl::OkStatus();
+  }
+  // A few chunks per thread (the calling thread included) leave room for
+  // stealing when the iterations are not equally expensive.
+  int64_t chunk_size = std::max(
+      min_chunk_size, count / (4 * (thread_count() + 1)) + int64_t{1});
+  TaskGroup group(this);
+  for (int64_t start = 0; start < count; start += chunk_size) {
+    int64_t end = std::min(count, start + chunk_size);
+    group.Schedule([&group, fn, start, end]() -> absl::Status {
+      for (int64_t i = start; i < end && !group.cancelled(); ++i) {
+        absl::Status status = fn(i);
+        if (!status.ok()) {
+          return status;
+        }
+      }
+      return absl::OkStatus();
+    });
+  }
+  return group.Wait();
+}
+
+ThreadPool& DefaultThreadPool() {
+  static absl::NoDestructor<ThreadPool> pool(DefaultThreadCount());
+  return *pool;
+}
+
+TaskGroup::~TaskGroup() { Wait().IgnoreError(); }
+
+void TaskGroup::Schedule(absl::AnyInvocable<absl::Status() &&> task) {
+  {
+    absl::MutexLock lock(&mu_);
+    ++pending_;
+  }
+  pool_->Schedule([this, task = std::move(task)]() mutable {
+    absl::Status status = cancelled() ? absl::OkStatus() : std::move(task)();
+    absl::MutexLock lock(&mu_);
+    if (!status.ok() && status_.ok()) {
+      status_ = std::move(status);
+      Cancel();
+    }
+    --pending_;
+  });
+}
+
+absl::Status TaskGroup::Wait() {
+  while (true) {
+    {
+      absl::MutexLock lock(&mu_);
+      if (Done()) {
+        break;
+      }
+    }
+    if (pool_->TryRunOneTask()) {
+      continue;
+    }
+    absl::MutexLock lock(&mu_);
+    mu_.AwaitWithTimeout(absl::Condition(this, &TaskGroup::Done),
+                         kHelpPollInterval);
+  }
+  absl::MutexLock lock(&mu_);
+  if (!status_.ok()) {
+    return status_;
+  }
+  if (cancelled()) {
+    return absl::CancelledError("Task group was cancelled");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace xls
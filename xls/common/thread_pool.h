@@ -0,0 +1,158 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_COMMON_THREAD_POOL_H_
+#define XLS_COMMON_THREAD_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/flags/declare.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/thread.h"
+
+ABSL_DECLARE_FLAG(int64_t, xls_threads);
+
+namespace xls {
+
+// Returns the number of threads XLS tools should use for parallel work: the
+// value of --xls_threads if it is positive, otherwise the number of available
+// CPUs. Always at least one.
+int64_t DefaultThreadCount();
+
+// A work-stealing thread pool. Each worker has its own task queue: tasks
+// scheduled from a worker are pushed onto (and popped from) the back of that
+// worker's queue, which keeps related work on one core, while idle workers
+// steal from the front of the other queues. Tasks scheduled from threads
+// outside the pool go to a shared injection queue.
+//
+// Threads waiting on a TaskGroup (including via ParallelFor) run queued tasks
+// while they wait, so tasks may wait on groups of subtasks without exhausting
+// the pool.
+class ThreadPool {
+ public:
+  // Creates a pool with `thread_count` worker threads. Zero means
+  // DefaultThreadCount().
+  explicit ThreadPool(int64_t thread_count = 0);
+
+  // Runs all tasks which have been scheduled and joins the worker threads.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int64_t thread_count() const { return threads_.size(); }
+
+  // Schedules `task` to run on one of the worker threads.
+  void Schedule(absl::AnyInvocable<void() &&> task);
+
+  // Runs `fn(i)` for every `i` in [0, `count`) on the pool and the calling
+  // thread, and waits for all of them. Indices are handed out in contiguous
+  // chunks of at least `min_chunk_size`. If an invocation returns an error the
+  // remaining invocations are skipped and the first error is returned.
+  absl::Status ParallelFor(int64_t count,
+                           absl::FunctionRef<absl::Status(int64_t)> fn,
+                           int64_t min_chunk_size = 1);
+
+  // Runs one queued task on the calling thread, if there is one. Returns
+  // whether a task was run.
+  bool TryRunOneTask();
+
+ private:
+  struct TaskQueue {
+    absl::Mutex mu;
+    std::deque<absl::AnyInvocable<void() &&>> tasks ABSL_GUARDED_BY(mu);
+  };
+
+  void WorkerLoop(int64_t index);
+
+  // Returns the index of the queue of the worker running on the calling thread
+  // or the injection queue if the calling thread is not a worker of this pool.
+  int64_t CurrentQueueIndex() const;
+
+  // Pops a task, preferring the back of the queue of worker `index` and then
+  // stealing from the front of the others. Returns nullptr if all queues are
+  // empty.
+  absl::AnyInvocable<void() &&> PopTask(int64_t index);
+
+  bool HasTasksOrStopping() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(sleep_mu_) {
+    return queued_.load(std::memory_order_acquire) > 0 || stopping_;
+  }
+
+  // One queue per worker plus the injection queue at the end.
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  // Number of tasks in all queues.
+  std::atomic<int64_t> queued_ = 0;
+
+  // Idle workers sleep on this mutex until a task is scheduled.
+  absl::Mutex sleep_mu_;
+  bool stopping_ ABSL_GUARDED_BY(sleep_mu_) = false;
+
+  std::vector<std::unique_ptr<Thread>> threads_;
+};
+
+// Returns the process-wide pool of DefaultThreadCount() threads. The pool is
+// created on first use; processes which fork (e.g. the fuzzer's fork server)
+// must not use it before forking.
+ThreadPool& DefaultThreadPool();
+
+// A set of tasks on a ThreadPool which are waited on and cancelled together.
+// Tasks return a status: the first error cancels the group and is returned by
+// Wait.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool* pool) : pool_(pool) {}
+
+  // Waits for all scheduled tasks; errors are dropped.
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  // Schedules `task` on the pool. Tasks which have not started when the group
+  // is cancelled are skipped.
+  void Schedule(absl::AnyInvocable<absl::Status() &&> task);
+
+  // Cancels the group. Running tasks are not interrupted but may poll
+  // `cancelled()` to stop early.
+  void Cancel() { cancelled_.store(true, std::memory_order_release); }
+  bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+  // Waits until all scheduled tasks have completed or been skipped, running
+  // queued tasks of the pool on the calling thread meanwhile. Returns the
+  // first error returned by a task, or a CancelledError if the group was
+  // cancelled by Cancel().
+  absl::Status Wait();
+
+ private:
+  bool Done() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return pending_ == 0; }
+
+  ThreadPool* pool_;
+  std::atomic<bool> cancelled_ = false;
+
+  absl::Mutex mu_;
+  int64_t pending_ ABSL_GUARDED_BY(mu_) = 0;
+  absl::Status status_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_COMMON_THREAD_POOL_H_
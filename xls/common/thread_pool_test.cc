@@ -0,0 +1,143 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/common/thread_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/flags/flag.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/synchronization/notification.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::testing::Each;
+using ::testing::Eq;
+
+TEST(ThreadPoolTest, DefaultThreadCount) {
+  int64_t old_value = absl::GetFlag(FLAGS_xls_threads);
+  absl::SetFlag(&FLAGS_xls_threads, 3);
+  EXPECT_EQ(DefaultThreadCount(), 3);
+  EXPECT_EQ(ThreadPool().thread_count(), 3);
+  absl::SetFlag(&FLAGS_xls_threads, 0);
+  EXPECT_GE(DefaultThreadCount(), 1);
+  absl::SetFlag(&FLAGS_xls_threads, old_value);
+}
+
+TEST(ThreadPoolTest, ScheduleRunsAllTasksBeforeDestruction) {
+  std::atomic<int64_t> count = 0;
+  {
+    ThreadPool pool(4);
+    for (int64_t i = 0; i < 1000; ++i) {
+      pool.Schedule([&count]() { count.fetch_add(1); });
+    }
+  }
+  EXPECT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPoolTest, ParallelForVisitsEachIndexOnce) {
+  ThreadPool pool(4);
+  for (int64_t count : {0, 1, 7, 1000}) {
+    std::vector<std::atomic<int64_t>> visits(count);
+    EXPECT_THAT(pool.ParallelFor(count,
+                                 [&](int64_t i) {
+                                   visits[i].fetch_add(1);
+                                   return absl::OkStatus();
+                                 }),
+                IsOk());
+    for (const std::atomic<int64_t>& v : visits) {
+      EXPECT_EQ(v.load(), 1);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForReturnsErrorAndSkipsRemainingWork) {
+  ThreadPool pool(2);
+  std::atomic<int64_t> visited = 0;
+  EXPECT_THAT(pool.ParallelFor(100000,
+                               [&](int64_t i) -> absl::Status {
+                                 visited.fetch_add(1);
+                                 if (i == 10) {
+                                   return absl::InternalError("boom");
+                                 }
+                                 return absl::OkStatus();
+                               }),
+              StatusIs(absl::StatusCode::kInternal, "boom"));
+  EXPECT_LT(visited.load(), 100000);
+}
+
+TEST(ThreadPoolTest, NestedParallelForDoesNotDeadlock) {
+  // More outer iterations than workers, each of which blocks on inner work.
+  ThreadPool pool(2);
+  std::vector<int64_t> sums(16);
+  EXPECT_THAT(pool.ParallelFor(sums.size(),
+                               [&](int64_t i) {
+                                 std::atomic<int64_t> sum = 0;
+                                 absl::Status status = pool.ParallelFor(
+                                     100, [&](int64_t j) {
+                                       sum.fetch_add(j);
+                                       return absl::OkStatus();
+                                     });
+                                 sums[i] = sum.load();
+                                 return status;
+                               }),
+              IsOk());
+  EXPECT_THAT(sums, Each(Eq(4950)));
+}
+
+TEST(ThreadPoolTest, TaskGroupCancellation) {
+  ThreadPool pool(1);
+  TaskGroup group(&pool);
+  absl::Notification started;
+  absl::Notification release;
+  std::atomic<bool> second_ran = false;
+  // The first task occupies the only worker until the group is cancelled, so
+  // the second is still queued when that happens.
+  group.Schedule([&]() {
+    started.Notify();
+    release.WaitForNotification();
+    return absl::OkStatus();
+  });
+  started.WaitForNotification();
+  group.Schedule([&]() {
+    second_ran = true;
+    return absl::OkStatus();
+  });
+  group.Cancel();
+  release.Notify();
+  EXPECT_THAT(group.Wait(), StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_FALSE(second_ran.load());
+}
+
+TEST(ThreadPoolTest, DefaultThreadPool) {
+  std::atomic<int64_t> sum = 0;
+  EXPECT_THAT(DefaultThreadPool().ParallelFor(10,
+                                              [&](int64_t i) {
+                                                sum.fetch_add(i);
+                                                return absl::OkStatus();
+                                              }),
+              IsOk());
+  EXPECT_EQ(sum.load(), 45);
+}
+
+}  // namespace
+}  // namespace xls
@@ -35,7 +35,7 @@
 #include "xls/codegen/verilog_conversion.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
-#include "xls/common/thread.h"
+#include "xls/common/thread_pool.h"
 #include "xls/fdo/extract_nodes.h"
 #include "xls/ir/block.h"
 #include "xls/ir/function.h"
@@ -50,29 +50,13 @@ absl::StatusOr<std::vector<int64_t>>
 Synthesizer::SynthesizeNodesConcurrentlyAndGetDelays(
     absl::Span<const absl::flat_hash_set<Node*>> nodes_list) const {
   // Launches multi-threading delay estimation.
-  std::vector<absl::StatusOr<int64_t>> results;
-  std::vector<std::unique_ptr<Thread>> threads;
-  results.reserve(nodes_list.size());
-  absl::StatusOr<int64_t> init_val = 0;
-  for (const absl::flat_hash_set<Node*>& nodes : nodes_list) {
-    results.push_back(init_val);
-    absl::StatusOr<int64_t>& dest = results.back();
-    // TODO(hanchenye): 2023-08-14 Use a thread pool structure that we can
-    // schedule on.
-    threads.push_back(std::make_unique<Thread>(
-        [&]() { dest = SynthesizeNodesAndGetDelay(nodes); }));
-  }
-
-  // Records the estimated delays.
-  for (auto& t : threads) {
-    t->Join();
-  }
-  std::vector<int64_t> delay_list;
-  delay_list.reserve(results.size());
-  for (absl::StatusOr<int64_t> result : results) {
-    XLS_RETURN_IF_ERROR(result.status());
-    delay_list.push_back(result.value());
-  }
+  std::vector<int64_t> delay_list(nodes_list.size());
+  XLS_RETURN_IF_ERROR(DefaultThreadPool().ParallelFor(
+      nodes_list.size(), [&](int64_t i) -> absl::Status {
+        XLS_ASSIGN_OR_RETURN(delay_list[i],
+                             SynthesizeNodesAndGetDelay(nodes_list[i]));
+        return absl::OkStatus();
+      }));
   return delay_list;
 }
 
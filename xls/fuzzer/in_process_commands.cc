@@ -0,0 +1,375 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/fuzzer/in_process_commands.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/types/span.h"
+#include "re2/re2.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/dslx/ir_convert/convert_options.h"
+#include "xls/dslx/ir_convert/ir_converter.h"
+#include "xls/fuzzer/sample.h"
+#include "xls/fuzzer/sample_runner.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/interpreter/interpreter_proc_runtime.h"
+#include "xls/interpreter/serial_proc_runtime.h"
+#include "xls/ir/format_preference.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/ir/value.h"
+#include "xls/jit/function_jit.h"
+#include "xls/jit/jit_proc_runtime.h"
+#include "xls/public/runtime_dslx_actions.h"
+#include "xls/tests/testvector.pb.h"
+#include "xls/tools/eval_utils.h"
+#include "xls/tools/opt.h"
+
+namespace xls {
+namespace {
+
+// The flags and positional arguments of a tool invocation.
+struct ToolArgs {
+  absl::flat_hash_map<std::string, std::string> flags;
+  std::vector<std::filesystem::path> paths;
+
+  std::optional<std::string_view> GetFlag(std::string_view name) const {
+    auto it = flags.find(name);
+    if (it == flags.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  absl::StatusOr<bool> GetBoolFlag(std::string_view name,
+                                   bool default_value) const {
+    std::optional<std::string_view> value = GetFlag(name);
+    if (!value.has_value()) {
+      return default_value;
+    }
+    bool result;
+    if (!absl::SimpleAtob(*value, &result)) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Invalid value for --%s: %s", name, *value));
+    }
+    return result;
+  }
+};
+
+// Parses the arguments of an invocation of `tool` as absl flags do. Only the
+// flags in `known_flags` are accepted. Relative paths are resolved against
+// `run_dir`, the working directory of a subprocess invocation.
+absl::StatusOr<ToolArgs> ParseToolArgs(
+    std::string_view tool, absl::Span<const std::string> args,
+    absl::Span<const std::string_view> known_flags,
+    const std::filesystem::path& run_dir) {
+  ToolArgs result;
+  for (std::string_view arg : args) {
+    if (!absl::ConsumePrefix(&arg, "--") && !absl::ConsumePrefix(&arg, "-")) {
+      std::filesystem::path path(arg);
+      result.paths.push_back(path.is_absolute() ? path : run_dir / path);
+      continue;
+    }
+    std::pair<std::string_view, std::string_view> flag =
+        absl::StrSplit(arg, absl::MaxSplits('=', 1));
+    std::string_view name = flag.first;
+    std::string value(flag.second);
+    if (!absl::StrContains(arg, '=')) {
+      value = "true";
+      if (!absl::c_linear_search(known_flags, name) &&
+          absl::ConsumePrefix(&name, "no")) {
+        value = "false";
+      }
+    }
+    if (!absl::c_linear_search(known_flags, name)) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Flag --%s of %s is not supported in-process", name, tool));
+    }
+    result.flags[name] = std::move(value);
+  }
+  return result;
+}
+
+absl::StatusOr<std::unique_ptr<Package>> ParsePackageFile(
+    const std::filesystem::path& path) {
+  XLS_ASSIGN_OR_RETURN(std::string ir_text, GetFileContents(path));
+  return Parser::ParsePackage(ir_text, path.string());
+}
+
+// In-process equivalent of ir_converter_main.
+absl::StatusOr<std::string> ConvertDslxToIr(
+    const std::vector<std::string>& args,
+    const std::filesystem::path& run_dir) {
+  XLS_ASSIGN_OR_RETURN(
+      ToolArgs tool_args,
+      ParseToolArgs("ir_converter_main", args,
+                    {"top", "package_name", "emit_assert", "emit_trace",
+                     "emit_cover", "verify", "convert_tests",
+                     "warnings_as_errors", "type_inference_v2",
+                     "lower_to_proc_scoped_channels",
+                     "force_implicit_token_calling_convention"},
+                    run_dir));
+  XLS_RET_CHECK_EQ(tool_args.paths.size(), 1);
+
+  // The defaults match those of the ir_converter_main flags.
+  dslx::ConvertOptions convert_options;
+  XLS_ASSIGN_OR_RETURN(convert_options.emit_assert,
+                       tool_args.GetBoolFlag("emit_assert", true));
+  XLS_ASSIGN_OR_RETURN(convert_options.emit_trace,
+                       tool_args.GetBoolFlag("emit_trace", true));
+  XLS_ASSIGN_OR_RETURN(convert_options.emit_cover,
+                       tool_args.GetBoolFlag("emit_cover", true));
+  XLS_ASSIGN_OR_RETURN(convert_options.verify_ir,
+                       tool_args.GetBoolFlag("verify", true));
+  XLS_ASSIGN_OR_RETURN(convert_options.convert_tests,
+                       tool_args.GetBoolFlag("convert_tests", false));
+  XLS_ASSIGN_OR_RETURN(convert_options.warnings_as_errors,
+                       tool_args.GetBoolFlag("warnings_as_errors", true));
+  XLS_ASSIGN_OR_RETURN(convert_options.type_inference_v2,
+                       tool_args.GetBoolFlag("type_inference_v2", false));
+  XLS_ASSIGN_OR_RETURN(
+      convert_options.lower_to_proc_scoped_channels,
+      tool_args.GetBoolFlag("lower_to_proc_scoped_channels", false));
+  XLS_ASSIGN_OR_RETURN(
+      convert_options.force_implicit_token_calling_convention,
+      tool_args.GetBoolFlag("force_implicit_token_calling_convention", false));
+
+  std::string path = tool_args.paths.front().string();
+  std::vector<std::string_view> paths = {path};
+  bool printed_error = false;
+  XLS_ASSIGN_OR_RETURN(
+      dslx::PackageConversionData result,
+      dslx::ConvertFilesToPackage(paths, GetDefaultDslxStdlibPath(),
+                                  /*dslx_paths=*/{}, convert_options,
+                                  /*top=*/tool_args.GetFlag("top"),
+                                  /*package_name=*/
+                                  tool_args.GetFlag("package_name"),
+                                  &printed_error));
+  if (printed_error) {
+    return absl::InternalError(
+        "IR conversion failed with an earlier non-fatal error.");
+  }
+  return result.DumpIr();
+}
+
+// In-process equivalent of opt_main.
+absl::StatusOr<std::string> OptimizeIr(const std::vector<std::string>& args,
+                                       const std::filesystem::path& run_dir) {
+  XLS_ASSIGN_OR_RETURN(ToolArgs tool_args,
+                       ParseToolArgs("opt_main", args, {"top"}, run_dir));
+  XLS_RET_CHECK_EQ(tool_args.paths.size(), 1);
+  XLS_ASSIGN_OR_RETURN(std::string ir_text,
+                       GetFileContents(tool_args.paths.front()));
+  tools::OptOptions options;
+  options.top = tool_args.GetFlag("top").value_or("");
+  return tools::OptimizeIrForTop(ir_text, options);
+}
+
+// In-process equivalent of eval_ir_main evaluating the arguments of a
+// testvector.
+absl::StatusOr<std::string> EvaluateIrFunction(
+    const std::vector<std::string>& args,
+    const std::filesystem::path& run_dir) {
+  XLS_ASSIGN_OR_RETURN(
+      ToolArgs tool_args,
+      ParseToolArgs("eval_ir_main", args,
+                    {"testvector_textproto", "use_llvm_jit"}, run_dir));
+  XLS_RET_CHECK_EQ(tool_args.paths.size(), 1);
+  std::optional<std::string_view> testvector_path =
+      tool_args.GetFlag("testvector_textproto");
+  XLS_RET_CHECK(testvector_path.has_value());
+  XLS_ASSIGN_OR_RETURN(bool use_jit,
+                       tool_args.GetBoolFlag("use_llvm_jit", true));
+
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       ParsePackageFile(tool_args.paths.front()));
+  XLS_ASSIGN_OR_RETURN(Function * f, package->GetTopAsFunction());
+  testvector::SampleInputsProto testvector;
+  XLS_RETURN_IF_ERROR(
+      ParseTextProtoFile(run_dir / *testvector_path, &testvector));
+  if (!testvector.has_function_args()) {
+    return absl::InvalidArgumentError("Expected function_args in testvector");
+  }
+
+  std::unique_ptr<FunctionJit> jit;
+  if (use_jit) {
+    XLS_ASSIGN_OR_RETURN(jit, FunctionJit::Create(f));
+  }
+  std::string results;
+  for (std::string_view arg_line : testvector.function_args().args()) {
+    std::vector<Value> arg_values;
+    for (std::string_view value_string : absl::StrSplit(arg_line, ';')) {
+      XLS_ASSIGN_OR_RETURN(Value arg, Parser::ParseTypedValue(value_string));
+      arg_values.push_back(std::move(arg));
+    }
+    InterpreterResult<Value> result;
+    if (use_jit) {
+      XLS_ASSIGN_OR_RETURN(result, jit->Run(arg_values));
+    } else {
+      XLS_ASSIGN_OR_RETURN(result, InterpretFunction(f, arg_values));
+    }
+    absl::StrAppend(&results, result.value.ToString(FormatPreference::kHex),
+                    "\n");
+  }
+  return results;
+}
+
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateProcRuntime(
+    Package* package, bool use_jit) {
+  if (package->ChannelsAreProcScoped()) {
+    XLS_ASSIGN_OR_RETURN(Proc * top, package->GetTopAsProc());
+    if (use_jit) {
+      return CreateJitSerialProcRuntime(top);
+    }
+    return CreateInterpreterSerialProcRuntime(top);
+  }
+  if (use_jit) {
+    return CreateJitSerialProcRuntime(package);
+  }
+  return CreateInterpreterSerialProcRuntime(package);
+}
+
+// In-process equivalent of eval_proc_main running a fixed number of ticks
+// without expected outputs: the values sent on every channel are returned.
+absl::StatusOr<std::string> EvaluateIrProc(
+    const std::vector<std::string>& args,
+    const std::filesystem::path& run_dir) {
+  XLS_ASSIGN_OR_RETURN(
+      ToolArgs tool_args,
+      ParseToolArgs("eval_proc_main", args,
+                    {"testvector_textproto", "ticks", "backend"}, run_dir));
+  XLS_RET_CHECK_EQ(tool_args.paths.size(), 1);
+  int64_t tick_count;
+  if (!absl::SimpleAtoi(tool_args.GetFlag("ticks").value_or(""),
+                        &tick_count) ||
+      tick_count < 0) {
+    return absl::InvalidArgumentError("--ticks must be a single tick count");
+  }
+  std::string_view backend = tool_args.GetFlag("backend").value_or("");
+  if (backend != "serial_jit" && backend != "ir_interpreter") {
+    return absl::UnimplementedError(absl::StrFormat(
+        "Backend %s of eval_proc_main is not supported in-process", backend));
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       ParsePackageFile(tool_args.paths.front()));
+  absl::btree_map<std::string, std::vector<Value>> inputs_for_channels;
+  if (std::optional<std::string_view> testvector_path =
+          tool_args.GetFlag("testvector_textproto");
+      testvector_path.has_value()) {
+    XLS_ASSIGN_OR_RETURN(inputs_for_channels,
+                         ParseChannelValuesFromTestVectorFile(
+                             (run_dir / *testvector_path).string(),
+                             tick_count));
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<SerialProcRuntime> runtime,
+      CreateProcRuntime(package.get(), backend == "serial_jit"));
+  ChannelQueueManager& queue_manager = runtime->queue_manager();
+  for (const auto& [channel_name, values] : inputs_for_channels) {
+    XLS_ASSIGN_OR_RETURN(ChannelQueue * in_queue,
+                         queue_manager.GetBoundaryQueueByName(channel_name));
+    for (const Value& value : values) {
+      XLS_RETURN_IF_ERROR(in_queue->Write(value));
+    }
+  }
+  runtime->ResetState();
+  for (int64_t i = 0; i < tick_count; ++i) {
+    runtime->ClearInterpreterEvents();
+    XLS_RETURN_IF_ERROR(runtime->Tick());
+  }
+
+  absl::btree_map<std::string, std::vector<Value>> outputs_for_channels;
+  for (const ChannelInstance* channel_instance :
+       queue_manager.elaboration().channel_instances()) {
+    if (!channel_instance->channel->CanSend()) {
+      continue;
+    }
+    ChannelQueue& out_queue = queue_manager.GetQueue(channel_instance);
+    std::vector<Value> channel_values;
+    while (std::optional<Value> value = out_queue.Read()) {
+      channel_values.push_back(*std::move(value));
+    }
+    outputs_for_channels.insert(
+        {std::string{out_queue.channel()->name()}, std::move(channel_values)});
+  }
+  return ChannelValuesToString(outputs_for_channels);
+}
+
+using InProcessTool = absl::StatusOr<std::string> (*)(
+    const std::vector<std::string>& args, const std::filesystem::path& run_dir);
+
+// Wraps `fn` as a command. Known failures of `tool` are matched against the
+// message of the returned error and reported as FailedPreconditionError, as
+// the SampleRunner does for the stderr of the tool.
+SampleRunner::Commands::Callable InProcessCallable(std::string_view tool,
+                                                   InProcessTool fn) {
+  return [tool, fn](
+             const std::vector<std::string>& args,
+             const std::filesystem::path& run_dir,
+             const SampleOptions& options) -> absl::StatusOr<std::string> {
+    absl::StatusOr<std::string> result = fn(args, run_dir);
+    if (result.ok()) {
+      return result;
+    }
+    for (const KnownFailure& filter : options.known_failures()) {
+      if ((filter.tool == nullptr || RE2::FullMatch(tool, *filter.tool)) &&
+          RE2::PartialMatch(result.status().message(), *filter.stderr_regex)) {
+        return absl::FailedPreconditionError(absl::StrFormat(
+            "%s failed but failure was suppressed due to stderr regexp: %s",
+            tool, result.status().message()));
+      }
+    }
+    return result;
+  };
+}
+
+}  // namespace
+
+SampleRunner::Commands InProcessCommands() {
+  return SampleRunner::Commands{
+      .eval_ir_main = InProcessCallable("eval_ir_main", EvaluateIrFunction),
+      .eval_proc_main = InProcessCallable("eval_proc_main", EvaluateIrProc),
+      .ir_converter_main =
+          InProcessCallable("ir_converter_main", ConvertDslxToIr),
+      .ir_opt_main = InProcessCallable("opt_main", OptimizeIr),
+  };
+}
+
+}  // namespace xls
@@ -0,0 +1,44 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_FUZZER_IN_PROCESS_COMMANDS_H_
+#define XLS_FUZZER_IN_PROCESS_COMMANDS_H_
+
+#include "xls/fuzzer/sample_runner.h"
+
+namespace xls {
+
+// Returns SampleRunner commands which perform DSLX conversion, optimization
+// and IR evaluation of functions and procs by calling the library entry points
+// in the calling process rather than spawning ir_converter_main, opt_main,
+// eval_ir_main and eval_proc_main. This avoids the process start-up and
+// re-parsing costs which otherwise dominate the run time of small samples.
+//
+// The commands accept the arguments the SampleRunner passes to the tools and
+// return an UnimplementedError for any other flag. Each invocation builds its
+// own import data, package and JIT so the commands may be used concurrently
+// from multiple threads. Known failures of a tool are matched against the
+// error message in place of its stderr. Timeouts are not enforced and a crash
+// of a stage takes down the calling process; see
+// SampleExecution::kForkedInProcess for a crash-resilient way to run samples
+// with these commands.
+//
+// Code generation and simulation are left unset, so they still invoke
+// codegen_main and simulate_module_main: their arguments are arbitrary
+// codegen flags and simulation runs an external simulator regardless.
+SampleRunner::Commands InProcessCommands();
+
+}  // namespace xls
+
+#endif  // XLS_FUZZER_IN_PROCESS_COMMANDS_H_
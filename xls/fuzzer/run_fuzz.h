@@ -33,11 +33,23 @@ namespace xls {
 // summary will be appended to this file; if `generate_sample_elapsed` is also
 // given, it will be recorded in the timings in the sample summary.
 //
-// `run_dir` must be an empty directory.
+// `run_dir` must be an empty directory. The stages of the sample are run with
+// `commands`; stages without a command spawn their tool as a subprocess.
 absl::StatusOr<CompletedSampleKind> RunSample(
     const Sample& smp, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt);
+    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt,
+    const SampleRunner::Commands& commands = {});
+
+// Runs the given sample as RunSample does. If the sample fails and
+// `crasher_dir` is given, the sample is saved there as a crasher along with a
+// minimized version of its IR where possible.
+absl::StatusOr<CompletedSampleKind> RunSampleAndSaveCrasher(
+    const Sample& smp, const std::filesystem::path& run_dir,
+    const std::optional<std::filesystem::path>& crasher_dir = std::nullopt,
+    const std::optional<std::filesystem::path>& summary_file = std::nullopt,
+    std::optional<absl::Duration> generate_sample_elapsed = std::nullopt,
+    bool force_failure = false, const SampleRunner::Commands& commands = {});
 
 absl::StatusOr<std::pair<Sample, CompletedSampleKind>> GenerateSampleAndRun(
     dslx::FileTable& file_table, absl::BitGenRef bit_gen,
@@ -45,7 +57,7 @@ absl::StatusOr<std::pair<Sample, CompletedSampleKind>> GenerateSampleAndRun(
     const SampleOptions& sample_options, const std::filesystem::path& run_dir,
     const std::optional<std::filesystem::path>& crasher_dir = std::nullopt,
     const std::optional<std::filesystem::path>& summary_file = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false, const SampleRunner::Commands& commands = {});
 
 }  // namespace xls
 
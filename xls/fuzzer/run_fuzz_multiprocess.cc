@@ -14,34 +14,48 @@
 
 #include "xls/fuzzer/run_fuzz_multiprocess.h"
 
+#include <stdlib.h>  // NOLINT for WIFEXITED, WEXITSTATUS; not in <cstdlib>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cstdint>
 #include <filesystem>
-#include <memory>
+#include <functional>
 #include <optional>
 #include <random>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/random/distributions.h"
 #include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
 #include "absl/time/time.h"
 #include "xls/common/file/filesystem.h"
 #include "xls/common/file/temp_directory.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/common/stopwatch.h"
-#include "xls/common/thread.h"
+#include "xls/common/strerror.h"
+#include "xls/common/thread_pool.h"
 #include "xls/dslx/frontend/pos.h"
 #include "xls/fuzzer/ast_generator.h"
+#include "xls/fuzzer/in_process_commands.h"
 #include "xls/fuzzer/run_fuzz.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample_runner.h"
+#include "xls/tests/testvector.pb.h"
 
 namespace xls {
 namespace {
@@ -56,6 +70,22 @@ static constexpr std::string_view kBlueText = "\033[34m";
 static constexpr std::string_view kRedText = "\033[31m";
 static constexpr std::string_view kDefaultColor = "\033[0m";
 
+// Writes the progress of a forked worker: the sample it is about to run (or
+// the next sample once it is done) and its counts so far. See
+// ReadWorkerProgress.
+absl::Status WriteWorkerProgress(const std::filesystem::path& progress_file,
+                                 bool done, int64_t sample, int64_t skipped,
+                                 int64_t crashers,
+                                 const std::filesystem::path& run_dir) {
+  return SetFileContents(
+      progress_file, absl::StrCat(done ? "done" : "running", " ", sample, " ",
+                                  skipped, " ", crashers, " ",
+                                  run_dir.string()));
+}
+
+// Generates and runs samples numbered from `first_sample` up to `sample_count`
+// (if given). The sample about to be run is recorded in `progress_file` (if
+// given) so the fork server can recover it if the worker crashes.
 absl::StatusOr<FuzzResult> GenerateAndRunSamples(
     int64_t worker_number,
     const dslx::AstGeneratorOptions& ast_generator_options,
@@ -64,7 +94,9 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count,
-    const std::optional<absl::Duration>& duration, bool force_failure) {
+    const std::optional<absl::Duration>& duration, bool force_failure,
+    int64_t first_sample, const SampleRunner::Commands& commands,
+    const std::optional<std::filesystem::path>& progress_file) {
   int64_t crashers = 0;
   int64_t skipped = 0;
   LOG(INFO) << "--- Started worker " << worker_number;
@@ -91,7 +123,7 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
   std::mt19937_64 rng{rng_seed};
   dslx::FileTable file_table;
 
-  int64_t sample = 0;
+  int64_t sample = first_sample;
   while (true) {
     std::filesystem::path run_dir;
     std::optional<TempDirectory> temp_run_dir;
@@ -104,9 +136,14 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
       run_dir = temp_run_dir->path();
     }
 
+    if (progress_file.has_value()) {
+      XLS_RETURN_IF_ERROR(WriteWorkerProgress(*progress_file, /*done=*/false,
+                                              sample, skipped, crashers,
+                                              run_dir));
+    }
     auto result = GenerateSampleAndRun(file_table, rng, ast_generator_options,
                                        sample_options, run_dir, crasher_dir,
-                                       summary_file, force_failure);
+                                       summary_file, force_failure, commands);
     if (!result.ok()) {
       LOG(INFO) << kRedText
                 << absl::StreamFormat(
@@ -120,7 +157,7 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
     }
 
     absl::Duration elapsed = stopwatch.GetElapsedTime();
-    if (sample > 0 && sample % 16 == 0) {
+    if (sample > first_sample && sample % 16 == 0) {
       std::vector<std::string> metrics;
       metrics.reserve(3);
       if (sample_count.has_value()) {
@@ -130,8 +167,8 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
         metrics.push_back(absl::StrCat(sample, " samples"));
       }
       metrics.push_back(absl::StrFormat(
-          "%.2f samples/s",
-          static_cast<double>(sample) / absl::ToDoubleSeconds(elapsed)));
+          "%.2f samples/s", static_cast<double>(sample - first_sample) /
+                                absl::ToDoubleSeconds(elapsed)));
       if (duration.has_value()) {
         metrics.push_back(absl::StrFormat("running for %s (limit %s)",
                                           absl::FormatDuration(elapsed),
@@ -159,19 +196,280 @@ absl::StatusOr<FuzzResult> GenerateAndRunSamples(
   }
 
   absl::Duration elapsed = stopwatch.GetElapsedTime();
+  int64_t samples_generated = sample - first_sample;
   LOG(INFO) << absl::StreamFormat(
       "--- Worker #%d finished! %d samples; %d skipped; %d crashers; %.2f "
       "samples/s; ran for %s",
-      worker_number, sample, skipped, crashers,
-      static_cast<double>(sample) / absl::ToDoubleSeconds(elapsed),
+      worker_number, samples_generated, skipped, crashers,
+      static_cast<double>(samples_generated) / absl::ToDoubleSeconds(elapsed),
       absl::FormatDuration(elapsed));
+  if (progress_file.has_value()) {
+    XLS_RETURN_IF_ERROR(WriteWorkerProgress(*progress_file, /*done=*/true,
+                                            sample, skipped, crashers,
+                                            /*run_dir=*/""));
+  }
   return FuzzResult{
-      .samples_generated = sample,
+      .samples_generated = samples_generated,
       .samples_skipped = skipped,
       .crashers = crashers,
   };
 }
 
+struct WorkerProgress {
+  bool done;
+  int64_t sample;
+  int64_t skipped;
+  int64_t crashers;
+  std::filesystem::path run_dir;
+};
+
+absl::StatusOr<WorkerProgress> ReadWorkerProgress(
+    const std::filesystem::path& progress_file) {
+  XLS_ASSIGN_OR_RETURN(std::string contents, GetFileContents(progress_file));
+  std::vector<std::string_view> fields =
+      absl::StrSplit(contents, absl::MaxSplits(' ', 4));
+  WorkerProgress progress;
+  if (fields.size() != 5 || (fields[0] != "done" && fields[0] != "running") ||
+      !absl::SimpleAtoi(fields[1], &progress.sample) ||
+      !absl::SimpleAtoi(fields[2], &progress.skipped) ||
+      !absl::SimpleAtoi(fields[3], &progress.crashers)) {
+    return absl::InternalError(absl::StrFormat(
+        "Malformed worker progress in %s: %s", progress_file, contents));
+  }
+  progress.done = fields[0] == "done";
+  progress.run_dir = fields[4];
+  return progress;
+}
+
+// Forks a child process which runs `fn` and exits with EXIT_SUCCESS if it
+// returns an ok status. Returns the pid of the child.
+absl::StatusOr<pid_t> Fork(const std::function<absl::Status()>& fn) {
+  pid_t pid = fork();
+  if (pid == -1) {
+    return absl::InternalError(absl::StrCat("fork failed: ", Strerror(errno)));
+  }
+  if (pid == 0) {
+    absl::Status status = fn();
+    if (!status.ok()) {
+      LOG(ERROR) << "Forked process failed: " << status;
+    }
+    // Skip the exit handlers and destructors of the state inherited from the
+    // fork server.
+    _exit(status.ok() ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+  return pid;
+}
+
+absl::StatusOr<int> WaitForChild(pid_t pid) {
+  int wait_status;
+  while (waitpid(pid, &wait_status, 0) == -1) {
+    if (errno != EINTR) {
+      return absl::InternalError(
+          absl::StrCat("waitpid failed: ", Strerror(errno)));
+    }
+  }
+  return wait_status;
+}
+
+// Exit status of a replay subprocess whose sample passed.
+constexpr int kReplayPassedExitStatus = 2;
+
+// Reruns the sample left in `run_dir` by a crashed worker with every stage in
+// a subprocess, recording it in `crasher_dir` if it fails. Returns whether the
+// sample failed again.
+absl::StatusOr<bool> ReplayCrashedSample(
+    const std::filesystem::path& run_dir,
+    const std::optional<std::filesystem::path>& top_run_dir,
+    const std::optional<std::filesystem::path>& crasher_dir) {
+  XLS_ASSIGN_OR_RETURN(std::string input_text,
+                       GetFileContents(run_dir / "sample.x"));
+  XLS_ASSIGN_OR_RETURN(std::string options_text,
+                       GetFileContents(run_dir / "options.pbtxt"));
+  XLS_ASSIGN_OR_RETURN(SampleOptions options,
+                       SampleOptions::FromPbtxt(options_text));
+  testvector::SampleInputsProto testvector;
+  XLS_RETURN_IF_ERROR(
+      ParseTextProtoFile(run_dir / "testvector.pbtxt", &testvector));
+  Sample smp(std::move(input_text), std::move(options), std::move(testvector));
+
+  std::filesystem::path replay_dir;
+  std::optional<TempDirectory> temp_replay_dir;
+  if (top_run_dir.has_value()) {
+    replay_dir = run_dir;
+    replay_dir += "-replay";
+    XLS_RETURN_IF_ERROR(RecursivelyCreateDir(replay_dir));
+  } else {
+    XLS_ASSIGN_OR_RETURN(temp_replay_dir, TempDirectory::Create());
+    replay_dir = temp_replay_dir->path();
+  }
+  absl::StatusOr<CompletedSampleKind> result =
+      RunSampleAndSaveCrasher(smp, replay_dir, crasher_dir);
+  if (result.ok()) {
+    LOG(ERROR) << kRedText << "--- Sample " << run_dir
+               << " crashed in-process but passed when replayed"
+               << kDefaultColor;
+    return false;
+  }
+  return true;
+}
+
+// Runs the workers as processes forked from this process; see
+// SampleExecution::kForkedInProcess.
+absl::StatusOr<FuzzResult> RunForkedWorkers(
+    int64_t worker_count,
+    const dslx::AstGeneratorOptions& ast_generator_options,
+    const SampleOptions& sample_options, std::optional<uint64_t> seed,
+    const std::optional<std::filesystem::path>& top_run_dir,
+    const std::optional<std::filesystem::path>& crasher_dir,
+    const std::optional<std::filesystem::path>& summary_dir,
+    std::optional<int64_t> sample_count, std::optional<absl::Duration> duration,
+    bool force_failure) {
+  XLS_ASSIGN_OR_RETURN(TempDirectory progress_dir, TempDirectory::Create());
+  Stopwatch stopwatch;
+
+  struct Worker {
+    int64_t number;
+    std::optional<int64_t> sample_count;
+    // The first sample and seed of the current incarnation of the worker.
+    int64_t first_sample = 0;
+    std::optional<uint64_t> seed;
+    std::filesystem::path progress_file;
+  };
+  absl::flat_hash_map<pid_t, Worker> running;
+  auto start_worker = [&](Worker worker) -> absl::Status {
+    std::optional<absl::Duration> remaining_duration;
+    if (duration.has_value()) {
+      remaining_duration = *duration - stopwatch.GetElapsedTime();
+    }
+    XLS_ASSIGN_OR_RETURN(pid_t pid, Fork([&]() -> absl::Status {
+                           return GenerateAndRunSamples(
+                                      worker.number, ast_generator_options,
+                                      sample_options, worker.seed, top_run_dir,
+                                      crasher_dir, summary_dir,
+                                      worker.sample_count, remaining_duration,
+                                      force_failure, worker.first_sample,
+                                      InProcessCommands(), worker.progress_file)
+                               .status();
+                         }));
+    running.emplace(pid, std::move(worker));
+    return absl::OkStatus();
+  };
+  for (int64_t i = 0; i < worker_count; ++i) {
+    XLS_RETURN_IF_ERROR(start_worker(Worker{
+        .number = i,
+        .sample_count = sample_count.has_value()
+                            ? std::make_optional((*sample_count + i) /
+                                                 worker_count)
+                            : std::nullopt,
+        .seed = seed,
+        .progress_file =
+            progress_dir.path() / absl::StrCat("worker", i, ".progress"),
+    }));
+  }
+
+  FuzzResult total{};
+  while (!running.empty()) {
+    int wait_status;
+    pid_t pid = wait(&wait_status);
+    if (pid == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return absl::InternalError(
+          absl::StrCat("wait failed: ", Strerror(errno)));
+    }
+    auto it = running.find(pid);
+    if (it == running.end()) {
+      continue;
+    }
+    Worker worker = std::move(it->second);
+    running.erase(it);
+
+    absl::StatusOr<WorkerProgress> progress =
+        ReadWorkerProgress(worker.progress_file);
+    if (WIFEXITED(wait_status)) {
+      if (WEXITSTATUS(wait_status) == EXIT_SUCCESS && progress.ok() &&
+          progress->done) {
+        total.samples_generated += progress->sample - worker.first_sample;
+        total.samples_skipped += progress->skipped;
+        total.crashers += progress->crashers;
+      } else {
+        LOG(ERROR) << kRedText << "-- Worker #" << worker.number
+                   << " failed with exit status " << WEXITSTATUS(wait_status)
+                   << kDefaultColor;
+      }
+      continue;
+    }
+    if (!progress.ok() || progress->done) {
+      LOG(ERROR) << kRedText << "-- Worker #" << worker.number
+                 << " crashed outside of a sample" << kDefaultColor;
+      continue;
+    }
+
+    LOG(INFO) << kRedText
+              << absl::StreamFormat(
+                     "--- Worker #%d crashed (status 0x%x) running sample "
+                     "number %d in %s; replaying it in a subprocess",
+                     worker.number, wait_status, progress->sample,
+                     progress->run_dir)
+              << kDefaultColor;
+    total.samples_generated += progress->sample - worker.first_sample + 1;
+    total.samples_skipped += progress->skipped;
+    total.crashers += progress->crashers;
+    XLS_ASSIGN_OR_RETURN(
+        pid_t replay_pid, Fork([&]() -> absl::Status {
+          XLS_ASSIGN_OR_RETURN(bool reproduced,
+                               ReplayCrashedSample(progress->run_dir,
+                                                   top_run_dir, crasher_dir));
+          if (!reproduced) {
+            _exit(kReplayPassedExitStatus);
+          }
+          return absl::OkStatus();
+        }));
+    XLS_ASSIGN_OR_RETURN(int replay_status, WaitForChild(replay_pid));
+    bool replay_passed = WIFEXITED(replay_status) &&
+                         WEXITSTATUS(replay_status) == kReplayPassedExitStatus;
+    bool replay_reproduced =
+        WIFEXITED(replay_status) && WEXITSTATUS(replay_status) == EXIT_SUCCESS;
+    if (replay_reproduced) {
+      // Only a failure which reproduces has been recorded as a crasher.
+      ++total.crashers;
+    }
+    if (!replay_passed && !replay_reproduced) {
+      LOG(ERROR) << kRedText << "--- Replaying sample " << progress->run_dir
+                 << " failed as well; the sample is left in place"
+                 << kDefaultColor;
+    } else if (!top_run_dir.has_value()) {
+      std::error_code ec;
+      std::filesystem::remove_all(progress->run_dir, ec);
+    }
+
+    // Restart the worker with the remaining samples and a fresh seed.
+    int64_t next_sample = progress->sample + 1;
+    if ((worker.sample_count.has_value() &&
+         next_sample >= *worker.sample_count) ||
+        (duration.has_value() && stopwatch.GetElapsedTime() >= *duration)) {
+      continue;
+    }
+    worker.first_sample = next_sample;
+    if (worker.seed.has_value()) {
+      *worker.seed += worker_count;
+    }
+    XLS_RETURN_IF_ERROR(start_worker(std::move(worker)));
+  }
+  return total;
+}
+
+void LogTotals(const FuzzResult& total) {
+  LOG(INFO) << absl::StreamFormat(
+      "Multiprocess Fuzzer finished! Total: %d samples; %d skipped; %d "
+      "crashes; Sample skip rate: %.4f%%.",
+
+      total.samples_generated, total.samples_skipped, total.crashers,
+      static_cast<double>(total.samples_skipped * 100) /
+          static_cast<double>(total.samples_generated));
+}
+
 }  // namespace
 
 absl::Status ParallelGenerateAndRunSamples(
@@ -182,31 +480,40 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& crasher_dir,
     const std::optional<std::filesystem::path>& summary_dir,
     std::optional<int64_t> sample_count, std::optional<absl::Duration> duration,
-    bool force_failure) {
-  std::vector<std::unique_ptr<Thread>> workers;
-  workers.resize(worker_count);
-  std::vector<absl::StatusOr<FuzzResult>> worker_status;
-  worker_status.resize(workers.size(),
-                       absl::InternalError("worker did not terminate."));
-  for (int64_t i = 0; i < workers.size(); ++i) {
+    bool force_failure, SampleExecution execution) {
+  if (execution == SampleExecution::kForkedInProcess) {
+    XLS_ASSIGN_OR_RETURN(
+        FuzzResult total,
+        RunForkedWorkers(worker_count, ast_generator_options, sample_options,
+                         seed, top_run_dir, crasher_dir, summary_dir,
+                         sample_count, duration, force_failure));
+    LogTotals(total);
+    return absl::OkStatus();
+  }
+
+  SampleRunner::Commands commands;
+  if (execution == SampleExecution::kInProcess) {
+    commands = InProcessCommands();
+  }
+  std::vector<absl::StatusOr<FuzzResult>> worker_status(
+      worker_count, absl::InternalError("worker did not terminate."));
+  // Workers run for the whole fuzzing session, so each gets its own thread.
+  ThreadPool pool(worker_count);
+  XLS_RETURN_IF_ERROR(pool.ParallelFor(worker_count, [&](int64_t i) {
     std::optional<int64_t> worker_sample_count =
         sample_count.has_value()
             ? std::make_optional((*sample_count + i) / worker_count)
             : std::nullopt;
-    workers[i] = std::make_unique<Thread>([&, i, worker_sample_count,
-                                           status = &worker_status[i]] {
-      *status =
-          GenerateAndRunSamples(i, ast_generator_options, sample_options, seed,
-                                top_run_dir, crasher_dir, summary_dir,
-                                worker_sample_count, duration, force_failure);
-    });
-  }
+    worker_status[i] = GenerateAndRunSamples(
+        i, ast_generator_options, sample_options, seed, top_run_dir,
+        crasher_dir, summary_dir, worker_sample_count, duration, force_failure,
+        /*first_sample=*/0, commands, /*progress_file=*/std::nullopt);
+    return absl::OkStatus();
+  }));
 
   FuzzResult total{};
 
-  for (int64_t i = 0; i < workers.size(); ++i) {
-    LOG(INFO) << "-- Waiting on worker " << i;
-    workers[i]->Join();
+  for (int64_t i = 0; i < worker_count; ++i) {
     if (worker_status[i].ok()) {
       total.samples_generated += worker_status[i]->samples_generated;
       total.samples_skipped += worker_status[i]->samples_skipped;
@@ -217,14 +524,7 @@ absl::Status ParallelGenerateAndRunSamples(
     }
   }
 
-  LOG(INFO) << absl::StreamFormat(
-      "Multiprocess Fuzzer finished! Total: %d samples; %d skipped; %d "
-      "crashes; Sample skip rate: %.4f%%.",
-
-      total.samples_generated, total.samples_skipped, total.crashers,
-      static_cast<double>(total.samples_skipped * 100) /
-          static_cast<double>(total.samples_generated));
-
+  LogTotals(total);
   return absl::OkStatus();
 }
 
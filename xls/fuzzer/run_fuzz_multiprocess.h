@@ -26,6 +26,22 @@
 
 namespace xls {
 
+// How the stages of the samples are executed.
+enum class SampleExecution : uint8_t {
+  // Every stage spawns its tool as a subprocess.
+  kSubprocess,
+  // The conversion, optimization and evaluation stages run in the worker
+  // threads through library calls (see InProcessCommands). A crash in any
+  // stage terminates the fuzzer.
+  kInProcess,
+  // As kInProcess, but the workers are processes forked from the calling
+  // process, which acts as a fork server. When a worker crashes, the sample it
+  // was running is rerun with kSubprocess execution in a separate process to
+  // record the crasher and the worker is restarted with the remaining samples.
+  // The calling process must not have started any other threads.
+  kForkedInProcess,
+};
+
 // Generate and run fuzzer samples on `worker_count` threads; runs up to
 // `sample_count` samples (unbounded if unspecified) for up to `duration` time.
 //
@@ -36,7 +52,8 @@ namespace xls {
 // written to `crasher_dir`, and summaries to `summary_dir`.
 //
 // If `force_failure` is true, every sample run will be considered a failure.
-// This is useful for testing failure paths.
+// This is useful for testing failure paths. `execution` selects how the
+// stages of each sample are run.
 absl::Status ParallelGenerateAndRunSamples(
     int64_t worker_count,
     const dslx::AstGeneratorOptions& ast_generator_options,
@@ -47,7 +64,8 @@ absl::Status ParallelGenerateAndRunSamples(
     const std::optional<std::filesystem::path>& summary_dir = std::nullopt,
     std::optional<int64_t> sample_count = std::nullopt,
     std::optional<absl::Duration> duration = std::nullopt,
-    bool force_failure = false);
+    bool force_failure = false,
+    SampleExecution execution = SampleExecution::kSubprocess);
 
 }  // namespace xls
 
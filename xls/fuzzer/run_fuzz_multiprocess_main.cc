@@ -12,7 +12,6 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <algorithm>
 #include <cstdint>
 #include <filesystem>
 #include <optional>
@@ -30,7 +29,7 @@
 #include "xls/common/file/filesystem.h"
 #include "xls/common/init_xls.h"
 #include "xls/common/status/status_macros.h"
-#include "xls/common/thread.h"
+#include "xls/common/thread_pool.h"
 #include "xls/fuzzer/ast_generator.h"
 #include "xls/fuzzer/run_fuzz_multiprocess.h"
 #include "xls/fuzzer/sample.h"
@@ -43,6 +42,12 @@ ABSL_FLAG(std::optional<std::string>, crash_path, std::nullopt,
           "Path at which to place crash data.");
 ABSL_FLAG(bool, codegen, false, "Run code generation.");
 ABSL_FLAG(bool, emit_loops, true, "Emit loops in generator.");
+ABSL_FLAG(std::string, execution, "subprocess",
+          "How samples are run: 'subprocess' invokes a tool binary for every "
+          "stage, 'in_process' runs the conversion, optimization and "
+          "evaluation stages in the worker threads, and 'forked_in_process' "
+          "does the same in forked worker processes which are restarted if a "
+          "sample crashes them.");
 ABSL_FLAG(
     bool, force_failure, false,
     "Forces the samples to fail. Can be used to test failure code paths.");
@@ -81,8 +86,8 @@ ABSL_FLAG(
     bool, use_system_verilog, true,
     "If true, emit SystemVerilog during codegen; otherwise emit Verilog.");
 ABSL_FLAG(std::optional<int64_t>, worker_count, std::nullopt,
-          "Number of workers to use for execution; defaults to number of "
-          "physical cores detected.");
+          "Number of workers to use for execution; defaults to "
+          "--xls_threads, or the number of physical cores detected.");
 ABSL_FLAG(bool, with_valid_holdoff, false,
           "If true, emit valid random holdoffs on proc input channels.");
 
@@ -95,6 +100,7 @@ struct Options {
   std::optional<std::filesystem::path> crash_path;
   bool codegen;
   bool emit_loops;
+  SampleExecution execution;
   bool force_failure;
   bool generate_proc;
   int64_t max_width_aggregate_types;
@@ -139,7 +145,7 @@ absl::Status RealMain(const Options& options) {
   if (options.worker_count.has_value()) {
     worker_count = *options.worker_count;
   } else {
-    worker_count = std::max(AvailableCPUs(), 1);
+    worker_count = DefaultThreadCount();
   }
 
   dslx::AstGeneratorOptions ast_generator_options;
@@ -177,7 +183,8 @@ absl::Status RealMain(const Options& options) {
       worker_count, ast_generator_options, sample_options, options.seed,
       /*top_run_dir=*/options.save_temps_path,
       /*crasher_dir=*/options.crash_path, /*summary_dir=*/options.summary_path,
-      options.sample_count, options.duration, options.force_failure);
+      options.sample_count, options.duration, options.force_failure,
+      options.execution);
 }
 
 }  // namespace
@@ -197,6 +204,16 @@ int main(int argc, char** argv) {
   if (absl::GetFlag(FLAGS_simulate) && !absl::GetFlag(FLAGS_codegen)) {
     LOG(QFATAL) << "Must specify --codegen when --simulate is given.";
   }
+  xls::SampleExecution execution;
+  if (absl::GetFlag(FLAGS_execution) == "subprocess") {
+    execution = xls::SampleExecution::kSubprocess;
+  } else if (absl::GetFlag(FLAGS_execution) == "in_process") {
+    execution = xls::SampleExecution::kInProcess;
+  } else if (absl::GetFlag(FLAGS_execution) == "forked_in_process") {
+    execution = xls::SampleExecution::kForkedInProcess;
+  } else {
+    LOG(QFATAL) << "Invalid --execution: " << absl::GetFlag(FLAGS_execution);
+  }
 
   return xls::ExitStatus(xls::RealMain({
       .duration = absl::GetFlag(FLAGS_duration),
@@ -204,6 +221,7 @@ int main(int argc, char** argv) {
       .crash_path = absl::GetFlag(FLAGS_crash_path),
       .codegen = absl::GetFlag(FLAGS_codegen),
       .emit_loops = absl::GetFlag(FLAGS_emit_loops),
+      .execution = execution,
       .force_failure = absl::GetFlag(FLAGS_force_failure),
       .generate_proc = absl::GetFlag(FLAGS_generate_proc),
       .max_width_aggregate_types =
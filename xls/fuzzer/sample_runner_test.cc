@@ -40,6 +40,7 @@
 #include "xls/dslx/interp_value.h"
 #include "xls/dslx/interp_value_utils.h"
 #include "xls/fuzzer/cpp_sample_runner.h"
+#include "xls/fuzzer/in_process_commands.h"
 #include "xls/fuzzer/sample.h"
 #include "xls/fuzzer/sample.pb.h"
 #include "xls/ir/bits.h"
@@ -574,6 +575,69 @@ TEST_F(SampleRunnerTest, InterpretOptIRMiscompare) {
                      HasSubstr("\nevaluated opt IR (JIT) =\n   bits[8]:0x0"))));
 }
 
+TEST_F(SampleRunnerTest, InProcessEvaluateAndOptimizeIR) {
+  SampleRunner runner(GetTempPath(), InProcessCommands());
+  constexpr std::string_view dslx_text =
+      "fn main(x: u8, y: u8) -> u8 { x + y }";
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_ir_converter_args({"--top=main"});
+  XLS_ASSERT_OK_AND_ASSIGN(ArgsBatch args_batch,
+                           ToArgsBatch({{"bits[8]:42", "bits[8]:100"},
+                                        {"bits[8]:222", "bits[8]:240"}}));
+  XLS_ASSERT_OK(
+      runner.Run(Sample(std::string(dslx_text), options, args_batch)));
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.ir"),
+              IsOkAndHolds(HasSubstr("package sample")));
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.opt.ir"),
+              IsOkAndHolds(HasSubstr("package sample")));
+  for (std::string_view results_file :
+       {"sample.ir.results", "sample.opt.ir.results"}) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::string results,
+                             GetFileContents(GetTempPath() / results_file));
+    EXPECT_THAT(absl::StrSplit(absl::StripAsciiWhitespace(results), "\n",
+                               absl::SkipEmpty()),
+                ElementsAre("bits[8]:0x8e", "bits[8]:0xce"));
+  }
+}
+
+TEST_F(SampleRunnerTest, InProcessUnsupportedFlag) {
+  SampleRunner runner(GetTempPath(), InProcessCommands());
+  constexpr std::string_view dslx_text =
+      "fn main(x: u8, y: u8) -> u8 { x + y }";
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_ir_converter_args({"--top=main", "--not_a_real_flag=1"});
+  ArgsBatch no_args;
+  EXPECT_THAT(runner.Run(Sample(std::string(dslx_text), options, no_args)),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("--not_a_real_flag")));
+}
+
+TEST_F(SampleRunnerTest, InProcessEvaluateProc) {
+  SampleRunner runner(GetTempPath(), InProcessCommands());
+  SampleOptions options;
+  options.set_input_is_dslx(true);
+  options.set_ir_converter_args({"--top=main"});
+  options.set_sample_type(fuzzer::SAMPLE_TYPE_PROC);
+  XLS_ASSERT_OK_AND_ASSIGN(ArgsBatch args_batch, ToArgsBatch({
+                                                     {
+                                                         "bits[32]:42",
+                                                         "bits[32]:100",
+                                                     },
+                                                 }));
+  XLS_ASSERT_OK(runner.Run(
+      Sample(std::string(kProcAdderDSLX), options, args_batch,
+             /*ir_channel_names=*/{"sample__operand_0", "sample__operand_1"})));
+
+  constexpr std::string_view expected_result =
+      "sample__result : {\n  bits[32]:0x8e\n}";
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.ir.results"),
+              IsOkAndHolds(HasSubstr(expected_result)));
+  EXPECT_THAT(GetFileContents(GetTempPath() / "sample.opt.ir.results"),
+              IsOkAndHolds(HasSubstr(expected_result)));
+}
+
 TEST_F(SampleRunnerTest, CodegenCombinational) {
   SampleRunner runner(GetTempPath());
   constexpr std::string_view dslx_text =
@@ -14,15 +14,21 @@
 
 #include "xls/interpreter/block_evaluator.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <random>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/log/vlog_is_on.h"
@@ -34,17 +40,21 @@
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xls/codegen/module_signature.pb.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/block.h"
 #include "xls/ir/block_elaboration.h"
 #include "xls/ir/elaboration.h"
+#include "xls/ir/events.h"
 #include "xls/ir/instantiation.h"
 #include "xls/ir/node.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/register.h"
+#include "xls/ir/type.h"
 #include "xls/ir/value.h"
+#include "xls/ir/value_flattening.h"
 #include "xls/ir/value_utils.h"
 
 namespace xls {
@@ -165,8 +175,99 @@ ConvertInputsToUint64(const absl::flat_hash_map<std::string, Value>& inputs,
   return input_uint64s;
 }
 
+// Clears the bits of the last byte of `bytes` beyond `bit_count`.
+void MaskLastByte(absl::Span<uint8_t> bytes, int64_t bit_count) {
+  if (bit_count % 8 != 0) {
+    bytes.back() &= static_cast<uint8_t>((1 << (bit_count % 8)) - 1);
+  }
+}
+
+// Returns true if every bit of the given port is set.
+bool PortIsAllOnes(const PackedPortBuffer& buffer, int64_t port) {
+  absl::Span<const uint8_t> port_bytes = buffer.bytes(port);
+  int64_t bit_count = buffer.port_bit_count(port);
+  for (size_t i = 0; i < port_bytes.size(); ++i) {
+    int64_t bits_in_byte = std::min(bit_count - 8 * static_cast<int64_t>(i),
+                                    int64_t{8});
+    if (port_bytes[i] != static_cast<uint8_t>((1 << bits_in_byte) - 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::StatusOr<int64_t> FindPortIndex(absl::Span<const std::string> names,
+                                      std::string_view name,
+                                      std::string_view direction) {
+  auto it = std::find(names.begin(), names.end(), name);
+  if (it == names.end()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Block has no %s port '%s'", direction, name));
+  }
+  return std::distance(names.begin(), it);
+}
+
 }  // namespace
 
+PackedPortBuffer::PackedPortBuffer(absl::Span<Type* const> types)
+    : types_(types.begin(), types.end()) {
+  bit_counts_.reserve(types_.size());
+  offsets_.reserve(types_.size() + 1);
+  for (Type* type : types_) {
+    bit_counts_.push_back(type->GetFlatBitCount());
+    offsets_.push_back(offsets_.back() +
+                       CeilOfRatio(bit_counts_.back(), int64_t{8}));
+  }
+  data_.resize(offsets_.back());
+}
+
+uint64_t PackedPortBuffer::GetUint64(int64_t port) const {
+  DCHECK_LE(port_bit_count(port), 64);
+  absl::Span<const uint8_t> port_bytes = bytes(port);
+  uint64_t value = 0;
+  for (size_t i = 0; i < port_bytes.size(); ++i) {
+    value |= uint64_t{port_bytes[i]} << (8 * i);
+  }
+  return value;
+}
+
+void PackedPortBuffer::SetUint64(int64_t port, uint64_t value) {
+  DCHECK_LE(port_bit_count(port), 64);
+  absl::Span<uint8_t> port_bytes = bytes(port);
+  for (size_t i = 0; i < port_bytes.size(); ++i) {
+    port_bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  if (!port_bytes.empty()) {
+    MaskLastByte(port_bytes, port_bit_count(port));
+  }
+}
+
+void PackedPortBuffer::Fill(int64_t port, bool value) {
+  absl::Span<uint8_t> port_bytes = bytes(port);
+  if (port_bytes.empty()) {
+    return;
+  }
+  std::fill(port_bytes.begin(), port_bytes.end(), value ? 0xff : 0);
+  MaskLastByte(port_bytes, port_bit_count(port));
+}
+
+Value PackedPortBuffer::GetValue(int64_t port) const {
+  absl::StatusOr<Value> value = UnflattenBitsToValue(
+      Bits::FromBytes(bytes(port), port_bit_count(port)), port_type(port));
+  CHECK_OK(value.status());
+  return *std::move(value);
+}
+
+absl::Status PackedPortBuffer::SetValue(int64_t port, const Value& value) {
+  if (!ValueConformsToType(value, port_type(port))) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Value %s does not match port type %s",
+                        value.ToString(), port_type(port)->ToString()));
+  }
+  FlattenValueToBits(value).ToBytes(bytes(port));
+  return absl::OkStatus();
+}
+
 absl::StatusOr<absl::flat_hash_map<std::string, Value>>
 BlockEvaluator::EvaluateCombinationalBlock(
     Block* block, const absl::flat_hash_map<std::string, Value>& inputs,
@@ -421,6 +522,122 @@ ChannelSink::GetOutputCycleSequenceAsUint64() const {
   return ret;
 }
 
+absl::Status ChannelSource::BindPorts(const BlockContinuation& continuation) {
+  XLS_ASSIGN_OR_RETURN(data_index_,
+                       continuation.GetInputPortIndex(data_name_));
+  XLS_ASSIGN_OR_RETURN(valid_index_,
+                       continuation.GetInputPortIndex(valid_name_));
+  if (ready_name_.has_value()) {
+    XLS_ASSIGN_OR_RETURN(ready_index_,
+                         continuation.GetOutputPortIndex(*ready_name_));
+  }
+  int64_t byte_count = continuation.packed_inputs().bytes(data_index_).size();
+  current_data_.assign(byte_count, 0);
+  next_data_.assign(byte_count, 0);
+  return absl::OkStatus();
+}
+
+bool ChannelSource::HasMoreDataPacked() {
+  if (producer_ == nullptr) {
+    return HasMoreData();
+  }
+  if (!next_fetched_) {
+    next_available_ = producer_(absl::MakeSpan(next_data_));
+    next_fetched_ = true;
+  }
+  return next_available_;
+}
+
+absl::Status ChannelSource::SetBlockInputs(int64_t this_cycle,
+                                           PackedPortBuffer& inputs,
+                                           absl::BitGenRef random_engine,
+                                           bool reset_asserted) {
+  XLS_RET_CHECK_GE(data_index_, 0) << "ports of " << data_name_ << " not bound";
+  // Mirrors the map-based variant above, including its use of random_engine.
+  if (reset_behavior_ == BehaviorDuringReset::kAttendReady || !reset_asserted) {
+    if (!is_valid_ && HasMoreDataPacked() &&
+        absl::Bernoulli(random_engine, lambda_)) {
+      if (producer_ != nullptr) {
+        std::swap(current_data_, next_data_);
+        next_fetched_ = false;
+        if (!current_data_.empty()) {
+          MaskLastByte(absl::MakeSpan(current_data_),
+                       inputs.port_bit_count(data_index_));
+        }
+      } else {
+        ++current_index_;
+        XLS_RETURN_IF_ERROR(
+            inputs.SetValue(data_index_, data_sequence_.at(current_index_)));
+        absl::c_copy(inputs.bytes(data_index_), current_data_.begin());
+      }
+      is_valid_ = true;
+    }
+    if (is_valid_) {
+      // Drive valid and data until the ready signal arrives.
+      absl::c_copy(current_data_, inputs.bytes(data_index_).begin());
+      inputs.SetUint64(valid_index_, 1);
+      return absl::OkStatus();
+    }
+  }
+
+  // If stalling, randomly send all ones or zeros with valid bit set to zero.
+  inputs.Fill(data_index_, absl::Bernoulli(random_engine, 0.5));
+  inputs.SetUint64(valid_index_, 0);
+  return absl::OkStatus();
+}
+
+absl::Status ChannelSource::GetBlockOutputs(int64_t this_cycle,
+                                            const PackedPortBuffer& outputs) {
+  if (!ready_index_.has_value() || PortIsAllOnes(outputs, *ready_index_)) {
+    is_valid_ = false;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ChannelSink::BindPorts(const BlockContinuation& continuation) {
+  XLS_ASSIGN_OR_RETURN(data_index_,
+                       continuation.GetOutputPortIndex(data_name_));
+  XLS_ASSIGN_OR_RETURN(valid_index_,
+                       continuation.GetOutputPortIndex(valid_name_));
+  XLS_ASSIGN_OR_RETURN(ready_index_,
+                       continuation.GetInputPortIndex(ready_name_));
+  return absl::OkStatus();
+}
+
+absl::Status ChannelSink::SetBlockInputs(int64_t this_cycle,
+                                         PackedPortBuffer& inputs,
+                                         absl::BitGenRef random_engine,
+                                         bool reset_asserted) {
+  XLS_RET_CHECK_GE(ready_index_, 0) << "ports of " << data_name_
+                                    << " not bound";
+  // Ready is independently random each cycle
+  bool signalled_ready = absl::Bernoulli(random_engine, lambda_);
+  inputs.SetUint64(ready_index_, signalled_ready ? 1 : 0);
+
+  // Don't consider ourselves ready when ignoring data received during reset.
+  is_ready_ = signalled_ready &&
+              (reset_behavior_ == BehaviorDuringReset::kAttendValid ||
+               !reset_asserted);
+  return absl::OkStatus();
+}
+
+absl::Status ChannelSink::GetBlockOutputs(int64_t this_cycle,
+                                          const PackedPortBuffer& outputs) {
+  // If ready and valid, grab data.
+  if (is_ready_ && PortIsAllOnes(outputs, valid_index_)) {
+    if (consumer_ != nullptr) {
+      consumer_(this_cycle, outputs.bytes(data_index_));
+      return absl::OkStatus();
+    }
+    Value data = outputs.GetValue(data_index_);
+    data_sequence_.push_back(data);
+    data_per_cycle_.push_back(std::move(data));
+  } else if (consumer_ == nullptr) {
+    data_per_cycle_.push_back(std::nullopt);
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<BlockIOResults>
 BlockEvaluator::EvaluateChannelizedSequentialBlock(
     Block* block, absl::Span<ChannelSource> channel_sources,
@@ -534,6 +751,121 @@ BlockEvaluator::EvaluateChannelizedSequentialBlockWithUint64(
   return block_io_result_as_uint64;
 }
 
+absl::StatusOr<InterpreterEvents>
+BlockEvaluator::StreamChannelizedSequentialBlock(
+    Block* block, absl::Span<ChannelSource> channel_sources,
+    absl::Span<ChannelSink> channel_sinks, int64_t cycle_count,
+    absl::FunctionRef<absl::Status(int64_t cycle, PackedPortBuffer& inputs)>
+        drive_inputs,
+    const std::optional<verilog::ResetProto>& reset, int64_t seed) const {
+  std::minstd_rand random_engine;
+  random_engine.seed(seed);
+
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<BlockContinuation> continuation,
+      NewContinuation(block, OutputPortSampleTime::kAtLastPosEdgeClock));
+  for (ChannelSource& src : channel_sources) {
+    XLS_RETURN_IF_ERROR(src.BindPorts(*continuation));
+  }
+  for (ChannelSink& sink : channel_sinks) {
+    XLS_RETURN_IF_ERROR(sink.BindPorts(*continuation));
+  }
+
+  // As in the map-based variant, a reset without a matching single-bit input
+  // port is never considered asserted.
+  PackedPortBuffer& inputs = continuation->packed_inputs();
+  std::optional<int64_t> reset_index;
+  uint64_t reset_asserted_value = 1;
+  if (reset.has_value()) {
+    absl::StatusOr<int64_t> index =
+        continuation->GetInputPortIndex(reset->name());
+    if (index.ok() && inputs.port_bit_count(*index) == 1) {
+      reset_index = *index;
+    }
+    reset_asserted_value = reset->active_low() ? 0 : 1;
+  }
+
+  InterpreterEvents events;
+  for (int64_t cycle = 0; cycle < cycle_count; ++cycle) {
+    XLS_RETURN_IF_ERROR(drive_inputs(cycle, inputs));
+    bool reset_asserted =
+        reset_index.has_value() &&
+        inputs.GetUint64(*reset_index) == reset_asserted_value;
+
+    // Sources set data/valid
+    for (ChannelSource& src : channel_sources) {
+      XLS_RETURN_IF_ERROR(
+          src.SetBlockInputs(cycle, inputs, random_engine, reset_asserted));
+    }
+
+    // Sinks set ready
+    for (ChannelSink& sink : channel_sinks) {
+      XLS_RETURN_IF_ERROR(
+          sink.SetBlockInputs(cycle, inputs, random_engine, reset_asserted));
+    }
+
+    XLS_RETURN_IF_ERROR(continuation->RunOneCyclePacked());
+
+    // Sources get ready
+    for (ChannelSource& src : channel_sources) {
+      XLS_RETURN_IF_ERROR(
+          src.GetBlockOutputs(cycle, continuation->packed_outputs()));
+    }
+
+    // Sinks get data/valid
+    for (ChannelSink& sink : channel_sinks) {
+      XLS_RETURN_IF_ERROR(
+          sink.GetBlockOutputs(cycle, continuation->packed_outputs()));
+    }
+
+    events.AppendFrom(continuation->events());
+  }
+
+  return events;
+}
+
+absl::StatusOr<int64_t> BlockContinuation::GetInputPortIndex(
+    std::string_view name) const {
+  return FindPortIndex(input_port_names_, name, "input");
+}
+
+absl::StatusOr<int64_t> BlockContinuation::GetOutputPortIndex(
+    std::string_view name) const {
+  return FindPortIndex(output_port_names_, name, "output");
+}
+
+absl::Status BlockContinuation::RunOneCyclePacked() {
+  absl::flat_hash_map<std::string, Value> inputs;
+  inputs.reserve(input_port_names_.size());
+  for (int64_t i = 0; i < packed_inputs_.port_count(); ++i) {
+    inputs.emplace(input_port_names_[i], packed_inputs_.GetValue(i));
+  }
+  XLS_RETURN_IF_ERROR(RunOneCycle(inputs));
+  const absl::flat_hash_map<std::string, Value>& outputs = output_ports();
+  for (int64_t i = 0; i < packed_outputs_.port_count(); ++i) {
+    auto it = outputs.find(output_port_names_[i]);
+    XLS_RET_CHECK(it != outputs.end())
+        << "no port named " << output_port_names_[i];
+    XLS_RETURN_IF_ERROR(packed_outputs_.SetValue(i, it->second));
+  }
+  return absl::OkStatus();
+}
+
+void BlockContinuation::InitializePackedPorts(Block* block) {
+  std::vector<Type*> input_types;
+  for (InputPort* port : block->GetInputPorts()) {
+    input_port_names_.push_back(std::string(port->name()));
+    input_types.push_back(port->GetType());
+  }
+  std::vector<Type*> output_types;
+  for (OutputPort* port : block->GetOutputPorts()) {
+    output_port_names_.push_back(std::string(port->name()));
+    output_types.push_back(port->port_type());
+  }
+  packed_inputs_ = PackedPortBuffer(input_types);
+  packed_outputs_ = PackedPortBuffer(output_types);
+}
+
 absl::StatusOr<std::unique_ptr<BlockContinuation>>
 BlockEvaluator::NewContinuation(
     Block* block,
@@ -541,8 +873,11 @@ BlockEvaluator::NewContinuation(
     BlockEvaluator::OutputPortSampleTime sample_time) const {
   XLS_ASSIGN_OR_RETURN(BlockElaboration elaboration,
                        BlockElaboration::Elaborate(block));
-  return MakeNewContinuation(std::move(elaboration), initial_registers,
-                             sample_time);
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<BlockContinuation> continuation,
+                       MakeNewContinuation(std::move(elaboration),
+                                           initial_registers, sample_time));
+  continuation->InitializePackedPorts(block);
+  return continuation;
 }
 
 absl::StatusOr<std::unique_ptr<BlockContinuation>>
@@ -561,7 +896,11 @@ BlockEvaluator::NewContinuation(
           ZeroOfType(reg->type());
     }
   }
-  return MakeNewContinuation(std::move(elaboration), regs, sample_time);
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<BlockContinuation> continuation,
+      MakeNewContinuation(std::move(elaboration), regs, sample_time));
+  continuation->InitializePackedPorts(block);
+  return continuation;
 }
 
 }  // namespace xls
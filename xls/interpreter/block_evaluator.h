@@ -16,13 +16,16 @@
 #define XLS_INTERPRETER_BLOCK_EVALUATOR_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/random/bit_gen_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -32,10 +35,59 @@
 #include "xls/ir/block.h"
 #include "xls/ir/block_elaboration.h"
 #include "xls/ir/events.h"
+#include "xls/ir/type.h"
 #include "xls/ir/value.h"
 
 namespace xls {
 
+class BlockContinuation;
+
+// Packed storage for the values of a fixed list of block ports, used by the
+// port-indexed interface of BlockContinuation. Each port occupies
+// ceil(bit_count / 8) bytes at a fixed offset and holds the flattened bits of
+// its value (see xls/ir/value_flattening.h) least significant byte first, the
+// packed layout also used by PackedBitsView and PackedTupleView. Bits of the
+// last byte of a port beyond its bit count must be zero.
+class PackedPortBuffer {
+ public:
+  PackedPortBuffer() = default;
+  explicit PackedPortBuffer(absl::Span<Type* const> types);
+
+  int64_t port_count() const { return types_.size(); }
+  Type* port_type(int64_t port) const { return types_[port]; }
+  int64_t port_bit_count(int64_t port) const { return bit_counts_[port]; }
+
+  // Returns the packed bytes of the given port.
+  absl::Span<uint8_t> bytes(int64_t port) {
+    return absl::MakeSpan(data_).subspan(offsets_[port],
+                                         offsets_[port + 1] - offsets_[port]);
+  }
+  absl::Span<const uint8_t> bytes(int64_t port) const {
+    return absl::MakeConstSpan(data_).subspan(
+        offsets_[port], offsets_[port + 1] - offsets_[port]);
+  }
+
+  // Accessors for ports of at most 64 bits. SetUint64 truncates `value` to the
+  // width of the port.
+  uint64_t GetUint64(int64_t port) const;
+  void SetUint64(int64_t port, uint64_t value);
+
+  // Sets every bit of the given port to `value`.
+  void Fill(int64_t port, bool value);
+
+  // Conversions from and to Values, for ports of aggregate type and for
+  // debugging.
+  Value GetValue(int64_t port) const;
+  absl::Status SetValue(int64_t port, const Value& value);
+
+ private:
+  std::vector<Type*> types_;
+  std::vector<int64_t> bit_counts_;
+  // Byte offset of each port followed by the total size.
+  std::vector<int64_t> offsets_ = {0};
+  std::vector<uint8_t> data_;
+};
+
 struct BlockRunResult {
   absl::flat_hash_map<std::string, Value> outputs;
   absl::flat_hash_map<std::string, Value> reg_state;
@@ -94,8 +146,41 @@ class ChannelSource {
       int64_t this_cycle,
       const absl::flat_hash_map<std::string, Value>& outputs);
 
-  // Source has transferred all data to the block.
-  bool AllDataSent() const { return !HasMoreData() && !is_valid_; }
+  // Writes the packed value of the next element to send into `data` and
+  // returns true, or returns false once there is no more data. Called once per
+  // element, on demand, by the packed-port interface below.
+  using DataProducer = std::function<bool(absl::Span<uint8_t> data)>;
+
+  // Streams the data to send from `producer` rather than the data sequence.
+  // Only supported by the packed-port interface.
+  void SetDataProducer(DataProducer producer) {
+    producer_ = std::move(producer);
+  }
+
+  // Resolves the indices of this channel's ports in the packed port buffers of
+  // `continuation`. Must be called before the packed-port variants of
+  // SetBlockInputs() and GetBlockOutputs().
+  absl::Status BindPorts(const BlockContinuation& continuation);
+
+  // Variants of SetBlockInputs() and GetBlockOutputs() operating on packed
+  // port buffers, for use with BlockContinuation::RunOneCyclePacked().
+  // `reset_asserted` indicates whether the block's reset is asserted in
+  // this_cycle. For a given random engine these drive the same inputs as the
+  // map-based variants.
+  absl::Status SetBlockInputs(int64_t this_cycle, PackedPortBuffer& inputs,
+                              absl::BitGenRef random_engine,
+                              bool reset_asserted);
+  absl::Status GetBlockOutputs(int64_t this_cycle,
+                               const PackedPortBuffer& outputs);
+
+  // Source has transferred all data to the block. With a data producer this
+  // is only known once the producer has reported the end of its data.
+  bool AllDataSent() const {
+    if (producer_ != nullptr) {
+      return next_fetched_ && !next_available_ && !is_valid_;
+    }
+    return !HasMoreData() && !is_valid_;
+  }
 
  private:
   // This source has more data to be sent.
@@ -103,6 +188,10 @@ class ChannelSource {
     return current_index_ + 1 < data_sequence_.size();
   }
 
+  // Like HasMoreData() but fetches the next element from the producer, if any,
+  // into next_data_.
+  bool HasMoreDataPacked();
+
   std::string data_name_;
   std::string valid_name_;
   std::optional<std::string> ready_name_;
@@ -120,6 +209,16 @@ class ChannelSource {
 
   int64_t current_index_ = -1;  // Cycle next data will be sent on.
   bool is_valid_ = false;       // Valid signal is asserted.
+
+  // State of the packed-port interface.
+  DataProducer producer_;
+  int64_t data_index_ = -1;
+  int64_t valid_index_ = -1;
+  std::optional<int64_t> ready_index_;
+  std::vector<uint8_t> current_data_;  // Packed data currently driven.
+  std::vector<uint8_t> next_data_;     // Packed data fetched from producer_.
+  bool next_fetched_ = false;
+  bool next_available_ = false;
 };
 
 // Drives output channel simulation for testing blocks.
@@ -167,6 +266,32 @@ class ChannelSink {
       int64_t this_cycle,
       const absl::flat_hash_map<std::string, Value>& outputs);
 
+  // Receives the packed value of each element read from the block along with
+  // the cycle it was read in.
+  using DataConsumer =
+      std::function<void(int64_t cycle, absl::Span<const uint8_t> data)>;
+
+  // Streams the data read from the block to `consumer` instead of recording
+  // it in the output sequences. Only supported by the packed-port interface.
+  void SetDataConsumer(DataConsumer consumer) {
+    consumer_ = std::move(consumer);
+  }
+
+  // Resolves the indices of this channel's ports in the packed port buffers of
+  // `continuation`. Must be called before the packed-port variants of
+  // SetBlockInputs() and GetBlockOutputs().
+  absl::Status BindPorts(const BlockContinuation& continuation);
+
+  // Variants of SetBlockInputs() and GetBlockOutputs() operating on packed
+  // port buffers, for use with BlockContinuation::RunOneCyclePacked().
+  // `reset_asserted` indicates whether the block's reset is asserted in
+  // this_cycle.
+  absl::Status SetBlockInputs(int64_t this_cycle, PackedPortBuffer& inputs,
+                              absl::BitGenRef random_engine,
+                              bool reset_asserted);
+  absl::Status GetBlockOutputs(int64_t this_cycle,
+                               const PackedPortBuffer& outputs);
+
   // Returns the sequence of values read from the block.
   absl::StatusOr<std::vector<uint64_t>> GetOutputSequenceAsUint64() const;
   absl::Span<const Value> GetOutputSequence() const { return data_sequence_; }
@@ -196,6 +321,12 @@ class ChannelSink {
   std::vector<Value> data_sequence_;  // Data sequence received.
   std::vector<std::optional<Value>>
       data_per_cycle_;  // Data received each cycle.
+
+  // State of the packed-port interface.
+  DataConsumer consumer_;
+  int64_t data_index_ = -1;
+  int64_t valid_index_ = -1;
+  int64_t ready_index_ = -1;
 };
 
 struct BlockIOResults {
@@ -210,8 +341,6 @@ struct BlockIOResultsAsUint64 {
   InterpreterEvents interpreter_events;
 };
 
-class BlockContinuation;
-
 class BlockEvaluator {
  public:
   // What position in a clock cycle should output ports be tapped during. This
@@ -398,6 +527,32 @@ class BlockEvaluator {
         block, channel_sources, channel_sinks, inputs, /*reset=*/std::nullopt);
   }
 
+  // Streaming variant of EvaluateChannelizedSequentialBlock which runs the
+  // block for `cycle_count` cycles through the packed-port interface of a
+  // continuation. No maps are built and no per-cycle inputs or outputs are
+  // recorded: channel data flows through the data sequences or producers of
+  // the sources and the output sequences or consumers of the sinks.
+  //
+  // At the start of every cycle `drive_inputs` may set the ports which are not
+  // part of a channel (like rst); input ports keep their value from the
+  // previous cycle otherwise and are initially zero. Returns the interpreter
+  // events of all cycles.
+  absl::StatusOr<InterpreterEvents> StreamChannelizedSequentialBlock(
+      Block* block, absl::Span<ChannelSource> channel_sources,
+      absl::Span<ChannelSink> channel_sinks, int64_t cycle_count,
+      absl::FunctionRef<absl::Status(int64_t cycle, PackedPortBuffer& inputs)>
+          drive_inputs,
+      const std::optional<verilog::ResetProto>& reset, int64_t seed) const;
+
+  absl::StatusOr<InterpreterEvents> StreamChannelizedSequentialBlock(
+      Block* block, absl::Span<ChannelSource> channel_sources,
+      absl::Span<ChannelSink> channel_sinks, int64_t cycle_count) const {
+    return StreamChannelizedSequentialBlock(
+        block, channel_sources, channel_sinks, cycle_count,
+        [](int64_t, PackedPortBuffer&) { return absl::OkStatus(); },
+        /*reset=*/std::nullopt, /*seed=*/0);
+  }
+
   template <typename Sink>
   friend void AbslStringify(Sink& sink, const BlockEvaluator& b) {
     absl::Format(&sink, "%s", b.name());
@@ -443,6 +598,48 @@ class BlockContinuation {
   virtual absl::Status SetObserver(EvaluationObserver* obs) = 0;
   // Clear any evaluation observer
   virtual void ClearObserver() = 0;
+
+  // Port-indexed interface. Ports are identified by their index in
+  // Block::GetInputPorts() or Block::GetOutputPorts() of the top block, which
+  // callers resolve once by name. Each cycle the input port values are written
+  // into packed_inputs() and the output ports read from packed_outputs(), which
+  // avoids hashing port names and boxing Values every cycle.
+  absl::StatusOr<int64_t> GetInputPortIndex(std::string_view name) const;
+  absl::StatusOr<int64_t> GetOutputPortIndex(std::string_view name) const;
+  absl::Span<const std::string> input_port_names() const {
+    return input_port_names_;
+  }
+  absl::Span<const std::string> output_port_names() const {
+    return output_port_names_;
+  }
+
+  // The input port values used by the next call to RunOneCyclePacked. The
+  // values persist between cycles.
+  PackedPortBuffer& packed_inputs() { return packed_inputs_; }
+  const PackedPortBuffer& packed_inputs() const { return packed_inputs_; }
+  // The output ports as sampled at `sample_time` by the last call to
+  // RunOneCyclePacked.
+  const PackedPortBuffer& packed_outputs() const { return packed_outputs_; }
+
+  // Run a single cycle of the block on the inputs in packed_inputs() using the
+  // current register state. The default implementation goes through
+  // RunOneCycle; evaluators which can do better operate on the packed buffers
+  // directly.
+  virtual absl::Status RunOneCyclePacked();
+
+ protected:
+  PackedPortBuffer& mutable_packed_outputs() { return packed_outputs_; }
+
+ private:
+  friend class BlockEvaluator;
+
+  // Lays out the packed port buffers for the ports of `block`.
+  void InitializePackedPorts(Block* block);
+
+  std::vector<std::string> input_port_names_;
+  std::vector<std::string> output_port_names_;
+  PackedPortBuffer packed_inputs_;
+  PackedPortBuffer packed_outputs_;
 };
 
 }  // namespace xls
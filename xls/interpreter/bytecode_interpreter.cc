@@ -0,0 +1,611 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/bytecode_interpreter.h"
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/ir_interpreter.h"
+#include "xls/interpreter/observer.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/dfs_visitor.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/keyword_args.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/source_location.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+// Records the order in which the IrInterpreter would evaluate the nodes of a
+// function so side effects (traces, asserts) are produced in the same order.
+class EvaluationOrder final : public DfsVisitorWithDefault {
+ public:
+  absl::Status DefaultHandler(Node* node) override {
+    order_.push_back(node);
+    return absl::OkStatus();
+  }
+
+  const std::vector<Node*>& order() const { return order_; }
+
+ private:
+  std::vector<Node*> order_;
+};
+
+// Interpreter which evaluates a single node given the values of its operands.
+// Unlike InterpretNode, side-effecting ops record their events and the
+// interpreter is reused across nodes.
+class SingleNodeInterpreter final : public IrInterpreter {
+ public:
+  using IrInterpreter::IrInterpreter;
+
+  absl::StatusOr<Value> Evaluate(Node* node,
+                                 absl::Span<const Value> operand_values) {
+    // Operand values are inserted directly rather than with SetValueResult so
+    // the observer only sees the evaluated node.
+    NodeValuesMap().clear();
+    for (int64_t i = 0; i < operand_values.size(); ++i) {
+      NodeValuesMap().insert_or_assign(node->operand(i), operand_values[i]);
+    }
+    XLS_RETURN_IF_ERROR(node->VisitSingleNode(this));
+    return std::move(NodeValuesMap().at(node));
+  }
+};
+
+uint64_t Mask(int64_t width) {
+  return width >= 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+}
+
+int64_t SignExtend(uint64_t value, int64_t width) {
+  if (width == 0) {
+    return 0;
+  }
+  if (width >= 64) {
+    return static_cast<int64_t>(value);
+  }
+  int64_t shift = 64 - width;
+  return static_cast<int64_t>(value << shift) >> shift;
+}
+
+std::optional<std::string> ResolveSourceFilename(
+    Function* function, const std::optional<SourceInfo>& info) {
+  if (info.has_value() && !info->locations.empty()) {
+    return function->package()->GetFilename(info->locations.front().fileno());
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+struct BytecodeFunction::RunState {
+  std::vector<uint64_t> words;
+  std::vector<Value> values;
+  InterpreterEvents events;
+  // Scratch space for the operands of slow-path instructions.
+  std::vector<Value> operand_values;
+  std::optional<SingleNodeInterpreter> fallback;
+
+  Value Load(Slot slot) const {
+    if (slot.packed()) {
+      return Value(UBits(words[slot.index], slot.width));
+    }
+    return values[slot.index];
+  }
+
+  absl::Status Store(Slot slot, Value value) {
+    if (slot.packed()) {
+      XLS_ASSIGN_OR_RETURN(words[slot.index], value.bits().ToUint64());
+    } else {
+      values[slot.index] = std::move(value);
+    }
+    return absl::OkStatus();
+  }
+};
+
+/* static */ absl::StatusOr<std::unique_ptr<BytecodeFunction>>
+BytecodeFunction::Compile(Function* function) {
+  absl::flat_hash_map<Function*, std::shared_ptr<const BytecodeFunction>>
+      compiled_callees;
+  auto compiled = absl::WrapUnique(new BytecodeFunction(function));
+  XLS_RETURN_IF_ERROR(compiled->Lower(compiled_callees));
+  return compiled;
+}
+
+absl::Status BytecodeFunction::Lower(
+    absl::flat_hash_map<Function*, std::shared_ptr<const BytecodeFunction>>&
+        compiled_callees) {
+  EvaluationOrder order;
+  XLS_RETURN_IF_ERROR(function_->Accept(&order));
+
+  absl::flat_hash_map<Node*, Slot> slots;
+  for (Node* node : order.order()) {
+    Slot slot;
+    if (node->GetType()->IsBits() && node->BitCountOrDie() <= 64) {
+      slot = Slot{.index = static_cast<int32_t>(initial_words_.size()),
+                  .width = static_cast<int32_t>(node->BitCountOrDie())};
+      initial_words_.push_back(0);
+    } else {
+      slot = Slot{.index = static_cast<int32_t>(initial_values_.size()),
+                  .width = -1};
+      initial_values_.push_back(Value());
+    }
+    slots[node] = slot;
+  }
+  return_slot_ = slots.at(function_->return_value());
+
+  for (Node* node : order.order()) {
+    Slot result = slots.at(node);
+    if (node->Is<Literal>()) {
+      const Value& value = node->As<Literal>()->value();
+      if (result.packed()) {
+        XLS_ASSIGN_OR_RETURN(initial_words_[result.index],
+                             value.bits().ToUint64());
+      } else {
+        initial_values_[result.index] = value;
+      }
+      literals_.push_back(node->As<Literal>());
+      continue;
+    }
+
+    Instruction instruction{.opcode = Opcode::kFallback,
+                            .result = result,
+                            .operand_start =
+                                static_cast<int32_t>(operands_.size()),
+                            .operand_count =
+                                static_cast<int32_t>(node->operand_count()),
+                            .immediate = 0,
+                            .node = node};
+    bool all_packed = result.packed();
+    for (Node* operand : node->operands()) {
+      operands_.push_back(slots.at(operand));
+      all_packed = all_packed && operands_.back().packed();
+    }
+
+    if (node->Is<Param>()) {
+      instruction.opcode = Opcode::kParam;
+      XLS_ASSIGN_OR_RETURN(instruction.immediate,
+                           function_->GetParamIndex(node->As<Param>()));
+    } else if (node->Is<Invoke>()) {
+      Function* callee = node->As<Invoke>()->to_apply();
+      if (!compiled_callees.contains(callee)) {
+        auto compiled = absl::WrapUnique(new BytecodeFunction(callee));
+        XLS_RETURN_IF_ERROR(compiled->Lower(compiled_callees));
+        compiled_callees[callee] = std::move(compiled);
+      }
+      instruction.opcode = Opcode::kInvoke;
+      instruction.immediate = callees_.size();
+      callees_.push_back(compiled_callees.at(callee));
+    } else if (all_packed) {
+      switch (node->op()) {
+        case Op::kAdd:
+          instruction.opcode = Opcode::kAdd;
+          break;
+        case Op::kSub:
+          instruction.opcode = Opcode::kSub;
+          break;
+        case Op::kUMul:
+          instruction.opcode = Opcode::kUMul;
+          break;
+        case Op::kSMul:
+          instruction.opcode = Opcode::kSMul;
+          break;
+        case Op::kNeg:
+          instruction.opcode = Opcode::kNeg;
+          break;
+        case Op::kNot:
+          instruction.opcode = Opcode::kNot;
+          break;
+        case Op::kAnd:
+          instruction.opcode = Opcode::kAnd;
+          break;
+        case Op::kOr:
+          instruction.opcode = Opcode::kOr;
+          break;
+        case Op::kXor:
+          instruction.opcode = Opcode::kXor;
+          break;
+        case Op::kNand:
+          instruction.opcode = Opcode::kNand;
+          break;
+        case Op::kNor:
+          instruction.opcode = Opcode::kNor;
+          break;
+        case Op::kEq:
+          instruction.opcode = Opcode::kEq;
+          break;
+        case Op::kNe:
+          instruction.opcode = Opcode::kNe;
+          break;
+        case Op::kULt:
+          instruction.opcode = Opcode::kULt;
+          break;
+        case Op::kULe:
+          instruction.opcode = Opcode::kULe;
+          break;
+        case Op::kUGt:
+          instruction.opcode = Opcode::kUGt;
+          break;
+        case Op::kUGe:
+          instruction.opcode = Opcode::kUGe;
+          break;
+        case Op::kSLt:
+          instruction.opcode = Opcode::kSLt;
+          break;
+        case Op::kSLe:
+          instruction.opcode = Opcode::kSLe;
+          break;
+        case Op::kSGt:
+          instruction.opcode = Opcode::kSGt;
+          break;
+        case Op::kSGe:
+          instruction.opcode = Opcode::kSGe;
+          break;
+        case Op::kShll:
+          instruction.opcode = Opcode::kShll;
+          break;
+        case Op::kShrl:
+          instruction.opcode = Opcode::kShrl;
+          break;
+        case Op::kShra:
+          instruction.opcode = Opcode::kShra;
+          break;
+        case Op::kBitSlice:
+          instruction.opcode = Opcode::kBitSlice;
+          instruction.immediate = node->As<BitSlice>()->start();
+          break;
+        case Op::kConcat:
+          instruction.opcode = Opcode::kConcat;
+          break;
+        case Op::kZeroExt:
+          instruction.opcode = Opcode::kZeroExtend;
+          break;
+        case Op::kSignExt:
+          instruction.opcode = Opcode::kSignExtend;
+          break;
+        case Op::kIdentity:
+          instruction.opcode = Opcode::kIdentity;
+          break;
+        case Op::kSel:
+          instruction.opcode = Opcode::kSel;
+          instruction.immediate = node->As<Select>()->cases().size();
+          break;
+        case Op::kGate:
+          instruction.opcode = Opcode::kGate;
+          break;
+        case Op::kAndReduce:
+          instruction.opcode = Opcode::kAndReduce;
+          break;
+        case Op::kOrReduce:
+          instruction.opcode = Opcode::kOrReduce;
+          break;
+        case Op::kXorReduce:
+          instruction.opcode = Opcode::kXorReduce;
+          break;
+        case Op::kReverse:
+          instruction.opcode = Opcode::kReverse;
+          break;
+        default:
+          break;
+      }
+    }
+    instructions_.push_back(instruction);
+  }
+  VLOG(3) << absl::StreamFormat(
+      "Lowered function %s to %d instructions (%d evaluated by the "
+      "IrInterpreter)",
+      function_->name(), instruction_count(), fallback_instruction_count());
+  return absl::OkStatus();
+}
+
+int64_t BytecodeFunction::fallback_instruction_count() const {
+  int64_t count = 0;
+  for (const Instruction& instruction : instructions_) {
+    if (instruction.opcode == Opcode::kFallback) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+absl::StatusOr<InterpreterResult<Value>> BytecodeFunction::Run(
+    absl::Span<const Value> args, const EvaluatorOptions& options,
+    std::optional<EvaluationObserver*> observer, int call_depth,
+    std::optional<SourceInfo> call_site) const {
+  VLOG(3) << "Interpreting function " << function_->name() << " as bytecode";
+  if (args.size() != function_->params().size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Function `%s` (type: `%s`) wants %d arguments, got %d.",
+        function_->name(), function_->GetType()->ToString(),
+        function_->params().size(), args.size()));
+  }
+  for (int64_t argno = 0; argno < args.size(); ++argno) {
+    Type* param_type = function_->param(argno)->GetType();
+    if (function_->package()->GetTypeForValue(args[argno]) != param_type) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Got argument %s for parameter %d which is not of type %s",
+          args[argno].ToString(), argno, param_type->ToString()));
+    }
+  }
+
+  RunState state{.words = initial_words_, .values = initial_values_};
+  if (options.trace_calls()) {
+    state.events.AddTraceCallMessage(
+        function_->name(), args, call_depth, options.format_preference(),
+        call_site, ResolveSourceFilename(function_, call_site));
+  }
+  if (observer.has_value()) {
+    for (Literal* literal : literals_) {
+      (*observer)->NodeEvaluated(literal, literal->value());
+    }
+  }
+
+  uint64_t* words = state.words.data();
+  for (const Instruction& instruction : instructions_) {
+    const Slot* operands = operands_.data() + instruction.operand_start;
+    auto operand = [&](int64_t i) -> uint64_t {
+      return words[operands[i].index];
+    };
+    const uint64_t width = instruction.result.width;
+    uint64_t result;
+    switch (instruction.opcode) {
+      case Opcode::kAdd:
+        result = operand(0) + operand(1);
+        break;
+      case Opcode::kSub:
+        result = operand(0) - operand(1);
+        break;
+      case Opcode::kUMul:
+        result = operand(0) * operand(1);
+        break;
+      case Opcode::kSMul:
+        // The low bits of the product do not depend on the high bits of the
+        // operands so the product modulo 2^64 is sufficient.
+        result =
+            static_cast<uint64_t>(SignExtend(operand(0), operands[0].width)) *
+            static_cast<uint64_t>(SignExtend(operand(1), operands[1].width));
+        break;
+      case Opcode::kNeg:
+        result = uint64_t{0} - operand(0);
+        break;
+      case Opcode::kNot:
+        result = ~operand(0);
+        break;
+      case Opcode::kAnd:
+      case Opcode::kNand:
+        result = ~uint64_t{0};
+        for (int64_t i = 0; i < instruction.operand_count; ++i) {
+          result &= operand(i);
+        }
+        if (instruction.opcode == Opcode::kNand) {
+          result = ~result;
+        }
+        break;
+      case Opcode::kOr:
+      case Opcode::kNor:
+        result = 0;
+        for (int64_t i = 0; i < instruction.operand_count; ++i) {
+          result |= operand(i);
+        }
+        if (instruction.opcode == Opcode::kNor) {
+          result = ~result;
+        }
+        break;
+      case Opcode::kXor:
+        result = 0;
+        for (int64_t i = 0; i < instruction.operand_count; ++i) {
+          result ^= operand(i);
+        }
+        break;
+      case Opcode::kEq:
+        result = operand(0) == operand(1);
+        break;
+      case Opcode::kNe:
+        result = operand(0) != operand(1);
+        break;
+      case Opcode::kULt:
+        result = operand(0) < operand(1);
+        break;
+      case Opcode::kULe:
+        result = operand(0) <= operand(1);
+        break;
+      case Opcode::kUGt:
+        result = operand(0) > operand(1);
+        break;
+      case Opcode::kUGe:
+        result = operand(0) >= operand(1);
+        break;
+      case Opcode::kSLt:
+        result = SignExtend(operand(0), operands[0].width) <
+                 SignExtend(operand(1), operands[1].width);
+        break;
+      case Opcode::kSLe:
+        result = SignExtend(operand(0), operands[0].width) <=
+                 SignExtend(operand(1), operands[1].width);
+        break;
+      case Opcode::kSGt:
+        result = SignExtend(operand(0), operands[0].width) >
+                 SignExtend(operand(1), operands[1].width);
+        break;
+      case Opcode::kSGe:
+        result = SignExtend(operand(0), operands[0].width) >=
+                 SignExtend(operand(1), operands[1].width);
+        break;
+      case Opcode::kShll:
+        result = operand(1) >= width ? 0 : operand(0) << operand(1);
+        break;
+      case Opcode::kShrl:
+        result = operand(1) >= width ? 0 : operand(0) >> operand(1);
+        break;
+      case Opcode::kShra: {
+        int64_t value = SignExtend(operand(0), width);
+        if (operand(1) >= width) {
+          result = value < 0 ? ~uint64_t{0} : 0;
+        } else {
+          result = static_cast<uint64_t>(value >> operand(1));
+        }
+        break;
+      }
+      case Opcode::kBitSlice:
+        result = instruction.immediate >= 64
+                     ? 0
+                     : operand(0) >> instruction.immediate;
+        break;
+      case Opcode::kConcat:
+        // Operand zero is the most significant. An operand of 64 bits can
+        // only be concatenated with zero-width operands.
+        result = 0;
+        for (int64_t i = 0; i < instruction.operand_count; ++i) {
+          result = operands[i].width >= 64
+                       ? operand(i)
+                       : (result << operands[i].width) | operand(i);
+        }
+        break;
+      case Opcode::kZeroExtend:
+      case Opcode::kIdentity:
+        result = operand(0);
+        break;
+      case Opcode::kSignExtend:
+        result =
+            static_cast<uint64_t>(SignExtend(operand(0), operands[0].width));
+        break;
+      case Opcode::kSel: {
+        uint64_t selector = operand(0);
+        uint64_t case_count = instruction.immediate;
+        result = selector < case_count ? operand(selector + 1)
+                                       : operand(case_count + 1);
+        break;
+      }
+      case Opcode::kGate:
+        result = operand(0) != 0 ? operand(1) : 0;
+        break;
+      case Opcode::kAndReduce:
+        result = operand(0) == Mask(operands[0].width);
+        break;
+      case Opcode::kOrReduce:
+        result = operand(0) != 0;
+        break;
+      case Opcode::kXorReduce:
+        result = std::popcount(operand(0)) & 1;
+        break;
+      case Opcode::kReverse: {
+        uint64_t value = operand(0);
+        result = 0;
+        for (uint64_t i = 0; i < width; ++i) {
+          result = (result << 1) | ((value >> i) & 1);
+        }
+        break;
+      }
+      case Opcode::kParam:
+      case Opcode::kInvoke:
+      case Opcode::kFallback:
+        XLS_RETURN_IF_ERROR(ExecuteSlow(instruction, args, options, observer,
+                                        call_depth, state));
+        continue;
+    }
+    words[instruction.result.index] =
+        result & Mask(instruction.result.width);
+    if (observer.has_value()) {
+      (*observer)->NodeEvaluated(instruction.node,
+                                 state.Load(instruction.result));
+    }
+  }
+
+  Value result = state.Load(return_slot_);
+  VLOG(2) << "Result = " << result;
+  if (options.trace_calls()) {
+    state.events.AddTraceCallReturnMessage(
+        function_->name(), call_depth, options.format_preference(), result,
+        call_site, ResolveSourceFilename(function_, call_site));
+  }
+  return InterpreterResult<Value>{std::move(result), std::move(state.events)};
+}
+
+absl::Status BytecodeFunction::ExecuteSlow(
+    const Instruction& instruction, absl::Span<const Value> args,
+    const EvaluatorOptions& options,
+    std::optional<EvaluationObserver*> observer, int call_depth,
+    RunState& state) const {
+  if (instruction.opcode == Opcode::kParam) {
+    const Value& arg = args[instruction.immediate];
+    XLS_RETURN_IF_ERROR(state.Store(instruction.result, arg));
+    if (observer.has_value()) {
+      (*observer)->NodeEvaluated(instruction.node, arg);
+    }
+    return absl::OkStatus();
+  }
+
+  state.operand_values.clear();
+  for (int64_t i = 0; i < instruction.operand_count; ++i) {
+    state.operand_values.push_back(
+        state.Load(operands_[instruction.operand_start + i]));
+  }
+  if (instruction.opcode == Opcode::kInvoke) {
+    XLS_ASSIGN_OR_RETURN(
+        InterpreterResult<Value> result,
+        callees_[instruction.immediate]->Run(
+            state.operand_values, options, observer, call_depth + 1,
+            std::optional<SourceInfo>(instruction.node->loc())));
+    state.events.AppendFrom(result.events);
+    if (observer.has_value()) {
+      (*observer)->NodeEvaluated(instruction.node, result.value);
+    }
+    return state.Store(instruction.result, std::move(result.value));
+  }
+
+  XLS_RET_CHECK(instruction.opcode == Opcode::kFallback);
+  if (!state.fallback.has_value()) {
+    // Functions applied by loops and maps are evaluated by the IrInterpreter
+    // rather than compiled on every iteration.
+    EvaluatorOptions fallback_options = options;
+    fallback_options.set_use_bytecode(false);
+    state.fallback.emplace(&state.events, fallback_options, observer,
+                           call_depth);
+  }
+  XLS_ASSIGN_OR_RETURN(
+      Value result,
+      state.fallback->Evaluate(instruction.node, state.operand_values));
+  return state.Store(instruction.result, std::move(result));
+}
+
+absl::StatusOr<InterpreterResult<Value>> BytecodeFunction::RunKwargs(
+    const absl::flat_hash_map<std::string, Value>& args,
+    const EvaluatorOptions& options,
+    std::optional<EvaluationObserver*> observer) const {
+  XLS_ASSIGN_OR_RETURN(std::vector<Value> positional_args,
+                       KeywordArgsToPositional(*function_, args));
+  return Run(positional_args, options, observer);
+}
+
+}  // namespace xls
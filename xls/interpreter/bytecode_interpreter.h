@@ -0,0 +1,173 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_BYTECODE_INTERPRETER_H_
+#define XLS_INTERPRETER_BYTECODE_INTERPRETER_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/observer.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/source_location.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+
+// An interpreter for XLS functions which lowers the function once into a flat
+// array of instructions in evaluation order. Each node is assigned a dense
+// slot index: bits-typed nodes of at most 64 bits live in a preallocated array
+// of words and are evaluated by a tight dispatch loop without hashing or
+// allocation. All other nodes (wider bits, tuples, arrays, tokens) and ops
+// without a specialized instruction are held as Values and evaluated by the
+// IrInterpreter one node at a time, so every function supported by the
+// IrInterpreter is supported here as well.
+//
+// The compiled function is immutable and may be run concurrently from
+// multiple threads. The function must not be modified after compilation.
+class BytecodeFunction {
+ public:
+  static absl::StatusOr<std::unique_ptr<BytecodeFunction>> Compile(
+      Function* function);
+
+  // Runs the compiled function on the given arguments. Semantics (including
+  // trace, assert and call-tracing events) match InterpretFunction.
+  absl::StatusOr<InterpreterResult<Value>> Run(
+      absl::Span<const Value> args,
+      const EvaluatorOptions& options = EvaluatorOptions(),
+      std::optional<EvaluationObserver*> observer = std::nullopt,
+      int call_depth = 0,
+      std::optional<SourceInfo> call_site = std::nullopt) const;
+
+  // As above, with the arguments given by parameter name.
+  absl::StatusOr<InterpreterResult<Value>> RunKwargs(
+      const absl::flat_hash_map<std::string, Value>& args,
+      const EvaluatorOptions& options = EvaluatorOptions(),
+      std::optional<EvaluationObserver*> observer = std::nullopt) const;
+
+  Function* function() const { return function_; }
+
+  // Returns the number of instructions and the number of those which are
+  // evaluated by the IrInterpreter rather than natively.
+  int64_t instruction_count() const { return instructions_.size(); }
+  int64_t fallback_instruction_count() const;
+
+ private:
+  enum class Opcode : uint8_t {
+    kParam,
+    kAdd,
+    kSub,
+    kUMul,
+    kSMul,
+    kNeg,
+    kNot,
+    kAnd,
+    kOr,
+    kXor,
+    kNand,
+    kNor,
+    kEq,
+    kNe,
+    kULt,
+    kULe,
+    kUGt,
+    kUGe,
+    kSLt,
+    kSLe,
+    kSGt,
+    kSGe,
+    kShll,
+    kShrl,
+    kShra,
+    kBitSlice,
+    kConcat,
+    kZeroExtend,
+    kSignExtend,
+    kIdentity,
+    kSel,
+    kGate,
+    kAndReduce,
+    kOrReduce,
+    kXorReduce,
+    kReverse,
+    // Evaluates an invoke by running the callee's compiled form.
+    kInvoke,
+    // Evaluates the node with the IrInterpreter.
+    kFallback,
+  };
+
+  // Location of a node's value. Nodes with a `width` of at least zero are
+  // bits-typed and stored in word `index` of the packed storage. Other nodes
+  // are stored in entry `index` of the Value storage.
+  struct Slot {
+    int32_t index;
+    int32_t width;
+
+    bool packed() const { return width >= 0; }
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    Slot result;
+    // Operands are `operands_[operand_start, operand_start + operand_count)`.
+    int32_t operand_start;
+    int32_t operand_count;
+    // Opcode-specific immediate: the parameter index for kParam, the start bit
+    // for kBitSlice, the case count for kSel and the callee index for kInvoke.
+    int64_t immediate;
+    Node* node;
+  };
+
+  struct RunState;
+
+  explicit BytecodeFunction(Function* function) : function_(function) {}
+
+  // Lowers `function_` into instructions. Invoked functions are compiled as
+  // well and shared through `compiled_callees`.
+  absl::Status Lower(
+      absl::flat_hash_map<Function*, std::shared_ptr<const BytecodeFunction>>&
+          compiled_callees);
+  // Executes the instructions which do not operate on packed words.
+  absl::Status ExecuteSlow(const Instruction& instruction,
+                           absl::Span<const Value> args,
+                           const EvaluatorOptions& options,
+                           std::optional<EvaluationObserver*> observer,
+                           int call_depth, RunState& state) const;
+
+  Function* function_;
+  std::vector<Instruction> instructions_;
+  std::vector<Slot> operands_;
+  // Initial contents of the packed and Value storage; literals are written
+  // here at compile time.
+  std::vector<uint64_t> initial_words_;
+  std::vector<Value> initial_values_;
+  std::vector<Literal*> literals_;
+  std::vector<std::shared_ptr<const BytecodeFunction>> callees_;
+  Slot return_slot_;
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_BYTECODE_INTERPRETER_H_
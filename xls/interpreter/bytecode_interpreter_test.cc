@@ -0,0 +1,173 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/bytecode_interpreter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/random.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/interpreter/ir_evaluator_test_base.h"
+#include "xls/interpreter/observer.h"
+#include "xls/interpreter/random_value.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+INSTANTIATE_TEST_SUITE_P(
+    BytecodeInterpreterTest, IrEvaluatorTestBase,
+    testing::Values(IrEvaluatorTestParam(
+        [](Function* function, absl::Span<const Value> args,
+           const EvaluatorOptions& options,
+           std::optional<EvaluationObserver*> obs)
+            -> absl::StatusOr<InterpreterResult<Value>> {
+          XLS_ASSIGN_OR_RETURN(std::unique_ptr<BytecodeFunction> bytecode,
+                               BytecodeFunction::Compile(function));
+          return bytecode->Run(args, options, obs);
+        },
+        [](Function* function,
+           const absl::flat_hash_map<std::string, Value>& kwargs,
+           const EvaluatorOptions& options,
+           std::optional<EvaluationObserver*> obs)
+            -> absl::StatusOr<InterpreterResult<Value>> {
+          XLS_ASSIGN_OR_RETURN(std::unique_ptr<BytecodeFunction> bytecode,
+                               BytecodeFunction::Compile(function));
+          return bytecode->RunKwargs(kwargs, options, obs);
+        },
+        true, "BytecodeInterpreter")),
+    testing::PrintToStringParamName());
+
+class BytecodeInterpreterOnlyTest : public IrTestBase {};
+
+// Compares the bytecode interpreter against the IrInterpreter on random inputs
+// for every op with a packed implementation at a range of widths.
+TEST_F(BytecodeInterpreterOnlyTest, PackedOpsMatchIrInterpreter) {
+  for (int64_t width : {1, 3, 8, 31, 32, 63, 64}) {
+    auto p = CreatePackage();
+    FunctionBuilder fb(TestName(), p.get());
+    BValue x = fb.Param("x", p->GetBitsType(width));
+    BValue y = fb.Param("y", p->GetBitsType(width));
+    BValue amount = fb.Param("amount", p->GetBitsType(7));
+    BValue s = fb.Param("s", p->GetBitsType(2));
+    std::vector<BValue> results = {
+        fb.Add(x, y),
+        fb.Subtract(x, y),
+        fb.UMul(x, y),
+        fb.SMul(x, y),
+        fb.UMul(x, amount, /*result_width=*/std::min<int64_t>(width + 7, 64)),
+        fb.SMul(x, amount, /*result_width=*/std::min<int64_t>(width + 7, 64)),
+        fb.Negate(x),
+        fb.Not(x),
+        fb.And({x, y, x}),
+        fb.Or(x, y),
+        fb.Xor({x, y, y}),
+        fb.Nand(x, y),
+        fb.Nor(x, y),
+        fb.Eq(x, y),
+        fb.Ne(x, y),
+        fb.ULt(x, y),
+        fb.ULe(x, y),
+        fb.UGt(x, y),
+        fb.UGe(x, y),
+        fb.SLt(x, y),
+        fb.SLe(x, y),
+        fb.SGt(x, y),
+        fb.SGe(x, y),
+        fb.Shll(x, amount),
+        fb.Shrl(x, amount),
+        fb.Shra(x, amount),
+        fb.BitSlice(x, /*start=*/width / 2, /*width=*/width - width / 2),
+        fb.Concat({s, fb.BitSlice(x, 0, std::min<int64_t>(width, 62))}),
+        fb.ZeroExtend(x, 64),
+        fb.SignExtend(x, 64),
+        fb.Identity(x),
+        fb.Select(s, {x, y, fb.Negate(x), fb.Not(y)}),
+        fb.Select(fb.BitSlice(s, 0, 1), std::vector<BValue>{x},
+                  /*default_value=*/y),
+        fb.Gate(fb.BitSlice(s, 1, 1), x),
+        fb.AndReduce(x),
+        fb.OrReduce(x),
+        fb.XorReduce(x),
+        fb.Reverse(x),
+    };
+    // Wide and aggregate values fall back to the IrInterpreter.
+    results.push_back(fb.Tuple({fb.ZeroExtend(x, 100), fb.Shll(x, s)}));
+    fb.Tuple(results);
+    XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BytecodeFunction> bytecode,
+                             BytecodeFunction::Compile(f));
+    EXPECT_EQ(bytecode->fallback_instruction_count(), 3);
+
+    absl::BitGen rng;
+    for (int64_t i = 0; i < 256; ++i) {
+      std::vector<Value> args = RandomFunctionArguments(f, rng);
+      XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> expected,
+                               InterpretFunction(f, args));
+      XLS_ASSERT_OK_AND_ASSIGN(InterpreterResult<Value> actual,
+                               bytecode->Run(args));
+      ASSERT_EQ(actual.value, expected.value)
+          << "width " << width << " args "
+          << Value::Tuple(args).ToString();
+    }
+  }
+}
+
+TEST_F(BytecodeInterpreterOnlyTest, UseBytecodeOption) {
+  auto p = CreatePackage();
+  FunctionBuilder inner_b("inner", p.get());
+  inner_b.Add(inner_b.Param("a", p->GetBitsType(8)),
+              inner_b.Param("b", p->GetBitsType(8)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * inner, inner_b.Build());
+  FunctionBuilder fb(TestName(), p.get());
+  BValue m = fb.Param("m", p->GetBitsType(8));
+  BValue n = fb.Param("n", p->GetBitsType(8));
+  fb.Add(fb.Invoke({m, n}, inner), fb.Invoke({n, m}, inner));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  EvaluatorOptions options;
+  options.set_trace_calls(true);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpreterResult<Value> expected,
+      InterpretFunction(f, {Value(UBits(1, 8)), Value(UBits(2, 8))}, options));
+  options.set_use_bytecode(true);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      InterpreterResult<Value> actual,
+      InterpretFunction(f, {Value(UBits(1, 8)), Value(UBits(2, 8))}, options));
+  EXPECT_EQ(actual.value, Value(UBits(6, 8)));
+  EXPECT_EQ(actual.value, expected.value);
+  EXPECT_THAT(actual.events.GetTraceMessageStrings(),
+              testing::ElementsAreArray(
+                  expected.events.GetTraceMessageStrings()));
+}
+
+}  // namespace
+}  // namespace xls
@@ -49,11 +49,20 @@ class EvaluatorOptions {
   }
   bool trace_calls() const { return trace_calls_; }
 
+  // Whether functions are interpreted by lowering them to a linear bytecode
+  // (see BytecodeFunction) rather than by visiting each node of the IR.
+  EvaluatorOptions& set_use_bytecode(bool value) {
+    use_bytecode_ = value;
+    return *this;
+  }
+  bool use_bytecode() const { return use_bytecode_; }
+
  private:
   bool trace_channels_ = false;
   FormatPreference format_preference_ = FormatPreference::kDefault;
   bool support_observers_ = false;
   bool trace_calls_ = false;
+  bool use_bytecode_ = false;
 };
 
 }  // namespace xls
@@ -14,6 +14,7 @@
 #include "xls/interpreter/function_interpreter.h"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -26,6 +27,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/interpreter/bytecode_interpreter.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/interpreter/observer.h"
@@ -73,6 +75,11 @@ absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
     const EvaluatorOptions& options,
     std::optional<EvaluationObserver*> observer, int call_depth,
     std::optional<SourceInfo> call_site) {
+  if (options.use_bytecode()) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<BytecodeFunction> bytecode,
+                         BytecodeFunction::Compile(function));
+    return bytecode->Run(args, options, observer, call_depth, call_site);
+  }
   VLOG(3) << "Interpreting function " << function->name();
   if (args.size() != function->params().size()) {
     return absl::InvalidArgumentError(absl::StrFormat(
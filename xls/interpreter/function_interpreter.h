@@ -34,6 +34,10 @@ namespace xls {
 // indexed by parameter name. Returns both the value and any events that
 // happened while running.
 // New overload: accepts options before observer.
+//
+// If `options.use_bytecode()` is set the function is lowered to bytecode
+// before evaluation. Callers which evaluate a function many times should
+// instead compile it once with BytecodeFunction::Compile.
 absl::StatusOr<InterpreterResult<Value>> InterpretFunction(
     Function* function, absl::Span<const Value> args,
     const EvaluatorOptions& options = EvaluatorOptions(),
@@ -0,0 +1,188 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/benchmark_support.h"
+#include "xls/common/init_xls.h"
+#include "xls/interpreter/bytecode_interpreter.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/benchmark_support.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+constexpr int64_t kParamCount = 16;
+
+// Leaf strategy which cycles through a fixed set of parameters.
+class CyclingParam final : public benchmark_support::strategy::NullaryNode {
+ public:
+  explicit CyclingParam(std::vector<BValue> params)
+      : params_(std::move(params)) {}
+
+  absl::StatusOr<BValue> GenerateNullaryNode(
+      FunctionBuilder& builder) const final {
+    return params_[next_++ % params_.size()];
+  }
+
+ private:
+  std::vector<BValue> params_;
+  mutable int64_t next_ = 0;
+};
+
+// Returns a function containing a balanced tree of `2^depth` adds of 32-bit
+// parameters.
+Function* BalancedAddTree(Package* package, int64_t depth) {
+  FunctionBuilder fb("tree", package);
+  std::vector<BValue> params;
+  for (int64_t i = 0; i < kParamCount; ++i) {
+    params.push_back(fb.Param(absl::StrCat("p", i), package->GetBitsType(32)));
+  }
+  CyclingParam leaves(params);
+  CHECK_OK(benchmark_support::GenerateBalancedTree(
+               fb, depth, /*fan_out=*/2,
+               benchmark_support::strategy::BinaryAdd(), leaves)
+               .status());
+  return fb.Build().value();
+}
+
+std::vector<Value> Arguments() {
+  std::vector<Value> args;
+  for (int64_t i = 0; i < kParamCount; ++i) {
+    args.push_back(Value(UBits(i * 0x01010101, 32)));
+  }
+  return args;
+}
+
+void BM_InterpretAddTree(benchmark::State& state) {
+  Package package("benchmark");
+  Function* function = BalancedAddTree(&package, state.range(0));
+  std::vector<Value> args = Arguments();
+  for (auto _ : state) {
+    absl::StatusOr<InterpreterResult<Value>> result =
+        InterpretFunction(function, args);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["nodes"] = function->node_count();
+}
+
+void BM_InterpretAddTreeBytecode(benchmark::State& state) {
+  Package package("benchmark");
+  Function* function = BalancedAddTree(&package, state.range(0));
+  std::unique_ptr<BytecodeFunction> bytecode =
+      BytecodeFunction::Compile(function).value();
+  std::vector<Value> args = Arguments();
+  for (auto _ : state) {
+    absl::StatusOr<InterpreterResult<Value>> result = bytecode->Run(args);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["nodes"] = function->node_count();
+}
+
+// Includes the cost of lowering the function on every evaluation.
+void BM_InterpretAddTreeBytecodeOption(benchmark::State& state) {
+  Package package("benchmark");
+  Function* function = BalancedAddTree(&package, state.range(0));
+  std::vector<Value> args = Arguments();
+  EvaluatorOptions options = EvaluatorOptions().set_use_bytecode(true);
+  for (auto _ : state) {
+    absl::StatusOr<InterpreterResult<Value>> result =
+        InterpretFunction(function, args, options);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["nodes"] = function->node_count();
+}
+
+// Returns a function which applies a chain of `length` read-modify-write
+// updates to an array of 64 32-bit elements.
+Function* ArrayUpdateChain(Package* package, int64_t length) {
+  constexpr int64_t kArraySize = 64;
+  FunctionBuilder fb("chain", package);
+  BValue array = fb.Param(
+      "a", package->GetArrayType(kArraySize, package->GetBitsType(32)));
+  for (int64_t i = 0; i < length; ++i) {
+    BValue index = fb.Literal(UBits((i * 7) % kArraySize, 8));
+    BValue element = fb.ArrayIndex(array, {index});
+    array = fb.ArrayUpdate(
+        array, fb.Add(element, fb.Literal(UBits(i, 32))), {index});
+  }
+  return fb.Build().value();
+}
+
+std::vector<Value> ArrayArguments() {
+  std::vector<Value> elements;
+  for (int64_t i = 0; i < 64; ++i) {
+    elements.push_back(Value(UBits(i, 32)));
+  }
+  return {Value::ArrayOrDie(elements)};
+}
+
+void BM_InterpretArrayUpdateChain(benchmark::State& state) {
+  Package package("benchmark");
+  Function* function = ArrayUpdateChain(&package, state.range(0));
+  std::vector<Value> args = ArrayArguments();
+  for (auto _ : state) {
+    absl::StatusOr<InterpreterResult<Value>> result =
+        InterpretFunction(function, args);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["nodes"] = function->node_count();
+}
+
+void BM_InterpretArrayUpdateChainBytecode(benchmark::State& state) {
+  Package package("benchmark");
+  Function* function = ArrayUpdateChain(&package, state.range(0));
+  std::unique_ptr<BytecodeFunction> bytecode =
+      BytecodeFunction::Compile(function).value();
+  std::vector<Value> args = ArrayArguments();
+  for (auto _ : state) {
+    absl::StatusOr<InterpreterResult<Value>> result = bytecode->Run(args);
+    CHECK_OK(result.status());
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["nodes"] = function->node_count();
+}
+
+BENCHMARK(BM_InterpretAddTree)->DenseRange(4, 12, 4);
+BENCHMARK(BM_InterpretAddTreeBytecode)->DenseRange(4, 12, 4);
+BENCHMARK(BM_InterpretAddTreeBytecodeOption)->DenseRange(4, 12, 4);
+BENCHMARK(BM_InterpretArrayUpdateChain)->Range(16, 1024);
+BENCHMARK(BM_InterpretArrayUpdateChainBytecode)->Range(16, 1024);
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RunSpecifiedBenchmarks(/*default_spec=*/"all");
+  return 0;
+}
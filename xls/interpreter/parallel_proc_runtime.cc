@@ -0,0 +1,282 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/parallel_proc_runtime.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/ir/events.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/proc_elaboration.h"
+
+namespace xls {
+namespace {
+
+bool HasNonBlockingReceives(const ProcElaboration& elaboration) {
+  for (Proc* proc : elaboration.procs()) {
+    for (Node* node : proc->nodes()) {
+      if (node->Is<Receive>() && !node->As<Receive>()->is_blocking()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+ParallelProcRuntime::Create(
+    std::vector<std::unique_ptr<ProcEvaluator>>&& evaluators,
+    std::unique_ptr<ChannelQueueManager>&& queue_manager,
+    const EvaluatorOptions& options, int64_t thread_count) {
+  XLS_RET_CHECK_GE(thread_count, 0);
+  // Verify there exists exactly one evaluator per proc in the package.
+  absl::flat_hash_map<Proc*, std::unique_ptr<ProcEvaluator>> evaluator_map;
+  for (std::unique_ptr<ProcEvaluator>& evaluator : evaluators) {
+    Proc* proc = evaluator->proc();
+    auto [it, inserted] = evaluator_map.insert({proc, std::move(evaluator)});
+    XLS_RET_CHECK(inserted) << absl::StreamFormat(
+        "More than one evaluator given for proc `%s`", proc->name());
+  }
+  for (Proc* proc : queue_manager->elaboration().procs()) {
+    XLS_RET_CHECK(evaluator_map.contains(proc))
+        << absl::StreamFormat("No evaluator given for proc `%s`", proc->name());
+  }
+  XLS_RET_CHECK_EQ(evaluator_map.size(),
+                   queue_manager->elaboration().procs().size())
+      << "More evaluators than procs given.";
+
+  const ProcElaboration& elaboration = queue_manager->elaboration();
+  int64_t worker_count =
+      thread_count == 0 ? DefaultThreadCount() : thread_count;
+  worker_count = std::clamp<int64_t>(
+      worker_count, 1,
+      std::max<int64_t>(1, elaboration.proc_instances().size()));
+  // Channel traces are recorded in the order in which channel operations
+  // occur so tracing requires the serial tick order as well.
+  bool requires_serial_order =
+      HasNonBlockingReceives(elaboration) || options.trace_channels();
+  return absl::WrapUnique(new ParallelProcRuntime(
+      std::move(evaluator_map), std::move(queue_manager), options,
+      worker_count, requires_serial_order));
+}
+
+ParallelProcRuntime::ParallelProcRuntime(
+    absl::flat_hash_map<Proc*, std::unique_ptr<ProcEvaluator>>&& evaluators,
+    std::unique_ptr<ChannelQueueManager>&& queue_manager,
+    const EvaluatorOptions& options, int64_t worker_count,
+    bool requires_serial_order)
+    : ProcRuntime(std::move(evaluators), std::move(queue_manager), options),
+      worker_count_(worker_count),
+      requires_serial_order_(requires_serial_order) {
+  absl::MutexLock lock(&mutex_);
+  ready_.resize(worker_count_);
+}
+
+ParallelProcRuntime::ReadyElement ParallelProcRuntime::MakeReadyElement(
+    ProcInstance* instance) const {
+  return ReadyElement{.instance = instance,
+                      .evaluator = evaluators_.at(instance->proc()).get(),
+                      .continuation = continuations_.at(instance).get()};
+}
+
+void ParallelProcRuntime::PushReady(int64_t worker,
+                                    const ReadyElement& element) {
+  ready_[worker].push_back(element);
+  ++ready_count_;
+}
+
+ParallelProcRuntime::ReadyElement ParallelProcRuntime::PopOrStealReady(
+    int64_t worker) {
+  CHECK_GT(ready_count_, 0);
+  --ready_count_;
+  if (!ready_[worker].empty()) {
+    ReadyElement element = ready_[worker].front();
+    ready_[worker].pop_front();
+    return element;
+  }
+  for (int64_t i = 1; i < ready_.size(); ++i) {
+    std::deque<ReadyElement>& victim = ready_[(worker + i) % ready_.size()];
+    if (!victim.empty()) {
+      ReadyElement element = victim.back();
+      victim.pop_back();
+      VLOG(4) << absl::StreamFormat("Worker %d stole proc instance `%s`",
+                                    worker, element.instance->GetName());
+      return element;
+    }
+  }
+  LOG(FATAL) << "Ready count is positive but no ready proc instances found";
+}
+
+void ParallelProcRuntime::RunWorker(int64_t worker) {
+  auto can_proceed = [this]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return ready_count_ > 0 || running_count_ == 0 || !tick_status_.ok();
+  };
+  while (true) {
+    mutex_.Await(absl::Condition(&can_proceed));
+    if (!tick_status_.ok() || ready_count_ == 0) {
+      // Either an error occurred or no proc instance is ready or running so
+      // the network tick is complete.
+      return;
+    }
+    const ReadyElement element = PopOrStealReady(worker);
+    ++running_count_;
+
+    absl::StatusOr<TickResult> tick_result;
+    {
+      mutex_.Unlock();
+      VLOG(3) << absl::StreamFormat("Worker %d ticking proc instance `%s`",
+                                    worker, element.instance->GetName());
+      tick_result = element.evaluator->Tick(*element.continuation);
+      if (tick_result.ok()) {
+        absl::Status events_status = InterpreterEventsToStatus(
+            GetInterpreterEvents(element.instance));
+        if (!events_status.ok()) {
+          tick_result = events_status;
+        }
+      }
+      mutex_.Lock();
+    }
+    --running_count_;
+
+    if (!tick_result.ok()) {
+      if (tick_status_.ok()) {
+        tick_status_ = tick_result.status();
+      }
+      continue;
+    }
+    VLOG(3) << "Tick result: " << *tick_result;
+
+    progress_made_ |= tick_result->progress_made;
+    progress_made_on_io_procs_ |= (tick_result->progress_made &&
+                                   element.evaluator->ProcHasIoOperations());
+    if (tick_result->execution_state == TickExecutionState::kSentOnChannel) {
+      ChannelInstance* channel_instance = tick_result->channel_instance.value();
+      auto it = blocked_instances_.find(channel_instance);
+      if (it != blocked_instances_.end()) {
+        VLOG(3) << absl::StreamFormat(
+            "Unblocking proc instance `%s` and adding to ready list",
+            it->second->GetName());
+        PushReady(worker, MakeReadyElement(it->second));
+        blocked_instances_.erase(it);
+      }
+      // This proc instance can go back on the ready queue.
+      PushReady(worker, element);
+    } else if (tick_result->execution_state ==
+               TickExecutionState::kBlockedOnReceive) {
+      ChannelInstance* channel_instance = tick_result->channel_instance.value();
+      // The sender may have written to the channel after this proc instance
+      // observed it as empty but before the lock was reacquired. In that case
+      // the sender found no blocked instance to wake up so resume immediately.
+      if (!queue_manager().GetQueue(channel_instance).IsEmpty()) {
+        PushReady(worker, element);
+      } else {
+        VLOG(3) << absl::StreamFormat(
+            "Proc instance `%s` is now blocked on channel instance `%s`",
+            element.instance->GetName(), channel_instance->ToString());
+        blocked_instances_[channel_instance] = element.instance;
+      }
+    }
+  }
+}
+
+absl::StatusOr<ParallelProcRuntime::NetworkTickResult>
+ParallelProcRuntime::TickInternal() {
+  VLOG(3) << absl::StreamFormat("TickInternal on package %s",
+                                package()->name());
+  // Observers are not thread-safe and networks with non-blocking receives are
+  // sensitive to the tick order so these are ticked on the calling thread only
+  // in the same order as SerialProcRuntime.
+  bool use_worker_threads = worker_count_ > 1 && !requires_serial_order_ &&
+                            !observer_.has_value();
+  int64_t worker_count = use_worker_threads ? worker_count_ : 1;
+  {
+    absl::MutexLock lock(&mutex_);
+    XLS_RET_CHECK_EQ(ready_count_, 0);
+    XLS_RET_CHECK_EQ(running_count_, 0);
+    blocked_instances_.clear();
+    tick_status_ = absl::OkStatus();
+    progress_made_ = false;
+    progress_made_on_io_procs_ = false;
+
+    // Distribute all proc instances across the workers' ready lists.
+    int64_t next_worker = 0;
+    for (ProcInstance* instance : elaboration().proc_instances()) {
+      VLOG(3) << absl::StreamFormat("Proc instance `%s` added to ready list",
+                                    instance->GetName());
+      PushReady(next_worker, MakeReadyElement(instance));
+      next_worker = (next_worker + 1) % worker_count;
+    }
+  }
+
+  // Every worker runs until the network tick is complete, so the tick
+  // completes even if only some of the workers get a thread. Waiting for all
+  // of them ensures continuations are not touched after this method returns.
+  if (use_worker_threads) {
+    XLS_RETURN_IF_ERROR(
+        DefaultThreadPool().ParallelFor(worker_count, [&](int64_t worker) {
+          absl::MutexLock lock(&mutex_);
+          RunWorker(worker);
+          return absl::OkStatus();
+        }));
+  } else {
+    absl::MutexLock lock(&mutex_);
+    RunWorker(/*worker=*/0);
+  }
+
+  absl::MutexLock lock(&mutex_);
+  // Discard any remaining ready proc instances in case of an error.
+  for (std::deque<ReadyElement>& ready : ready_) {
+    ready.clear();
+  }
+  ready_count_ = 0;
+  XLS_RETURN_IF_ERROR(tick_status_);
+
+  std::vector<ChannelInstance*> blocked_channel_instances;
+  for (ChannelInstance* instance : elaboration().channel_instances()) {
+    if (blocked_instances_.contains(instance)) {
+      blocked_channel_instances.push_back(instance);
+    }
+  }
+  return NetworkTickResult{
+      .progress_made = progress_made_,
+      .progress_made_on_io_procs = progress_made_on_io_procs_,
+      .blocked_channel_instances = std::move(blocked_channel_instances),
+  };
+}
+
+}  // namespace xls
@@ -0,0 +1,125 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_INTERPRETER_PARALLEL_PROC_RUNTIME_H_
+#define XLS_INTERPRETER_PARALLEL_PROC_RUNTIME_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_runtime.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc_elaboration.h"
+
+namespace xls {
+
+// Class for evaluating a network of procs using multiple threads. Proc
+// instances which are ready to run are ticked concurrently by a set of workers
+// which run on DefaultThreadPool() and the calling thread. Each worker owns a
+// deque of ready proc instances and steals from the other workers' deques when
+// its own is empty. Proc instances which block on a
+// receive are parked until a send on the respective channel instance makes
+// them ready again.
+//
+// A network tick has the same semantics as SerialProcRuntime: every proc
+// instance executes (up to) a single iteration. For networks which only use
+// blocking receives the resulting channel contents and proc state are
+// independent of the order in which proc instances are ticked, so results are
+// identical to those of SerialProcRuntime. Non-blocking receives, observers and
+// channel tracing depend on the tick order so networks using any of them are
+// ticked on the calling thread in the same order as SerialProcRuntime.
+//
+// The evaluators must support concurrently ticking distinct continuations and
+// the channel queues must support a concurrent producer and consumer (e.g., as
+// created by JitChannelQueueManager::CreateThreadSafe or with lock-free
+// single-producer/single-consumer queues).
+//
+// ParallelProcRuntimes are thread-compatible, but not thread-safe.
+class ParallelProcRuntime : public ProcRuntime {
+ public:
+  // Creates and returns a parallel proc network runtime for the given
+  // evaluators. `thread_count` is the maximum number of threads to use
+  // (including the calling thread). If zero, DefaultThreadCount() is used.
+  static absl::StatusOr<std::unique_ptr<ParallelProcRuntime>> Create(
+      std::vector<std::unique_ptr<ProcEvaluator>>&& evaluators,
+      std::unique_ptr<ChannelQueueManager>&& queue_manager,
+      const EvaluatorOptions& options = EvaluatorOptions(),
+      int64_t thread_count = 0);
+
+  // Returns the number of threads used to tick the network.
+  int64_t thread_count() const { return worker_count_; }
+
+ private:
+  ParallelProcRuntime(
+      absl::flat_hash_map<Proc*, std::unique_ptr<ProcEvaluator>>&& evaluators,
+      std::unique_ptr<ChannelQueueManager>&& queue_manager,
+      const EvaluatorOptions& options, int64_t worker_count,
+      bool requires_serial_order);
+
+  absl::StatusOr<NetworkTickResult> TickInternal() override;
+
+  struct ReadyElement {
+    ProcInstance* instance;
+    ProcEvaluator* evaluator;
+    ProcContinuation* continuation;
+  };
+  ReadyElement MakeReadyElement(ProcInstance* instance) const;
+
+  // Adds the element to the ready deque of the given worker.
+  void PushReady(int64_t worker, const ReadyElement& element)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Removes a ready element from the worker's own deque or, if empty, steals
+  // one from the back of another worker's deque.
+  ReadyElement PopOrStealReady(int64_t worker)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Ticks ready proc instances until the network tick is complete or an error
+  // occurs.
+  void RunWorker(int64_t worker) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Number of workers used to tick the network, including the calling thread.
+  int64_t worker_count_;
+  bool requires_serial_order_;
+
+  absl::Mutex mutex_;
+
+  // Per-worker deques of proc instances which are ready to tick.
+  std::vector<std::deque<ReadyElement>> ready_ ABSL_GUARDED_BY(mutex_);
+  int64_t ready_count_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t running_count_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Proc instances blocked on a receive, indexed by channel instance.
+  absl::flat_hash_map<ChannelInstance*, ProcInstance*> blocked_instances_
+      ABSL_GUARDED_BY(mutex_);
+
+  // Results of the current network tick.
+  absl::Status tick_status_ ABSL_GUARDED_BY(mutex_);
+  bool progress_made_ ABSL_GUARDED_BY(mutex_) = false;
+  bool progress_made_on_io_procs_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace xls
+
+#endif  // XLS_INTERPRETER_PARALLEL_PROC_RUNTIME_H_
@@ -0,0 +1,176 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/interpreter/parallel_proc_runtime.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/log/check.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_runtime.h"
+#include "xls/interpreter/proc_runtime_test_base.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/channel_ops.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc_conversion.h"
+#include "xls/ir/value.h"
+#include "xls/jit/jit_proc_runtime.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::testing::ElementsAreArray;
+
+class ParallelProcRuntimeTest : public IrTestBase {};
+
+// Builds a chain of `stage_count` pass-through procs fed by a counter proc and
+// returns the output channel of the last stage.
+absl::StatusOr<Channel*> BuildPipeline(int64_t stage_count, Package* p) {
+  XLS_ASSIGN_OR_RETURN(
+      Channel * in_ch,
+      p->CreateStreamingChannel("stage_0", ChannelOps::kSendReceive,
+                                p->GetBitsType(32)));
+  {
+    ProcBuilder pb("counter", p);
+    BValue st = pb.ReadStateElement("st", Value(UBits(0, 32)));
+    pb.Send(in_ch, pb.Literal(Value::Token()), st);
+    XLS_RETURN_IF_ERROR(
+        pb.Build({pb.Add(st, pb.Literal(UBits(1, 32)))}).status());
+  }
+  for (int64_t i = 1; i <= stage_count; ++i) {
+    XLS_ASSIGN_OR_RETURN(
+        Channel * out_ch,
+        p->CreateStreamingChannel(
+            absl::StrFormat("stage_%d", i),
+            i == stage_count ? ChannelOps::kSendOnly : ChannelOps::kSendReceive,
+            p->GetBitsType(32)));
+    ProcBuilder pb(absl::StrFormat("pass_%d", i), p);
+    BValue rcv = pb.Receive(in_ch, pb.Literal(Value::Token()));
+    pb.Send(out_ch, pb.TupleIndex(rcv, 0),
+            pb.UMul(pb.TupleIndex(rcv, 1), pb.Literal(UBits(3, 32))));
+    XLS_RETURN_IF_ERROR(pb.Build().status());
+    in_ch = out_ch;
+  }
+  return in_ch;
+}
+
+TEST_F(ParallelProcRuntimeTest, PipelineMatchesSerialRuntime) {
+  constexpr int64_t kStages = 24;
+  constexpr int64_t kOutputs = 100;
+
+  auto serial_package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * serial_out,
+                           BuildPipeline(kStages, serial_package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(auto serial_runtime,
+                           CreateJitSerialProcRuntime(serial_package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      int64_t serial_ticks,
+      serial_runtime->TickUntilOutput({{serial_out, kOutputs}}));
+
+  auto parallel_package = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Channel * parallel_out,
+                           BuildPipeline(kStages, parallel_package.get()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto parallel_runtime,
+      CreateJitParallelProcRuntime(parallel_package.get(), EvaluatorOptions(),
+                                   /*thread_count=*/4));
+  EXPECT_EQ(parallel_runtime->thread_count(), 4);
+  EXPECT_THAT(parallel_runtime->TickUntilOutput({{parallel_out, kOutputs}}),
+              IsOkAndHolds(serial_ticks));
+
+  auto drain = [](ChannelQueue& queue) {
+    std::vector<Value> values;
+    while (std::optional<Value> v = queue.Read()) {
+      values.push_back(*v);
+    }
+    return values;
+  };
+  std::vector<Value> serial_values =
+      drain(serial_runtime->queue_manager().GetQueue(serial_out));
+  std::vector<Value> parallel_values =
+      drain(parallel_runtime->queue_manager().GetQueue(parallel_out));
+  EXPECT_EQ(serial_values.size(), kOutputs);
+  EXPECT_THAT(parallel_values, ElementsAreArray(serial_values));
+
+  for (int64_t i = 0; i < serial_package->procs().size(); ++i) {
+    EXPECT_EQ(
+        serial_runtime->ResolveState(serial_package->procs()[i].get()),
+        parallel_runtime->ResolveState(parallel_package->procs()[i].get()));
+  }
+}
+
+// Instantiate and run all the tests in proc_runtime_test_base.cc using the
+// parallel runtime.
+INSTANTIATE_TEST_SUITE_P(
+    ParallelProcRuntimeTest, ProcRuntimeTestBase,
+    testing::Values(
+        ProcRuntimeTestParam(
+            "jit",
+            [](Package* package, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              CHECK(!package->ChannelsAreProcScoped())
+                  << "Remove this test parameter once all channels are "
+                     "proc-scoped";
+              return CreateJitParallelProcRuntime(package, options,
+                                                  /*thread_count=*/4)
+                  .value();
+            },
+            [](Proc* top, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateJitParallelProcRuntime(top, options,
+                                                  /*thread_count=*/4)
+                  .value();
+            },
+            /*supports_observers=*/true),
+        ProcRuntimeTestParam(
+            "jit_proc_scoped",
+            [](Package* package, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              if (!package->ChannelsAreProcScoped()) {
+                CHECK_OK(ConvertPackageToNewStyleProcs(package));
+              }
+              Proc* top = package->GetTopAsProc().value();
+              return CreateJitParallelProcRuntime(top, options,
+                                                  /*thread_count=*/4)
+                  .value();
+            },
+            [](Proc* top, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateJitParallelProcRuntime(top, options,
+                                                  /*thread_count=*/4)
+                  .value();
+            },
+            /*supports_observers=*/true)),
+    [](const testing::TestParamInfo<ProcRuntimeTestBase::ParamType>& info) {
+      return info.param.name();
+    });
+
+}  // namespace
+}  // namespace xls
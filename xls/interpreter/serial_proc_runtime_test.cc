@@ -359,6 +359,21 @@ INSTANTIATE_TEST_SUITE_P(
               return CreateJitSerialProcRuntime(top, options).value();
             },
             /*supports_observers=*/true),
+        ProcRuntimeTestParam(
+            "tiered",
+            [](Package* package, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              CHECK(!package->ChannelsAreProcScoped())
+                  << "Remove this test parameter once all channels are "
+                     "proc-scoped";
+              return CreateTieredJitSerialProcRuntime(package, options)
+                  .value();
+            },
+            [](Proc* top, const EvaluatorOptions& options)
+                -> std::unique_ptr<ProcRuntime> {
+              return CreateTieredJitSerialProcRuntime(top, options).value();
+            },
+            /*supports_observers=*/true),
         ProcRuntimeTestParam(
             "mixed",
             [](Package* package, const EvaluatorOptions& options)
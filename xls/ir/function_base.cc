@@ -241,12 +241,9 @@ std::ostream& operator<<(std::ostream& os, const FunctionBase::Kind& kind) {
 void FunctionBase::MoveFrom(FunctionBase& other,
                             std::function<bool(const Node*)> pred) {
   for (auto it = other.nodes_.begin(); it != other.nodes_.end();) {
-    std::unique_ptr<Node>& node = *it;
-    if (pred == nullptr || pred(node.get())) {
-      TakeOwnershipOfNode(std::move(node));
-      it = other.nodes_.erase(it);
-    } else {
-      ++it;
+    Node* node = *it++;
+    if (pred == nullptr || pred(node)) {
+      TakeOwnershipOfNode(other.nodes_.Remove(node));
     }
   }
 }
@@ -254,8 +251,6 @@ void FunctionBase::MoveFrom(FunctionBase& other,
 void FunctionBase::TakeOwnershipOfNode(std::unique_ptr<Node>&& node) {
   FunctionBase* old_owner = node->function_base();
 
-  old_owner->node_iterators_.erase(node.get());
-
   if (auto it = old_owner->node_to_stage_.find(node.get());
       it != old_owner->node_to_stage_.end()) {
     node_to_stage_[node.get()] = it->second;
@@ -515,10 +510,8 @@ absl::Status FunctionBase::RemoveNode(Node* node) {
       node_to_stage_.erase(it);
     }
   }
-  auto node_it = node_iterators_.find(node);
-  XLS_RET_CHECK(node_it != node_iterators_.end());
-  nodes_.erase(node_it->second);
-  node_iterators_.erase(node_it);
+  XLS_RET_CHECK_EQ(node->function_base(), this);
+  nodes_.Remove(node);
   return absl::OkStatus();
 }
 
@@ -594,7 +587,7 @@ Node* FunctionBase::AddNodeInternal(std::unique_ptr<Node> node) {
     next_values_by_state_element_[next->state_element()].insert(next);
   }
   Node* ptr = node.get();
-  node_iterators_[ptr] = nodes_.insert(nodes_.end(), std::move(node));
+  nodes_.push_back(std::move(node));
   for (ChangeListener* listener : change_listeners_) {
     listener->NodeAdded(ptr);
   }
@@ -711,7 +704,6 @@ absl::Status FunctionBase::RebuildSideTables() {
   // make a ton of sense.
   // NB Because of above the next-values/next_values_by_state_read_ and params
   // lists are updated in proc and function respectively.
-  // NB We assume that node_iterators_ never gets invalidated.
   XLS_RETURN_IF_ERROR(InternalRebuildSideTables());
   XLS_RETURN_IF_ERROR(RebuildStageSideTables());
   return absl::OkStatus();
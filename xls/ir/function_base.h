@@ -17,7 +17,6 @@
 
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <optional>
 #include <ostream>
@@ -45,9 +44,9 @@
 #include "xls/ir/ir_annotator.h"
 #include "xls/ir/name_uniquer.h"
 #include "xls/ir/node.h"
+#include "xls/ir/node_list.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
-#include "xls/ir/unwrapping_iterator.h"
 #include "xls/ir/verify_node.h"
 
 namespace xls {
@@ -194,9 +193,6 @@ class Stage {
 
 // Base class for Functions and Procs. A holder of a set of nodes.
 class FunctionBase {
- protected:
-  using NodeList = std::list<std::unique_ptr<Node>>;
-
  public:
   enum class Kind {
     kFunction,
@@ -309,24 +305,11 @@ class FunctionBase {
 
   // Expose Nodes, so that transformation passes can operate
   // on this function.
-  xabsl::iterator_range<UnwrappingIterator<NodeList::iterator>> nodes() {
-    return xabsl::make_range(MakeUnwrappingIterator(nodes_.begin()),
-                             MakeUnwrappingIterator(nodes_.end()));
-  }
-  xabsl::iterator_range<UnwrappingIterator<NodeList::const_iterator>> nodes()
-      const {
-    return xabsl::make_range(MakeUnwrappingIterator(nodes_.begin()),
-                             MakeUnwrappingIterator(nodes_.end()));
-  }
-  xabsl::iterator_range<UnwrappingIterator<NodeList::reverse_iterator>>
-  nodes_reversed() {
-    return xabsl::make_range(MakeUnwrappingIterator(nodes_.rbegin()),
-                             MakeUnwrappingIterator(nodes_.rend()));
+  xabsl::iterator_range<NodeList::iterator> nodes() const {
+    return xabsl::make_range(nodes_.begin(), nodes_.end());
   }
-  xabsl::iterator_range<UnwrappingIterator<NodeList::const_reverse_iterator>>
-  nodes_reversed() const {
-    return xabsl::make_range(MakeUnwrappingIterator(nodes_.rbegin()),
-                             MakeUnwrappingIterator(nodes_.rend()));
+  xabsl::iterator_range<NodeList::reverse_iterator> nodes_reversed() const {
+    return xabsl::make_range(nodes_.rbegin(), nodes_.rend());
   }
 
   // Adds a node to the set owned by this function.
@@ -580,11 +563,9 @@ class FunctionBase {
   Package* package_;
   std::optional<int64_t> initiation_interval_;
 
-  // Store Nodes in std::list as they can be added and removed arbitrarily and
-  // we want a stable iteration order. Keep a map from instruction pointer to
-  // location in the list for fast lookup.
+  // Nodes are stored in an intrusive list as they can be added and removed
+  // arbitrarily and we want a stable iteration order.
   NodeList nodes_;
-  absl::flat_hash_map<const Node*, NodeList::iterator> node_iterators_;
 
   std::vector<Param*> params_;
   std::vector<Next*> next_values_;
@@ -2260,8 +2260,14 @@ absl::StatusOr<Block*> BlockBuilder::Build() {
   // down_cast the FunctionBase* to Block*. We know this is safe because
   // BlockBuilder constructs and passes a Block to BuilderBase constructor so
   // function_ is always a Block.
-  Block* block = package()->AddBlock(
-      absl::WrapUnique(absl::down_cast<Block*>(function_.release())));
+  Block* block;
+  if (overridden_dest_ != nullptr) {
+    *overridden_dest_ = absl::WrapUnique(function_.release());
+    block = absl::down_cast<Block*>(overridden_dest_->get());
+  } else {
+    block = package()->AddBlock(
+        absl::WrapUnique(absl::down_cast<Block*>(function_.release())));
+  }
   if (should_verify_) {
     XLS_RETURN_IF_ERROR(VerifyBlock(block));
   }
@@ -241,6 +241,42 @@ TEST_F(FunctionTest, MoveParams) {
   EXPECT_EQ(func->params()[2]->GetName(), "y");
 }
 
+TEST_F(FunctionTest, NodeOrderAfterRemoval) {
+  auto p = CreatePackage();
+  FunctionBuilder b("f", p.get());
+  BValue x = b.Param("x", p->GetBitsType(32));
+  BValue a = b.Not(x, SourceInfo(), "a");
+  BValue c = b.Negate(x, SourceInfo(), "c");
+  BValue d = b.Identity(x, SourceInfo(), "d");
+  XLS_ASSERT_OK_AND_ASSIGN(Function * func, b.BuildWithReturnValue(d));
+  EXPECT_THAT(func->nodes(), ElementsAre(x.node(), a.node(), c.node(),
+                                         d.node()));
+
+  // Remove nodes from the middle and the front while iterating.
+  for (Node* node : func->nodes()) {
+    if (node == a.node()) {
+      XLS_ASSERT_OK(func->RemoveNode(c.node()));
+      XLS_ASSERT_OK(func->RemoveNode(a.node()));
+      break;
+    }
+  }
+  EXPECT_EQ(func->node_count(), 2);
+  EXPECT_THAT(func->nodes(), ElementsAre(x.node(), d.node()));
+  EXPECT_THAT(func->nodes_reversed(), ElementsAre(d.node(), x.node()));
+
+  // Nodes added while iterating are visited.
+  int64_t visited = 0;
+  for (Node* node : func->nodes()) {
+    ++visited;
+    if (node == d.node()) {
+      XLS_ASSERT_OK(func->MakeNode<UnOp>(SourceInfo(), x.node(), Op::kNot)
+                        .status());
+    }
+  }
+  EXPECT_EQ(visited, 3);
+  EXPECT_EQ(func->node_count(), 3);
+}
+
 TEST_F(FunctionTest, MakeInvalidNode) {
   Package p(TestName());
   XLS_ASSERT_OK_AND_ASSIGN(Function * func, ParseFunction(R"(
@@ -0,0 +1,1294 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/ir_binary_format.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/call_graph.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/foreign_function_data.pb.h"
+#include "xls/ir/format_strings.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/lsb_or_msb.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/source_location.h"
+#include "xls/ir/state_element.h"
+#include "xls/ir/topo_sort.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+enum class FunctionBaseKind : uint8_t { kFunction = 0, kProc = 1 };
+
+// Flags for the optional attributes of a function base.
+constexpr uint64_t kNonSynthFlag = 1 << 0;
+constexpr uint64_t kInitiationIntervalFlag = 1 << 1;
+constexpr uint64_t kForeignFunctionFlag = 1 << 2;
+
+// Limit on the number of leaves of a type read from binary IR. Aggregate types
+// store an entry for each of their leaves so the memory used by a type is not
+// bounded by the size of its encoding.
+constexpr int64_t kMaxTypeLeafCount = int64_t{1} << 24;
+
+void AppendVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+// Zig-zag encodes `value` so that small negative numbers stay small.
+void AppendSignedVarint(int64_t value, std::string& out) {
+  AppendVarint((static_cast<uint64_t>(value) << 1) ^
+                   static_cast<uint64_t>(value >> 63),
+               out);
+}
+
+class BinaryIrWriter {
+ public:
+  explicit BinaryIrWriter(const Package& package) : package_(package) {}
+
+  absl::StatusOr<std::string> Write();
+
+ private:
+  // Returns the index of the given entry in the respective table, adding it
+  // if necessary.
+  uint64_t InternString(std::string_view s);
+  uint64_t InternOp(Op op);
+  uint64_t InternType(Type* type);
+  uint64_t InternValue(const Value& value, Type* type);
+
+  void AppendValueContents(const Value& value, std::string& out);
+  // Optional strings are encoded as zero or one plus the string index.
+  void AppendOptionalString(const std::optional<std::string>& s,
+                            std::string& out);
+
+  absl::Status WriteFunctionBase(FunctionBase* fb);
+  absl::Status WriteNode(
+      Node* node, const absl::flat_hash_map<Node*, int64_t>& node_indices,
+      const absl::flat_hash_map<StateElement*, int64_t>& state_indices);
+
+  const Package& package_;
+
+  absl::flat_hash_map<std::string, uint64_t> string_indices_;
+  std::string strings_;
+  absl::flat_hash_map<Op, uint64_t> op_indices_;
+  absl::flat_hash_map<Type*, uint64_t> type_indices_;
+  std::string types_;
+  absl::flat_hash_map<Value, uint64_t> value_indices_;
+  std::string values_;
+  absl::flat_hash_map<const FunctionBase*, uint64_t> function_base_indices_;
+  std::string function_bases_;
+};
+
+uint64_t BinaryIrWriter::InternString(std::string_view s) {
+  auto [it, inserted] =
+      string_indices_.try_emplace(std::string(s), string_indices_.size());
+  if (inserted) {
+    AppendVarint(s.size(), strings_);
+    strings_.append(s);
+  }
+  return it->second;
+}
+
+uint64_t BinaryIrWriter::InternOp(Op op) {
+  auto it = op_indices_.find(op);
+  if (it == op_indices_.end()) {
+    it = op_indices_.emplace(op, InternString(OpToString(op))).first;
+  }
+  return it->second;
+}
+
+uint64_t BinaryIrWriter::InternType(Type* type) {
+  auto it = type_indices_.find(type);
+  if (it != type_indices_.end()) {
+    return it->second;
+  }
+  // Element types are interned first so the loader only sees references to
+  // types it has already materialized.
+  std::string encoded;
+  encoded.push_back(static_cast<char>(type->kind()));
+  switch (type->kind()) {
+    case TypeKind::kBits:
+      AppendVarint(type->AsBitsOrDie()->bit_count(), encoded);
+      break;
+    case TypeKind::kTuple: {
+      TupleType* tuple_type = type->AsTupleOrDie();
+      AppendVarint(tuple_type->size(), encoded);
+      for (Type* element_type : tuple_type->element_types()) {
+        AppendVarint(InternType(element_type), encoded);
+      }
+      break;
+    }
+    case TypeKind::kArray:
+      AppendVarint(type->AsArrayOrDie()->size(), encoded);
+      AppendVarint(InternType(type->AsArrayOrDie()->element_type()), encoded);
+      break;
+    case TypeKind::kToken:
+      break;
+  }
+  types_.append(encoded);
+  uint64_t index = type_indices_.size();
+  type_indices_[type] = index;
+  return index;
+}
+
+uint64_t BinaryIrWriter::InternValue(const Value& value, Type* type) {
+  auto it = value_indices_.find(value);
+  if (it != value_indices_.end()) {
+    return it->second;
+  }
+  AppendVarint(InternType(type), values_);
+  AppendValueContents(value, values_);
+  uint64_t index = value_indices_.size();
+  value_indices_[value] = index;
+  return index;
+}
+
+void BinaryIrWriter::AppendValueContents(const Value& value,
+                                         std::string& out) {
+  if (value.IsBits()) {
+    std::vector<uint8_t> bytes = value.bits().ToBytes();
+    out.append(bytes.begin(), bytes.end());
+  } else if (value.IsTuple() || value.IsArray()) {
+    for (const Value& element : value.elements()) {
+      AppendValueContents(element, out);
+    }
+  }
+}
+
+void BinaryIrWriter::AppendOptionalString(const std::optional<std::string>& s,
+                                          std::string& out) {
+  AppendVarint(s.has_value() ? InternString(*s) + 1 : 0, out);
+}
+
+absl::StatusOr<std::string> BinaryIrWriter::Write() {
+  for (FunctionBase* fb : package_.GetFunctionBases()) {
+    if (fb->IsBlock()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Blocks are not supported by the binary IR format: %s", fb->name()));
+    }
+    if (fb->IsScheduled()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Scheduled function bases are not supported by the binary IR "
+          "format: %s",
+          fb->name()));
+    }
+    if (fb->IsProc() && fb->AsProcOrDie()->is_new_style_proc()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Procs with proc-scoped channels are not supported by the binary IR "
+          "format: %s",
+          fb->name()));
+    }
+  }
+
+  std::vector<uint64_t> channels;
+  for (Channel* channel : package_.channels()) {
+    channels.push_back(InternString(channel->ToString()));
+  }
+  // Emit function bases in post order so callees are materialized before
+  // their callers.
+  std::vector<FunctionBase*> function_bases = FunctionsInPostOrder(&package_);
+  for (FunctionBase* fb : function_bases) {
+    XLS_RETURN_IF_ERROR(WriteFunctionBase(fb));
+    function_base_indices_[fb] = function_base_indices_.size();
+  }
+
+  std::vector<std::pair<Fileno, uint64_t>> files;
+  for (const auto& [fileno, filename] : package_.fileno_to_name()) {
+    files.push_back({fileno, InternString(filename)});
+  }
+  std::sort(files.begin(), files.end());
+
+  std::string out(kBinaryIrMagic);
+  AppendVarint(kBinaryIrVersion, out);
+  AppendVarint(package_.name().size(), out);
+  out.append(package_.name());
+  AppendVarint(string_indices_.size(), out);
+  out.append(strings_);
+  AppendVarint(type_indices_.size(), out);
+  out.append(types_);
+  AppendVarint(value_indices_.size(), out);
+  out.append(values_);
+  AppendVarint(files.size(), out);
+  for (const auto& [fileno, filename] : files) {
+    AppendSignedVarint(fileno.value(), out);
+    AppendVarint(filename, out);
+  }
+  AppendVarint(channels.size(), out);
+  for (uint64_t channel : channels) {
+    AppendVarint(channel, out);
+  }
+  AppendVarint(function_bases.size(), out);
+  out.append(function_bases_);
+  std::optional<FunctionBase*> top = package_.GetTop();
+  AppendVarint(top.has_value() ? function_base_indices_.at(*top) + 1 : 0, out);
+  AppendVarint(package_.next_node_id(), out);
+  return out;
+}
+
+absl::Status BinaryIrWriter::WriteFunctionBase(FunctionBase* fb) {
+  std::string& out = function_bases_;
+  uint64_t flags = 0;
+  if (fb->IsFunction()) {
+    Function* function = fb->AsFunctionOrDie();
+    if (!function->attributes().empty()) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Function attributes are not supported by the binary IR format: %s",
+          fb->name()));
+    }
+    XLS_RET_CHECK(function->return_value() != nullptr) << fb->name();
+    if (function->non_synth()) {
+      flags |= kNonSynthFlag;
+    }
+  }
+  if (fb->GetInitiationInterval().has_value()) {
+    flags |= kInitiationIntervalFlag;
+  }
+  if (fb->ForeignFunctionData().has_value()) {
+    flags |= kForeignFunctionFlag;
+  }
+
+  out.push_back(static_cast<char>(fb->IsFunction() ? FunctionBaseKind::kFunction
+                                                   : FunctionBaseKind::kProc));
+  AppendVarint(InternString(fb->name()), out);
+  AppendVarint(flags, out);
+  if (fb->GetInitiationInterval().has_value()) {
+    AppendVarint(*fb->GetInitiationInterval(), out);
+  }
+  if (fb->ForeignFunctionData().has_value()) {
+    std::string serialized;
+    XLS_RET_CHECK(fb->ForeignFunctionData()->SerializeToString(&serialized));
+    AppendVarint(InternString(serialized), out);
+  }
+
+  absl::flat_hash_map<StateElement*, int64_t> state_indices;
+  if (fb->IsProc()) {
+    Proc* proc = fb->AsProcOrDie();
+    AppendVarint(proc->GetStateElementCount(), out);
+    for (StateElement* state_element : proc->StateElements()) {
+      state_indices[state_element] = state_indices.size();
+      AppendVarint(InternString(state_element->name()), out);
+      AppendVarint(InternValue(state_element->initial_value(),
+                               state_element->type()),
+                   out);
+      AppendVarint(state_element->non_synthesizable() ? 1 : 0, out);
+    }
+  }
+
+  // Nodes are written in their current order if it is topological so that the
+  // loaded function base dumps identically; otherwise in a topological order.
+  std::vector<Node*> order(fb->nodes().begin(), fb->nodes().end());
+  absl::flat_hash_map<Node*, int64_t> node_indices;
+  node_indices.reserve(order.size());
+  for (Node* node : order) {
+    node_indices[node] = node_indices.size();
+  }
+  bool is_topological = absl::c_all_of(order, [&](Node* node) {
+    return absl::c_all_of(node->operands(), [&](Node* operand) {
+      return node_indices.at(operand) < node_indices.at(node);
+    });
+  });
+  if (!is_topological) {
+    XLS_ASSIGN_OR_RETURN(order, TopoSort(fb));
+    for (int64_t i = 0; i < order.size(); ++i) {
+      node_indices[order[i]] = i;
+    }
+  }
+  AppendVarint(order.size(), out);
+  for (Node* node : order) {
+    XLS_RETURN_IF_ERROR(WriteNode(node, node_indices, state_indices));
+  }
+  // The parameter order may differ from the order in which params appear.
+  AppendVarint(fb->params().size(), out);
+  for (Param* param : fb->params()) {
+    AppendVarint(node_indices.at(param), out);
+  }
+  if (fb->IsFunction()) {
+    AppendVarint(node_indices.at(fb->AsFunctionOrDie()->return_value()), out);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BinaryIrWriter::WriteNode(
+    Node* node, const absl::flat_hash_map<Node*, int64_t>& node_indices,
+    const absl::flat_hash_map<StateElement*, int64_t>& state_indices) {
+  std::string& out = function_bases_;
+  AppendVarint(InternOp(node->op()), out);
+  AppendVarint(InternType(node->GetType()), out);
+  AppendVarint(node->HasAssignedName() ? InternString(node->GetName()) + 1 : 0,
+               out);
+  AppendVarint(node->id(), out);
+  AppendVarint(node->loc().locations.size(), out);
+  for (const SourceLocation& location : node->loc().locations) {
+    AppendSignedVarint(location.fileno().value(), out);
+    AppendSignedVarint(location.lineno().value(), out);
+    AppendSignedVarint(location.colno().value(), out);
+  }
+  AppendVarint(node->operand_count(), out);
+  for (Node* operand : node->operands()) {
+    AppendVarint(node_indices.at(operand), out);
+  }
+
+  // Op-specific attributes. Optional operands such as predicates are implied
+  // by the operand count.
+  switch (node->op()) {
+    case Op::kLiteral:
+      AppendVarint(InternValue(node->As<Literal>()->value(), node->GetType()),
+                   out);
+      break;
+    case Op::kBitSlice:
+      AppendVarint(node->As<BitSlice>()->start(), out);
+      AppendVarint(node->As<BitSlice>()->width(), out);
+      break;
+    case Op::kDynamicBitSlice:
+      AppendVarint(node->As<DynamicBitSlice>()->width(), out);
+      break;
+    case Op::kArraySlice:
+      AppendVarint(node->As<ArraySlice>()->width(), out);
+      break;
+    case Op::kTupleIndex:
+      AppendVarint(node->As<TupleIndex>()->index(), out);
+      break;
+    case Op::kArrayIndex:
+      AppendVarint(node->As<ArrayIndex>()->assumed_in_bounds() ? 1 : 0, out);
+      break;
+    case Op::kArrayUpdate:
+      AppendVarint(node->As<ArrayUpdate>()->assumed_in_bounds() ? 1 : 0, out);
+      break;
+    case Op::kInvoke:
+      AppendVarint(function_base_indices_.at(node->As<Invoke>()->to_apply()),
+                   out);
+      break;
+    case Op::kMap:
+      AppendVarint(function_base_indices_.at(node->As<Map>()->to_apply()),
+                   out);
+      break;
+    case Op::kCountedFor:
+      AppendVarint(node->As<CountedFor>()->trip_count(), out);
+      AppendVarint(node->As<CountedFor>()->stride(), out);
+      AppendVarint(function_base_indices_.at(node->As<CountedFor>()->body()),
+                   out);
+      break;
+    case Op::kDynamicCountedFor:
+      AppendVarint(
+          function_base_indices_.at(node->As<DynamicCountedFor>()->body()),
+          out);
+      break;
+    case Op::kOneHot:
+      AppendVarint(node->As<OneHot>()->priority() == LsbOrMsb::kLsb ? 1 : 0,
+                   out);
+      break;
+    case Op::kSel:
+      AppendVarint(node->As<Select>()->default_value().has_value() ? 1 : 0,
+                   out);
+      break;
+    case Op::kMinDelay:
+      AppendVarint(node->As<MinDelay>()->delay(), out);
+      break;
+    case Op::kZeroExt:
+    case Op::kSignExt:
+      AppendVarint(node->As<ExtendOp>()->new_bit_count(), out);
+      break;
+    case Op::kDecode:
+      AppendVarint(node->As<Decode>()->width(), out);
+      break;
+    case Op::kUMul:
+    case Op::kSMul:
+      AppendVarint(node->As<ArithOp>()->width(), out);
+      break;
+    case Op::kUMulp:
+    case Op::kSMulp:
+      AppendVarint(node->As<PartialProductOp>()->width(), out);
+      break;
+    case Op::kReceive:
+      AppendVarint(InternString(node->As<Receive>()->channel_name()), out);
+      AppendVarint(node->As<Receive>()->is_blocking() ? 1 : 0, out);
+      AppendVarint(InternType(node->As<Receive>()->GetPayloadType()), out);
+      break;
+    case Op::kSend:
+      AppendVarint(InternString(node->As<Send>()->channel_name()), out);
+      break;
+    case Op::kAssert:
+      AppendVarint(InternString(node->As<Assert>()->message()), out);
+      AppendOptionalString(node->As<Assert>()->label(), out);
+      AppendOptionalString(node->As<Assert>()->original_label(), out);
+      break;
+    case Op::kCover:
+      AppendVarint(InternString(node->As<Cover>()->label()), out);
+      AppendOptionalString(node->As<Cover>()->original_label(), out);
+      break;
+    case Op::kTrace:
+      AppendVarint(
+          InternString(StepsToXlsFormatString(node->As<Trace>()->format())),
+          out);
+      AppendVarint(node->As<Trace>()->verbosity(), out);
+      break;
+    case Op::kStateRead:
+      AppendVarint(state_indices.at(node->As<StateRead>()->state_element()),
+                   out);
+      AppendOptionalString(node->As<StateRead>()->label(), out);
+      break;
+    case Op::kNext:
+      AppendVarint(state_indices.at(node->As<Next>()->state_element()), out);
+      AppendOptionalString(node->As<Next>()->label(), out);
+      break;
+    case Op::kInputPort:
+    case Op::kOutputPort:
+    case Op::kRegisterRead:
+    case Op::kRegisterWrite:
+    case Op::kInstantiationInput:
+    case Op::kInstantiationOutput:
+    case Op::kNewChannel:
+    case Op::kRecvChannelEnd:
+    case Op::kSendChannelEnd:
+      return absl::UnimplementedError(
+          absl::StrFormat("Op %s is not supported by the binary IR format",
+                          OpToString(node->op())));
+    default:
+      break;
+  }
+  return absl::OkStatus();
+}
+
+class BinaryIrReader {
+ public:
+  explicit BinaryIrReader(std::string_view data) : data_(data) {}
+
+  absl::StatusOr<std::unique_ptr<Package>> Read();
+
+ private:
+  static constexpr int64_t kVariadic = std::numeric_limits<int64_t>::max();
+
+  // Primitive readers. Malformed input (a truncated buffer or an index out of
+  // range) is recorded and reported by `Check`; in the meantime the readers
+  // return a null or default value.
+  uint64_t ReadVarint();
+  int64_t ReadSignedVarint();
+  std::string_view ReadString();
+  std::optional<std::string> ReadOptionalString();
+  std::optional<Op> ReadOp();
+  Type* ReadType();
+  Value ReadValue();
+  Value ReadValueContents(Type* type);
+  Node* ReadOperand();
+  Function* ReadFunction();
+  StateElement* ReadStateElement(Proc* proc);
+  void Fail();
+  absl::Status Check() const;
+  absl::Status CheckOperandCount(Op op, int64_t min, int64_t max) const;
+
+  absl::Status ReadTypes();
+  absl::Status ReadValues();
+  absl::Status ReadFunctionBase();
+  absl::StatusOr<Node*> ReadNode(FunctionBase* fb, Proc* proc);
+
+  // Constructs a node with the location and name of the node being read.
+  template <typename NodeT, typename... Args>
+  absl::StatusOr<Node*> Make(FunctionBase* fb, Args&&... args) {
+    XLS_RETURN_IF_ERROR(Check());
+    return fb->AddNode(std::make_unique<NodeT>(
+        loc_, std::forward<Args>(args)..., name_, fb));
+  }
+
+  std::string_view data_;
+  size_t pos_ = 0;
+  std::optional<size_t> error_offset_;
+
+  std::unique_ptr<Package> package_;
+  std::vector<std::string_view> strings_;
+  std::vector<std::optional<Op>> ops_;
+  std::vector<Type*> types_;
+  std::vector<Value> values_;
+  std::vector<FunctionBase*> function_bases_;
+
+  // State of the function base and node being read.
+  std::vector<Node*> nodes_;
+  std::vector<Node*> operands_;
+  SourceInfo loc_;
+  std::string_view name_;
+};
+
+void BinaryIrReader::Fail() {
+  if (!error_offset_.has_value()) {
+    error_offset_ = pos_;
+  }
+  pos_ = data_.size();
+}
+
+absl::Status BinaryIrReader::Check() const {
+  if (error_offset_.has_value()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Malformed binary IR at byte offset %d", *error_offset_));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BinaryIrReader::CheckOperandCount(Op op, int64_t min,
+                                               int64_t max) const {
+  const int64_t count = operands_.size();
+  if (count < min || count > max) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Malformed binary IR: %s node has %d operands",
+                        OpToString(op), count));
+  }
+  return absl::OkStatus();
+}
+
+uint64_t BinaryIrReader::ReadVarint() {
+  uint64_t result = 0;
+  for (int64_t shift = 0; shift < 64 && pos_ < data_.size(); shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return result;
+    }
+  }
+  Fail();
+  return 0;
+}
+
+int64_t BinaryIrReader::ReadSignedVarint() {
+  uint64_t value = ReadVarint();
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+std::string_view BinaryIrReader::ReadString() {
+  uint64_t index = ReadVarint();
+  if (index >= strings_.size()) {
+    Fail();
+    return "";
+  }
+  return strings_[index];
+}
+
+std::optional<std::string> BinaryIrReader::ReadOptionalString() {
+  uint64_t index = ReadVarint();
+  if (index == 0) {
+    return std::nullopt;
+  }
+  if (index > strings_.size()) {
+    Fail();
+    return std::nullopt;
+  }
+  return std::string(strings_[index - 1]);
+}
+
+std::optional<Op> BinaryIrReader::ReadOp() {
+  uint64_t index = ReadVarint();
+  if (index >= strings_.size()) {
+    Fail();
+    return std::nullopt;
+  }
+  if (!ops_[index].has_value()) {
+    absl::StatusOr<Op> op = StringToOp(strings_[index]);
+    if (!op.ok()) {
+      Fail();
+      return std::nullopt;
+    }
+    ops_[index] = *op;
+  }
+  return ops_[index];
+}
+
+Type* BinaryIrReader::ReadType() {
+  uint64_t index = ReadVarint();
+  if (index >= types_.size()) {
+    Fail();
+    return nullptr;
+  }
+  return types_[index];
+}
+
+Value BinaryIrReader::ReadValue() {
+  uint64_t index = ReadVarint();
+  if (index >= values_.size()) {
+    Fail();
+    return Value();
+  }
+  return values_[index];
+}
+
+Value BinaryIrReader::ReadValueContents(Type* type) {
+  switch (type->kind()) {
+    case TypeKind::kBits: {
+      int64_t bit_count = type->AsBitsOrDie()->bit_count();
+      size_t byte_count = (bit_count + 7) / 8;
+      if (data_.size() - pos_ < byte_count) {
+        Fail();
+        return Value();
+      }
+      Bits bits = Bits::FromBytes(
+          absl::MakeConstSpan(
+              reinterpret_cast<const uint8_t*>(data_.data() + pos_),
+              byte_count),
+          bit_count);
+      pos_ += byte_count;
+      return Value(std::move(bits));
+    }
+    case TypeKind::kTuple: {
+      TupleType* tuple_type = type->AsTupleOrDie();
+      std::vector<Value> elements;
+      elements.reserve(
+          std::min<uint64_t>(tuple_type->size(), data_.size() - pos_));
+      for (Type* element_type : tuple_type->element_types()) {
+        elements.push_back(ReadValueContents(element_type));
+        if (error_offset_.has_value()) {
+          return Value();
+        }
+      }
+      return Value::TupleOwned(std::move(elements));
+    }
+    case TypeKind::kArray: {
+      ArrayType* array_type = type->AsArrayOrDie();
+      // Every element of nonzero width takes at least one byte so the array
+      // cannot have more elements than there are bytes left.
+      if (array_type->element_type()->GetFlatBitCount() > 0 &&
+          static_cast<uint64_t>(array_type->size()) > data_.size() - pos_) {
+        Fail();
+        return Value();
+      }
+      std::vector<Value> elements;
+      elements.reserve(
+          std::min<uint64_t>(array_type->size(), data_.size() - pos_));
+      for (int64_t i = 0; i < array_type->size() && !error_offset_.has_value();
+           ++i) {
+        elements.push_back(ReadValueContents(array_type->element_type()));
+      }
+      if (error_offset_.has_value()) {
+        return Value();
+      }
+      return Value::ArrayOwned(std::move(elements));
+    }
+    case TypeKind::kToken:
+      return Value::Token();
+  }
+  return Value();
+}
+
+Node* BinaryIrReader::ReadOperand() {
+  uint64_t index = ReadVarint();
+  if (index >= nodes_.size()) {
+    Fail();
+    return nullptr;
+  }
+  return nodes_[index];
+}
+
+Function* BinaryIrReader::ReadFunction() {
+  uint64_t index = ReadVarint();
+  if (index >= function_bases_.size() ||
+      !function_bases_[index]->IsFunction()) {
+    Fail();
+    return nullptr;
+  }
+  return function_bases_[index]->AsFunctionOrDie();
+}
+
+StateElement* BinaryIrReader::ReadStateElement(Proc* proc) {
+  uint64_t index = ReadVarint();
+  if (proc == nullptr || index >= proc->GetStateElementCount()) {
+    Fail();
+    return nullptr;
+  }
+  return proc->GetStateElement(index);
+}
+
+absl::Status BinaryIrReader::ReadTypes() {
+  constexpr int64_t kMaxBitCount = std::numeric_limits<int64_t>::max();
+  uint64_t count = ReadVarint();
+  for (uint64_t i = 0; i < count && !error_offset_.has_value(); ++i) {
+    uint64_t kind = ReadVarint();
+    Type* type = nullptr;
+    switch (static_cast<TypeKind>(kind)) {
+      case TypeKind::kBits: {
+        uint64_t bit_count = ReadVarint();
+        if (bit_count > kMaxBitCount) {
+          Fail();
+        }
+        XLS_RETURN_IF_ERROR(Check());
+        type = package_->GetBitsType(bit_count);
+        break;
+      }
+      case TypeKind::kTuple: {
+        uint64_t size = ReadVarint();
+        std::vector<Type*> element_types;
+        int64_t leaf_count = 0;
+        int64_t bit_count = 0;
+        for (uint64_t j = 0; j < size && !error_offset_.has_value(); ++j) {
+          Type* element_type = ReadType();
+          if (element_type == nullptr) {
+            break;
+          }
+          leaf_count += element_type->leaf_count();
+          if (leaf_count > kMaxTypeLeafCount ||
+              element_type->GetFlatBitCount() > kMaxBitCount - bit_count) {
+            Fail();
+            break;
+          }
+          bit_count += element_type->GetFlatBitCount();
+          element_types.push_back(element_type);
+        }
+        XLS_RETURN_IF_ERROR(Check());
+        type = package_->GetTupleType(element_types);
+        break;
+      }
+      case TypeKind::kArray: {
+        uint64_t size = ReadVarint();
+        Type* element_type = ReadType();
+        XLS_RETURN_IF_ERROR(Check());
+        // Arrays of zero-width elements (e.g., empty tuples) have no leaves
+        // but the type is still built one element at a time.
+        int64_t element_leaf_count =
+            std::max<int64_t>(element_type->leaf_count(), 1);
+        int64_t element_bit_count = element_type->GetFlatBitCount();
+        if (size > kMaxTypeLeafCount / element_leaf_count ||
+            (element_bit_count > 0 &&
+             size > kMaxBitCount / element_bit_count)) {
+          Fail();
+        }
+        XLS_RETURN_IF_ERROR(Check());
+        type = package_->GetArrayType(size, element_type);
+        break;
+      }
+      case TypeKind::kToken:
+        type = package_->GetTokenType();
+        break;
+      default:
+        Fail();
+    }
+    types_.push_back(type);
+  }
+  return Check();
+}
+
+absl::Status BinaryIrReader::ReadValues() {
+  uint64_t count = ReadVarint();
+  for (uint64_t i = 0; i < count && !error_offset_.has_value(); ++i) {
+    Type* type = ReadType();
+    XLS_RETURN_IF_ERROR(Check());
+    values_.push_back(ReadValueContents(type));
+  }
+  return Check();
+}
+
+absl::StatusOr<std::unique_ptr<Package>> BinaryIrReader::Read() {
+  if (!IsBinaryIr(data_)) {
+    return absl::InvalidArgumentError("Data is not in the binary IR format");
+  }
+  pos_ = kBinaryIrMagic.size();
+  uint64_t version = ReadVarint();
+  XLS_RETURN_IF_ERROR(Check());
+  if (version != kBinaryIrVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Unsupported binary IR version %d, expected %d",
+                        version, kBinaryIrVersion));
+  }
+
+  uint64_t name_size = ReadVarint();
+  if (data_.size() - pos_ < name_size) {
+    Fail();
+  }
+  XLS_RETURN_IF_ERROR(Check());
+  package_ = std::make_unique<Package>(data_.substr(pos_, name_size));
+  pos_ += name_size;
+
+  uint64_t string_count = ReadVarint();
+  strings_.reserve(std::min<uint64_t>(string_count, data_.size()));
+  for (uint64_t i = 0; i < string_count && !error_offset_.has_value(); ++i) {
+    uint64_t size = ReadVarint();
+    if (data_.size() - pos_ < size) {
+      Fail();
+      break;
+    }
+    strings_.push_back(data_.substr(pos_, size));
+    pos_ += size;
+  }
+  XLS_RETURN_IF_ERROR(Check());
+  ops_.resize(strings_.size());
+
+  XLS_RETURN_IF_ERROR(ReadTypes());
+  XLS_RETURN_IF_ERROR(ReadValues());
+
+  uint64_t file_count = ReadVarint();
+  for (uint64_t i = 0; i < file_count && !error_offset_.has_value(); ++i) {
+    int64_t fileno = ReadSignedVarint();
+    std::string_view filename = ReadString();
+    XLS_RETURN_IF_ERROR(Check());
+    package_->SetFileno(Fileno(fileno), filename);
+  }
+
+  uint64_t channel_count = ReadVarint();
+  for (uint64_t i = 0; i < channel_count && !error_offset_.has_value(); ++i) {
+    std::string_view channel = ReadString();
+    XLS_RETURN_IF_ERROR(Check());
+    XLS_RETURN_IF_ERROR(Parser::ParseChannel(channel, package_.get()).status());
+  }
+
+  uint64_t function_base_count = ReadVarint();
+  for (uint64_t i = 0; i < function_base_count && !error_offset_.has_value();
+       ++i) {
+    XLS_RETURN_IF_ERROR(ReadFunctionBase());
+  }
+
+  uint64_t top = ReadVarint();
+  uint64_t next_node_id = ReadVarint();
+  XLS_RETURN_IF_ERROR(Check());
+  if (top > function_bases_.size()) {
+    return absl::InvalidArgumentError("Malformed binary IR: invalid top");
+  }
+  if (top != 0) {
+    XLS_RETURN_IF_ERROR(package_->SetTop(function_bases_[top - 1]));
+  }
+  package_->set_next_node_id(
+      std::max<int64_t>(next_node_id, package_->next_node_id()));
+  if (pos_ != data_.size()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Malformed binary IR: %d trailing bytes", data_.size() - pos_));
+  }
+  return std::move(package_);
+}
+
+absl::Status BinaryIrReader::ReadFunctionBase() {
+  if (pos_ >= data_.size()) {
+    Fail();
+    return Check();
+  }
+  uint8_t kind = static_cast<uint8_t>(data_[pos_++]);
+  std::string_view name = ReadString();
+  uint64_t flags = ReadVarint();
+  std::optional<int64_t> initiation_interval;
+  if (flags & kInitiationIntervalFlag) {
+    initiation_interval = ReadVarint();
+  }
+  std::optional<std::string_view> foreign_function;
+  if (flags & kForeignFunctionFlag) {
+    foreign_function = ReadString();
+  }
+  XLS_RETURN_IF_ERROR(Check());
+
+  FunctionBase* fb;
+  Proc* proc = nullptr;
+  if (kind == static_cast<uint8_t>(FunctionBaseKind::kFunction)) {
+    Function* function = package_->AddFunction(
+        std::make_unique<Function>(name, package_.get()));
+    function->set_non_synth((flags & kNonSynthFlag) != 0);
+    fb = function;
+  } else if (kind == static_cast<uint8_t>(FunctionBaseKind::kProc)) {
+    proc = package_->AddProc(std::make_unique<Proc>(name, package_.get()));
+    uint64_t state_count = ReadVarint();
+    for (uint64_t i = 0; i < state_count && !error_offset_.has_value(); ++i) {
+      std::string_view state_name = ReadString();
+      Value initial_value = ReadValue();
+      bool non_synthesizable = ReadVarint() != 0;
+      XLS_RETURN_IF_ERROR(Check());
+      XLS_ASSIGN_OR_RETURN(StateElement * state_element,
+                           proc->AppendUnreadStateElement(
+                               state_name, initial_value, non_synthesizable));
+      if (state_element->name() != state_name) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Malformed binary IR: duplicate state element `%s`", state_name));
+      }
+    }
+    fb = proc;
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Malformed binary IR: invalid function kind %d", kind));
+  }
+  if (initiation_interval.has_value()) {
+    fb->SetInitiationInterval(*initiation_interval);
+  }
+  if (foreign_function.has_value()) {
+    xls::ForeignFunctionData ffi;
+    if (!ffi.ParseFromArray(foreign_function->data(),
+                            foreign_function->size())) {
+      return absl::InvalidArgumentError(
+          "Malformed binary IR: invalid foreign function data");
+    }
+    fb->SetForeignFunctionData(ffi);
+  }
+
+  uint64_t node_count = ReadVarint();
+  nodes_.clear();
+  nodes_.reserve(std::min<uint64_t>(node_count, data_.size() - pos_));
+  for (uint64_t i = 0; i < node_count && !error_offset_.has_value(); ++i) {
+    XLS_ASSIGN_OR_RETURN(Node * node, ReadNode(fb, proc));
+    nodes_.push_back(node);
+  }
+  uint64_t param_count = ReadVarint();
+  std::vector<Param*> params;
+  for (uint64_t i = 0; i < param_count && !error_offset_.has_value(); ++i) {
+    Node* param = ReadOperand();
+    if (param != nullptr && !param->Is<Param>()) {
+      Fail();
+    }
+    params.push_back(param == nullptr ? nullptr : param->As<Param>());
+  }
+  XLS_RETURN_IF_ERROR(Check());
+  if (!absl::c_equal(params, fb->params())) {
+    XLS_RETURN_IF_ERROR(fb->ReorderParams(params));
+  }
+  if (proc == nullptr) {
+    Node* return_value = ReadOperand();
+    XLS_RETURN_IF_ERROR(Check());
+    XLS_RETURN_IF_ERROR(fb->AsFunctionOrDie()->set_return_value(return_value));
+  }
+  function_bases_.push_back(fb);
+  return Check();
+}
+
+absl::StatusOr<Node*> BinaryIrReader::ReadNode(FunctionBase* fb, Proc* proc) {
+  std::optional<Op> maybe_op = ReadOp();
+  Type* type = ReadType();
+  uint64_t name_index = ReadVarint();
+  if (name_index > strings_.size()) {
+    Fail();
+  }
+  name_ = name_index == 0 || error_offset_.has_value()
+              ? std::string_view()
+              : strings_[name_index - 1];
+  int64_t id = ReadVarint();
+  uint64_t location_count = ReadVarint();
+  loc_.locations.clear();
+  for (uint64_t i = 0; i < location_count && !error_offset_.has_value();
+       ++i) {
+    int64_t fileno = ReadSignedVarint();
+    int64_t lineno = ReadSignedVarint();
+    int64_t colno = ReadSignedVarint();
+    loc_.locations.push_back(
+        SourceLocation(Fileno(fileno), Lineno(lineno), Colno(colno)));
+  }
+  uint64_t operand_count = ReadVarint();
+  operands_.clear();
+  for (uint64_t i = 0; i < operand_count && !error_offset_.has_value(); ++i) {
+    operands_.push_back(ReadOperand());
+  }
+  XLS_RETURN_IF_ERROR(Check());
+
+  // Node constructors take their id from the package so set it up front rather
+  // than renumbering afterwards.
+  package_->set_next_node_id(id);
+  const Op op = *maybe_op;
+  absl::Span<Node* const> operands = operands_;
+  const int64_t n = operands.size();
+  absl::StatusOr<Node*> node;
+  switch (op) {
+    case Op::kParam:
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 0, 0));
+      node = Make<Param>(fb, type);
+      break;
+    case Op::kLiteral: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 0, 0));
+      Value value = ReadValue();
+      node = Make<Literal>(fb, std::move(value));
+      break;
+    }
+    case Op::kBitSlice: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      int64_t start = ReadVarint();
+      int64_t width = ReadVarint();
+      node = Make<BitSlice>(fb, operands[0], start, width);
+      break;
+    }
+    case Op::kDynamicBitSlice: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+      int64_t width = ReadVarint();
+      node = Make<DynamicBitSlice>(fb, operands[0], operands[1], width);
+      break;
+    }
+    case Op::kBitSliceUpdate:
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 3, 3));
+      node = Make<BitSliceUpdate>(fb, operands[0], operands[1], operands[2]);
+      break;
+    case Op::kArraySlice: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+      int64_t width = ReadVarint();
+      node = Make<ArraySlice>(fb, operands[0], operands[1], width);
+      break;
+    }
+    case Op::kConcat:
+      node = Make<Concat>(fb, operands);
+      break;
+    case Op::kTuple:
+      node = Make<Tuple>(fb, operands);
+      break;
+    case Op::kAfterAll:
+      node = Make<AfterAll>(fb, operands);
+      break;
+    case Op::kArrayConcat:
+      node = Make<ArrayConcat>(fb, operands);
+      break;
+    case Op::kArray:
+      if (!type->IsArray()) {
+        return absl::InvalidArgumentError(
+            "Malformed binary IR: array node without array type");
+      }
+      node = Make<Array>(fb, operands, type->AsArrayOrDie()->element_type());
+      break;
+    case Op::kTupleIndex: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      int64_t index = ReadVarint();
+      node = Make<TupleIndex>(fb, operands[0], index);
+      break;
+    }
+    case Op::kArrayIndex: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, kVariadic));
+      bool assumed_in_bounds = ReadVarint() != 0;
+      node = Make<ArrayIndex>(fb, operands[0], operands.subspan(1),
+                              assumed_in_bounds);
+      break;
+    }
+    case Op::kArrayUpdate: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, kVariadic));
+      bool assumed_in_bounds = ReadVarint() != 0;
+      node = Make<ArrayUpdate>(fb, operands[0], operands[1],
+                               operands.subspan(2), assumed_in_bounds);
+      break;
+    }
+    case Op::kInvoke: {
+      Function* to_apply = ReadFunction();
+      node = Make<Invoke>(fb, operands, to_apply);
+      break;
+    }
+    case Op::kMap: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      Function* to_apply = ReadFunction();
+      node = Make<Map>(fb, operands[0], to_apply);
+      break;
+    }
+    case Op::kCountedFor: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, kVariadic));
+      int64_t trip_count = ReadVarint();
+      int64_t stride = ReadVarint();
+      Function* body = ReadFunction();
+      node = Make<CountedFor>(fb, operands[0], operands.subspan(1), trip_count,
+                              stride, body);
+      break;
+    }
+    case Op::kDynamicCountedFor: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 3, kVariadic));
+      Function* body = ReadFunction();
+      node = Make<DynamicCountedFor>(fb, operands[0], operands[1], operands[2],
+                                     operands.subspan(3), body);
+      break;
+    }
+    case Op::kOneHot: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      LsbOrMsb priority = ReadVarint() != 0 ? LsbOrMsb::kLsb : LsbOrMsb::kMsb;
+      node = Make<OneHot>(fb, operands[0], priority);
+      break;
+    }
+    case Op::kOneHotSel:
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, kVariadic));
+      node = Make<OneHotSelect>(fb, operands[0], operands.subspan(1));
+      break;
+    case Op::kPrioritySel:
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, kVariadic));
+      node = Make<PrioritySelect>(fb, operands[0], operands.subspan(1, n - 2),
+                                  operands[n - 1]);
+      break;
+    case Op::kSel: {
+      bool has_default = ReadVarint() != 0;
+      XLS_RETURN_IF_ERROR(
+          CheckOperandCount(op, has_default ? 3 : 2, kVariadic));
+      std::optional<Node*> default_value =
+          has_default ? std::make_optional(operands[n - 1]) : std::nullopt;
+      node = Make<Select>(fb, operands[0],
+                          operands.subspan(1, n - 1 - (has_default ? 1 : 0)),
+                          default_value);
+      break;
+    }
+    case Op::kMinDelay: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      int64_t delay = ReadVarint();
+      node = Make<MinDelay>(fb, operands[0], delay);
+      break;
+    }
+    case Op::kZeroExt:
+    case Op::kSignExt: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      int64_t new_bit_count = ReadVarint();
+      node = Make<ExtendOp>(fb, operands[0], new_bit_count, op);
+      break;
+    }
+    case Op::kDecode: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      int64_t width = ReadVarint();
+      node = Make<Decode>(fb, operands[0], width);
+      break;
+    }
+    case Op::kEncode:
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      node = Make<Encode>(fb, operands[0]);
+      break;
+    case Op::kUMul:
+    case Op::kSMul: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+      int64_t width = ReadVarint();
+      node = Make<ArithOp>(fb, operands[0], operands[1], width, op);
+      break;
+    }
+    case Op::kUMulp:
+    case Op::kSMulp: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+      int64_t width = ReadVarint();
+      node = Make<PartialProductOp>(fb, operands[0], operands[1], width, op);
+      break;
+    }
+    case Op::kGate:
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+      node = Make<Gate>(fb, operands[0], operands[1]);
+      break;
+    case Op::kReceive: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 2));
+      std::string_view channel_name = ReadString();
+      bool is_blocking = ReadVarint() != 0;
+      Type* payload_type = ReadType();
+      std::optional<Node*> predicate =
+          n == 2 ? std::make_optional(operands[1]) : std::nullopt;
+      node = Make<Receive>(fb, operands[0], predicate, channel_name,
+                           is_blocking, payload_type);
+      break;
+    }
+    case Op::kSend: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 3));
+      std::string_view channel_name = ReadString();
+      std::optional<Node*> predicate =
+          n == 3 ? std::make_optional(operands[2]) : std::nullopt;
+      node = Make<Send>(fb, operands[0], operands[1], predicate, channel_name);
+      break;
+    }
+    case Op::kAssert: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+      std::string_view message = ReadString();
+      std::optional<std::string> label = ReadOptionalString();
+      std::optional<std::string> original_label = ReadOptionalString();
+      node = Make<Assert>(fb, operands[0], operands[1], message,
+                          std::move(label), std::move(original_label));
+      break;
+    }
+    case Op::kCover: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+      std::string_view label = ReadString();
+      std::optional<std::string> original_label = ReadOptionalString();
+      node = Make<Cover>(fb, operands[0], label, std::move(original_label));
+      break;
+    }
+    case Op::kTrace: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, kVariadic));
+      std::string_view format_string = ReadString();
+      int64_t verbosity = ReadVarint();
+      XLS_RETURN_IF_ERROR(Check());
+      XLS_ASSIGN_OR_RETURN(std::vector<FormatStep> format,
+                           ParseFormatString(format_string));
+      node = Make<Trace>(fb, operands[0], operands[1], operands.subspan(2),
+                         format, verbosity);
+      break;
+    }
+    case Op::kStateRead: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 0, 1));
+      StateElement* state_element = ReadStateElement(proc);
+      std::optional<std::string> label = ReadOptionalString();
+      XLS_RETURN_IF_ERROR(Check());
+      std::optional<Node*> predicate =
+          n == 1 ? std::make_optional(operands[0]) : std::nullopt;
+      // State reads must be registered with the proc.
+      XLS_ASSIGN_OR_RETURN(StateRead * state_read,
+                           proc->AddStateRead(state_element, predicate,
+                                              std::move(label), loc_));
+      if (!name_.empty() && state_read->GetName() != name_) {
+        state_read->SetName(name_);
+      }
+      node = state_read;
+      break;
+    }
+    case Op::kNext: {
+      XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 2));
+      StateElement* state_element = ReadStateElement(proc);
+      std::optional<std::string> label = ReadOptionalString();
+      std::optional<Node*> predicate =
+          n == 2 ? std::make_optional(operands[1]) : std::nullopt;
+      node = Make<Next>(fb, state_element, operands[0], predicate,
+                        std::move(label));
+      break;
+    }
+    default:
+      if (IsOpClass<UnOp>(op)) {
+        XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+        node = Make<UnOp>(fb, operands[0], op);
+      } else if (IsOpClass<BinOp>(op)) {
+        XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+        node = Make<BinOp>(fb, operands[0], operands[1], op);
+      } else if (IsOpClass<CompareOp>(op)) {
+        XLS_RETURN_IF_ERROR(CheckOperandCount(op, 2, 2));
+        node = Make<CompareOp>(fb, operands[0], operands[1], op);
+      } else if (IsOpClass<NaryOp>(op)) {
+        node = Make<NaryOp>(fb, operands, op);
+      } else if (IsOpClass<BitwiseReductionOp>(op)) {
+        XLS_RETURN_IF_ERROR(CheckOperandCount(op, 1, 1));
+        node = Make<BitwiseReductionOp>(fb, operands[0], op);
+      } else {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "Op %s is not supported by the binary IR format", OpToString(op)));
+      }
+      break;
+  }
+  XLS_RETURN_IF_ERROR(node.status());
+  if ((*node)->GetType() != type) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Malformed binary IR: node %s has type %s, expected %s",
+        (*node)->GetName(), (*node)->GetType()->ToString(), type->ToString()));
+  }
+  return node;
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> PackageToBinaryIr(const Package& package) {
+  return BinaryIrWriter(package).Write();
+}
+
+absl::StatusOr<std::unique_ptr<Package>> PackageFromBinaryIrNoVerify(
+    std::string_view data) {
+  return BinaryIrReader(data).Read();
+}
+
+}  // namespace xls
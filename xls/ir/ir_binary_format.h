@@ -0,0 +1,67 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_IR_BINARY_FORMAT_H_
+#define XLS_IR_IR_BINARY_FORMAT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "xls/ir/package.h"
+
+namespace xls {
+
+// A compact binary serialization of IR packages which can be loaded without
+// tokenizing. The encoding is a magic prefix, version number and package name
+// followed by
+//
+//   * a string table holding every name, label, message and channel
+//     definition in the package,
+//   * a type table in which every type follows its element types,
+//   * a pool of the values used by literals and state elements,
+//   * the file number table and the channels, and
+//   * the function bases in call-graph post order, each a dense table of nodes
+//     in topological order. Nodes refer to their operands, types, strings and
+//     callees by index into these tables.
+//
+// Integers are LEB128 varints and the encoding contains no pointers, so the
+// loader operates directly on a read-only view of the bytes (e.g., a mapped
+// file) and only copies strings when they are stored in the IR.
+//
+// Functions and procs with global channels are supported. Blocks, scheduled
+// function bases, procs with proc-scoped channels and function attributes are
+// not, and PackageToBinaryIr returns an UnimplementedError for them.
+inline constexpr std::string_view kBinaryIrMagic = "\x89XLSIR\r\n";
+inline constexpr int64_t kBinaryIrVersion = 1;
+
+// Returns true if `data` begins with the binary IR magic prefix.
+inline bool IsBinaryIr(std::string_view data) {
+  return data.substr(0, kBinaryIrMagic.size()) == kBinaryIrMagic;
+}
+
+// Serializes the package into the binary IR format.
+absl::StatusOr<std::string> PackageToBinaryIr(const Package& package);
+
+// Materializes a package from the binary IR format. The package is not
+// verified; Parser::ParsePackage accepts binary IR as well and verifies the
+// result.
+absl::StatusOr<std::unique_ptr<Package>> PackageFromBinaryIrNoVerify(
+    std::string_view data);
+
+}  // namespace xls
+
+#endif  // XLS_IR_IR_BINARY_FORMAT_H_
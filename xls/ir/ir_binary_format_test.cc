@@ -0,0 +1,308 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/ir_binary_format.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "xls/common/fuzzing/fuzztest.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/status/matchers.h"
+#include "xls/fuzzer/ir_fuzzer/ir_fuzz_domain.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/type.h"
+#include "xls/ir/value.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::HasSubstr;
+
+class IrBinaryFormatTest : public IrTestBase {
+ protected:
+  // Serializes the package and checks that loading the result produces the
+  // same IR text.
+  void ExpectRoundTrip(const Package& package) {
+    XLS_ASSERT_OK_AND_ASSIGN(std::string binary, PackageToBinaryIr(package));
+    EXPECT_TRUE(IsBinaryIr(binary));
+    XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> loaded,
+                             Parser::ParsePackage(binary));
+    EXPECT_EQ(loaded->DumpIr(), package.DumpIr());
+  }
+};
+
+TEST_F(IrBinaryFormatTest, Function) {
+  auto p = CreatePackage();
+  FunctionBuilder body_b("body", p.get());
+  body_b.Add(body_b.Param("i", p->GetBitsType(32)),
+             body_b.Param("acc", p->GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * body, body_b.Build());
+  FunctionBuilder inc_b("inc", p.get());
+  inc_b.Add(inc_b.Param("e", p->GetBitsType(8)), inc_b.Literal(UBits(1, 8)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * inc, inc_b.Build());
+
+  FunctionBuilder fb(TestName(), p.get());
+  BValue tkn = fb.Param("tkn", p->GetTokenType());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  BValue s = fb.Param("s", p->GetBitsType(2));
+  BValue a = fb.Param("a", p->GetArrayType(4, p->GetBitsType(8)));
+  BValue c = fb.BitSlice(s, 0, 1);
+  BValue lit = fb.Literal(Value::Tuple({Value(UBits(3, 4)),
+                                        Value::UBitsArray({1, 2}, 8).value()}));
+  BValue after = fb.Assert(tkn, c, "oops", "my_label");
+  after = fb.Trace(after, c, {x, s}, "x is {} and s is {:x}", /*verbosity=*/1);
+  fb.Cover(c, "covered");
+  fb.Tuple({
+      fb.Add(x, fb.Literal(UBits(7, 32)), SourceInfo(), "my_add"),
+      fb.UMul(x, x, /*result_width=*/40),
+      fb.UMulp(x, x),
+      fb.Not(x),
+      fb.AndReduce(x),
+      fb.ULt(x, x),
+      fb.Concat({s, x}),
+      fb.SignExtend(s, 17),
+      fb.DynamicBitSlice(x, s, 5),
+      fb.OneHot(s, LsbOrMsb::kMsb),
+      fb.Decode(s, /*width=*/3),
+      fb.Encode(x),
+      fb.Select(s, {x, x, x}, /*default_value=*/x),
+      fb.PrioritySelect(s, {x, x}, x),
+      fb.OneHotSelect(s, {x, x}),
+      fb.ArrayIndex(a, {s}, /*assumed_in_bounds=*/true),
+      fb.ArraySlice(a, s, 2),
+      fb.ArrayUpdate(a, fb.Literal(UBits(0, 8)), {s}),
+      fb.ArrayConcat({a, a}),
+      fb.TupleIndex(lit, 1),
+      fb.Map(a, inc),
+      fb.Invoke({x, x}, body),
+      fb.CountedFor(x, /*trip_count=*/4, /*stride=*/2, body),
+      fb.MinDelay(after, /*delay=*/3),
+      fb.Gate(c, x),
+  });
+  XLS_ASSERT_OK(fb.Build().status());
+  ExpectRoundTrip(*p);
+}
+
+TEST_F(IrBinaryFormatTest, Proc) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(R"(
+package test
+
+file_number 0 "/my/file.x"
+
+chan in(bits[32], id=0, kind=streaming, ops=receive_only, flow_control=ready_valid, strictness=proven_mutually_exclusive)
+chan out(bits[32], id=1, kind=streaming, ops=send_only, flow_control=ready_valid, strictness=proven_mutually_exclusive)
+
+top proc my_proc(x: bits[32], y: bits[1], init={42, 1}) {
+  tkn: token = literal(value=token)
+  x: bits[32] = state_read(state_element=x, predicate=y, id=7)
+  y: bits[1] = state_read(state_element=y)
+  rcv: (token, bits[32]) = receive(tkn, channel=in, pos=[(0,1,2)])
+  rcv_tkn: token = tuple_index(rcv, index=0)
+  data: bits[32] = tuple_index(rcv, index=1)
+  sum: bits[32] = add(x, data, pos=[(0,3,4), (0,5,6)])
+  snd: token = send(rcv_tkn, sum, predicate=y, channel=out)
+  next_x: () = next_value(state_element=x, value=sum, predicate=y, label="nx")
+  not_y: bits[1] = not(y)
+  next_y: () = next_value(state_element=y, value=not_y)
+}
+)"));
+  ExpectRoundTrip(*p);
+}
+
+TEST_F(IrBinaryFormatTest, TopFromEntry) {
+  auto p = CreatePackage();
+  FunctionBuilder fb1("f1", p.get());
+  fb1.Param("x", p->GetBitsType(8));
+  XLS_ASSERT_OK(fb1.Build().status());
+  FunctionBuilder fb2("f2", p.get());
+  fb2.Param("x", p->GetBitsType(8));
+  XLS_ASSERT_OK(fb2.Build().status());
+  XLS_ASSERT_OK_AND_ASSIGN(std::string binary, PackageToBinaryIr(*p));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> loaded,
+                           Parser::ParsePackageWithEntry(binary, "f2"));
+  ASSERT_TRUE(loaded->GetTop().has_value());
+  EXPECT_EQ(loaded->GetTop().value()->name(), "f2");
+}
+
+TEST_F(IrBinaryFormatTest, BlocksAreUnimplemented) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto p, Parser::ParsePackage(R"(
+package test
+
+block my_block(a: bits[32], out: bits[32]) {
+  a: bits[32] = input_port(name=a)
+  out: () = output_port(a, name=out)
+}
+)"));
+  EXPECT_THAT(PackageToBinaryIr(*p),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST_F(IrBinaryFormatTest, MalformedInput) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetArrayType(2, p->GetBitsType(8)));
+  fb.ArrayIndex(x, {fb.Literal(UBits(1, 1))});
+  XLS_ASSERT_OK(fb.Build().status());
+  XLS_ASSERT_OK_AND_ASSIGN(std::string binary, PackageToBinaryIr(*p));
+
+  // Every proper prefix of the encoding must be rejected.
+  for (size_t i = 0; i < binary.size(); ++i) {
+    EXPECT_THAT(PackageFromBinaryIrNoVerify(binary.substr(0, i)),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << "prefix of length " << i;
+  }
+  EXPECT_THAT(PackageFromBinaryIrNoVerify(absl::StrCat(binary, "x")),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  std::string wrong_version = binary;
+  wrong_version[kBinaryIrMagic.size()] = kBinaryIrVersion + 1;
+  EXPECT_THAT(PackageFromBinaryIrNoVerify(wrong_version),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("version")));
+}
+
+TEST_F(IrBinaryFormatTest, OversizedArrayValue) {
+  // A package with an array type of 2^40 bytes and a single value of that
+  // type backed by a single byte.
+  std::string binary(kBinaryIrMagic);
+  binary.push_back(kBinaryIrVersion);
+  binary.append("\x01p");  // Package name.
+  binary.push_back(0);      // Strings.
+  binary.push_back(2);      // Types.
+  binary.push_back(static_cast<char>(TypeKind::kBits));
+  binary.push_back(8);
+  binary.push_back(static_cast<char>(TypeKind::kArray));
+  binary.append("\x80\x80\x80\x80\x80\x20", 6);  // 2^40 as a varint.
+  binary.push_back(0);                              // Element type.
+  binary.push_back(1);                              // Values.
+  binary.push_back(1);                              // Value type.
+  binary.push_back(42);
+
+  EXPECT_THAT(PackageFromBinaryIrNoVerify(binary),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(IrBinaryFormatTest, OversizedBitsType) {
+  std::string binary(kBinaryIrMagic);
+  binary.push_back(kBinaryIrVersion);
+  binary.append("\x01p");  // Package name.
+  binary.push_back(0);      // Strings.
+  binary.push_back(1);      // Types.
+  binary.push_back(static_cast<char>(TypeKind::kBits));
+  binary.append("\x80\x80\x80\x80\x80\x80\x80\x80\x80\x01",
+                10);  // 2^63 as a varint.
+
+  EXPECT_THAT(PackageFromBinaryIrNoVerify(binary),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(IrBinaryFormatTest, OversizedArrayOfEmptyTuples) {
+  std::string binary(kBinaryIrMagic);
+  binary.push_back(kBinaryIrVersion);
+  binary.append("\x01p");  // Package name.
+  binary.push_back(0);      // Strings.
+  binary.push_back(2);      // Types.
+  binary.push_back(static_cast<char>(TypeKind::kTuple));
+  binary.push_back(0);
+  binary.push_back(static_cast<char>(TypeKind::kArray));
+  binary.append("\x80\x80\x80\x80\x80\x20", 6);  // 2^40 as a varint.
+  binary.push_back(0);                              // Element type.
+
+  EXPECT_THAT(PackageFromBinaryIrNoVerify(binary),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+void RoundtripBinaryIrFuzz(std::shared_ptr<Package> original) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::string binary, PackageToBinaryIr(*original));
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> loaded,
+                           Parser::ParsePackage(binary));
+  EXPECT_EQ(loaded->DumpIr(), original->DumpIr());
+}
+FUZZ_TEST(IrBinaryFormatFuzzTest, RoundtripBinaryIrFuzz)
+    .WithDomains(IrFuzzDomain());
+
+// Returns the text of a package containing `function_count` chained functions
+// of `node_count` nodes each.
+std::string LargePackageText(int64_t function_count, int64_t node_count) {
+  Package p("benchmark");
+  Function* previous = nullptr;
+  for (int64_t i = 0; i < function_count; ++i) {
+    FunctionBuilder fb(absl::StrCat("f", i), &p);
+    BValue x = fb.Param("x", p.GetBitsType(32));
+    BValue y = fb.Param("y", p.GetBitsType(32));
+    for (int64_t j = 0; j < node_count; j += 2) {
+      BValue sum = fb.Add(x, y);
+      y = x;
+      x = fb.Xor(sum, fb.Literal(UBits(j, 32)));
+    }
+    if (previous != nullptr) {
+      x = fb.Invoke({x, y}, previous);
+    }
+    previous = fb.Build().value();
+  }
+  CHECK_OK(p.SetTop(previous));
+  return p.DumpIr();
+}
+
+void BM_LoadText(benchmark::State& state) {
+  std::string text = LargePackageText(state.range(0), 1000);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Parser::ParsePackageNoVerify(text).value());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_LoadBinary(benchmark::State& state) {
+  std::string binary =
+      PackageToBinaryIr(
+          *Parser::ParsePackage(LargePackageText(state.range(0), 1000)).value())
+          .value();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PackageFromBinaryIrNoVerify(binary).value());
+  }
+  state.SetBytesProcessed(state.iterations() * binary.size());
+}
+
+// Unlike the benchmarks above this includes verification.
+void BM_LoadTextConcurrently(benchmark::State& state) {
+  std::string text = LargePackageText(state.range(0), 1000);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        Parser::ParsePackageConcurrently(text, /*thread_count=*/0).value());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_LoadText)->Range(1, 64);
+BENCHMARK(BM_LoadTextConcurrently)->Range(1, 64);
+BENCHMARK(BM_LoadBinary)->Range(1, 64);
+
+}  // namespace
+}  // namespace xls
@@ -14,7 +14,10 @@
 
 #include "xls/ir/ir_parser.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <initializer_list>
 #include <limits>
@@ -28,17 +31,21 @@
 #include <vector>
 
 #include "absl/base/casts.h"
+#include "absl/base/no_destructor.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
+#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/notification.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "google/protobuf/text_format.h"
@@ -47,6 +54,7 @@
 #include "xls/common/attribute_data.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/common/visitor.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/bits_ops.h"
@@ -61,6 +69,7 @@
 #include "xls/ir/function_base.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/instantiation.h"
+#include "xls/ir/ir_binary_format.h"
 #include "xls/ir/ir_scanner.h"
 #include "xls/ir/lsb_or_msb.h"
 #include "xls/ir/node.h"
@@ -807,7 +816,7 @@ absl::StatusOr<BValue> Parser::ParseNode(
           arg_parser.AddKeywordArg<IdentifierString>("to_apply");
       XLS_ASSIGN_OR_RETURN(operands, arg_parser.Run(/*arity=*/1));
       XLS_ASSIGN_OR_RETURN(Function * to_apply,
-                           package->GetFunction(to_apply_name->value));
+                           GetFunction(package, to_apply_name->value));
       bvalue = fb->Map(operands[0], to_apply, *loc, node_name);
       break;
     }
@@ -933,7 +942,7 @@ absl::StatusOr<BValue> Parser::ParseNode(
               "invariant_args", /*default_value=*/{});
       XLS_ASSIGN_OR_RETURN(operands, arg_parser.Run(/*arity=*/1));
       XLS_ASSIGN_OR_RETURN(Function * body,
-                           package->GetFunction(body_name->value));
+                           GetFunction(package, body_name->value));
       bvalue = fb->CountedFor(operands[0], *trip_count, *stride, body,
                               *invariant_args, *loc, node_name);
       break;
@@ -946,7 +955,7 @@ absl::StatusOr<BValue> Parser::ParseNode(
               "invariant_args", /*default_value=*/{});
       XLS_ASSIGN_OR_RETURN(operands, arg_parser.Run(/*arity=*/3));
       XLS_ASSIGN_OR_RETURN(Function * body,
-                           package->GetFunction(body_name->value));
+                           GetFunction(package, body_name->value));
       bvalue = fb->DynamicCountedFor(operands[0], operands[1], operands[2],
                                      body, *invariant_args, *loc, node_name);
       break;
@@ -1091,7 +1100,7 @@ absl::StatusOr<BValue> Parser::ParseNode(
           arg_parser.AddKeywordArg<IdentifierString>("to_apply");
       XLS_ASSIGN_OR_RETURN(operands, arg_parser.Run(ArgParser::kVariadic));
       XLS_ASSIGN_OR_RETURN(Function * to_apply,
-                           package->GetFunction(to_apply_name->value));
+                           GetFunction(package, to_apply_name->value));
       bvalue = fb->Invoke(operands, to_apply, *loc, node_name);
       break;
     }
@@ -1673,7 +1682,7 @@ absl::StatusOr<Instantiation*> Parser::ParseInstantiation(Block* block) {
     XLS_ASSIGN_OR_RETURN(Token instantiated_block_name,
                          scanner_.PopTokenOrError(LexicalTokenType::kIdent));
     instantiated_block =
-        block->package()->TryGetBlock(instantiated_block_name.value());
+        TryGetBlock(block->package(), instantiated_block_name.value());
     if (!instantiated_block.has_value()) {
       return absl::InvalidArgumentError(absl::StrFormat(
           "No such block '%s' @ %s", instantiated_block_name.value(),
@@ -2407,6 +2416,8 @@ absl::StatusOr<Function*> Parser::ParseFunctionInternal(
   FunctionBuilder* fb = function_data.first.get();
   if (overridden_dest != nullptr) {
     fb->OverrideDestination(overridden_dest);
+  } else if (construct_destination_ != nullptr) {
+    fb->OverrideDestination(construct_destination_);
   }
 
   Function* result = nullptr;
@@ -2508,6 +2519,8 @@ absl::StatusOr<Proc*> Parser::ParseProcInternal(
                        ParseProcSignature(&name_to_value, package, scheduled));
   if (overridden_dest != nullptr) {
     pb->OverrideDestination(overridden_dest);
+  } else if (construct_destination_ != nullptr) {
+    pb->OverrideDestination(construct_destination_);
   }
 
   XLS_ASSIGN_OR_RETURN(BodyResult body_result,
@@ -2602,6 +2615,9 @@ absl::StatusOr<Block*> Parser::ParseBlockInternal(
     bb = std::make_unique<BlockBuilder>(signature.block_name, package,
                                         /*should_verify=*/false);
   }
+  if (construct_destination_ != nullptr) {
+    bb->OverrideDestination(construct_destination_);
+  }
 
   absl::flat_hash_map<std::string, BValue> name_to_value;
   XLS_ASSIGN_OR_RETURN(BodyResult body_result,
@@ -3427,6 +3443,14 @@ Parser::ParsePackageWithEntry(std::string_view input_string,
 Parser::ParsePackageNoVerify(std::string_view input_string,
                              std::optional<std::string_view> filename,
                              std::optional<std::string_view> entry) {
+  if (IsBinaryIr(input_string)) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                         PackageFromBinaryIrNoVerify(input_string));
+    if (entry.has_value()) {
+      XLS_RETURN_IF_ERROR(package->SetTopByName(entry.value()));
+    }
+    return package;
+  }
   return ParseDerivedPackageNoVerify<Package>(input_string, filename, entry);
 }
 
@@ -3622,4 +3646,433 @@ absl::Status Parser::ParseControlledStage(
   return absl::OkStatus();
 }
 
+// Nodes created while parsing the `i`-th construct of a package which is
+// parsed concurrently take their IDs from block `i + 1` above the IDs in use
+// when the functions, procs and blocks start being parsed.
+static constexpr int64_t kNodeIdBlockSize = int64_t{1} << 32;
+
+class Parser::ConcurrentParse {
+ public:
+  enum class Kind : uint8_t {
+    kHeader,
+    kFileNumber,
+    kChannel,
+    kFunction,
+    kProc,
+    kBlock,
+    // Anything which cannot be parsed independently of the rest of the package
+    // (scheduled function bases, new-style procs) or was not recognized.
+    kUnsupported,
+  };
+
+  // Returns the parsed package, or nullptr if the text cannot be split into
+  // constructs which are parsed independently.
+  static absl::StatusOr<std::unique_ptr<Package>> Run(
+      std::string_view input_string, int64_t thread_count);
+
+  // Returns the function, proc or block named `name` defined by a construct
+  // preceding construct `index`, waiting for it to be built.
+  absl::StatusOr<FunctionBase*> Lookup(Kind kind, std::string_view name,
+                                       int64_t index);
+
+ private:
+  struct Construct {
+    std::string_view text;
+    int64_t first_lineno = 0;
+    Kind kind = Kind::kUnsupported;
+    std::string_view name;
+    bool is_top = false;
+
+    // Set by the worker which builds the function, proc or block.
+    absl::Status status;
+    std::unique_ptr<FunctionBase> function_base;
+    Package::NodeIdHistory node_ids;
+    TransformMetrics metrics;
+    absl::Notification parsed;
+  };
+
+  // Splits `text` at the lines on which top-level constructs begin and
+  // classifies each construct by its leading keyword. Returns false if the
+  // brackets or quotes of the text are unbalanced.
+  bool Split(std::string_view text);
+
+  absl::Status ParseFunctionBase(Package* package, int64_t index);
+
+  int64_t BlockStart(int64_t index) const {
+    return first_node_id_ + (index + 1) * kNodeIdBlockSize;
+  }
+
+  // Deque so that constructs (and their notifications) never move.
+  std::deque<Construct> constructs_;
+  absl::flat_hash_map<std::pair<Kind, std::string_view>, int64_t> definitions_;
+  int64_t first_node_id_ = 0;
+};
+
+bool Parser::ConcurrentParse::Split(std::string_view text) {
+  static const absl::NoDestructor<absl::flat_hash_map<std::string_view, Kind>>
+      kDeclarations({
+          {"package", Kind::kHeader},
+          {"file_number", Kind::kFileNumber},
+          {"chan", Kind::kChannel},
+          {"fn", Kind::kFunction},
+          {"proc", Kind::kProc},
+          {"block", Kind::kBlock},
+          {"scheduled_fn", Kind::kUnsupported},
+          {"scheduled_proc", Kind::kUnsupported},
+          {"scheduled_block", Kind::kUnsupported},
+      });
+  std::vector<size_t> starts = {0};
+  constructs_.emplace_back();
+  bool has_declaration = false;
+  bool expect_name = false;
+  bool at_line_start = true;
+  size_t line_start = 0;
+  int64_t lineno = 0;
+  int64_t depth = 0;
+  size_t i = 0;
+  while (i < text.size()) {
+    const char c = text[i];
+    if (c == '\n') {
+      ++lineno;
+      line_start = ++i;
+      at_line_start = true;
+      continue;
+    }
+    if (absl::ascii_isspace(c)) {
+      ++i;
+      continue;
+    }
+    const bool first_on_line = std::exchange(at_line_start, false);
+    if (text.substr(i, 2) == "//") {
+      i = std::min(text.find('\n', i), text.size());
+      continue;
+    }
+    if (c == '"' || c == '`') {
+      const size_t quote_size = text.substr(i, 3) == "\"\"\"" ? 3 : 1;
+      const std::string_view quote = text.substr(i, quote_size);
+      size_t end = i + quote_size;
+      while (end < text.size() && text.substr(end, quote_size) != quote) {
+        if (text[end] == '\\') {
+          ++end;
+        }
+        if (end < text.size() && text[end] == '\n') {
+          ++lineno;
+        }
+        ++end;
+      }
+      if (end >= text.size()) {
+        return false;
+      }
+      i = end + quote_size;
+      continue;
+    }
+    if (c == '(' || c == '[' || c == '{') {
+      ++depth;
+      ++i;
+      continue;
+    }
+    if (c == ')' || c == ']' || c == '}') {
+      if (--depth < 0) {
+        return false;
+      }
+      ++i;
+      continue;
+    }
+    if (depth != 0 || !(c == '#' || c == '_' || absl::ascii_isalpha(c))) {
+      ++i;
+      continue;
+    }
+    size_t end = i + 1;
+    while (c != '#' && end < text.size() &&
+           (absl::ascii_isalnum(text[end]) || text[end] == '_' ||
+            text[end] == '.')) {
+      ++end;
+    }
+    const std::string_view word = text.substr(i, end - i);
+    i = end;
+    Construct& current = constructs_.back();
+    if (expect_name) {
+      expect_name = false;
+      current.name = word;
+      // New-style procs declare their channel interfaces in angle brackets
+      // after the name.
+      size_t next = text.find_first_not_of(" \t\r\n", i);
+      if (current.kind == Kind::kProc && next != std::string_view::npos &&
+          text[next] == '<') {
+        current.kind = Kind::kUnsupported;
+      }
+      continue;
+    }
+    auto declaration = kDeclarations->find(word);
+    if (first_on_line && has_declaration &&
+        (word == "#" || word == "top" || declaration != kDeclarations->end())) {
+      starts.push_back(line_start);
+      constructs_.emplace_back().first_lineno = lineno;
+      has_declaration = false;
+    }
+    if (!has_declaration && declaration != kDeclarations->end()) {
+      has_declaration = true;
+      constructs_.back().kind = declaration->second;
+      expect_name = declaration->second == Kind::kChannel ||
+                    declaration->second == Kind::kFunction ||
+                    declaration->second == Kind::kProc ||
+                    declaration->second == Kind::kBlock;
+    }
+  }
+  if (depth != 0 || expect_name) {
+    return false;
+  }
+  starts.push_back(text.size());
+  for (int64_t k = 0; k < static_cast<int64_t>(constructs_.size()); ++k) {
+    constructs_[k].text = text.substr(starts[k], starts[k + 1] - starts[k]);
+  }
+  return true;
+}
+
+absl::StatusOr<FunctionBase*> Parser::ConcurrentParse::Lookup(
+    Kind kind, std::string_view name, int64_t index) {
+  auto it = definitions_.find(std::make_pair(kind, name));
+  if (it == definitions_.end() || it->second >= index) {
+    return absl::NotFoundError(
+        absl::StrFormat("`%s` is not defined before its use", name));
+  }
+  Construct& definition = constructs_[it->second];
+  definition.parsed.WaitForNotification();
+  if (!definition.status.ok()) {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Definition of `%s` failed to parse", name));
+  }
+  return definition.function_base.get();
+}
+
+absl::Status Parser::ConcurrentParse::ParseFunctionBase(Package* package,
+                                                        int64_t index) {
+  Construct& construct = constructs_[index];
+  XLS_ASSIGN_OR_RETURN(
+      Scanner scanner,
+      Scanner::Create(construct.text, construct.first_lineno));
+  Parser parser(std::move(scanner));
+  parser.concurrent_parse_ = this;
+  parser.construct_index_ = index;
+  parser.construct_destination_ = &construct.function_base;
+  XLS_ASSIGN_OR_RETURN(std::vector<IrAttribute> attributes,
+                       parser.MaybeParseOuterAttributes(package));
+  construct.is_top = parser.scanner_.TryDropKeyword("top");
+  switch (construct.kind) {
+    case Kind::kFunction:
+      XLS_RETURN_IF_ERROR(parser.ParseFunction(package, attributes).status());
+      break;
+    case Kind::kProc:
+      XLS_RETURN_IF_ERROR(parser.ParseProc(package, attributes).status());
+      break;
+    case Kind::kBlock:
+      XLS_RETURN_IF_ERROR(parser.ParseBlock(package, attributes).status());
+      break;
+    default:
+      return absl::InternalError("Construct is not a function, proc or block");
+  }
+  if (!parser.AtEof() || construct.function_base == nullptr ||
+      construct.function_base->name() != construct.name) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Construct starting on line %d was not split correctly",
+        construct.first_lineno + 1));
+  }
+  return absl::OkStatus();
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<Package>>
+Parser::ConcurrentParse::Run(std::string_view input_string,
+                             int64_t thread_count) {
+  ConcurrentParse parse;
+  if (!parse.Split(input_string)) {
+    return nullptr;
+  }
+  std::vector<int64_t> function_bases;
+  for (int64_t index = 0;
+       index < static_cast<int64_t>(parse.constructs_.size()); ++index) {
+    const Construct& construct = parse.constructs_[index];
+    switch (construct.kind) {
+      case Kind::kHeader:
+        if (index != 0) {
+          return nullptr;
+        }
+        break;
+      case Kind::kFileNumber:
+      case Kind::kChannel:
+        break;
+      case Kind::kFunction:
+      case Kind::kProc:
+      case Kind::kBlock:
+        if (!parse.definitions_
+                 .emplace(std::make_pair(construct.kind, construct.name), index)
+                 .second) {
+          return nullptr;
+        }
+        function_bases.push_back(index);
+        break;
+      case Kind::kUnsupported:
+        return nullptr;
+    }
+  }
+  if (parse.constructs_.front().kind != Kind::kHeader ||
+      function_bases.size() < 2) {
+    return nullptr;
+  }
+
+  // The package header and the channel and file number declarations are cheap
+  // and are parsed serially, in order, before anything refers to them.
+  std::unique_ptr<Package> package;
+  for (Construct& construct : parse.constructs_) {
+    if (construct.kind != Kind::kHeader &&
+        construct.kind != Kind::kFileNumber &&
+        construct.kind != Kind::kChannel) {
+      continue;
+    }
+    XLS_ASSIGN_OR_RETURN(
+        Scanner scanner,
+        Scanner::Create(construct.text, construct.first_lineno));
+    Parser parser(std::move(scanner));
+    if (construct.kind == Kind::kHeader) {
+      XLS_ASSIGN_OR_RETURN(std::string package_name,
+                           parser.ParsePackageName());
+      package = std::make_unique<Package>(package_name);
+    } else {
+      XLS_ASSIGN_OR_RETURN(std::vector<IrAttribute> attributes,
+                           parser.MaybeParseOuterAttributes(package.get()));
+      if (construct.kind == Kind::kChannel) {
+        XLS_RETURN_IF_ERROR(
+            parser.ParseChannel(package.get(), attributes).status());
+      } else {
+        XLS_RETURN_IF_ERROR(parser.ParseFileNumber(package.get(), attributes));
+      }
+    }
+    if (!parser.AtEof()) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Construct starting on line %d was not split correctly",
+          construct.first_lineno + 1));
+    }
+  }
+
+  // Build the functions, procs and blocks. Each construct only waits for
+  // constructs which precede it and workers claim constructs in text order, so
+  // the construct being waited for has always been claimed already.
+  parse.first_node_id_ = package->next_node_id();
+  std::atomic<int64_t> next_function_base = 0;
+  auto build_function_bases = [&]() {
+    for (int64_t k = next_function_base.fetch_add(1);
+         k < static_cast<int64_t>(function_bases.size());
+         k = next_function_base.fetch_add(1)) {
+      const int64_t index = function_bases[k];
+      Construct& construct = parse.constructs_[index];
+      {
+        Package::NodeIdBlockScope block(
+            package.get(), parse.BlockStart(index),
+            parse.BlockStart(index) + kNodeIdBlockSize,
+            /*record_history=*/true);
+        construct.status = parse.ParseFunctionBase(package.get(), index);
+        construct.node_ids = std::move(block.history());
+        construct.metrics = block.metrics();
+      }
+      construct.parsed.Notify();
+    }
+  };
+  // Each worker claims constructs until none are left, so at most
+  // `worker_count` are built at once.
+  const int64_t worker_count =
+      std::min(thread_count, static_cast<int64_t>(function_bases.size()));
+  XLS_RETURN_IF_ERROR(
+      DefaultThreadPool().ParallelFor(worker_count, [&](int64_t) {
+        build_function_bases();
+        return absl::OkStatus();
+      }));
+
+  // Add the results to the package in text order. Nodes which kept the ID
+  // handed out from their block when they were created (e.g., next_value
+  // nodes built for `next (...)` in a proc) are given the ID a serial parse
+  // would have handed out at that point instead.
+  for (int64_t index : function_bases) {
+    Construct& construct = parse.constructs_[index];
+    XLS_RETURN_IF_ERROR(construct.status);
+    FunctionBase* function_base = construct.function_base.get();
+    switch (construct.kind) {
+      case Kind::kFunction:
+        package->AddFunction(absl::WrapUnique(
+            absl::down_cast<Function*>(construct.function_base.release())));
+        break;
+      case Kind::kProc:
+        package->AddProc(absl::WrapUnique(
+            absl::down_cast<Proc*>(construct.function_base.release())));
+        break;
+      default:
+        package->AddBlock(absl::WrapUnique(
+            absl::down_cast<Block*>(construct.function_base.release())));
+        break;
+    }
+    if (construct.is_top) {
+      if (package->HasTop()) {
+        return absl::InvalidArgumentError("Top declared more than once");
+      }
+      XLS_RETURN_IF_ERROR(package->SetTop(function_base));
+    }
+    const int64_t next_id = package->next_node_id();
+    for (Node* node : function_base->nodes()) {
+      const int64_t creation = node->id() - parse.BlockStart(index);
+      if (creation >= 0 && creation < construct.node_ids.creation_count()) {
+        node->SetId(construct.node_ids.IdOfCreation(creation, next_id));
+      }
+    }
+    package->set_next_node_id(construct.node_ids.NextId(next_id));
+    package->transform_metrics() =
+        package->transform_metrics() + construct.metrics;
+  }
+  SetUnassignedNodeIds(package.get());
+  return package;
+}
+
+absl::StatusOr<Function*> Parser::GetFunction(Package* package,
+                                              std::string_view name) {
+  if (concurrent_parse_ == nullptr) {
+    return package->GetFunction(name);
+  }
+  XLS_ASSIGN_OR_RETURN(
+      FunctionBase * function,
+      concurrent_parse_->Lookup(ConcurrentParse::Kind::kFunction, name,
+                                construct_index_));
+  return function->AsFunctionOrDie();
+}
+
+std::optional<Block*> Parser::TryGetBlock(Package* package,
+                                          std::string_view name) {
+  if (concurrent_parse_ == nullptr) {
+    return package->TryGetBlock(name);
+  }
+  absl::StatusOr<FunctionBase*> block = concurrent_parse_->Lookup(
+      ConcurrentParse::Kind::kBlock, name, construct_index_);
+  if (!block.ok()) {
+    return std::nullopt;
+  }
+  return block.value()->AsBlockOrDie();
+}
+
+/* static */ absl::StatusOr<std::unique_ptr<Package>>
+Parser::ParsePackageConcurrently(std::string_view input_string,
+                                 int64_t thread_count,
+                                 std::optional<std::string_view> filename) {
+  if (thread_count == 0) {
+    thread_count = DefaultThreadCount();
+  }
+  if (thread_count > 1 && !IsBinaryIr(input_string)) {
+    absl::StatusOr<std::unique_ptr<Package>> package =
+        ConcurrentParse::Run(input_string, thread_count);
+    if (package.ok() && *package != nullptr) {
+      XLS_RETURN_IF_ERROR(VerifyAndSwapError(package->get()));
+      return std::move(package).value();
+    }
+    VLOG(2) << "Parsing package serially: "
+            << (package.ok() ? "it cannot be split into independent constructs"
+                             : package.status().ToString());
+  }
+  return ParsePackage(input_string, filename);
+}
+
 }  // namespace xls
@@ -93,7 +93,8 @@ struct IrAttribute {
 
 class Parser {
  public:
-  // Parses the given input string as a package.
+  // Parses the given input string as a package. Input in the binary IR format
+  // (see ir_binary_format.h) is accepted as well.
   static absl::StatusOr<std::unique_ptr<Package>> ParsePackage(
       std::string_view input_string,
       std::optional<std::string_view> filename = std::nullopt);
@@ -104,6 +105,21 @@ class Parser {
       std::string_view input_string, std::string_view entry,
       std::optional<std::string_view> filename = std::nullopt);
 
+  // As ParsePackage, but parses the functions, procs and blocks of the package
+  // concurrently on up to `thread_count` threads of DefaultThreadPool() (zero
+  // means DefaultThreadCount()). The text is pre-scanned for the boundaries of
+  // its top-level constructs; channels and file numbers are declared first,
+  // then each function, proc or block is tokenized and built on a worker,
+  // waiting for the constructs it refers to, and the results are added to the
+  // package in text order. For valid input the package is identical to the
+  // one ParsePackage returns, node IDs included. Packages which contain
+  // new-style procs or scheduled function bases, or which fail to parse, are
+  // handed to ParsePackage so that errors are reported exactly as it reports
+  // them.
+  static absl::StatusOr<std::unique_ptr<Package>> ParsePackageConcurrently(
+      std::string_view input_string, int64_t thread_count,
+      std::optional<std::string_view> filename = std::nullopt);
+
   // Parse the input_string as a function into the given package.
   // If verify_function_only is true, then only this new function is verified,
   // otherwise the whole package is verified by default.
@@ -175,8 +191,19 @@ class Parser {
  private:
   friend class ArgParser;
 
+  // State shared by the parsers of the top-level constructs of a package which
+  // is parsed concurrently.
+  class ConcurrentParse;
+
   explicit Parser(Scanner scanner) : scanner_(scanner) {}
 
+  // Returns the function or block with the given name which has been defined
+  // so far. When parsing a package concurrently, this waits for the preceding
+  // construct which defines it to be built.
+  absl::StatusOr<Function*> GetFunction(Package* package,
+                                        std::string_view name);
+  std::optional<Block*> TryGetBlock(Package* package, std::string_view name);
+
   // Parse a function starting at the current scanner position.
   absl::StatusOr<Function*> ParseFunction(
       Package* package, absl::Span<const IrAttribute> outer_attributes = {},
@@ -431,6 +458,13 @@ class Parser {
   bool AtEof() const { return scanner_.AtEof(); }
 
   Scanner scanner_;
+
+  // Set when this parser handles a single construct of a package which is
+  // parsed concurrently. The function, proc or block it builds is moved to
+  // `construct_destination_` rather than added to the package.
+  ConcurrentParse* concurrent_parse_ = nullptr;
+  int64_t construct_index_ = 0;
+  std::unique_ptr<FunctionBase>* construct_destination_ = nullptr;
 };
 
 /* static */ template <typename PackageT>
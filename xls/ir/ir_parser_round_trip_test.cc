@@ -32,6 +32,7 @@
 #include "xls/common/source_location.h"
 #include "xls/common/status/matchers.h"
 #include "xls/fuzzer/ir_fuzzer/ir_fuzz_domain.h"
+#include "xls/ir/ir_binary_format.h"
 #include "xls/ir/ir_parser.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/package.h"
@@ -88,6 +89,23 @@ static void ParsePackageAndCheckDump(
   std::string ir_text = GetFileContents(abs_path).value();
   XLS_ASSERT_OK_AND_ASSIGN(auto package, Parser::ParsePackage(ir_text));
   ExpectEqualToGoldenFile(TestFilePath(test_name), package->DumpIr(), loc);
+
+  // Packages supported by the binary IR format must round trip through it
+  // unchanged as well.
+  absl::StatusOr<std::string> binary = PackageToBinaryIr(*package);
+  if (binary.ok()) {
+    XLS_ASSERT_OK_AND_ASSIGN(auto binary_package,
+                             Parser::ParsePackage(*binary));
+    EXPECT_EQ(binary_package->DumpIr(), package->DumpIr());
+  } else {
+    EXPECT_THAT(binary.status(), StatusIs(absl::StatusCode::kUnimplemented));
+  }
+
+  // Parsing concurrently must produce exactly the same package.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto concurrent_package,
+      Parser::ParsePackageConcurrently(ir_text, /*thread_count=*/4));
+  EXPECT_EQ(concurrent_package->DumpIr(), package->DumpIr());
 }
 
 TEST(IrParserRoundTripTest, ParseBitsLiteral) {
@@ -1437,4 +1437,65 @@ fn main(x: bits[32]) -> bits[32] {
                HasSubstr("Expected token of type \"backticked string\"")));
 }
 
+TEST(IrParserTest, ParsePackageConcurrently) {
+  // Nodes without ids, including the next_value nodes built for `next (...)`,
+  // must be numbered exactly as a serial parse numbers them.
+  std::string program = R"(
+package test
+
+file_number 0 "/a/b.x"
+
+chan out(bits[32], id=0, kind=streaming, ops=send_only, flow_control=ready_valid, strictness=proven_mutually_exclusive)
+
+fn inc(x: bits[32]) -> bits[32] {
+  one: bits[32] = literal(value=1)
+  ret add: bits[32] = add(x, one, pos=[(0,1,2)])
+}
+
+fn body(i: bits[32], acc: bits[32]) -> bits[32] {
+  ret r: bits[32] = invoke(acc, to_apply=inc, id=100)
+}
+
+#[initiation_interval(2)]
+proc counter(st: bits[32], init={7}) {
+  tkn: token = literal(value=token)
+  st: bits[32] = state_read(state_element=st)
+  looped: bits[32] = counted_for(st, trip_count=3, stride=1, body=body)
+  snd: token = send(tkn, looped, channel=out)
+  next (looped)
+}
+
+top fn main(a: bits[32][2]) -> bits[32][2] {
+  ret m: bits[32][2] = map(a, to_apply=inc)
+}
+)";
+  XLS_ASSERT_OK_AND_ASSIGN(auto serial, Parser::ParsePackage(program));
+  for (int64_t threads : {2, 4}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        auto concurrent, Parser::ParsePackageConcurrently(program, threads));
+    EXPECT_EQ(concurrent->DumpIr(), serial->DumpIr());
+    EXPECT_EQ(concurrent->next_node_id(), serial->next_node_id());
+    EXPECT_EQ(concurrent->GetTop().value()->name(), "main");
+  }
+}
+
+TEST(IrParserTest, ParsePackageConcurrentlyReportsSerialErrors) {
+  std::string program = R"(
+package test
+
+fn f(x: bits[32]) -> bits[32] {
+  ret r: bits[32] = invoke(x, to_apply=g)
+}
+
+fn g(x: bits[32]) -> bits[32] {
+  ret x: bits[32] = param(name=x)
+}
+)";
+  absl::Status serial = Parser::ParsePackage(program).status();
+  ASSERT_FALSE(serial.ok());
+  EXPECT_EQ(
+      Parser::ParsePackageConcurrently(program, /*thread_count=*/4).status(),
+      serial);
+}
+
 }  // namespace xls
@@ -137,8 +137,8 @@ class Tokenizer {
  public:
   // Tokenizes the given string and returns the vector of Tokens.
   static absl::StatusOr<std::vector<Token>> TokenizeString(
-      std::string_view str) {
-    Tokenizer tokenizer(str);
+      std::string_view str, int64_t first_lineno) {
+    Tokenizer tokenizer(str, first_lineno);
     return tokenizer.Tokenize();
   }
 
@@ -401,7 +401,8 @@ class Tokenizer {
   int64_t colno() const { return colno_; }
 
  private:
-  explicit Tokenizer(std::string_view str) : str_(str) {}
+  Tokenizer(std::string_view str, int64_t first_lineno)
+      : str_(str), lineno_(first_lineno) {}
 
   // The string being tokenized.
   std::string_view str_;
@@ -410,18 +411,20 @@ class Tokenizer {
   int64_t index_ = 0;
 
   // Line/column number based on the current index.
-  int64_t lineno_ = 0;
+  int64_t lineno_;
   int64_t colno_ = 0;
 };
 
 }  // namespace
 
-absl::StatusOr<std::vector<Token>> TokenizeString(std::string_view str) {
-  return Tokenizer::TokenizeString(str);
+absl::StatusOr<std::vector<Token>> TokenizeString(std::string_view str,
+                                                  int64_t first_lineno) {
+  return Tokenizer::TokenizeString(str, first_lineno);
 }
 
-absl::StatusOr<Scanner> Scanner::Create(std::string_view text) {
-  XLS_ASSIGN_OR_RETURN(auto tokens, TokenizeString(text));
+absl::StatusOr<Scanner> Scanner::Create(std::string_view text,
+                                        int64_t first_lineno) {
+  XLS_ASSIGN_OR_RETURN(auto tokens, TokenizeString(text, first_lineno));
   return Scanner(std::move(tokens));
 }
 
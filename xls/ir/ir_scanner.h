@@ -156,12 +156,15 @@ inline std::ostream& operator<<(std::ostream& os, const Token& token) {
 // Tokenizes the given string and returns the tokens. It maintains precise
 // source location information.  Right now this is a eager implementation - it
 // tokenizes the whole input. This can be easily changed later to a more demand
-// driven tokenization.
-absl::StatusOr<std::vector<Token>> TokenizeString(std::string_view str);
+// driven tokenization. `first_lineno` is the line number of the start of
+// `str`, for when it is a fragment of a larger text beginning at a line start.
+absl::StatusOr<std::vector<Token>> TokenizeString(std::string_view str,
+                                                  int64_t first_lineno = 0);
 
 class Scanner {
  public:
-  static absl::StatusOr<Scanner> Create(std::string_view text);
+  static absl::StatusOr<Scanner> Create(std::string_view text,
+                                        int64_t first_lineno = 0);
 
   // Peeks at the next token in the token stream, or returns an error if we're
   // at EOF and no more tokens are available.
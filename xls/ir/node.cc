@@ -927,7 +927,7 @@ void Node::SetId(int64_t id) {
   for (Node* operand : operands()) {
     operand->AddUser(this);
   }
-  package()->set_next_node_id(std::max(id + 1, package()->next_node_id()));
+  package()->ReserveNodeId(id);
 }
 
 bool Node::ReplaceOperand(Node* old_operand, Node* new_operand) {
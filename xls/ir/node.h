@@ -16,6 +16,7 @@
 #define XLS_IR_NODE_H_
 
 #include <compare>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -32,6 +33,7 @@
 #include "absl/types/span.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/change_listener.h"
+#include "xls/ir/node_allocator.h"
 #include "xls/ir/op.h"
 #include "xls/ir/source_location.h"
 #include "xls/ir/type.h"
@@ -84,6 +86,15 @@ class Node {
  public:
   virtual ~Node() = default;
 
+  // Nodes are allocated from pooled slabs to reduce the cost of the node churn
+  // generated by optimization passes. See NodeAllocator.
+  static void* operator new(size_t size) {
+    return NodeAllocator::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    NodeAllocator::Deallocate(ptr, size);
+  }
+
   // Accepts the visitor, instructing it to visit this node.
   absl::Status Accept(DfsVisitor* visitor);
 
@@ -340,6 +351,8 @@ class Node {
   // Block needs to be a friend to strongly name ports (guarantee name has no
   // uniquifying prefix).
   friend class Block;
+  // NodeList threads the nodes of a FunctionBase through its neighbor links.
+  friend class NodeList;
 
   Node(Op op, Type* type, const SourceInfo& loc, std::string_view name,
        FunctionBase* function);
@@ -391,6 +404,10 @@ class Node {
 
   // Set of users sorted by node_id for stability.
   absl::InlinedVector<Node*, 2> users_;
+
+  // Neighbors in the node list of the owning FunctionBase.
+  Node* prev_in_function_ = nullptr;
+  Node* next_in_function_ = nullptr;
 };
 
 inline NodeRef::NodeRef(Node* node)
@@ -0,0 +1,202 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_allocator.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "absl/base/config.h"
+#include "absl/base/no_destructor.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace xls {
+namespace {
+
+#if defined(ABSL_HAVE_ADDRESS_SANITIZER) ||   \
+    defined(ABSL_HAVE_MEMORY_SANITIZER) ||    \
+    defined(ABSL_HAVE_THREAD_SANITIZER) ||    \
+    defined(ABSL_HAVE_HWADDRESS_SANITIZER)
+// Pooling would hide use-after-free of nodes from the sanitizers.
+constexpr bool kUsePool = false;
+#else
+constexpr bool kUsePool = true;
+#endif
+
+constexpr size_t kGranularity = alignof(std::max_align_t);
+constexpr int64_t kSizeClassCount =
+    NodeAllocator::kMaxPooledSize / kGranularity;
+constexpr size_t kSlabBytes = 64 * 1024;
+// Number of blocks moved between a thread cache and the depot at a time.
+constexpr int64_t kBatchSize = 64;
+
+static_assert(NodeAllocator::kMaxPooledSize % kGranularity == 0);
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeBlock* head = nullptr;
+  int64_t size = 0;
+
+  void Push(void* ptr) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = head;
+    head = block;
+    ++size;
+  }
+  void* Pop() {
+    FreeBlock* block = head;
+    head = block->next;
+    --size;
+    return block;
+  }
+  // Moves up to `count` blocks from this list to `other`.
+  void MoveTo(FreeList& other, int64_t count) {
+    for (int64_t i = 0; i < count && head != nullptr; ++i) {
+      other.Push(Pop());
+    }
+  }
+};
+
+int64_t SizeClass(size_t size) {
+  return (static_cast<int64_t>(size) + kGranularity - 1) / kGranularity - 1;
+}
+size_t BlockSize(int64_t size_class) {
+  return static_cast<size_t>(size_class + 1) * kGranularity;
+}
+
+std::atomic<int64_t> slab_bytes = 0;
+
+// Shared pool of free blocks and owner of all slabs.
+class Depot {
+ public:
+  // Moves a batch of free blocks of the given size class into `list`,
+  // allocating a new slab if the depot has none.
+  void Refill(int64_t size_class, FreeList& list) {
+    absl::MutexLock lock(&mutex_);
+    FreeList& free = free_[size_class];
+    if (free.head == nullptr) {
+      NewSlab(size_class, free);
+    }
+    free.MoveTo(list, kBatchSize);
+  }
+
+  // Moves `count` blocks (all if negative) from `list` into the depot.
+  void Release(int64_t size_class, FreeList& list, int64_t count) {
+    absl::MutexLock lock(&mutex_);
+    list.MoveTo(free_[size_class], count < 0 ? list.size : count);
+  }
+
+  void Deallocate(int64_t size_class, void* ptr) {
+    absl::MutexLock lock(&mutex_);
+    free_[size_class].Push(ptr);
+  }
+
+ private:
+  void NewSlab(int64_t size_class, FreeList& list)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    size_t block_size = BlockSize(size_class);
+    slabs_.push_back(std::make_unique<std::byte[]>(kSlabBytes));
+    slab_bytes.fetch_add(kSlabBytes, std::memory_order_relaxed);
+    std::byte* slab = slabs_.back().get();
+    // Push in reverse so blocks are handed out in address order.
+    for (int64_t i = kSlabBytes / block_size - 1; i >= 0; --i) {
+      list.Push(slab + i * block_size);
+    }
+  }
+
+  absl::Mutex mutex_;
+  std::array<FreeList, kSizeClassCount> free_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::unique_ptr<std::byte[]>> slabs_ ABSL_GUARDED_BY(mutex_);
+};
+
+Depot& GetDepot() {
+  static absl::NoDestructor<Depot> depot;
+  return *depot;
+}
+
+// Set once the calling thread's cache has been destroyed. Nodes may still be
+// freed afterwards (e.g., by static destructors) in which case blocks go
+// directly to the depot.
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache {
+  ~ThreadCache() {
+    for (int64_t size_class = 0; size_class < kSizeClassCount; ++size_class) {
+      GetDepot().Release(size_class, free[size_class], /*count=*/-1);
+    }
+    thread_cache_destroyed = true;
+  }
+
+  std::array<FreeList, kSizeClassCount> free;
+};
+
+ThreadCache& GetThreadCache() {
+  thread_local ThreadCache cache;
+  return cache;
+}
+
+}  // namespace
+
+/* static */ void* NodeAllocator::Allocate(size_t size) {
+  if (!kUsePool || size > kMaxPooledSize) {
+    return ::operator new(size);
+  }
+  int64_t size_class = SizeClass(size);
+  if (thread_cache_destroyed) {
+    FreeList list;
+    GetDepot().Refill(size_class, list);
+    void* ptr = list.Pop();
+    GetDepot().Release(size_class, list, /*count=*/-1);
+    return ptr;
+  }
+  FreeList& list = GetThreadCache().free[size_class];
+  if (list.head == nullptr) {
+    GetDepot().Refill(size_class, list);
+  }
+  return list.Pop();
+}
+
+/* static */ void NodeAllocator::Deallocate(void* ptr, size_t size) {
+  if (!kUsePool || size > kMaxPooledSize) {
+    ::operator delete(ptr, size);
+    return;
+  }
+  int64_t size_class = SizeClass(size);
+  if (thread_cache_destroyed) {
+    GetDepot().Deallocate(size_class, ptr);
+    return;
+  }
+  FreeList& list = GetThreadCache().free[size_class];
+  list.Push(ptr);
+  // Return memory freed on this thread to the depot so threads which mostly
+  // free nodes allocated elsewhere do not accumulate blocks indefinitely.
+  if (list.size > 2 * kBatchSize) {
+    GetDepot().Release(size_class, list, kBatchSize);
+  }
+}
+
+/* static */ int64_t NodeAllocator::SlabBytes() {
+  return slab_bytes.load(std::memory_order_relaxed);
+}
+
+}  // namespace xls
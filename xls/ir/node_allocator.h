@@ -0,0 +1,48 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_NODE_ALLOCATOR_H_
+#define XLS_IR_NODE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xls {
+
+// Allocator for the storage of IR nodes. Blocks are carved out of large slabs
+// segregated by size class so nodes created together are laid out densely in
+// memory. Freed blocks are kept on per-size-class free lists and reused by
+// subsequent allocations, which avoids a trip through the general-purpose
+// allocator for the node churn generated by optimization passes. Slabs are
+// retained for the lifetime of the process.
+//
+// Each thread keeps a small cache of free blocks; blocks are exchanged with a
+// shared depot in batches, so allocation is thread-safe and rarely contended.
+// Allocations larger than the largest size class (and all allocations in
+// sanitizer builds) are forwarded to the global operator new.
+class NodeAllocator {
+ public:
+  // The largest allocation served from the slabs.
+  static constexpr size_t kMaxPooledSize = 512;
+
+  static void* Allocate(size_t size);
+  static void Deallocate(void* ptr, size_t size);
+
+  // Returns the total number of bytes of slab memory allocated so far.
+  static int64_t SlabBytes();
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_NODE_ALLOCATOR_H_
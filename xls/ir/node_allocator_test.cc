@@ -0,0 +1,151 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/node_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+#include "xls/ir/source_location.h"
+
+namespace xls {
+namespace {
+
+class NodeAllocatorTest : public IrTestBase {};
+
+TEST_F(NodeAllocatorTest, FreedBlocksAreReused) {
+  void* ptr = NodeAllocator::Allocate(100);
+  if (NodeAllocator::SlabBytes() == 0) {
+    NodeAllocator::Deallocate(ptr, 100);
+    GTEST_SKIP() << "Node pooling is disabled in this build";
+  }
+  std::memset(ptr, 0xab, 100);
+  NodeAllocator::Deallocate(ptr, 100);
+  // Sizes in the same size class share a free list.
+  void* reused = NodeAllocator::Allocate(97);
+  EXPECT_EQ(reused, ptr);
+  NodeAllocator::Deallocate(reused, 97);
+}
+
+TEST_F(NodeAllocatorTest, LargeAllocation) {
+  constexpr size_t kSize = NodeAllocator::kMaxPooledSize + 1;
+  void* ptr = NodeAllocator::Allocate(kSize);
+  std::memset(ptr, 0xcd, kSize);
+  NodeAllocator::Deallocate(ptr, kSize);
+}
+
+TEST_F(NodeAllocatorTest, FreeOnAnotherThread) {
+  std::vector<void*> blocks;
+  for (int64_t i = 0; i < 1000; ++i) {
+    blocks.push_back(NodeAllocator::Allocate(64));
+    std::memset(blocks.back(), 0, 64);
+  }
+  {
+    Thread thread([&]() {
+      for (void* block : blocks) {
+        NodeAllocator::Deallocate(block, 64);
+      }
+    });
+  }
+  for (void*& block : blocks) {
+    block = NodeAllocator::Allocate(64);
+  }
+  for (void* block : blocks) {
+    NodeAllocator::Deallocate(block, 64);
+  }
+}
+
+TEST_F(NodeAllocatorTest, NodesSurviveChurn) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(32));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.BuildWithReturnValue(x));
+  for (int64_t i = 0; i < 100; ++i) {
+    std::vector<Node*> nodes;
+    for (int64_t j = 0; j < 100; ++j) {
+      XLS_ASSERT_OK_AND_ASSIGN(
+          Node * node, f->MakeNode<UnOp>(SourceInfo(), x.node(), Op::kNot));
+      nodes.push_back(node);
+    }
+    for (Node* node : nodes) {
+      XLS_ASSERT_OK(f->RemoveNode(node));
+    }
+  }
+  EXPECT_EQ(f->node_count(), 1);
+  EXPECT_EQ(f->return_value(), x.node());
+}
+
+// Benchmark of creating `state.range(0)` nodes and then removing them, as
+// optimization passes do when rewriting a function.
+void BM_CreateAndRemoveNodes(benchmark::State& state) {
+  Package p("benchmark");
+  FunctionBuilder fb("f", &p);
+  BValue x = fb.Param("x", p.GetBitsType(32));
+  BValue y = fb.Param("y", p.GetBitsType(32));
+  Function* f = fb.BuildWithReturnValue(fb.Add(x, y)).value();
+  std::vector<Node*> nodes(state.range(0));
+  for (auto _ : state) {
+    for (Node*& node : nodes) {
+      node = f->MakeNode<BinOp>(SourceInfo(), x.node(), y.node(), Op::kSub)
+                 .value();
+    }
+    for (Node* node : nodes) {
+      CHECK_OK(f->RemoveNode(node));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["slab_bytes"] = NodeAllocator::SlabBytes();
+}
+
+BENCHMARK(BM_CreateAndRemoveNodes)->Range(64, 1 << 16);
+
+// Benchmark of iterating over the nodes of a function with
+// `state.range(0)` nodes.
+void BM_IterateNodes(benchmark::State& state) {
+  Package p("benchmark");
+  FunctionBuilder fb("f", &p);
+  BValue acc = fb.Param("x", p.GetBitsType(32));
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    acc = fb.Add(acc, fb.Literal(UBits(i, 32)));
+  }
+  Function* f = fb.BuildWithReturnValue(acc).value();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (Node* node : f->nodes()) {
+      sum += node->id();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * f->node_count());
+}
+
+BENCHMARK(BM_IterateNodes)->Range(64, 1 << 16);
+
+}  // namespace
+}  // namespace xls
@@ -0,0 +1,134 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_NODE_LIST_H_
+#define XLS_IR_NODE_LIST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include "absl/log/check.h"
+#include "xls/ir/node.h"
+
+namespace xls {
+
+// Owning, intrusive, doubly-linked list of the nodes of a FunctionBase in
+// insertion order. The links are stored in the nodes themselves so adding or
+// removing a node requires no allocation and no side table. Like std::list,
+// iterators remain valid when other nodes are added or removed, and nodes
+// appended during iteration are visited.
+class NodeList {
+ public:
+  template <bool kReverse>
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Node*;
+    using difference_type = ptrdiff_t;
+    using pointer = value_type*;
+    using reference = value_type&;
+
+    Iterator() = default;
+    explicit Iterator(Node* node) : node_(node) {}
+
+    Node* operator*() const { return node_; }
+    Node* operator->() const { return node_; }
+    Iterator& operator++() {
+      node_ = kReverse ? node_->prev_in_function_ : node_->next_in_function_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator temp = *this;
+      operator++();
+      return temp;
+    }
+
+    friend bool operator==(const Iterator& a, const Iterator& b) {
+      return a.node_ == b.node_;
+    }
+    friend bool operator!=(const Iterator& a, const Iterator& b) {
+      return !(a == b);
+    }
+
+   private:
+    Node* node_ = nullptr;
+  };
+  using iterator = Iterator</*kReverse=*/false>;
+  using reverse_iterator = Iterator</*kReverse=*/true>;
+
+  NodeList() = default;
+  NodeList(const NodeList&) = delete;
+  NodeList& operator=(const NodeList&) = delete;
+
+  // Destroys the nodes from front to back.
+  ~NodeList() {
+    while (head_ != nullptr) {
+      std::unique_ptr<Node> node = Remove(head_);
+    }
+  }
+
+  int64_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  iterator begin() const { return iterator(head_); }
+  iterator end() const { return iterator(); }
+  reverse_iterator rbegin() const { return reverse_iterator(tail_); }
+  reverse_iterator rend() const { return reverse_iterator(); }
+
+  // Appends the node to the list, taking ownership of it.
+  void push_back(std::unique_ptr<Node> node) {
+    Node* ptr = node.release();
+    DCHECK(ptr->prev_in_function_ == nullptr &&
+           ptr->next_in_function_ == nullptr);
+    ptr->prev_in_function_ = tail_;
+    if (tail_ == nullptr) {
+      head_ = ptr;
+    } else {
+      tail_->next_in_function_ = ptr;
+    }
+    tail_ = ptr;
+    ++size_;
+  }
+
+  // Unlinks the node, which must be in this list, and returns ownership of it.
+  std::unique_ptr<Node> Remove(Node* node) {
+    if (node->prev_in_function_ == nullptr) {
+      DCHECK_EQ(head_, node);
+      head_ = node->next_in_function_;
+    } else {
+      node->prev_in_function_->next_in_function_ = node->next_in_function_;
+    }
+    if (node->next_in_function_ == nullptr) {
+      DCHECK_EQ(tail_, node);
+      tail_ = node->prev_in_function_;
+    } else {
+      node->next_in_function_->prev_in_function_ = node->prev_in_function_;
+    }
+    node->prev_in_function_ = nullptr;
+    node->next_in_function_ = nullptr;
+    --size_;
+    return std::unique_ptr<Node>(node);
+  }
+
+ private:
+  Node* head_ = nullptr;
+  Node* tail_ = nullptr;
+  int64_t size_ = 0;
+};
+
+}  // namespace xls
+
+#endif  // XLS_IR_NODE_LIST_H_
@@ -55,6 +55,12 @@
 #include "xls/ir/value_utils.h"
 
 namespace xls {
+namespace {
+
+// The NodeIdBlockScope active on this thread, if any.
+thread_local Package::NodeIdBlockScope* active_node_id_block = nullptr;
+
+}  // namespace
 
 Package::Package(std::string_view name) : name_(name) {}
 
@@ -487,6 +493,63 @@ absl::Status Package::RemoveBlock(Block* block) {
   return absl::OkStatus();
 }
 
+Package::NodeIdBlockScope::NodeIdBlockScope(Package* package,
+                                            int64_t first_id, int64_t limit,
+                                            bool record_history)
+    : package_(package),
+      first_id_(first_id),
+      next_id_(first_id),
+      limit_(limit),
+      record_history_(record_history),
+      enclosing_(active_node_id_block) {
+  CHECK_LE(first_id, limit);
+  active_node_id_block = this;
+}
+
+Package::NodeIdBlockScope::~NodeIdBlockScope() {
+  CHECK_EQ(active_node_id_block, this);
+  active_node_id_block = enclosing_;
+}
+
+Package::NodeIdHistory& Package::NodeIdBlockScope::history() {
+  CHECK(record_history_) << "NodeIdBlockScope does not record its history";
+  return history_;
+}
+
+int64_t Package::GetNextNodeIdAndIncrement() {
+  NodeIdBlockScope* block = active_node_id_block;
+  if (block != nullptr && block->package_ == this) {
+    CHECK_LT(block->next_id_, block->limit_)
+        << "Node id block starting at " << block->first_id_ << " exhausted";
+    if (block->record_history_) {
+      NodeIdHistory& history = block->history_;
+      history.creation_floors_.push_back(history.floor_);
+      ++history.floor_;
+    }
+    return block->next_id_++;
+  }
+  return next_node_id_++;
+}
+
+void Package::ReserveNodeId(int64_t id) {
+  NodeIdBlockScope* block = active_node_id_block;
+  if (block != nullptr && block->package_ == this) {
+    if (block->record_history_) {
+      block->history_.floor_ = std::max(block->history_.floor_, id + 1);
+    }
+    return;
+  }
+  next_node_id_ = std::max(next_node_id_, id + 1);
+}
+
+TransformMetrics& Package::transform_metrics() {
+  NodeIdBlockScope* block = active_node_id_block;
+  if (block != nullptr && block->package_ == this) {
+    return block->metrics_;
+  }
+  return transform_metrics_;
+}
+
 SourceLocation Package::AddSourceLocation(std::string_view filename,
                                           Lineno lineno, Colno colno) {
   Fileno this_fileno = GetOrCreateFileno(filename);
@@ -15,6 +15,7 @@
 #ifndef XLS_IR_PACKAGE_H_
 #define XLS_IR_PACKAGE_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -229,8 +230,89 @@ class Package {
   std::string SourceLocationToString(const SourceLocation& loc);
 
   // Retrieves the next node ID to assign to a node in the package and
-  // increments the next node counter. For use in node construction.
-  int64_t GetNextNodeIdAndIncrement() { return next_node_id_++; }
+  // increments the next node counter. For use in node construction. If a
+  // NodeIdBlockScope for this package is active on the calling thread the ID is
+  // taken from that scope's block instead.
+  int64_t GetNextNodeIdAndIncrement();
+
+  // Ensures that IDs handed out from now on are greater than `id`. Called when
+  // a node's ID is set explicitly. If a NodeIdBlockScope for this package is
+  // active on the calling thread the reservation is recorded in that scope's
+  // history instead.
+  void ReserveNodeId(int64_t id);
+
+  // The effect of a sequence of node creations and explicit ID assignments on
+  // the package's node ID counter. A NodeIdBlockScope records this so that the
+  // IDs a serial run would have produced can be recovered after nodes were
+  // created concurrently.
+  class NodeIdHistory {
+   public:
+    // Returns the counter's value after replaying the history with the counter
+    // starting at `next_id`.
+    int64_t NextId(int64_t next_id) const {
+      return std::max(next_id + creation_count(), floor_);
+    }
+
+    // Returns the ID which the `index`-th node creation is handed out when
+    // replaying the history with the counter starting at `next_id`.
+    int64_t IdOfCreation(int64_t index, int64_t next_id) const {
+      return std::max(next_id + index, creation_floors_[index]);
+    }
+
+    int64_t creation_count() const { return creation_floors_.size(); }
+
+   private:
+    friend class Package;
+
+    // The lower bound which reservations placed on the counter, at the end of
+    // the history and at each node creation.
+    int64_t floor_ = 0;
+    std::vector<int64_t> creation_floors_;
+  };
+
+  // While alive, nodes created in `package` on the constructing thread take
+  // their IDs from the block [first_id, limit) rather than from the package's
+  // counter, and transform metrics are accumulated in the scope rather than in
+  // the package. This allows separate threads to create nodes in separate
+  // FunctionBases of the same package at the same time, with IDs which do not
+  // depend on how the threads are scheduled. The caller is responsible for
+  // choosing disjoint blocks and for folding the scope's metrics and
+  // next_id() back into the package afterwards.
+  //
+  // If `record_history` is true the scope also records the NodeIdHistory of
+  // the nodes created in it, which costs an entry per created node.
+  //
+  // Scopes may be nested on a thread, e.g. when a thread waiting on a
+  // ThreadPool runs another task; the innermost scope is the active one.
+  class NodeIdBlockScope {
+   public:
+    NodeIdBlockScope(Package* package, int64_t first_id, int64_t limit,
+                     bool record_history = false);
+    ~NodeIdBlockScope();
+
+    NodeIdBlockScope(const NodeIdBlockScope&) = delete;
+    NodeIdBlockScope& operator=(const NodeIdBlockScope&) = delete;
+
+    int64_t first_id() const { return first_id_; }
+    // One past the last ID handed out by this scope.
+    int64_t next_id() const { return next_id_; }
+    const TransformMetrics& metrics() const { return metrics_; }
+    // Only available if the scope records its history.
+    NodeIdHistory& history();
+
+   private:
+    friend class Package;
+
+    Package* package_;
+    int64_t first_id_;
+    int64_t next_id_;
+    int64_t limit_;
+    bool record_history_;
+    TransformMetrics metrics_;
+    NodeIdHistory history_;
+    // The scope which was active on the thread when this one was created.
+    NodeIdBlockScope* enclosing_;
+  };
 
   // Adds a file to the file-number table and returns its corresponding number.
   // If it already exists, returns the existing file-number entry.
@@ -455,7 +537,10 @@ class Package {
   const TransformMetrics& transform_metrics() const {
     return transform_metrics_;
   }
-  TransformMetrics& transform_metrics() { return transform_metrics_; }
+  //
+  // Mutations made under a NodeIdBlockScope are recorded in the scope's
+  // metrics.
+  TransformMetrics& transform_metrics();
 
   template <typename Sink>
   friend void FuzzTestPrintSourceCode(Sink& sink,
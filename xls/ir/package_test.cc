@@ -1217,5 +1217,22 @@ TEST_F(PackageTest, TransformMetrics) {
   EXPECT_EQ(p->transform_metrics().operands_replaced, 2);
 }
 
+TEST_F(PackageTest, NestedNodeIdBlockScopes) {
+  Package p(TestName());
+  int64_t next_id = p.next_node_id();
+  {
+    Package::NodeIdBlockScope outer(&p, 100, 200);
+    EXPECT_EQ(p.GetNextNodeIdAndIncrement(), 100);
+    {
+      Package::NodeIdBlockScope inner(&p, 300, 400);
+      EXPECT_EQ(p.GetNextNodeIdAndIncrement(), 300);
+      EXPECT_EQ(inner.next_id(), 301);
+    }
+    EXPECT_EQ(p.GetNextNodeIdAndIncrement(), 101);
+    EXPECT_EQ(outer.next_id(), 102);
+  }
+  EXPECT_EQ(p.GetNextNodeIdAndIncrement(), next_id);
+}
+
 }  // namespace
 }  // namespace xls
@@ -0,0 +1,463 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/packed_ternary.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/types/span.h"
+#include "xls/data_structures/inline_bitmap.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/ternary.h"
+
+namespace xls {
+namespace {
+
+constexpr int64_t kWordBits = InlineBitmap::kWordBits;
+
+// TernaryValues are stored one per byte as 0 (known zero), 1 (known one) or 2
+// (unknown), so the least significant bit of each byte is the value bit and
+// the next bit is the unknown bit.
+static_assert(static_cast<int>(TernaryValue::kKnownZero) == 0 &&
+              static_cast<int>(TernaryValue::kKnownOne) == 1 &&
+              static_cast<int>(TernaryValue::kUnknown) == 2);
+static_assert(sizeof(TernaryValue) == 1);
+
+// Returns the least significant bits of the eight bytes of `bytes` packed into
+// the low eight bits of the result.
+uint64_t GatherByteLsbs(uint64_t bytes) {
+  return ((bytes & 0x0101010101010101) * 0x0102040810204080) >> 56;
+}
+
+// The inverse of GatherByteLsbs: returns the low eight bits of `bits` spread
+// into the least significant bits of the eight bytes of the result.
+uint64_t ScatterToByteLsbs(uint64_t bits) {
+  uint64_t selected = ((bits & 0xff) * 0x0101010101010101) & 0x8040201008040201;
+  return ((selected + 0x7f7f7f7f7f7f7f7f) >> 7) & 0x0101010101010101;
+}
+
+// Returns a bitmap of `bit_count` bits whose word `i` is `f(i)`.
+template <typename F>
+InlineBitmap MapWords(int64_t bit_count, F f) {
+  InlineBitmap result(bit_count);
+  for (int64_t i = 0; i < result.word_count(); ++i) {
+    result.SetWord(i, f(i));
+  }
+  return result;
+}
+
+// Returns the word `wordno` of the bitmap or zero if it is out of range.
+uint64_t GetWordOrZero(const InlineBitmap& bitmap, int64_t wordno) {
+  if (wordno < 0 || wordno >= bitmap.word_count()) {
+    return 0;
+  }
+  return bitmap.GetWord(wordno);
+}
+
+// Returns `a + b + carry_in` truncated to the width of the operands.
+InlineBitmap AddBitmaps(const InlineBitmap& a, const InlineBitmap& b,
+                        bool carry_in) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  uint64_t carry = carry_in ? 1 : 0;
+  return MapWords(a.bit_count(), [&](int64_t i) {
+    uint64_t x = a.GetWord(i);
+    uint64_t partial = x + b.GetWord(i);
+    uint64_t sum = partial + carry;
+    carry = static_cast<uint64_t>(partial < x) |
+            static_cast<uint64_t>(sum < partial);
+    return sum;
+  });
+}
+
+// Shifts the bitmap left by `amount` bits, filling vacated bits with `fill`.
+InlineBitmap ShiftBitmapLeft(const InlineBitmap& bitmap, int64_t amount,
+                             bool fill) {
+  int64_t bit_count = bitmap.bit_count();
+  if (amount >= bit_count) {
+    return InlineBitmap(bit_count, fill);
+  }
+  int64_t word_shift = amount / kWordBits;
+  int64_t bit_shift = amount % kWordBits;
+  InlineBitmap result = MapWords(bit_count, [&](int64_t i) {
+    uint64_t word = GetWordOrZero(bitmap, i - word_shift) << bit_shift;
+    if (bit_shift != 0) {
+      word |= GetWordOrZero(bitmap, i - word_shift - 1) >>
+              (kWordBits - bit_shift);
+    }
+    return word;
+  });
+  if (fill) {
+    result.SetRange(0, amount);
+  }
+  return result;
+}
+
+// Shifts the bitmap right by `amount` bits, filling vacated bits with `fill`.
+InlineBitmap ShiftBitmapRight(const InlineBitmap& bitmap, int64_t amount,
+                              bool fill) {
+  int64_t bit_count = bitmap.bit_count();
+  if (amount >= bit_count) {
+    return InlineBitmap(bit_count, fill);
+  }
+  int64_t word_shift = amount / kWordBits;
+  int64_t bit_shift = amount % kWordBits;
+  InlineBitmap result = MapWords(bit_count, [&](int64_t i) {
+    uint64_t word = GetWordOrZero(bitmap, i + word_shift) >> bit_shift;
+    if (bit_shift != 0) {
+      word |= GetWordOrZero(bitmap, i + word_shift + 1)
+              << (kWordBits - bit_shift);
+    }
+    return word;
+  });
+  if (fill) {
+    result.SetRange(bit_count - amount, bit_count);
+  }
+  return result;
+}
+
+// Returns the largest value the vector may take (all unknown bits set).
+InlineBitmap MaxValue(const PackedTernaryVector& v) {
+  return MapWords(v.bit_count(), [&](int64_t i) {
+    return v.value().GetWord(i) | ~v.known().GetWord(i);
+  });
+}
+
+// Returns true if `v` may take the value `k`.
+bool MayEqual(const PackedTernaryVector& v, int64_t k) {
+  if (v.bit_count() < kWordBits && (k >> v.bit_count()) != 0) {
+    return false;
+  }
+  for (int64_t i = 0; i < v.word_count(); ++i) {
+    uint64_t k_word = i == 0 ? static_cast<uint64_t>(k) : 0;
+    if (((k_word ^ v.value().GetWord(i)) & v.known().GetWord(i)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if `v` may take a value greater than or equal to `k`.
+bool MayBeAtLeast(const PackedTernaryVector& v, int64_t k) {
+  InlineBitmap max = MaxValue(v);
+  for (int64_t i = 1; i < max.word_count(); ++i) {
+    if (max.GetWord(i) != 0) {
+      return true;
+    }
+  }
+  return GetWordOrZero(max, 0) >= static_cast<uint64_t>(k);
+}
+
+// Computes `a + b + carry_in` following the carry analysis of "Known Bits"
+// style abstract interpretation: the carry into each position is known if the
+// sums of the smallest and of the largest possible operand values agree on it.
+PackedTernaryVector AddWithCarryIn(const PackedTernaryVector& a,
+                                   const PackedTernaryVector& b,
+                                   bool carry_in) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  InlineBitmap max_a = MaxValue(a);
+  InlineBitmap max_b = MaxValue(b);
+  InlineBitmap min_sum = AddBitmaps(a.value(), b.value(), carry_in);
+  InlineBitmap max_sum = AddBitmaps(max_a, max_b, carry_in);
+  InlineBitmap known = MapWords(a.bit_count(), [&](int64_t i) {
+    uint64_t carry_known_zero =
+        ~(max_sum.GetWord(i) ^ max_a.GetWord(i) ^ max_b.GetWord(i));
+    uint64_t carry_known_one =
+        min_sum.GetWord(i) ^ a.value().GetWord(i) ^ b.value().GetWord(i);
+    return a.known().GetWord(i) & b.known().GetWord(i) &
+           (carry_known_zero | carry_known_one);
+  });
+  return PackedTernaryVector(std::move(known), std::move(min_sum));
+}
+
+enum class ShiftKind { kLeftLogical, kRightLogical, kRightArith };
+
+PackedTernaryVector ShiftByConstant(const PackedTernaryVector& a,
+                                    int64_t amount, ShiftKind kind) {
+  if (a.bit_count() == 0 || amount == 0) {
+    return a;
+  }
+  switch (kind) {
+    case ShiftKind::kLeftLogical:
+      return PackedTernaryVector(
+          ShiftBitmapLeft(a.known(), amount, /*fill=*/true),
+          ShiftBitmapLeft(a.value(), amount, /*fill=*/false));
+    case ShiftKind::kRightLogical:
+      return PackedTernaryVector(
+          ShiftBitmapRight(a.known(), amount, /*fill=*/true),
+          ShiftBitmapRight(a.value(), amount, /*fill=*/false));
+    case ShiftKind::kRightArith: {
+      int64_t sign = a.bit_count() - 1;
+      return PackedTernaryVector(
+          ShiftBitmapRight(a.known(), amount, a.known().Get(sign)),
+          ShiftBitmapRight(a.value(), amount, a.value().Get(sign)));
+    }
+  }
+  LOG(FATAL) << "Invalid shift kind";
+}
+
+PackedTernaryVector ShiftByTernary(const PackedTernaryVector& a,
+                                   const PackedTernaryVector& amount,
+                                   ShiftKind kind) {
+  int64_t bit_count = a.bit_count();
+  if (bit_count == 0) {
+    return a;
+  }
+  // Every shift amount of at least `bit_count` produces the same result, so
+  // at most `bit_count + 1` distinct cases need to be considered.
+  std::optional<PackedTernaryVector> result;
+  auto add_case = [&](int64_t shift) {
+    PackedTernaryVector shifted = ShiftByConstant(a, shift, kind);
+    result = result.has_value()
+                 ? packed_ternary_ops::Intersection(*result, shifted)
+                 : std::move(shifted);
+  };
+  for (int64_t shift = 0; shift < bit_count; ++shift) {
+    if (MayEqual(amount, shift)) {
+      add_case(shift);
+      if (result->known().IsAllZeroes()) {
+        return *std::move(result);
+      }
+    }
+  }
+  if (MayBeAtLeast(amount, bit_count)) {
+    add_case(bit_count);
+  }
+  CHECK(result.has_value());
+  return *std::move(result);
+}
+
+}  // namespace
+
+PackedTernaryVector::PackedTernaryVector(InlineBitmap known,
+                                         InlineBitmap value)
+    : known_(std::move(known)), value_(std::move(value)) {
+  CHECK_EQ(known_.bit_count(), value_.bit_count());
+  value_.Intersect(known_);
+}
+
+PackedTernaryVector PackedTernaryVector::FromTernary(TernarySpan ternary) {
+  int64_t bit_count = ternary.size();
+  InlineBitmap known(bit_count);
+  InlineBitmap value(bit_count);
+  for (int64_t i = 0; i < known.word_count(); ++i) {
+    int64_t base = i * kWordBits;
+    int64_t limit = std::min(kWordBits, bit_count - base);
+    uint64_t unknown_word = 0;
+    uint64_t value_word = 0;
+    int64_t j = 0;
+    for (; j + 8 <= limit; j += 8) {
+      uint64_t bytes;
+      std::memcpy(&bytes, &ternary[base + j], sizeof(bytes));
+      value_word |= GatherByteLsbs(bytes) << j;
+      unknown_word |= GatherByteLsbs(bytes >> 1) << j;
+    }
+    for (; j < limit; ++j) {
+      auto t = static_cast<uint64_t>(ternary[base + j]);
+      value_word |= (t & 1) << j;
+      unknown_word |= (t >> 1) << j;
+    }
+    known.SetWord(i, ~unknown_word);
+    value.SetWord(i, value_word);
+  }
+  return PackedTernaryVector(std::move(known), std::move(value));
+}
+
+PackedTernaryVector PackedTernaryVector::FromBits(const Bits& bits) {
+  return PackedTernaryVector(InlineBitmap(bits.bit_count(), /*fill=*/true),
+                             bits.bitmap());
+}
+
+TernaryVector PackedTernaryVector::ToTernary() const {
+  TernaryVector result(bit_count());
+  for (int64_t i = 0; i < word_count(); ++i) {
+    int64_t base = i * kWordBits;
+    int64_t limit = std::min(kWordBits, bit_count() - base);
+    uint64_t unknown_word = ~known_.GetWord(i);
+    uint64_t value_word = value_.GetWord(i);
+    int64_t j = 0;
+    for (; j + 8 <= limit; j += 8) {
+      uint64_t bytes = ScatterToByteLsbs(value_word >> j) |
+                       (ScatterToByteLsbs(unknown_word >> j) << 1);
+      std::memcpy(&result[base + j], &bytes, sizeof(bytes));
+    }
+    for (; j < limit; ++j) {
+      result[base + j] = static_cast<TernaryValue>(
+          ((value_word >> j) & 1) | (((unknown_word >> j) & 1) << 1));
+    }
+  }
+  return result;
+}
+
+TernaryValue PackedTernaryVector::Get(int64_t index) const {
+  if (!known_.Get(index)) {
+    return TernaryValue::kUnknown;
+  }
+  return value_.Get(index) ? TernaryValue::kKnownOne
+                           : TernaryValue::kKnownZero;
+}
+
+std::string PackedTernaryVector::ToString() const {
+  return xls::ToString(ToTernary());
+}
+
+namespace packed_ternary_ops {
+
+PackedTernaryVector Not(const PackedTernaryVector& a) {
+  return PackedTernaryVector(a.known(), MapWords(a.bit_count(), [&](int64_t i) {
+                               return a.GetKnownZeroWord(i);
+                             }));
+}
+
+PackedTernaryVector And(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  return PackedTernaryVector(
+      MapWords(a.bit_count(),
+               [&](int64_t i) {
+                 return (a.known().GetWord(i) & b.known().GetWord(i)) |
+                        a.GetKnownZeroWord(i) | b.GetKnownZeroWord(i);
+               }),
+      MapWords(a.bit_count(), [&](int64_t i) {
+        return a.value().GetWord(i) & b.value().GetWord(i);
+      }));
+}
+
+PackedTernaryVector Or(const PackedTernaryVector& a,
+                       const PackedTernaryVector& b) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  InlineBitmap value = MapWords(a.bit_count(), [&](int64_t i) {
+    return a.value().GetWord(i) | b.value().GetWord(i);
+  });
+  InlineBitmap known = MapWords(a.bit_count(), [&](int64_t i) {
+    return (a.known().GetWord(i) & b.known().GetWord(i)) | value.GetWord(i);
+  });
+  return PackedTernaryVector(std::move(known), std::move(value));
+}
+
+PackedTernaryVector Xor(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  return PackedTernaryVector(
+      MapWords(a.bit_count(),
+               [&](int64_t i) {
+                 return a.known().GetWord(i) & b.known().GetWord(i);
+               }),
+      MapWords(a.bit_count(), [&](int64_t i) {
+        return a.value().GetWord(i) ^ b.value().GetWord(i);
+      }));
+}
+
+PackedTernaryVector Intersection(const PackedTernaryVector& a,
+                                 const PackedTernaryVector& b) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  return PackedTernaryVector(
+      MapWords(a.bit_count(),
+               [&](int64_t i) {
+                 return a.known().GetWord(i) & b.known().GetWord(i) &
+                        ~(a.value().GetWord(i) ^ b.value().GetWord(i));
+               }),
+      a.value());
+}
+
+PackedTernaryVector Add(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b) {
+  return AddWithCarryIn(a, b, /*carry_in=*/false);
+}
+
+PackedTernaryVector Sub(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b) {
+  // a - b == a + ~b + 1
+  return AddWithCarryIn(a, Not(b), /*carry_in=*/true);
+}
+
+PackedTernaryVector ShiftLeftLogical(const PackedTernaryVector& a,
+                                     int64_t amount) {
+  return ShiftByConstant(a, amount, ShiftKind::kLeftLogical);
+}
+PackedTernaryVector ShiftRightLogical(const PackedTernaryVector& a,
+                                      int64_t amount) {
+  return ShiftByConstant(a, amount, ShiftKind::kRightLogical);
+}
+PackedTernaryVector ShiftRightArith(const PackedTernaryVector& a,
+                                    int64_t amount) {
+  return ShiftByConstant(a, amount, ShiftKind::kRightArith);
+}
+
+PackedTernaryVector ShiftLeftLogical(const PackedTernaryVector& a,
+                                     const PackedTernaryVector& amount) {
+  return ShiftByTernary(a, amount, ShiftKind::kLeftLogical);
+}
+PackedTernaryVector ShiftRightLogical(const PackedTernaryVector& a,
+                                      const PackedTernaryVector& amount) {
+  return ShiftByTernary(a, amount, ShiftKind::kRightLogical);
+}
+PackedTernaryVector ShiftRightArith(const PackedTernaryVector& a,
+                                    const PackedTernaryVector& amount) {
+  return ShiftByTernary(a, amount, ShiftKind::kRightArith);
+}
+
+PackedTernaryVector Concat(absl::Span<const PackedTernaryVector> inputs) {
+  int64_t bit_count = 0;
+  for (const PackedTernaryVector& input : inputs) {
+    bit_count += input.bit_count();
+  }
+  InlineBitmap known(bit_count);
+  InlineBitmap value(bit_count);
+  int64_t offset = 0;
+  for (auto it = inputs.rbegin(); it != inputs.rend(); ++it) {
+    known.Overwrite(it->known(), it->bit_count(), offset);
+    value.Overwrite(it->value(), it->bit_count(), offset);
+    offset += it->bit_count();
+  }
+  return PackedTernaryVector(std::move(known), std::move(value));
+}
+
+TernaryValue Equals(const PackedTernaryVector& a,
+                    const PackedTernaryVector& b) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  for (int64_t i = 0; i < a.word_count(); ++i) {
+    uint64_t both_known = a.known().GetWord(i) & b.known().GetWord(i);
+    if (((a.value().GetWord(i) ^ b.value().GetWord(i)) & both_known) != 0) {
+      return TernaryValue::kKnownZero;
+    }
+  }
+  return a.IsFullyKnown() && b.IsFullyKnown() ? TernaryValue::kKnownOne
+                                              : TernaryValue::kUnknown;
+}
+
+TernaryValue ULessThan(const PackedTernaryVector& a,
+                       const PackedTernaryVector& b) {
+  CHECK_EQ(a.bit_count(), b.bit_count());
+  // The operands are independent so `a < b` is possible iff the smallest
+  // value of `a` is less than the largest value of `b`, and `a >= b` is
+  // possible iff the largest value of `a` is at least the smallest value of
+  // `b`.
+  if (a.value().UCmp(MaxValue(b)) >= 0) {
+    return TernaryValue::kKnownZero;
+  }
+  if (MaxValue(a).UCmp(b.value()) < 0) {
+    return TernaryValue::kKnownOne;
+  }
+  return TernaryValue::kUnknown;
+}
+
+}  // namespace packed_ternary_ops
+}  // namespace xls
@@ -0,0 +1,142 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_IR_PACKED_TERNARY_H_
+#define XLS_IR_PACKED_TERNARY_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/types/span.h"
+#include "xls/data_structures/inline_bitmap.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/ternary.h"
+
+namespace xls {
+
+// A bit-packed ternary vector. Where TernaryVector stores one byte per bit,
+// this stores two bitmaps: `known` has a one for each bit whose value is
+// known, and `value` has a one for each bit known to be one. Bits which are
+// not known are always zero in `value`.
+//
+// The packed form lets the ternary operations below process 64 bits per
+// machine operation, which matters for wide datapaths where the per-bit
+// abstract evaluation of adds, shifts and comparisons dominates the cost of
+// ternary analysis.
+class PackedTernaryVector {
+ public:
+  // Creates a vector of `bit_count` unknown bits.
+  explicit PackedTernaryVector(int64_t bit_count)
+      : known_(bit_count), value_(bit_count) {}
+
+  // Creates a vector from its bitmaps. Bits of `value` which are not set in
+  // `known` are cleared.
+  PackedTernaryVector(InlineBitmap known, InlineBitmap value);
+
+  static PackedTernaryVector FromTernary(TernarySpan ternary);
+  static PackedTernaryVector FromBits(const Bits& bits);
+
+  TernaryVector ToTernary() const;
+
+  int64_t bit_count() const { return known_.bit_count(); }
+  int64_t word_count() const { return known_.word_count(); }
+
+  const InlineBitmap& known() const { return known_; }
+  const InlineBitmap& value() const { return value_; }
+
+  // Returns the mask of bits known to be zero for the given word.
+  uint64_t GetKnownZeroWord(int64_t wordno) const {
+    return known_.GetWord(wordno) & ~value_.GetWord(wordno);
+  }
+
+  TernaryValue Get(int64_t index) const;
+
+  bool IsFullyKnown() const { return known_.IsAllOnes(); }
+
+  bool operator==(const PackedTernaryVector& other) const {
+    return known_ == other.known_ && value_ == other.value_;
+  }
+  bool operator!=(const PackedTernaryVector& other) const {
+    return !(*this == other);
+  }
+
+  std::string ToString() const;
+
+  template <typename Sink>
+  friend void AbslStringify(Sink& sink, const PackedTernaryVector& v) {
+    sink.Append(v.ToString());
+  }
+
+ private:
+  InlineBitmap known_;
+  InlineBitmap value_;
+};
+
+namespace packed_ternary_ops {
+
+// Bitwise operations. The operands of binary operations must have the same
+// width.
+PackedTernaryVector Not(const PackedTernaryVector& a);
+PackedTernaryVector And(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b);
+PackedTernaryVector Or(const PackedTernaryVector& a,
+                       const PackedTernaryVector& b);
+PackedTernaryVector Xor(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b);
+
+// Returns the bits known to have the same value in both `a` and `b`.
+PackedTernaryVector Intersection(const PackedTernaryVector& a,
+                                 const PackedTernaryVector& b);
+
+// Modular addition and subtraction. Carries are computed exactly: a result bit
+// is known whenever both operand bits and the carry into that position are
+// determined by the known bits of the operands.
+PackedTernaryVector Add(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b);
+PackedTernaryVector Sub(const PackedTernaryVector& a,
+                        const PackedTernaryVector& b);
+
+// Shifts by a constant amount. Shifting by the width of the input or more
+// results in all zeros for logical shifts and all sign bit for arithmetic
+// shifts.
+PackedTernaryVector ShiftLeftLogical(const PackedTernaryVector& a,
+                                     int64_t amount);
+PackedTernaryVector ShiftRightLogical(const PackedTernaryVector& a,
+                                      int64_t amount);
+PackedTernaryVector ShiftRightArith(const PackedTernaryVector& a,
+                                    int64_t amount);
+
+// Shifts by a possibly-unknown amount. The result is the intersection of the
+// results for every shift amount consistent with `amount`.
+PackedTernaryVector ShiftLeftLogical(const PackedTernaryVector& a,
+                                     const PackedTernaryVector& amount);
+PackedTernaryVector ShiftRightLogical(const PackedTernaryVector& a,
+                                      const PackedTernaryVector& amount);
+PackedTernaryVector ShiftRightArith(const PackedTernaryVector& a,
+                                    const PackedTernaryVector& amount);
+
+// Concatenates the given vectors. As with the IR concat operation the first
+// element holds the most significant bits.
+PackedTernaryVector Concat(absl::Span<const PackedTernaryVector> inputs);
+
+// Comparisons. The operands must have the same width.
+TernaryValue Equals(const PackedTernaryVector& a, const PackedTernaryVector& b);
+TernaryValue ULessThan(const PackedTernaryVector& a,
+                       const PackedTernaryVector& b);
+
+}  // namespace packed_ternary_ops
+}  // namespace xls
+
+#endif  // XLS_IR_PACKED_TERNARY_H_
@@ -0,0 +1,213 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/ir/packed_ternary.h"
+
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "xls/common/fuzzing/fuzztest.h"
+#include "xls/data_structures/inline_bitmap.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/bits_ops.h"
+#include "xls/ir/ternary.h"
+
+namespace xls {
+namespace {
+
+namespace pto = packed_ternary_ops;
+
+PackedTernaryVector FromString(std::string_view s) {
+  return PackedTernaryVector::FromTernary(StringToTernaryVector(s).value());
+}
+
+PackedTernaryVector FromBits(const Bits& bits) {
+  return PackedTernaryVector::FromBits(bits);
+}
+
+// Returns a 200-bit value with the given 64-bit pattern repeated.
+Bits Wide(uint64_t pattern) {
+  InlineBitmap bitmap(200);
+  for (int64_t i = 0; i < bitmap.word_count(); ++i) {
+    bitmap.SetWord(i, pattern);
+  }
+  return Bits::FromBitmap(std::move(bitmap));
+}
+
+TEST(PackedTernaryTest, RoundTrip) {
+  for (std::string_view s : {"0b", "0b1", "0bX", "0b0", "0b1X0_X01X"}) {
+    TernaryVector ternary = StringToTernaryVector(s).value();
+    PackedTernaryVector packed = PackedTernaryVector::FromTernary(ternary);
+    EXPECT_EQ(packed.ToTernary(), ternary) << s;
+    EXPECT_EQ(packed.ToString(), ToString(ternary)) << s;
+  }
+  PackedTernaryVector v = FromString("0b1X0");
+  EXPECT_EQ(v.Get(0), TernaryValue::kKnownZero);
+  EXPECT_EQ(v.Get(1), TernaryValue::kUnknown);
+  EXPECT_EQ(v.Get(2), TernaryValue::kKnownOne);
+  EXPECT_FALSE(v.IsFullyKnown());
+  EXPECT_TRUE(FromBits(UBits(5, 3)).IsFullyKnown());
+  EXPECT_EQ(FromBits(UBits(5, 3)), FromString("0b101"));
+}
+
+TEST(PackedTernaryTest, BitwiseOps) {
+  EXPECT_EQ(pto::Not(FromString("0b1X0")), FromString("0b0X1"));
+  EXPECT_EQ(pto::And(FromString("0b111XXX000"), FromString("0b0X10X10X1")),
+            FromString("0b0X10XX000"));
+  EXPECT_EQ(pto::Or(FromString("0b111XXX000"), FromString("0b0X10X10X1")),
+            FromString("0b111XX10X1"));
+  EXPECT_EQ(pto::Xor(FromString("0b111XXX000"), FromString("0b0X10X10X1")),
+            FromString("0b1X0XXX0X1"));
+  EXPECT_EQ(pto::Intersection(FromString("0b10X10"), FromString("0b1X011")),
+            FromString("0b1XX1X"));
+}
+
+TEST(PackedTernaryTest, Add) {
+  EXPECT_EQ(pto::Add(FromString("0b0011"), FromString("0b0001")),
+            FromString("0b0100"));
+  // The carry out of the low bits is one regardless of the unknown bit.
+  EXPECT_EQ(pto::Add(FromString("0b001X"), FromString("0b0011")),
+            FromString("0b01XX"));
+  EXPECT_EQ(pto::Add(FromString("0b0X11"), FromString("0b0001")),
+            FromString("0bXX00"));
+  EXPECT_EQ(pto::Add(FromString("0b00X0"), FromString("0b0001")),
+            FromString("0b00X1"));
+  // Carries propagate across words.
+  Bits ones = bits_ops::Not(Bits(200));
+  EXPECT_EQ(pto::Add(FromBits(ones), FromBits(UBits(1, 200))),
+            FromBits(Bits(200)));
+  EXPECT_EQ(pto::Add(FromBits(Wide(0x0123456789abcdef)),
+                     FromBits(Wide(0xfedcba9876543210))),
+            FromBits(bits_ops::Add(Wide(0x0123456789abcdef),
+                                   Wide(0xfedcba9876543210))));
+}
+
+TEST(PackedTernaryTest, Sub) {
+  EXPECT_EQ(pto::Sub(FromString("0b0100"), FromString("0b0001")),
+            FromString("0b0011"));
+  EXPECT_EQ(pto::Sub(FromString("0b0000"), FromString("0b0001")),
+            FromString("0b1111"));
+  EXPECT_EQ(pto::Sub(FromString("0b01X0"), FromString("0b0X00")),
+            FromString("0b0XX0"));
+  EXPECT_EQ(pto::Sub(FromBits(Wide(0x0123456789abcdef)),
+                     FromBits(Wide(0xfedcba9876543210))),
+            FromBits(bits_ops::Sub(Wide(0x0123456789abcdef),
+                                   Wide(0xfedcba9876543210))));
+}
+
+TEST(PackedTernaryTest, ShiftByConstant) {
+  EXPECT_EQ(pto::ShiftLeftLogical(FromString("0b1X01"), 1),
+            FromString("0bX010"));
+  EXPECT_EQ(pto::ShiftRightLogical(FromString("0b1X01"), 1),
+            FromString("0b01X0"));
+  EXPECT_EQ(pto::ShiftRightArith(FromString("0bX101"), 2),
+            FromString("0bXXX1"));
+  EXPECT_EQ(pto::ShiftRightArith(FromString("0b1101"), 10),
+            FromString("0b1111"));
+  EXPECT_EQ(pto::ShiftLeftLogical(FromString("0b1X01"), 4),
+            FromString("0b0000"));
+  Bits wide = Wide(0x0123456789abcdef);
+  for (int64_t amount : {0, 1, 63, 64, 65, 130, 199, 200, 300}) {
+    EXPECT_EQ(pto::ShiftLeftLogical(FromBits(wide), amount),
+              FromBits(bits_ops::ShiftLeftLogical(wide, amount)))
+        << amount;
+    EXPECT_EQ(pto::ShiftRightLogical(FromBits(wide), amount),
+              FromBits(bits_ops::ShiftRightLogical(wide, amount)))
+        << amount;
+    EXPECT_EQ(pto::ShiftRightArith(FromBits(wide), amount),
+              FromBits(bits_ops::ShiftRightArith(wide, amount)))
+        << amount;
+  }
+}
+
+TEST(PackedTernaryTest, ShiftByTernary) {
+  EXPECT_EQ(pto::ShiftLeftLogical(FromString("0b0011"), FromString("0b0X")),
+            FromString("0b0X1X"));
+  EXPECT_EQ(pto::ShiftRightLogical(FromString("0b1110"), FromString("0bX0")),
+            FromString("0bXX1X"));
+  EXPECT_EQ(pto::ShiftRightArith(FromString("0b1000"), FromString("0bXX")),
+            FromString("0b1XXX"));
+  // Shifting by at least the width gives all zeros.
+  EXPECT_EQ(pto::ShiftLeftLogical(FromString("0b1111"), FromString("0b1XX")),
+            FromString("0b0000"));
+  // An empty amount shifts by zero.
+  EXPECT_EQ(pto::ShiftLeftLogical(FromString("0b1X01"), FromString("0b")),
+            FromString("0b1X01"));
+}
+
+TEST(PackedTernaryTest, Concat) {
+  EXPECT_EQ(pto::Concat({}), FromString("0b"));
+  EXPECT_EQ(pto::Concat({FromString("0b1X0"), FromString("0b11")}),
+            FromString("0b1X011"));
+  Bits wide = Wide(0x0123456789abcdef);
+  EXPECT_EQ(pto::Concat({FromBits(wide), FromString("0b101"), FromBits(wide)}),
+            FromBits(bits_ops::Concat({wide, UBits(0b101, 3), wide})));
+}
+
+TEST(PackedTernaryTest, Compare) {
+  EXPECT_EQ(pto::Equals(FromString("0b101"), FromString("0bX0X")),
+            TernaryValue::kUnknown);
+  EXPECT_EQ(pto::Equals(FromString("0b101"), FromString("0bX1X")),
+            TernaryValue::kKnownZero);
+  EXPECT_EQ(pto::Equals(FromString("0b101"), FromString("0b101")),
+            TernaryValue::kKnownOne);
+  EXPECT_EQ(pto::Equals(FromString("0b"), FromString("0b")),
+            TernaryValue::kKnownOne);
+
+  EXPECT_EQ(pto::ULessThan(FromString("0b0XX"), FromString("0b1XX")),
+            TernaryValue::kKnownOne);
+  EXPECT_EQ(pto::ULessThan(FromString("0b1XX"), FromString("0b100")),
+            TernaryValue::kKnownZero);
+  EXPECT_EQ(pto::ULessThan(FromString("0bX00"), FromString("0b100")),
+            TernaryValue::kUnknown);
+  EXPECT_EQ(pto::ULessThan(FromString("0b"), FromString("0b")),
+            TernaryValue::kKnownZero);
+  EXPECT_EQ(pto::ULessThan(FromBits(Wide(1)), FromBits(Wide(2))),
+            TernaryValue::kKnownOne);
+}
+
+void BitwiseOpsMatchTernaryOps(std::tuple<TernaryVector, TernaryVector> args) {
+  auto [a, b] = std::move(args);
+  PackedTernaryVector packed_a = PackedTernaryVector::FromTernary(a);
+  PackedTernaryVector packed_b = PackedTernaryVector::FromTernary(b);
+  EXPECT_EQ(packed_a.ToTernary(), a);
+  EXPECT_EQ(pto::Not(packed_a).ToTernary(), ternary_ops::Not(a));
+  EXPECT_EQ(pto::And(packed_a, packed_b).ToTernary(), ternary_ops::And(a, b));
+  EXPECT_EQ(pto::Or(packed_a, packed_b).ToTernary(), ternary_ops::Or(a, b));
+  EXPECT_EQ(pto::Xor(packed_a, packed_b).ToTernary(), ternary_ops::Xor(a, b));
+  EXPECT_EQ(pto::Intersection(packed_a, packed_b).ToTernary(),
+            ternary_ops::Intersection(a, b));
+}
+
+FUZZ_TEST(PackedTernaryFuzzTest, BitwiseOpsMatchTernaryOps)
+    .WithDomains(fuzztest::FlatMap(
+        [](int64_t bit_count) {
+          return fuzztest::TupleOf(
+              fuzztest::VectorOf(fuzztest::ElementOf({TernaryValue::kKnownZero,
+                                                      TernaryValue::kKnownOne,
+                                                      TernaryValue::kUnknown}))
+                  .WithSize(bit_count),
+              fuzztest::VectorOf(fuzztest::ElementOf({TernaryValue::kKnownZero,
+                                                      TernaryValue::kKnownOne,
+                                                      TernaryValue::kUnknown}))
+                  .WithSize(bit_count));
+        },
+        fuzztest::InRange(0, 300)));
+
+}  // namespace
+}  // namespace xls
@@ -26,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/ir/type.h"
@@ -39,40 +40,63 @@ TypeManager::TypeManager() {
   owned_types_.insert(token_type_.get());
 }
 BitsType* TypeManager::GetBitsType(int64_t bit_count) {
-  if (bit_count_to_type_.find(bit_count) != bit_count_to_type_.end()) {
-    return &bit_count_to_type_.at(bit_count);
+  {
+    absl::ReaderMutexLock lock(mu_.get());
+    auto it = bit_count_to_type_.find(bit_count);
+    if (it != bit_count_to_type_.end()) {
+      return &it->second;
+    }
+  }
+  absl::MutexLock lock(mu_.get());
+  auto [it, inserted] =
+      bit_count_to_type_.try_emplace(bit_count, BitsType(bit_count));
+  BitsType* new_type = &it->second;
+  if (inserted) {
+    owned_types_.insert(new_type);
   }
-  auto it = bit_count_to_type_.emplace(bit_count, BitsType(bit_count));
-  BitsType* new_type = &(it.first->second);
-  owned_types_.insert(new_type);
   return new_type;
 }
 
 ArrayType* TypeManager::GetArrayType(int64_t size, Type* element_type) {
   ArrayKey key{size, element_type};
-  if (array_types_.find(key) != array_types_.end()) {
-    return &array_types_.at(key);
+  {
+    absl::ReaderMutexLock lock(mu_.get());
+    auto it = array_types_.find(key);
+    if (it != array_types_.end()) {
+      return &it->second;
+    }
   }
-  CHECK(IsOwnedType(element_type))
+  absl::MutexLock lock(mu_.get());
+  CHECK(owned_types_.contains(element_type))
       << "Type is not owned by package: " << *element_type;
-  auto it = array_types_.emplace(key, ArrayType(size, element_type));
-  ArrayType* new_type = &(it.first->second);
-  owned_types_.insert(new_type);
+  auto [it, inserted] =
+      array_types_.try_emplace(key, ArrayType(size, element_type));
+  ArrayType* new_type = &it->second;
+  if (inserted) {
+    owned_types_.insert(new_type);
+  }
   return new_type;
 }
 
 TupleType* TypeManager::GetTupleType(absl::Span<Type* const> element_types) {
   TypeVec key(element_types.begin(), element_types.end());
-  if (tuple_types_.find(key) != tuple_types_.end()) {
-    return &tuple_types_.at(key);
+  {
+    absl::ReaderMutexLock lock(mu_.get());
+    auto it = tuple_types_.find(key);
+    if (it != tuple_types_.end()) {
+      return &it->second;
+    }
   }
+  absl::MutexLock lock(mu_.get());
   for (const Type* element_type : element_types) {
-    CHECK(IsOwnedType(element_type))
+    CHECK(owned_types_.contains(element_type))
         << "Type is not owned by package: " << *element_type;
   }
-  auto it = tuple_types_.emplace(key, TupleType(element_types));
-  TupleType* new_type = &(it.first->second);
-  owned_types_.insert(new_type);
+  auto [it, inserted] = tuple_types_.try_emplace(key, TupleType(element_types));
+  TupleType* new_type = &it->second;
+  if (inserted) {
+    owned_types_.insert(new_type);
+  }
   return new_type;
 }
 
@@ -115,12 +139,13 @@ absl::StatusOr<Type*> TypeManager::MapTypeFromOtherArena(
 FunctionType* TypeManager::GetFunctionType(absl::Span<Type* const> args_types,
                                            Type* return_type) {
   std::string key = FunctionType(args_types, return_type).ToString();
+  absl::MutexLock lock(mu_.get());
   if (function_types_.find(key) != function_types_.end()) {
     return &function_types_.at(key);
   }
   for (Type* t : args_types) {
-    CHECK(IsOwnedType(t)) << "Parameter type is not owned by package: "
-                          << t->ToString();
+    CHECK(owned_types_.contains(t))
+        << "Parameter type is not owned by package: " << t->ToString();
   }
   auto it = function_types_.emplace(key, FunctionType(args_types, return_type));
   FunctionType* new_type = &(it.first->second);
@@ -24,6 +24,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/ir/type.h"
 #include "xls/ir/value.h"
@@ -31,6 +32,9 @@
 
 namespace xls {
 
+// Owns and interns the types of a package. Lookups and insertions are
+// thread-safe so nodes may be created in different FunctionBases of the same
+// package concurrently.
 class TypeManager {
  public:
   explicit TypeManager();
@@ -42,9 +46,11 @@ class TypeManager {
   TypeManager& operator=(const TypeManager&) = delete;
   // Returns whether the given type is one of the types owned by this package.
   bool IsOwnedType(const Type* type) const {
+    absl::ReaderMutexLock lock(mu_.get());
     return owned_types_.find(type) != owned_types_.end();
   }
   bool IsOwnedFunctionType(const FunctionType* function_type) const {
+    absl::ReaderMutexLock lock(mu_.get());
     return owned_function_types_.find(function_type) !=
            owned_function_types_.end();
   }
@@ -67,6 +73,10 @@ class TypeManager {
   Type* GetTypeForValue(const Value& value);
 
  private:
+  // Guards all of the type tables below. Held by pointer to keep the type
+  // manager movable.
+  std::unique_ptr<absl::Mutex> mu_ = std::make_unique<absl::Mutex>();
+
   // Set of owned types in this package.
   absl::flat_hash_set<const Type*> owned_types_;
 
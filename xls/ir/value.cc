@@ -14,8 +14,10 @@
 
 #include "xls/ir/value.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
 #include <variant>
@@ -42,6 +44,37 @@
 
 namespace xls {
 
+Value::Value(ValueKind kind, absl::Span<const Value> elements)
+    : kind_(kind) {
+  Elements shared;
+  if (!elements.empty()) {
+    shared = Elements(std::make_shared<Value[]>(elements.size()),
+                      elements.size());
+    std::copy(elements.begin(), elements.end(), shared.data.get());
+  }
+  payload_ = std::move(shared);
+}
+
+Value::Value(ValueKind kind, std::vector<Value>&& elements) : kind_(kind) {
+  Elements shared;
+  if (!elements.empty()) {
+    shared = Elements(std::make_shared<Value[]>(elements.size()),
+                      elements.size());
+    std::move(elements.begin(), elements.end(), shared.data.get());
+  }
+  payload_ = std::move(shared);
+}
+
+absl::Span<Value> Value::MutableElements() {
+  Elements& elements = std::get<Elements>(payload_);
+  if (elements.data != nullptr && elements.data.use_count() != 1) {
+    auto data = std::make_shared<Value[]>(elements.size);
+    absl::c_copy(elements.span(), data.get());
+    elements.data = std::move(data);
+  }
+  return absl::MakeSpan(elements.data.get(), elements.size);
+}
+
 /* static */ absl::StatusOr<Value> Value::Array(
     absl::Span<const Value> elements) {
   if (elements.empty()) {
@@ -269,7 +302,11 @@ absl::Status Value::PopulateFrom(BitmapView bitmap) {
       //
       // Here we iterate through values in reverse order so that the bit slicing
       // can ascend from least significant bit up to most significant bit.
-      auto& values = std::get<std::vector<Value>>(payload_);
+      if (elements().empty()) {
+        XLS_RET_CHECK_EQ(bitmap.bit_count(), 0);
+        return absl::OkStatus();
+      }
+      absl::Span<Value> values = MutableElements();
       int64_t bit_index = 0;
       for (int64_t i = values.size() - 1; i >= 0; --i) {
         int64_t element_bit_count = values[i].GetFlatBitCount();
@@ -290,7 +327,7 @@ absl::Status Value::PopulateFrom(BitmapView bitmap) {
 }
 
 absl::StatusOr<std::vector<Value>> Value::GetElements() const {
-  if (!std::holds_alternative<std::vector<Value>>(payload_)) {
+  if (!std::holds_alternative<Elements>(payload_)) {
     return absl::InvalidArgumentError("Value does not hold elements.");
   }
   return std::vector<Value>(elements().begin(), elements().end());
@@ -504,6 +541,14 @@ bool Value::operator==(const Value& other) const {
     return bits() == other.bits();
   }
 
+  // Copies of the same aggregate share their elements.
+  if (std::holds_alternative<Elements>(payload_) &&
+      std::holds_alternative<Elements>(other.payload_) &&
+      std::get<Elements>(payload_).data ==
+          std::get<Elements>(other.payload_).data) {
+    return true;
+  }
+
   // All non-Bits types are container types -- should have a size attribute.
   if (size() != other.size()) {
     return false;
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -63,6 +64,10 @@ inline std::ostream& operator<<(std::ostream& os, ValueKind kind) {
 // values, or arrays or values. Arrays are represented similarly to tuples, but
 // are monomorphic and potentially multi-dimensional.
 //
+// Bits values of up to 64 bits are stored inline. The elements of tuples and
+// arrays are immutable and shared between copies of a Value, so copying an
+// aggregate is constant time regardless of its size.
+//
 // TODO(leary): 2019-04-04 Arrays are not currently multi-dimensional, we had
 // some discussion around this, maybe they should be?
 class Value {
@@ -109,9 +114,7 @@ class Value {
     return Value(ValueKind::kArray, std::move(elements));
   }
 
-  static Value Token() {
-    return Value(ValueKind::kToken, std::vector<Value>({}));
-  }
+  static Value Token() { return Value(ValueKind::kToken, Elements()); }
   static Value Bool(bool enabled) {
     return Value(
         UBits(/*value=*/static_cast<uint64_t>(enabled), /*bit_count=*/1));
@@ -150,7 +153,7 @@ class Value {
   absl::StatusOr<std::vector<Value>> GetElements() const;
 
   absl::Span<const Value> elements() const {
-    return std::get<std::vector<Value>>(payload_);
+    return std::get<Elements>(payload_).span();
   }
   const Value& element(int64_t i) const { return elements().at(i); }
   int64_t size() const { return elements().size(); }
@@ -235,19 +238,54 @@ class Value {
 
   template <typename H>
   friend H AbslHashValue(H h, const Value& v) {
-    return H::combine(std::move(h), v.kind_, v.payload_);
+    if (v.IsBits()) {
+      return H::combine(std::move(h), v.kind_, v.bits());
+    }
+    if (std::holds_alternative<Elements>(v.payload_)) {
+      return H::combine(std::move(h), v.kind_, v.elements());
+    }
+    return H::combine(std::move(h), v.kind_);
   }
 
  private:
-  Value(ValueKind kind, absl::Span<const Value> elements)
-      : kind_(kind),
-        payload_(std::vector<Value>(elements.begin(), elements.end())) {}
+  // Elements of a tuple, array or token. These are stored in a single
+  // allocation which is shared between copies and must only be modified
+  // through MutableElements. No elements are allocated for empty aggregates
+  // and tokens, which is also the state an aggregate is left in when moved
+  // from.
+  struct Elements {
+    Elements() = default;
+    Elements(std::shared_ptr<Value[]> data, int64_t size)
+        : data(std::move(data)), size(size) {}
+    Elements(const Elements& other) = default;
+    Elements& operator=(const Elements& other) = default;
+    Elements(Elements&& other) noexcept
+        : data(std::move(other.data)), size(std::exchange(other.size, 0)) {}
+    Elements& operator=(Elements&& other) noexcept {
+      data = std::move(other.data);
+      size = std::exchange(other.size, 0);
+      return *this;
+    }
+
+    absl::Span<const Value> span() const {
+      return absl::MakeConstSpan(data.get(), size);
+    }
 
-  Value(ValueKind kind, std::vector<Value>&& elements)
+    std::shared_ptr<Value[]> data;
+    int64_t size = 0;
+  };
+
+  Value(ValueKind kind, absl::Span<const Value> elements);
+  Value(ValueKind kind, std::vector<Value>&& elements);
+  Value(ValueKind kind, Elements elements)
       : kind_(kind), payload_(std::move(elements)) {}
 
+  // Returns the elements of this value for modification, first copying them if
+  // they are shared with another value.
+  absl::Span<Value> MutableElements();
+
   ValueKind kind_;
-  std::variant<std::nullptr_t, std::vector<Value>, Bits> payload_;
+  std::variant<std::nullptr_t, Elements, Bits> payload_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Value& value) {
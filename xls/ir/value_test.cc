@@ -17,10 +17,15 @@
 #include <cstdint>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
+#include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "xls/common/fuzzing/fuzztest.h"
+#include "absl/hash/hash.h"
+#include "absl/hash/hash_testing.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
@@ -708,6 +713,55 @@ TEST(ValueTest, CanPopulateTokenFromEmptyBitmap) {
   EXPECT_EQ(v, v2);
 }
 
+TEST(ValueTest, PopulateFromDoesNotModifyCopies) {
+  Value original = Value::Tuple(
+      {Value(UBits(1, 8)), Value::ArrayOrDie({Value(UBits(2, 4))})});
+  Value copy = original;
+  EXPECT_EQ(copy, original);
+
+  Value replacement = Value::Tuple(
+      {Value(UBits(3, 8)), Value::ArrayOrDie({Value(UBits(4, 4))})});
+  BitPushBuffer push_buffer;
+  replacement.FlattenTo(&push_buffer);
+  InlineBitmap bitmap = push_buffer.ToBitmap();
+  XLS_ASSERT_OK(copy.PopulateFrom(BitmapView(bitmap)));
+  EXPECT_EQ(copy, replacement);
+  EXPECT_EQ(original.element(0), Value(UBits(1, 8)));
+  EXPECT_EQ(original.element(1).element(0), Value(UBits(2, 4)));
+}
+
+TEST(ValueTest, MovedFromAggregateIsEmpty) {
+  Value tuple = Value::Tuple({Value(UBits(1, 8)), Value(UBits(2, 8))});
+  Value moved = std::move(tuple);
+  EXPECT_EQ(moved.size(), 2);
+  // NOLINTBEGIN(bugprone-use-after-move)
+  EXPECT_TRUE(tuple.IsTuple());
+  EXPECT_EQ(tuple.size(), 0);
+  EXPECT_EQ(tuple, Value::Tuple({}));
+  EXPECT_EQ(absl::HashOf(tuple), absl::HashOf(Value::Tuple({})));
+
+  Value array = Value::ArrayOrDie({Value(UBits(3, 8))});
+  moved = std::move(array);
+  EXPECT_EQ(moved, Value::ArrayOrDie({Value(UBits(3, 8))}));
+  EXPECT_TRUE(array.elements().empty());
+  // NOLINTEND(bugprone-use-after-move)
+}
+
+TEST(ValueTest, Hash) {
+  EXPECT_TRUE(absl::VerifyTypeImplementsAbslHashCorrectly({
+      Value::Token(),
+      Value(UBits(0, 0)),
+      Value(UBits(1, 8)),
+      Value(UBits(2, 8)),
+      Value(Bits::AllOnes(100)),
+      Value::Tuple({}),
+      Value::Tuple({Value(UBits(1, 8))}),
+      Value::Tuple({Value(UBits(1, 8)), Value::Tuple({})}),
+      Value::ArrayOrDie({Value(UBits(1, 8))}),
+      Value::ArrayOrDie({Value(UBits(1, 8)), Value(UBits(2, 8))}),
+  }));
+}
+
 void ProtoValueRoundTripWorks(const ValueProto& v) {
   auto value = Value::FromProto(v, /*max_bit_size=*/1 << 16);
   if (!value.ok()) {
@@ -820,6 +874,21 @@ TEST(ValueTest, FuzzTestPrintSourceCode) {
             "Value::TupleOwned({Value(Bits::AllOnes(300))})");
 }
 
+// Benchmark of copying an array of `state.range(0)` tuples.
+void BM_CopyArrayOfTuples(benchmark::State& state) {
+  std::vector<Value> elements;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    elements.push_back(Value::Tuple({Value(UBits(i, 32)), Value(UBits(i, 8))}));
+  }
+  Value array = Value::ArrayOrDie(elements);
+  for (auto _ : state) {
+    Value copy = array;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+
+BENCHMARK(BM_CopyArrayOfTuples)->Range(1, 1024);
+
 }  // namespace
 
 }  // namespace xls
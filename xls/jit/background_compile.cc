@@ -0,0 +1,121 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/background_compile.h"
+
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xls/common/thread.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/jit/observer.h"
+
+namespace xls {
+namespace {
+
+class BackgroundThreads {
+ public:
+  ~BackgroundThreads() {
+    absl::MutexLock lock(&mu_);
+    for (Entry& entry : threads_) {
+      entry.thread->Join();
+    }
+  }
+
+  void Run(std::function<void()> fn) {
+    absl::MutexLock lock(&mu_);
+    // Reap the threads which have finished so the list stays short.
+    std::erase_if(threads_, [](Entry& entry) {
+      if (!entry.done->HasBeenNotified()) {
+        return false;
+      }
+      entry.thread->Join();
+      return true;
+    });
+    auto done = std::make_shared<absl::Notification>();
+    threads_.push_back(Entry{
+        .thread = std::make_unique<Thread>([fn = std::move(fn), done]() {
+          fn();
+          done->Notify();
+        }),
+        .done = done});
+  }
+
+ private:
+  struct Entry {
+    std::unique_ptr<Thread> thread;
+    std::shared_ptr<absl::Notification> done;
+  };
+
+  absl::Mutex mu_;
+  std::vector<Entry> threads_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+void RunInBackground(std::function<void()> fn) {
+  // Constructed on first use, i.e., after the statics used by the compiler, so
+  // it is destroyed (and joins its threads) before them.
+  static BackgroundThreads threads;
+  threads.Run(std::move(fn));
+}
+
+absl::StatusOr<std::unique_ptr<Package>> CopyPackageForBackgroundCompile(
+    const Package* package) {
+  // Unlike ClonePackage, a round trip through the IR text preserves node ids.
+  return Parser::ParsePackage(package->DumpIr());
+}
+
+void DetachableJitObserver::Detach() {
+  absl::MutexLock lock(&mu_);
+  observer_ = nullptr;
+}
+
+JitObserverRequests DetachableJitObserver::GetNotificationOptions() const {
+  absl::MutexLock lock(&mu_);
+  return observer_ == nullptr ? JitObserverRequests{}
+                              : observer_->GetNotificationOptions();
+}
+
+void DetachableJitObserver::UnoptimizedModule(const llvm::Module* module) {
+  absl::MutexLock lock(&mu_);
+  if (observer_ != nullptr) {
+    observer_->UnoptimizedModule(module);
+  }
+}
+
+void DetachableJitObserver::OptimizedModule(const llvm::Module* module) {
+  absl::MutexLock lock(&mu_);
+  if (observer_ != nullptr) {
+    observer_->OptimizedModule(module);
+  }
+}
+
+void DetachableJitObserver::AssemblyCodeString(const llvm::Module* module,
+                                               std::string_view asm_code) {
+  absl::MutexLock lock(&mu_);
+  if (observer_ != nullptr) {
+    observer_->AssemblyCodeString(module, asm_code);
+  }
+}
+
+}  // namespace xls
@@ -0,0 +1,69 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_BACKGROUND_COMPILE_H_
+#define XLS_JIT_BACKGROUND_COMPILE_H_
+
+#include <functional>
+#include <memory>
+#include <string_view>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/ir/package.h"
+#include "xls/jit/observer.h"
+
+namespace xls {
+
+// Utilities for JIT compiling in a background thread which may outlive the
+// evaluator which started it (see TieredProcEvaluator and
+// SwitchableFunctionJit). Everything such a compilation touches must be owned
+// by the compilation itself.
+
+// Runs `fn` in a thread owned by the process rather than by the caller so the
+// caller need not wait for `fn` to complete. Threads which are still running at
+// exit are joined when static objects are destroyed.
+void RunInBackground(std::function<void()> fn);
+
+// Returns a copy of `package` for a background compilation to own. Node ids
+// are preserved so code compiled from the copy may be used with the original.
+absl::StatusOr<std::unique_ptr<Package>> CopyPackageForBackgroundCompile(
+    const Package* package);
+
+// A JIT observer which forwards notifications to a caller-owned observer until
+// detached.
+class DetachableJitObserver final : public JitObserver {
+ public:
+  explicit DetachableJitObserver(JitObserver* observer)
+      : observer_(observer) {}
+
+  // Stops forwarding notifications. Waits for any notification in progress to
+  // complete so `observer` may be destroyed as soon as this returns.
+  void Detach();
+
+  JitObserverRequests GetNotificationOptions() const final;
+  void UnoptimizedModule(const llvm::Module* module) final;
+  void OptimizedModule(const llvm::Module* module) final;
+  void AssemblyCodeString(const llvm::Module* module,
+                          std::string_view asm_code) final;
+
+ private:
+  mutable absl::Mutex mu_;
+  JitObserver* observer_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_BACKGROUND_COMPILE_H_
@@ -0,0 +1,138 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "xls/common/benchmark_support.h"
+#include "xls/common/init_xls.h"
+#include "xls/interpreter/block_evaluator.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/block.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+#include "xls/ir/register.h"
+#include "xls/ir/value.h"
+#include "xls/jit/block_jit.h"
+#include "xls/jit/function_jit.h"
+
+namespace xls {
+namespace {
+
+// Measures the batch APIs of the JIT against evaluating the same invocations
+// (instances) one call at a time.
+
+constexpr int64_t kBatchSize = 4096;
+
+// Evaluates a batch of `kBatchSize` invocations of a narrow function.
+// `state.range(0)` is the number of threads.
+static void BM_FunctionJitBatch(benchmark::State& state) {
+  Package package("BM");
+  FunctionBuilder fb("f", &package);
+  BValue x = fb.Param("x", package.GetBitsType(16));
+  BValue y = fb.Param("y", package.GetBitsType(8));
+  fb.Add(fb.UMul(x, fb.ZeroExtend(y, 16)), fb.Literal(UBits(7, 16)));
+  Function* function = fb.Build().value();
+  std::unique_ptr<FunctionJit> jit = FunctionJit::Create(function).value();
+  int64_t args_size = jit->GetPackedArgsSize();
+  int64_t result_size = jit->GetPackedReturnTypeSize();
+  std::vector<uint8_t> args(kBatchSize * args_size);
+  for (int64_t i = 0; i < args.size(); ++i) {
+    args[i] = static_cast<uint8_t>(i * 7);
+  }
+  std::vector<uint8_t> results(kBatchSize * result_size);
+  for (auto _ : state) {
+    CHECK_OK(jit->RunBatchWithPackedViews(kBatchSize, args,
+                                          absl::MakeSpan(results),
+                                          /*thread_count=*/state.range(0)));
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+// Returns a block with a 16-bit accumulator register which adds its input
+// port on every cycle.
+static Block* BuildAccumulator(Package* package) {
+  BlockBuilder bb("accumulator", package);
+  CHECK_OK(bb.block()->AddClockPort("clk"));
+  Register* acc =
+      bb.block()->AddRegister("acc", package->GetBitsType(16)).value();
+  BValue x = bb.InputPort("x", package->GetBitsType(16));
+  BValue acc_read = bb.RegisterRead(acc);
+  bb.RegisterWrite(acc, bb.Add(acc_read, x));
+  bb.OutputPort("out", acc_read);
+  return bb.Build().value();
+}
+
+// Cycles `kBatchSize` instances of a block once, each with its own
+// continuation.
+static void BM_BlockJitSeparateContinuations(benchmark::State& state) {
+  Package package("BM");
+  Block* block = BuildAccumulator(&package);
+  std::unique_ptr<BlockJit> jit = BlockJit::Create(block).value();
+  std::vector<std::unique_ptr<BlockJitContinuation>> continuations;
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    continuations.push_back(jit->NewContinuation(
+        BlockEvaluator::OutputPortSampleTime::kAtLastPosEdgeClock));
+    CHECK_OK(continuations.back()->SetInputPorts({Value(UBits(i, 16))}));
+  }
+  for (auto _ : state) {
+    for (std::unique_ptr<BlockJitContinuation>& continuation : continuations) {
+      CHECK_OK(jit->RunOneCycle(*continuation));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+// Cycles `kBatchSize` instances of a block once with a multi-instance
+// continuation on the calling thread.
+static void BM_BlockJitMultiInstance(benchmark::State& state) {
+  Package package("BM");
+  Block* block = BuildAccumulator(&package);
+  std::unique_ptr<BlockJit> jit = BlockJit::Create(block).value();
+  std::unique_ptr<MultiInstanceBlockJitContinuation> continuation =
+      jit->NewMultiInstanceContinuation(
+             kBatchSize,
+             BlockEvaluator::OutputPortSampleTime::kAtLastPosEdgeClock)
+          .value();
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    CHECK_OK(continuation->SetInputPorts(i, {Value(UBits(i, 16))}));
+  }
+  for (auto _ : state) {
+    CHECK_OK(jit->RunCycles(
+        *continuation, /*cycle_count=*/1,
+        [](int64_t, int64_t, int64_t) { return absl::OkStatus(); },
+        /*thread_count=*/1));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+BENCHMARK(BM_FunctionJitBatch)->Arg(1)->Arg(4);
+BENCHMARK(BM_BlockJitSeparateContinuations);
+BENCHMARK(BM_BlockJitMultiInstance);
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RunSpecifiedBenchmarks(/*default_spec=*/"all");
+  return 0;
+}
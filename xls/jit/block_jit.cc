@@ -14,6 +14,8 @@
 
 #include "xls/jit/block_jit.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <iterator>
@@ -27,6 +29,7 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
@@ -37,8 +40,10 @@
 #include "xls/codegen/codegen_options.h"
 #include "xls/codegen/codegen_pass.h"
 #include "xls/codegen/maybe_materialize_fifos_pass.h"
+#include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/interpreter/block_evaluator.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/interpreter/observer.h"
@@ -72,6 +77,27 @@ namespace xls {
 
 namespace {
 
+// Minimum number of instances cycled by each shard of BlockJit::RunCycles.
+// Smaller shards do not amortize the cost of handing them to the thread pool.
+constexpr int64_t kMinInstanceShardSize = 64;
+
+// Distance in bytes between the values of consecutive instances in the arrays
+// of a MultiInstanceBlockJitContinuation.
+int64_t InstanceStride(const TypeBufferMetadata& metadata) {
+  return RoundUpToNearest(metadata.size, metadata.preferred_alignment);
+}
+
+// Advances each of the given element pointers to the value of the next
+// instance. Null pointers (elements with no storage) are left unchanged.
+void AdvanceElementPointers(absl::Span<const int64_t> strides,
+                            std::vector<uint8_t*>& pointers) {
+  for (int64_t i = 0; i < pointers.size(); ++i) {
+    if (pointers[i] != nullptr) {
+      pointers[i] += strides[i];
+    }
+  }
+}
+
 class CheckNoInstantiationsOnTop : public verilog::CodegenPass {
  public:
   CheckNoInstantiationsOnTop()
@@ -531,6 +557,106 @@ absl::Status BlockJit::RunOneCycle(BlockJitContinuation& continuation) {
   return absl::OkStatus();
 }
 
+absl::StatusOr<std::unique_ptr<MultiInstanceBlockJitContinuation>>
+BlockJit::NewMultiInstanceContinuation(
+    int64_t instance_count, BlockEvaluator::OutputPortSampleTime sample_time) {
+  XLS_RET_CHECK_GE(instance_count, 0);
+  if (!GetExtraRegisterWriteBufferMetadata().empty()) {
+    return absl::UnimplementedError(
+        "Multi-instance continuations do not support registers with multiple "
+        "writes");
+  }
+  return std::unique_ptr<MultiInstanceBlockJitContinuation>(
+      new MultiInstanceBlockJitContinuation(metadata_, this, function_,
+                                            instance_count, sample_time));
+}
+
+absl::Status BlockJit::RunOneCycle(
+    MultiInstanceBlockJitContinuation& continuation) {
+  XLS_RETURN_IF_ERROR(RunInstanceShard(
+      continuation, 0, continuation.instance_count(), /*cycle_count=*/1,
+      /*drive_inputs=*/std::nullopt, continuation.events_));
+  continuation.arg_set_index_ ^= 1;
+  return absl::OkStatus();
+}
+
+absl::Status BlockJit::RunCycles(
+    MultiInstanceBlockJitContinuation& continuation, int64_t cycle_count,
+    InstanceRangeCallback drive_inputs, int64_t thread_count) {
+  XLS_RET_CHECK_GE(cycle_count, 0);
+  XLS_RET_CHECK_GE(thread_count, 0);
+  int64_t instance_count = continuation.instance_count();
+  int64_t shard_count =
+      thread_count == 0 ? DefaultThreadCount() : thread_count;
+  shard_count = std::clamp<int64_t>(
+      shard_count, 1,
+      std::max<int64_t>(1, instance_count / kMinInstanceShardSize));
+  auto shard_start = [&](int64_t shard) {
+    return instance_count * shard / shard_count;
+  };
+  std::vector<InterpreterEvents> events(shard_count);
+  absl::Status status = DefaultThreadPool().ParallelFor(
+      shard_count, [&](int64_t shard) {
+        return RunInstanceShard(continuation, shard_start(shard),
+                                shard_start(shard + 1), cycle_count,
+                                drive_inputs, events[shard]);
+      });
+  // Every shard ran the same number of cycles so the register values of all
+  // instances are in the same set.
+  continuation.arg_set_index_ ^= cycle_count % 2;
+  for (int64_t shard = 0; shard < shard_count; ++shard) {
+    continuation.events_.AppendFrom(events[shard]);
+  }
+  return status;
+}
+
+absl::Status BlockJit::RunInstanceShard(
+    MultiInstanceBlockJitContinuation& continuation, int64_t first,
+    int64_t last, int64_t cycle_count,
+    std::optional<InstanceRangeCallback> drive_inputs,
+    InterpreterEvents& events) {
+  // The instance context holds mutable state so each shard uses its own.
+  InstanceContext context = InstanceContext::CreateForBlock();
+  JitTempBuffer temp_buffer = function_.CreateTempBuffer();
+  // Evaluates a cycle of every instance of the shard with the given argument
+  // sets, one call of the jitted function per instance. The element pointers
+  // start at instance `first` and are advanced to the next instance after
+  // each call.
+  auto run_instances = [&](absl::Span<uint8_t* const> input_set,
+                           absl::Span<uint8_t* const> output_set,
+                           InterpreterEvents* run_events) {
+    std::vector<uint8_t*> inputs = continuation.ElementPointers(
+        input_set, continuation.input_strides_, first);
+    std::vector<uint8_t*> outputs = continuation.ElementPointers(
+        output_set, continuation.output_strides_, first);
+    for (int64_t instance = first; instance < last; ++instance) {
+      function_.RunUnalignedJittedFunction</*kForceZeroCopy=*/true>(
+          inputs.data(), outputs.data(), temp_buffer.get_base_pointer(),
+          run_events, &context, runtime_.get(), /*continuation=*/0);
+      AdvanceElementPointers(continuation.input_strides_, inputs);
+      AdvanceElementPointers(continuation.output_strides_, outputs);
+    }
+  };
+  int64_t index = continuation.arg_set_index_;
+  for (int64_t cycle = 0; cycle < cycle_count; ++cycle) {
+    if (drive_inputs.has_value()) {
+      XLS_RETURN_IF_ERROR((*drive_inputs)(cycle, first, last));
+    }
+    run_instances(continuation.input_sets_[index],
+                  continuation.output_sets_[index], &events);
+    // The register writes of this cycle are the register reads of the next.
+    index ^= 1;
+    if (continuation.sample_time() ==
+        BlockEvaluator::OutputPortSampleTime::kAfterLastClock) {
+      // Run again to get the output wires.
+      InterpreterEvents fake_events;
+      run_instances(continuation.input_sets_[index],
+                    continuation.after_last_clock_output_set_, &fake_events);
+    }
+  }
+  return absl::OkStatus();
+}
+
 namespace {
 
 // Concatenates the points from `buffers` and returns the resulting vector.
@@ -799,6 +925,204 @@ absl::flat_hash_map<std::string, Value> BlockJitContinuation::GetRegistersMap()
   return result;
 }
 
+namespace {
+
+// Allocates an array holding a value of each of the given buffers for
+// `instance_count` instances. The arrays are zero-initialized.
+JitBuffer AllocateInstanceArrays(absl::Span<const TypeBufferMetadata> metadata,
+                                 int64_t instance_count) {
+  std::vector<TypeBufferMetadata> arrays;
+  arrays.reserve(metadata.size());
+  for (const TypeBufferMetadata& element : metadata) {
+    arrays.push_back(TypeBufferMetadata{
+        .size =
+            InstanceStride(element) * instance_count,
+        .preferred_alignment = element.preferred_alignment,
+        .abi_alignment = element.abi_alignment,
+        .packed_size = element.packed_size * instance_count});
+  }
+  return AllocateAlignedBuffer(arrays, /*zero=*/true);
+}
+
+std::vector<int64_t> ElementStrides(
+    absl::Span<const TypeBufferMetadata> metadata) {
+  std::vector<int64_t> strides;
+  strides.reserve(metadata.size());
+  for (const TypeBufferMetadata& element : metadata) {
+    strides.push_back(InstanceStride(element));
+  }
+  return strides;
+}
+
+}  // namespace
+
+MultiInstanceBlockJitContinuation::MultiInstanceBlockJitContinuation(
+    const BlockJit::InterfaceMetadata& metadata, BlockJit* jit,
+    const JittedFunctionBase& jit_func, int64_t instance_count,
+    OutputPortSampleTime sample_time)
+    : metadata_(metadata),
+      block_jit_(jit),
+      instance_count_(instance_count),
+      sample_time_(sample_time),
+      input_strides_(ElementStrides(jit_func.GetInputBufferMetadata())),
+      output_strides_(ElementStrides(jit_func.GetOutputBufferMetadata())),
+      input_port_arrays_(AllocateInstanceArrays(
+          jit->GetInputPortBufferMetadata(), instance_count)),
+      output_port_arrays_(AllocateInstanceArrays(
+          jit->GetOutputPortBufferMetadata(), instance_count)),
+      register_arrays_({AllocateInstanceArrays(
+                            jit->GetRegisterBufferMetadata(), instance_count),
+                        AllocateInstanceArrays(
+                            jit->GetRegisterBufferMetadata(), instance_count)}),
+      after_last_clock_output_port_arrays_(
+          sample_time == OutputPortSampleTime::kAfterLastClock
+              ? AllocateInstanceArrays(jit->GetOutputPortBufferMetadata(),
+                                       instance_count)
+              : JitBuffer()),
+      scratch_register_arrays_(
+          sample_time == OutputPortSampleTime::kAfterLastClock
+              ? AllocateInstanceArrays(jit->GetRegisterBufferMetadata(),
+                                       instance_count)
+              : JitBuffer()),
+      // The layouts of the sets are those of BlockJitContinuation.
+      input_sets_({ComposeBuffers({&input_port_arrays_, &register_arrays_[0]}),
+                   ComposeBuffers(
+                       {&input_port_arrays_, &register_arrays_[1]})}),
+      output_sets_(
+          {ComposeBuffers({&output_port_arrays_, &register_arrays_[1]}),
+           ComposeBuffers({&output_port_arrays_, &register_arrays_[0]})}),
+      after_last_clock_output_set_(
+          sample_time == OutputPortSampleTime::kAfterLastClock
+              ? ComposeBuffers({&after_last_clock_output_port_arrays_,
+                                &scratch_register_arrays_})
+              : output_sets_[0]) {}
+
+std::vector<uint8_t*> MultiInstanceBlockJitContinuation::ElementPointers(
+    absl::Span<uint8_t* const> arrays, absl::Span<const int64_t> strides,
+    int64_t instance) const {
+  std::vector<uint8_t*> pointers;
+  pointers.reserve(arrays.size());
+  for (int64_t i = 0; i < arrays.size(); ++i) {
+    // Zero-sized arrays have no backing storage.
+    pointers.push_back(arrays[i] == nullptr
+                           ? nullptr
+                           : arrays[i] + instance * strides[i]);
+  }
+  return pointers;
+}
+
+absl::Status MultiInstanceBlockJitContinuation::SetInputPorts(
+    int64_t instance, absl::Span<const Value> values) {
+  XLS_RET_CHECK_LT(instance, instance_count_);
+  XLS_RET_CHECK_EQ(metadata_.InputPortCount(), values.size());
+  for (int64_t i = 0; i < metadata_.InputPortCount(); ++i) {
+    XLS_RET_CHECK(ValueConformsToType(values[i], metadata_.input_port_types[i]))
+        << "input port " << metadata_.input_port_names[i]
+        << " cannot be set to value of " << values[i]
+        << " due to type mismatch with input port type of "
+        << metadata_.input_port_types[i]->ToString();
+  }
+  return block_jit_->runtime()->PackArgs(
+      values, metadata_.input_port_types,
+      absl::MakeConstSpan(ElementPointers(input_sets_[0], input_strides_,
+                                          instance))
+          .subspan(0, metadata_.InputPortCount()));
+}
+
+absl::Status MultiInstanceBlockJitContinuation::SetInputPortOfAllInstances(
+    int64_t port, const Value& value) {
+  XLS_RET_CHECK_LT(port, metadata_.InputPortCount());
+  Type* port_type = metadata_.input_port_types[port];
+  XLS_RET_CHECK(ValueConformsToType(value, port_type))
+      << "input port " << metadata_.input_port_names[port]
+      << " cannot be set to value of " << value
+      << " due to type mismatch with input port type of "
+      << port_type->ToString();
+  if (instance_count_ == 0) {
+    return absl::OkStatus();
+  }
+  int64_t size = block_jit_->GetInputPortBufferMetadata()[port].size;
+  block_jit_->runtime()->BlitValueToBuffer(
+      value, port_type, absl::MakeSpan(input_port_pointer(0, port), size));
+  for (int64_t instance = 1; instance < instance_count_; ++instance) {
+    memcpy(input_port_pointer(instance, port), input_port_pointer(0, port),
+           size);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status MultiInstanceBlockJitContinuation::SetRegisters(
+    int64_t instance, absl::Span<const Value> values) {
+  XLS_RET_CHECK_LT(instance, instance_count_);
+  XLS_RET_CHECK_EQ(metadata_.RegisterCount(), values.size());
+  for (int64_t i = 0; i < metadata_.RegisterCount(); ++i) {
+    XLS_RET_CHECK(ValueConformsToType(values[i], metadata_.register_types[i]))
+        << "register " << metadata_.register_names[i]
+        << " cannot be set to value of " << values[i]
+        << " due to type mismatch with register type of "
+        << metadata_.register_types[i]->ToString();
+  }
+  return block_jit_->runtime()->PackArgs(
+      values, metadata_.register_types,
+      absl::MakeConstSpan(ElementPointers(input_sets_[arg_set_index_],
+                                          input_strides_, instance))
+          .subspan(metadata_.InputPortCount()));
+}
+
+std::vector<Value> MultiInstanceBlockJitContinuation::GetOutputPorts(
+    int64_t instance) const {
+  CHECK_LT(instance, instance_count_);
+  std::vector<Value> result;
+  result.reserve(metadata_.OutputPortCount());
+  for (int64_t i = 0; i < metadata_.OutputPortCount(); ++i) {
+    result.push_back(block_jit_->runtime()->UnpackBuffer(
+        output_port_pointer(instance, i), metadata_.output_port_types[i]));
+  }
+  return result;
+}
+
+std::vector<Value> MultiInstanceBlockJitContinuation::GetRegisters(
+    int64_t instance) const {
+  CHECK_LT(instance, instance_count_);
+  std::vector<Value> result;
+  result.reserve(metadata_.RegisterCount());
+  for (int64_t i = 0; i < metadata_.RegisterCount(); ++i) {
+    result.push_back(block_jit_->runtime()->UnpackBuffer(
+        register_pointer(instance, i), metadata_.register_types[i]));
+  }
+  return result;
+}
+
+absl::flat_hash_map<std::string, int64_t>
+MultiInstanceBlockJitContinuation::GetInputPortIndices() const {
+  absl::flat_hash_map<std::string, int64_t> ret;
+  int i = 0;
+  for (const auto& name : metadata_.input_port_names) {
+    ret[name] = i++;
+  }
+  return ret;
+}
+
+absl::flat_hash_map<std::string, int64_t>
+MultiInstanceBlockJitContinuation::GetOutputPortIndices() const {
+  absl::flat_hash_map<std::string, int64_t> ret;
+  int i = 0;
+  for (const auto& name : metadata_.output_port_names) {
+    ret[name] = i++;
+  }
+  return ret;
+}
+
+absl::flat_hash_map<std::string, int64_t>
+MultiInstanceBlockJitContinuation::GetRegisterIndices() const {
+  absl::flat_hash_map<std::string, int64_t> ret;
+  int i = 0;
+  for (const auto& name : metadata_.register_names) {
+    ret[name] = i++;
+  }
+  return ret;
+}
+
 namespace {
 // Helper adapter to implement the interpreter-focused block-continuation api
 // used by eval_proc_main. This holds live all the values needed to run the
@@ -807,7 +1131,14 @@ class BlockContinuationJitWrapper final : public BlockContinuation {
  public:
   BlockContinuationJitWrapper(std::unique_ptr<BlockJitContinuation>&& cont,
                               std::unique_ptr<BlockJit>&& jit)
-      : continuation_(std::move(cont)), jit_(std::move(jit)) {}
+      : continuation_(std::move(cont)), jit_(std::move(jit)) {
+    // RunOneCyclePacked only writes the packed prefix of bits-typed input
+    // ports so the padding of the native buffers must start out zero.
+    for (int64_t i = 0; i < continuation_->input_port_pointers().size(); ++i) {
+      memset(continuation_->input_port_pointers()[i], 0,
+             jit_->GetInputPortBufferMetadata()[i].size);
+    }
+  }
   JitRuntime* runtime() const { return jit_->runtime(); }
   const absl::flat_hash_map<std::string, Value>& output_ports() final {
     if (!temporary_outputs_) {
@@ -839,6 +1170,51 @@ class BlockContinuationJitWrapper final : public BlockContinuation {
     return continuation_->SetRegisters(regs);
   }
 
+  // Copies the packed port buffers directly to and from the native buffers of
+  // the jitted block. Bits types are laid out identically up to padding so
+  // only aggregate-typed ports go through Values.
+  absl::Status RunOneCyclePacked() final {
+    if (!jit_input_indices_.has_value()) {
+      XLS_RETURN_IF_ERROR(BindPackedPorts());
+    }
+    temporary_outputs_.reset();
+    temporary_regs_.reset();
+    continuation_->ClearEvents();
+
+    const PackedPortBuffer& inputs = packed_inputs();
+    absl::Span<uint8_t* const> input_pointers =
+        continuation_->input_port_pointers();
+    for (int64_t i = 0; i < inputs.port_count(); ++i) {
+      int64_t jit_index = (*jit_input_indices_)[i];
+      if (inputs.port_type(i)->IsBits()) {
+        absl::c_copy(inputs.bytes(i), input_pointers[jit_index]);
+      } else {
+        runtime()->BlitValueToBuffer(
+            inputs.GetValue(i), inputs.port_type(i),
+            absl::MakeSpan(input_pointers[jit_index],
+                           jit_->GetInputPortBufferMetadata()[jit_index].size));
+      }
+    }
+
+    XLS_RETURN_IF_ERROR(jit_->RunOneCycle(*continuation_));
+
+    PackedPortBuffer& outputs = mutable_packed_outputs();
+    absl::Span<uint8_t const* const> output_pointers =
+        continuation_->output_port_pointers();
+    for (int64_t i = 0; i < outputs.port_count(); ++i) {
+      int64_t jit_index = jit_output_indices_[i];
+      if (outputs.port_type(i)->IsBits()) {
+        absl::Span<uint8_t> bytes = outputs.bytes(i);
+        std::copy_n(output_pointers[jit_index], bytes.size(), bytes.begin());
+      } else {
+        XLS_RETURN_IF_ERROR(outputs.SetValue(
+            i, runtime()->UnpackBuffer(output_pointers[jit_index],
+                                       outputs.port_type(i))));
+      }
+    }
+    return absl::OkStatus();
+  }
+
   void ClearObserver() override {
     continuation_->ClearObserver();
     eval_observer_.reset();
@@ -859,8 +1235,35 @@ class BlockContinuationJitWrapper final : public BlockContinuation {
   }
 
  private:
+  // Maps the indices of the packed port buffers to the port indices of the
+  // jitted block.
+  absl::Status BindPackedPorts() {
+    absl::flat_hash_map<std::string, int64_t> input_indices =
+        continuation_->GetInputPortIndices();
+    absl::flat_hash_map<std::string, int64_t> output_indices =
+        continuation_->GetOutputPortIndices();
+    std::vector<int64_t> jit_input_indices;
+    jit_output_indices_.clear();
+    for (const std::string& name : input_port_names()) {
+      auto it = input_indices.find(name);
+      XLS_RET_CHECK(it != input_indices.end()) << "no input port " << name;
+      jit_input_indices.push_back(it->second);
+    }
+    for (const std::string& name : output_port_names()) {
+      auto it = output_indices.find(name);
+      XLS_RET_CHECK(it != output_indices.end()) << "no output port " << name;
+      jit_output_indices_.push_back(it->second);
+    }
+    jit_input_indices_ = std::move(jit_input_indices);
+    return absl::OkStatus();
+  }
+
   std::unique_ptr<BlockJitContinuation> continuation_;
   std::unique_ptr<BlockJit> jit_;
+  // Port indices of the jitted block for each packed input and output port.
+  // Set on the first call to RunOneCyclePacked.
+  std::optional<std::vector<int64_t>> jit_input_indices_;
+  std::vector<int64_t> jit_output_indices_;
   // Holder for the data we return out of output_ports so that we can reduce
   // copying.
   std::optional<absl::flat_hash_map<std::string, Value>> temporary_outputs_;
@@ -19,12 +19,14 @@
 #include <cstdint>
 #include <initializer_list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -51,6 +53,7 @@
 namespace xls {
 
 class BlockJitContinuation;
+class MultiInstanceBlockJitContinuation;
 class BlockJit {
  public:
   struct InterfaceMetadata {
@@ -98,6 +101,36 @@ class BlockJit {
   // Runs a single cycle of a block with the given continuation.
   virtual absl::Status RunOneCycle(BlockJitContinuation& continuation);
 
+  // Creates a continuation holding `instance_count` independent instances of
+  // the block, all starting with zeroed registers and input ports. Blocks
+  // with multiple writes to the same register are not supported.
+  absl::StatusOr<std::unique_ptr<MultiInstanceBlockJitContinuation>>
+  NewMultiInstanceContinuation(
+      int64_t instance_count, BlockEvaluator::OutputPortSampleTime sample_time);
+
+  // Runs a single cycle of every instance of the continuation on the calling
+  // thread.
+  absl::Status RunOneCycle(MultiInstanceBlockJitContinuation& continuation);
+
+  // Called before each cycle of RunCycles with the range of instances
+  // [`first_instance`, `last_instance`) about to be cycled. The callback may
+  // set the input ports and read the output ports (the values of the previous
+  // cycle) of those instances only; it is invoked concurrently for disjoint
+  // ranges and must not touch registers.
+  using InstanceRangeCallback = absl::FunctionRef<absl::Status(
+      int64_t cycle, int64_t first_instance, int64_t last_instance)>;
+
+  // Runs `cycle_count` cycles of every instance of the continuation. The
+  // instances are split into `thread_count` contiguous shards which are run on
+  // DefaultThreadPool() and the calling thread, each shard running all of its
+  // cycles without synchronizing with the others. If `thread_count` is zero
+  // DefaultThreadCount() is used. `drive_inputs` is called before every cycle
+  // of every shard.
+  absl::Status RunCycles(MultiInstanceBlockJitContinuation& continuation,
+                         int64_t cycle_count,
+                         InstanceRangeCallback drive_inputs,
+                         int64_t thread_count = 0);
+
   OrcJit& orc_jit() const { return *jit_; }
 
   JitRuntime* runtime() const { return runtime_.get(); }
@@ -149,6 +182,14 @@ class BlockJit {
   absl::Status ReconcileMultipleRegisterWrites(
       BlockJitContinuation& continuation);
 
+  // Runs `cycle_count` cycles of the instances [`first`, `last`) of the
+  // continuation, appending any events to `events`.
+  absl::Status RunInstanceShard(
+      MultiInstanceBlockJitContinuation& continuation, int64_t first,
+      int64_t last, int64_t cycle_count,
+      std::optional<InstanceRangeCallback> drive_inputs,
+      InterpreterEvents& events);
+
   InterfaceMetadata metadata_;
   std::unique_ptr<JitRuntime> runtime_;
   std::unique_ptr<OrcJit> jit_;
@@ -298,6 +339,111 @@ class BlockJitContinuation {
   friend class BlockJit;
 };
 
+// A continuation holding many independent instances of a block, e.g., one per
+// seed of a randomized testbench, which are cycled together by
+// BlockJit::RunOneCycle/RunCycles. The state is stored as a struct of arrays:
+// each input port, output port and register has a contiguous array holding its
+// native-format value for every instance. This keeps the state of the
+// instances compact and lets threads cycle disjoint ranges of instances
+// independently. Each instance is still evaluated by its own call of the
+// jitted code.
+class MultiInstanceBlockJitContinuation {
+ public:
+  using OutputPortSampleTime = BlockEvaluator::OutputPortSampleTime;
+
+  int64_t instance_count() const { return instance_count_; }
+  OutputPortSampleTime sample_time() const { return sample_time_; }
+
+  // Overwrite all input-ports of the given instance with given values.
+  absl::Status SetInputPorts(int64_t instance, absl::Span<const Value> values);
+  // Overwrite the given input-port of every instance with the given value.
+  absl::Status SetInputPortOfAllInstances(int64_t port, const Value& value);
+  // Overwrite all registers of the given instance with given values.
+  absl::Status SetRegisters(int64_t instance, absl::Span<const Value> values);
+
+  std::vector<Value> GetOutputPorts(int64_t instance) const;
+  std::vector<Value> GetRegisters(int64_t instance) const;
+
+  absl::flat_hash_map<std::string, int64_t> GetInputPortIndices() const;
+  absl::flat_hash_map<std::string, int64_t> GetOutputPortIndices() const;
+  absl::flat_hash_map<std::string, int64_t> GetRegisterIndices() const;
+
+  // Gets a pointer to the native-format value of the given input port of the
+  // given instance. Write to the pointed to memory to set the input port for
+  // the next cycle.
+  uint8_t* input_port_pointer(int64_t instance, int64_t port) const {
+    return input_sets_[0][port] + instance * input_strides_[port];
+  }
+  // Gets a pointer to the native-format value of the given register of the
+  // given instance.
+  uint8_t* register_pointer(int64_t instance, int64_t reg) const {
+    int64_t element = metadata_.InputPortCount() + reg;
+    return input_sets_[arg_set_index_][element] +
+           instance * input_strides_[element];
+  }
+  // Gets a pointer to the native-format value of the given output port of the
+  // given instance.
+  const uint8_t* output_port_pointer(int64_t instance, int64_t port) const {
+    const std::vector<uint8_t*>& outputs =
+        sample_time_ == OutputPortSampleTime::kAfterLastClock
+            ? after_last_clock_output_set_
+            : output_sets_[0];
+    return outputs[port] + instance * output_strides_[port];
+  }
+
+  // Events raised by any of the instances. They are not attributed to the
+  // instance which raised them.
+  const InterpreterEvents& GetEvents() const { return events_; }
+  InterpreterEvents& GetEvents() { return events_; }
+  void ClearEvents() { events_.Clear(); }
+
+ private:
+  MultiInstanceBlockJitContinuation(const BlockJit::InterfaceMetadata& metadata,
+                                    BlockJit* jit,
+                                    const JittedFunctionBase& jit_func,
+                                    int64_t instance_count,
+                                    OutputPortSampleTime sample_time);
+
+  // Returns the given element pointers advanced to instance `instance`.
+  std::vector<uint8_t*> ElementPointers(absl::Span<uint8_t* const> arrays,
+                                        absl::Span<const int64_t> strides,
+                                        int64_t instance) const;
+
+  const BlockJit::InterfaceMetadata& metadata_;
+  BlockJit* block_jit_;
+  int64_t instance_count_;
+  OutputPortSampleTime sample_time_;
+
+  // Distance between the values of consecutive instances for each input
+  // (ports then registers) and output (ports then registers) of the jitted
+  // function.
+  std::vector<int64_t> input_strides_;
+  std::vector<int64_t> output_strides_;
+
+  // Backing arrays of the argument sets. As in BlockJitContinuation the
+  // register arrays are ping-ponged between the input and output sets. The
+  // register outputs of the second run of kAfterLastClock are written to
+  // `scratch_register_arrays_` and discarded.
+  JitBuffer input_port_arrays_;
+  JitBuffer output_port_arrays_;
+  std::array<JitBuffer, 2> register_arrays_;
+  JitBuffer after_last_clock_output_port_arrays_;
+  JitBuffer scratch_register_arrays_;
+
+  // The base of each array of the argument sets.
+  std::array<std::vector<uint8_t*>, 2> input_sets_;
+  std::array<std::vector<uint8_t*>, 2> output_sets_;
+  std::vector<uint8_t*> after_last_clock_output_set_;
+
+  // Which of the two sets in input_sets_/output_sets_ holds the current
+  // register values. This index alternates between 0 and 1.
+  int64_t arg_set_index_ = 0;
+
+  InterpreterEvents events_;
+
+  friend class BlockJit;
+};
+
 // A jit block evaluator that tries to use the jit's register saving as
 // possible.
 class JitBlockEvaluator : public BlockEvaluator {
@@ -15,6 +15,7 @@
 #include "xls/jit/block_jit.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <string>
@@ -401,6 +402,74 @@ TEST_F(BlockJitTest, RegistersAreInitiallyZero) {
               UnorderedElementsAre(Pair("test1", Value(UBits(1234, 16)))));
 }
 
+TEST_F(BlockJitTest, MultiInstanceContinuation) {
+  auto p = CreatePackage();
+  BlockBuilder bb(TestName(), p.get());
+  XLS_ASSERT_OK(bb.block()->AddClockPort("clk"));
+  XLS_ASSERT_OK_AND_ASSIGN(auto acc,
+                           bb.block()->AddRegister("acc", p->GetBitsType(16)));
+  BValue x = bb.InputPort("x", p->GetBitsType(16));
+  BValue acc_read = bb.RegisterRead(acc);
+  bb.RegisterWrite(acc, bb.Add(acc_read, x));
+  bb.OutputPort("out", acc_read);
+  XLS_ASSERT_OK_AND_ASSIGN(Block * b, bb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(b));
+
+  constexpr int64_t kInstanceCount = 201;
+  for (auto sample_time : {kAtLastPosEdgeClock, kAfterLastClock}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        auto cont, jit->NewMultiInstanceContinuation(kInstanceCount,
+                                                     sample_time));
+    for (int64_t i = 0; i < kInstanceCount; ++i) {
+      XLS_ASSERT_OK(cont->SetRegisters(i, {Value(UBits(i, 16))}));
+    }
+    // Instance i accumulates 3 * i + cycle on each cycle.
+    XLS_ASSERT_OK(jit->RunCycles(
+        *cont, /*cycle_count=*/5,
+        [&](int64_t cycle, int64_t first, int64_t last) -> absl::Status {
+          for (int64_t i = first; i < last; ++i) {
+            uint16_t value = 3 * i + cycle;
+            memcpy(cont->input_port_pointer(i, 0), &value, sizeof(value));
+          }
+          return absl::OkStatus();
+        },
+        /*thread_count=*/3));
+    for (int64_t i = 0; i < kInstanceCount; ++i) {
+      EXPECT_THAT(cont->GetRegisters(i), ElementsAre(Value(UBits(
+                                             (16 * i + 10) & 0xffff, 16))));
+      int64_t out = sample_time == kAfterLastClock ? 16 * i + 10 : 13 * i + 6;
+      EXPECT_THAT(cont->GetOutputPorts(i),
+                  ElementsAre(Value(UBits(out & 0xffff, 16))));
+    }
+
+    XLS_ASSERT_OK(cont->SetInputPortOfAllInstances(0, Value(UBits(1, 16))));
+    XLS_ASSERT_OK(jit->RunOneCycle(*cont));
+    for (int64_t i = 0; i < kInstanceCount; ++i) {
+      EXPECT_THAT(cont->GetRegisters(i), ElementsAre(Value(UBits(
+                                             (16 * i + 11) & 0xffff, 16))));
+    }
+  }
+}
+
+TEST_F(BlockJitTest, MultiInstanceContinuationWithoutRegisters) {
+  auto p = CreatePackage();
+  BlockBuilder bb(TestName(), p.get());
+  BValue in = bb.InputPort("in", p->GetBitsType(8));
+  bb.OutputPort("out", bb.Add(in, bb.Literal(UBits(1, 8))));
+  XLS_ASSERT_OK_AND_ASSIGN(Block * b, bb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, BlockJit::Create(b));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto cont, jit->NewMultiInstanceContinuation(4, kAtLastPosEdgeClock));
+  for (int64_t i = 0; i < 4; ++i) {
+    XLS_ASSERT_OK(cont->SetInputPorts(i, {Value(UBits(10 * i, 8))}));
+  }
+  XLS_ASSERT_OK(jit->RunOneCycle(*cont));
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_THAT(cont->GetOutputPorts(i),
+                ElementsAre(Value(UBits(10 * i + 1, 8))));
+  }
+}
+
 struct RegInput {
   uint32_t data;
   bool load_enable;
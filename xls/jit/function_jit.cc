@@ -14,6 +14,7 @@
 
 #include "xls/jit/function_jit.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -32,6 +33,7 @@
 #include "llvm/include/llvm/Support/Error.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/ir/events.h"
 #include "xls/ir/function.h"
@@ -45,11 +47,21 @@
 #include "xls/jit/aot_compiler.h"
 #include "xls/jit/aot_entrypoint.pb.h"
 #include "xls/jit/function_base_jit.h"
+#include "xls/jit/jit_buffer.h"
+#include "xls/jit/jit_callbacks.h"
 #include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/jit_object_cache.h"
 #include "xls/jit/jit_runtime.h"
 #include "xls/jit/orc_jit.h"
 
 namespace xls {
+namespace {
+
+// Minimum number of invocations evaluated by each shard of a batched run.
+// Smaller shards do not amortize the cost of handing them to the thread pool.
+constexpr int64_t kMinBatchShardSize = 1024;
+
+}  // namespace
 
 absl::StatusOr<FunctionJit::InterfaceMetadata>
 FunctionJit::InterfaceMetadata::CreateFromFunction(Function* function) {
@@ -154,10 +166,35 @@ absl::StatusOr<JitObjectCode> FunctionJit::CreateObjectCode(
 absl::StatusOr<std::unique_ptr<FunctionJit>> FunctionJit::CreateInternal(
     Function* xls_function, const EvaluatorOptions& options,
     const JitEvaluatorOptions& jit_options) {
+  if (UseJitObjectCache(jit_options)) {
+    XLS_ASSIGN_OR_RETURN(
+        CachedJitObjectCode cached,
+        LoadOrCompileCachedObjectCode(
+            xls_function, options, jit_options,
+            [&](const JitEvaluatorOptions& aot_options) {
+              return CreateObjectCode(xls_function, options, aot_options);
+            }));
+    XLS_ASSIGN_OR_RETURN(
+        JittedFunctionBase jfb,
+        JittedFunctionBase::BuildFromAot(cached.entrypoint, cached.function,
+                                         cached.packed_function));
+    llvm::Expected<llvm::DataLayout> layout =
+        llvm::DataLayout::parse(cached.data_layout);
+    XLS_RET_CHECK(layout) << "Unable to parse '" << cached.data_layout
+                          << "' to an llvm data-layout.";
+    XLS_ASSIGN_OR_RETURN(InterfaceMetadata metadata,
+                         InterfaceMetadata::CreateFromFunction(xls_function));
+    return std::unique_ptr<FunctionJit>(new FunctionJit(
+        std::move(metadata), std::move(cached.orc_jit), std::move(jfb),
+        /*has_observer_callbacks=*/false,
+        std::make_unique<JitRuntime>(*layout)));
+  }
+
   XLS_ASSIGN_OR_RETURN(auto orc_jit,
                        OrcJit::Create(jit_options.opt_level(),
                                       jit_options.include_observer_callbacks(),
-                                      jit_options.jit_observer()));
+                                      jit_options.jit_observer(),
+                                      jit_options.compile_threads()));
   XLS_ASSIGN_OR_RETURN(llvm::DataLayout data_layout,
                        orc_jit->CreateDataLayout());
   EvaluatorOptions eval_options = options;
@@ -213,6 +250,83 @@ absl::StatusOr<InterpreterResult<Value>> FunctionJit::Run(
   return Run(positional_args);
 }
 
+absl::Status FunctionJit::RunBatchWithPackedViews(
+    int64_t batch_size, absl::Span<const uint8_t> args,
+    absl::Span<uint8_t> results, int64_t thread_count) {
+  XLS_RET_CHECK(jitted_function_base_.HasPackedFunction());
+  XLS_RET_CHECK_GE(batch_size, 0);
+  XLS_RET_CHECK_GE(thread_count, 0);
+  if (args.size() < batch_size * GetPackedArgsSize()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Argument buffer too small for batch of %d - must be at least %d "
+        "bytes, got %d",
+        batch_size, batch_size * GetPackedArgsSize(), args.size()));
+  }
+  if (results.size() < batch_size * GetPackedReturnTypeSize()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Result buffer too small for batch of %d - must be at least %d bytes, "
+        "got %d",
+        batch_size, batch_size * GetPackedReturnTypeSize(), results.size()));
+  }
+
+  int64_t shard_count =
+      thread_count == 0 ? DefaultThreadCount() : thread_count;
+  // Runtime observers are not thread-safe.
+  if (callbacks_.observer != nullptr) {
+    shard_count = 1;
+  }
+  shard_count = std::clamp<int64_t>(
+      shard_count, 1, std::max<int64_t>(1, batch_size / kMinBatchShardSize));
+  if (shard_count == 1) {
+    return RunBatchShard(0, batch_size, args, results);
+  }
+
+  auto shard_start = [&](int64_t shard) {
+    return batch_size * shard / shard_count;
+  };
+  return DefaultThreadPool().ParallelFor(shard_count, [&](int64_t shard) {
+    return RunBatchShard(shard_start(shard), shard_start(shard + 1), args,
+                         results);
+  });
+}
+
+absl::Status FunctionJit::RunBatchShard(int64_t start, int64_t end,
+                                        absl::Span<const uint8_t> args,
+                                        absl::Span<uint8_t> results) {
+  absl::Span<const TypeBufferMetadata> input_metadata =
+      jitted_function_base_.GetInputBufferMetadata();
+  int64_t args_stride = GetPackedArgsSize();
+  int64_t result_stride = GetPackedReturnTypeSize();
+  // The instance context holds mutable state (e.g., the type arena used by
+  // callbacks) so each shard uses its own.
+  InstanceContext context = InstanceContext::CreateForFunc();
+  context.observer = callbacks_.observer;
+  InterpreterEvents events;
+  JitTempBuffer temp_buffer = jitted_function_base_.CreateTempBuffer();
+  std::vector<const uint8_t*> arg_buffers(input_metadata.size());
+  for (int64_t i = start; i < end; ++i) {
+    const uint8_t* arg_buffer = args.data() + i * args_stride;
+    for (int64_t j = 0; j < input_metadata.size(); ++j) {
+      arg_buffers[j] = arg_buffer;
+      arg_buffer += input_metadata[j].packed_size;
+    }
+    uint8_t* output_buffers[1] = {results.data() + i * result_stride};
+    jitted_function_base_.RunPackedJittedFunction(
+        arg_buffers.data(), output_buffers, temp_buffer.get_base_pointer(),
+        &events, &context, runtime(), /*continuation_point=*/0);
+    if (!events.AsProto().assert_msgs().empty()) {
+      absl::Status status = InterpreterEventsToStatus(events);
+      return absl::Status(
+          status.code(),
+          absl::StrFormat("Batch element %d: %s", i, status.message()));
+    }
+    if (!events.AsProto().trace_msgs().empty()) {
+      events.Clear();
+    }
+  }
+  return absl::OkStatus();
+}
+
 template <bool kForceZeroCopy>
 absl::Status FunctionJit::RunWithViews(absl::Span<uint8_t* const> args,
                                        absl::Span<uint8_t> result_buffer,
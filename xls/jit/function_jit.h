@@ -132,6 +132,26 @@ class FunctionJit {
     return InterpreterEventsToStatus(events);
   }
 
+  // Executes the compiled function on a batch of `batch_size` argument sets
+  // using the packed layout. `args` holds the arguments of the invocations
+  // back-to-back: the packed arguments of each invocation are concatenated in
+  // parameter order (GetPackedArgsSize() bytes per invocation). The packed
+  // results are written back-to-back into `results`
+  // (GetPackedReturnTypeSize() bytes per invocation).
+  //
+  // The batch is split into up to `thread_count` contiguous shards which are
+  // evaluated on DefaultThreadPool() and the calling thread, each with its own
+  // temporary buffer. If `thread_count` is zero DefaultThreadCount() is used.
+  // Small batches and functions with a runtime observer attached are
+  // evaluated on the calling thread only.
+  //
+  // Trace messages are discarded. If an invocation raises an assertion an
+  // error is returned and the contents of `results` are unspecified.
+  absl::Status RunBatchWithPackedViews(int64_t batch_size,
+                                       absl::Span<const uint8_t> args,
+                                       absl::Span<uint8_t> results,
+                                       int64_t thread_count = 1);
+
   // Same as RunWithPackedViews but expects a View rather than a PackedView.
   template <typename... ArgsT>
   absl::Status RunWithUnpackedViews(ArgsT... args) {
@@ -179,6 +199,16 @@ class FunctionJit {
   int64_t GetPackedReturnTypeSize() const {
     return jitted_function_base_.GetOutputBufferMetadata()[0].packed_size;
   }
+  // Gets the total size of all of the compiled function's arguments in the
+  // packed layout.
+  int64_t GetPackedArgsSize() const {
+    int64_t size = 0;
+    for (const TypeBufferMetadata& metadata :
+         jitted_function_base_.GetInputBufferMetadata()) {
+      size += metadata.packed_size;
+    }
+    return size;
+  }
 
   // Returns the size of the temporary buffer which must be passed to the jitted
   // function. The buffer is used to hold temporary node values inside the
@@ -299,6 +329,12 @@ class FunctionJit {
     *result_buffer = front.mutable_buffer();
   }
 
+  // Runs the packed jitted function on the invocations [`start`, `end`) of a
+  // batch laid out as described in RunBatchWithPackedViews.
+  absl::Status RunBatchShard(int64_t start, int64_t end,
+                             absl::Span<const uint8_t> args,
+                             absl::Span<uint8_t> results);
+
   // Invokes the jitted function with the given argument and outputs.
   template <bool kForceZeroCopy = false>
   void InvokeUnalignedJitFunction(absl::Span<const uint8_t* const> arg_buffers,
@@ -80,6 +80,7 @@ namespace {
 using ::absl_testing::IsOk;
 using ::absl_testing::IsOkAndHolds;
 using ::absl_testing::StatusIs;
+using ::testing::AllOf;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
@@ -1076,6 +1077,97 @@ fn f(x: bits[1], y: bits[8]) -> (bits[1], bits[8], bits[16]) {
   }
 }
 
+TEST(FunctionJitTest, BatchedPackedRun) {
+  Package package("my_package");
+  FunctionBuilder fb("test", &package);
+  BValue x = fb.Param("x", package.GetBitsType(16));
+  BValue y = fb.Param("y", package.GetBitsType(8));
+  fb.Add(fb.UMul(x, fb.ZeroExtend(y, 16)), fb.Literal(UBits(7, 16)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+  ASSERT_EQ(jit->GetPackedArgsSize(), 3);
+  ASSERT_EQ(jit->GetPackedReturnTypeSize(), 2);
+
+  constexpr int64_t kBatchSize = 10000;
+  std::vector<uint8_t> args(kBatchSize * 3);
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    uint16_t x_value = i * 13;
+    memcpy(args.data() + i * 3, &x_value, 2);
+    args[i * 3 + 2] = i % 251;
+  }
+  for (int64_t thread_count : {1, 4}) {
+    std::vector<uint8_t> results(kBatchSize * 2);
+    XLS_ASSERT_OK(jit->RunBatchWithPackedViews(
+        kBatchSize, args, absl::MakeSpan(results), thread_count));
+    for (int64_t i = 0; i < kBatchSize; ++i) {
+      uint16_t result;
+      memcpy(&result, results.data() + i * 2, 2);
+      EXPECT_EQ(result, static_cast<uint16_t>(i * 13 * (i % 251) + 7))
+          << "thread_count: " << thread_count << " element: " << i;
+    }
+  }
+
+  std::vector<uint8_t> short_results(kBatchSize);
+  EXPECT_THAT(jit->RunBatchWithPackedViews(kBatchSize, args,
+                                           absl::MakeSpan(short_results)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Result buffer too small")));
+}
+
+TEST(FunctionJitTest, BatchedPackedRunAssert) {
+  Package package("my_package");
+  FunctionBuilder fb("test", &package);
+  BValue x = fb.Param("x", package.GetBitsType(8));
+  fb.Assert(fb.Literal(Value::Token()), fb.ULt(x, fb.Literal(UBits(200, 8))),
+            "x is too big");
+  fb.Add(x, fb.Literal(UBits(1, 8)));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, fb.Build());
+  XLS_ASSERT_OK_AND_ASSIGN(auto jit, FunctionJit::Create(function));
+
+  std::vector<uint8_t> args(4096, 0);
+  args[3000] = 200;
+  std::vector<uint8_t> results(args.size());
+  EXPECT_THAT(
+      jit->RunBatchWithPackedViews(args.size(), args, absl::MakeSpan(results),
+                                   /*thread_count=*/2),
+      StatusIs(absl::StatusCode::kAborted,
+               AllOf(HasSubstr("Batch element 3000"),
+                     HasSubstr("x is too big"))));
+}
+
+TEST(FunctionJitTest, ParallelCompile) {
+  // Large enough that the LLVM module is split across threads.
+  constexpr int64_t kChainLength = 1000;
+  Package package("my_package");
+  FunctionBuilder fb("test", &package);
+  BValue x = fb.Param("x", package.GetBitsType(32));
+  BValue v = x;
+  for (int64_t i = 0; i < kChainLength; ++i) {
+    v = fb.Add(fb.UMul(v, fb.Literal(UBits(2 * i + 1, 32))), x);
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * function, fb.BuildWithReturnValue(v));
+
+  auto expected = [&](uint32_t x_value) {
+    uint32_t result = x_value;
+    for (int64_t i = 0; i < kChainLength; ++i) {
+      result = result * static_cast<uint32_t>(2 * i + 1) + x_value;
+    }
+    return result;
+  };
+  for (int64_t compile_threads : {1, 4}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        auto jit, FunctionJit::Create(function, EvaluatorOptions(),
+                                      JitEvaluatorOptions().set_compile_threads(
+                                          compile_threads)));
+    for (uint32_t x_value : {0u, 1u, 12345u, 0xffffffffu}) {
+      std::vector<Value> args = {Value(UBits(x_value, 32))};
+      EXPECT_THAT(DropInterpreterEvents(jit->Run(args)),
+                  IsOkAndHolds(Value(UBits(expected(x_value), 32))))
+          << "compile_threads: " << compile_threads;
+    }
+  }
+}
+
 TEST(FunctionJitTest, MisalignedPointerCopied) {
   Package package("my_package");
 
@@ -26,11 +26,14 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "xls/common/math_util.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
+#include "xls/ir/channel.h"
 #include "xls/ir/package.h"
 #include "xls/ir/proc_elaboration.h"
 #include "xls/ir/type.h"
@@ -40,16 +43,18 @@
 namespace xls {
 namespace {
 
+template <typename QueueT>
 void WriteValueOnQueue(const Value& value, Type* type, JitRuntime& runtime,
-                       ByteQueue& queue) {
+                       QueueT& queue) {
   absl::InlinedVector<uint8_t, ByteQueue::kInitBufferSize> buffer(
       queue.element_size());
   runtime.BlitValueToBuffer(value, type, absl::MakeSpan(buffer));
   queue.Write(buffer.data());
 }
 
+template <typename QueueT>
 std::optional<Value> ReadValueFromQueue(Type* type, JitRuntime& runtime,
-                                        ByteQueue& queue) {
+                                        QueueT& queue) {
   std::vector<uint8_t> buffer(queue.element_size());
   if (!queue.Read(buffer.data())) {
     return std::nullopt;
@@ -57,6 +62,28 @@ std::optional<Value> ReadValueFromQueue(Type* type, JitRuntime& runtime,
   return runtime.UnpackBuffer(buffer.data(), type);
 }
 
+// Calls `generator`, if any, until `queue` holds at least `count` elements or
+// the generator is exhausted, adding each generated value with `write`.
+template <typename QueueT, typename WriteFn>
+void FillFromGenerator(std::optional<ChannelQueue::GeneratorFn>& generator,
+                       const QueueT& queue, int64_t count, WriteFn write) {
+  if (!generator.has_value()) {
+    return;
+  }
+  while (queue.size() < count) {
+    std::optional<Value> generated_value = (*generator)();
+    if (!generated_value.has_value()) {
+      return;
+    }
+    write(*generated_value);
+  }
+}
+
+// Elements are stored in blocks of roughly this many bytes.
+constexpr int64_t kSpscBlockByteCount = 4096;
+// Minimum number of elements in each block.
+constexpr int64_t kSpscMinBlockElementCount = 8;
+
 }  // namespace
 
 ByteQueue::ByteQueue(int64_t channel_element_size, bool is_single_value)
@@ -103,16 +130,219 @@ void ByteQueue::Resize() {
   }
 }
 
+void ByteQueue::Grow(int64_t min_byte_count) {
+  int64_t buffer_size = circular_buffer_.size();
+  while (FloorOfRatio(buffer_size, allocated_element_size_) *
+             allocated_element_size_ <
+         min_byte_count) {
+    buffer_size *= 2;
+  }
+  // Unlike Resize the queue may not be full, so copy the elements in order to
+  // the front of the new buffer.
+  absl::InlinedVector<uint8_t, kInitBufferSize> buffer(buffer_size);
+  int64_t first_chunk = std::min(bytes_used_, max_byte_count_ - read_index_);
+  std::copy_n(circular_buffer_.begin() + read_index_, first_chunk,
+              buffer.begin());
+  std::copy_n(circular_buffer_.begin(), bytes_used_ - first_chunk,
+              buffer.begin() + first_chunk);
+  circular_buffer_ = std::move(buffer);
+  max_byte_count_ =
+      FloorOfRatio(buffer_size, allocated_element_size_) *
+      allocated_element_size_;
+  read_index_ = 0;
+  write_index_ = bytes_used_ == max_byte_count_ ? 0 : bytes_used_;
+}
+
+void ByteQueue::ReserveWrite(absl::Span<uint8_t*> slots) {
+  if (is_single_value_) {
+    CHECK_LE(slots.size(), 1) << "Single-value queues have a single slot";
+    if (!slots.empty()) {
+      slots[0] = circular_buffer_.data() + write_index_;
+    }
+    return;
+  }
+  int64_t byte_count =
+      static_cast<int64_t>(slots.size()) * allocated_element_size_;
+  if (bytes_used_ + byte_count > max_byte_count_) {
+    Grow(bytes_used_ + byte_count);
+  }
+  int64_t index = write_index_;
+  for (uint8_t*& slot : slots) {
+    slot = circular_buffer_.data() + index;
+    index += allocated_element_size_;
+    if (index == max_byte_count_) {
+      index = 0;
+    }
+  }
+}
+
+void ByteQueue::CommitWrite(int64_t count) {
+  if (count == 0) {
+    return;
+  }
+  if (is_single_value_) {
+    bytes_used_ = allocated_element_size_;
+    return;
+  }
+  int64_t byte_count = count * allocated_element_size_;
+  CHECK_LE(bytes_used_ + byte_count, max_byte_count_);
+  bytes_used_ += byte_count;
+  write_index_ = (write_index_ + byte_count) % max_byte_count_;
+}
+
+int64_t ByteQueue::PeekRead(absl::Span<const uint8_t*> slots) const {
+  int64_t count = std::min(static_cast<int64_t>(slots.size()), size());
+  int64_t index = read_index_;
+  for (int64_t i = 0; i < count; ++i) {
+    slots[i] = circular_buffer_.data() + index;
+    index += allocated_element_size_;
+    if (index == max_byte_count_) {
+      index = 0;
+    }
+  }
+  return count;
+}
+
+void ByteQueue::ReleaseRead(int64_t count) {
+  if (is_single_value_) {
+    return;
+  }
+  int64_t byte_count = count * allocated_element_size_;
+  CHECK_LE(byte_count, bytes_used_);
+  bytes_used_ -= byte_count;
+  read_index_ = (read_index_ + byte_count) % max_byte_count_;
+}
+
+SpscByteQueue::SpscByteQueue(int64_t channel_element_size)
+    : channel_element_size_(channel_element_size),
+      allocated_element_size_(
+          RoundUpToNearest(channel_element_size,
+                           static_cast<int64_t>(alignof(std::max_align_t)))) {
+  // Special case to handle empty tuples. Each element must occupy at least one
+  // byte so that offsets advance within the block.
+  if (allocated_element_size_ == 0) {
+    allocated_element_size_ = 1;
+  }
+  int64_t elements_per_block =
+      std::max(kSpscMinBlockElementCount,
+               FloorOfRatio(kSpscBlockByteCount, allocated_element_size_));
+  block_byte_count_ = elements_per_block * allocated_element_size_;
+  write_block_ = new Block(block_byte_count_);
+  read_block_ = write_block_;
+}
+
+SpscByteQueue::~SpscByteQueue() {
+  Block* block = read_block_;
+  while (block != nullptr) {
+    Block* next = block->next.load(std::memory_order_relaxed);
+    delete block;
+    block = next;
+  }
+  delete spare_block_.load(std::memory_order_relaxed);
+}
+
+void SpscByteQueue::AdvanceWriteBlock() {
+  Block* block = spare_block_.exchange(nullptr, std::memory_order_acquire);
+  if (block == nullptr) {
+    block = new Block(block_byte_count_);
+  } else {
+    block->next.store(nullptr, std::memory_order_relaxed);
+  }
+  // The release store publishes the reset `next` pointer of the block along
+  // with the block itself.
+  write_block_->next.store(block, std::memory_order_release);
+  write_block_ = block;
+  write_offset_ = 0;
+}
+
+void SpscByteQueue::AdvanceReadBlock() {
+  // The block is only exhausted if an element beyond its end was published, so
+  // the next block has already been linked by the producer.
+  Block* next = read_block_->next.load(std::memory_order_acquire);
+  CHECK_NE(next, nullptr);
+  Block* old_spare =
+      spare_block_.exchange(read_block_, std::memory_order_acq_rel);
+  delete old_spare;
+  read_block_ = next;
+  read_offset_ = 0;
+}
+
+void SpscByteQueue::ReserveWrite(absl::Span<uint8_t*> slots) {
+  // Moving to the next block is invisible to the consumer until an element in
+  // it is published, so blocks are linked eagerly.
+  for (uint8_t*& slot : slots) {
+    if (write_offset_ == block_byte_count_) {
+      AdvanceWriteBlock();
+    }
+    slot = write_block_->data.get() + write_offset_;
+    write_offset_ += allocated_element_size_;
+  }
+}
+
+int64_t SpscByteQueue::PeekRead(absl::Span<const uint8_t*> slots) {
+  int64_t read_count = read_count_.load(std::memory_order_relaxed);
+  if (read_count + static_cast<int64_t>(slots.size()) > cached_write_count_) {
+    cached_write_count_ = write_count_.load(std::memory_order_acquire);
+  }
+  int64_t count = std::min(static_cast<int64_t>(slots.size()),
+                           cached_write_count_ - read_count);
+  // Walk the blocks without recycling them; that happens on release.
+  const Block* block = read_block_;
+  int64_t offset = read_offset_;
+  for (int64_t i = 0; i < count; ++i) {
+    if (offset == block_byte_count_) {
+      block = block->next.load(std::memory_order_acquire);
+      offset = 0;
+    }
+    slots[i] = block->data.get() + offset;
+    offset += allocated_element_size_;
+  }
+  return count;
+}
+
+void SpscByteQueue::ReleaseRead(int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    if (read_offset_ == block_byte_count_) {
+      AdvanceReadBlock();
+    }
+    read_offset_ += allocated_element_size_;
+  }
+  read_count_.store(read_count_.load(std::memory_order_relaxed) + count,
+                    std::memory_order_release);
+}
+
+void JitChannelQueue::CallWriteCallbacksOnSlots(
+    absl::Span<uint8_t* const> slots) {
+  if (callbacks_.empty()) {
+    return;
+  }
+  for (const uint8_t* slot : slots) {
+    CallWriteCallbacks(jit_runtime_->UnpackBuffer(slot, channel()->type()));
+  }
+}
+
+void JitChannelQueue::CallReadCallbacksOnSlots(
+    absl::Span<const uint8_t* const> slots) {
+  if (callbacks_.empty()) {
+    return;
+  }
+  for (const uint8_t* slot : slots) {
+    CallReadCallbacks(jit_runtime_->UnpackBuffer(slot, channel()->type()));
+  }
+}
+
 int64_t ThreadSafeJitChannelQueue::GetSizeInternal() const {
   return byte_queue_.size();
 }
 
 void ThreadSafeJitChannelQueue::WriteInternal(const Value& value) {
+  AwaitWritable();
   CallWriteCallbacks(value);
   WriteValueOnQueue(value, channel()->type(), *jit_runtime_, byte_queue_);
 }
 
 std::optional<Value> ThreadSafeJitChannelQueue::ReadInternal() {
+  AwaitReadable();
   std::optional<Value> value =
       ReadValueFromQueue(channel()->type(), *jit_runtime_, byte_queue_);
   if (value.has_value()) {
@@ -121,6 +351,41 @@ std::optional<Value> ThreadSafeJitChannelQueue::ReadInternal() {
   return value;
 }
 
+void ThreadSafeJitChannelQueue::ReserveWriteRaw(absl::Span<uint8_t*> slots) {
+  absl::MutexLock lock(&mutex_);
+  AwaitWritable();
+  byte_queue_.ReserveWrite(slots);
+  write_slots_outstanding_ = !slots.empty();
+}
+
+void ThreadSafeJitChannelQueue::CommitWriteRaw(
+    absl::Span<uint8_t* const> slots) {
+  absl::MutexLock lock(&mutex_);
+  byte_queue_.CommitWrite(slots.size());
+  write_slots_outstanding_ = false;
+  CallWriteCallbacksOnSlots(slots);
+}
+
+int64_t ThreadSafeJitChannelQueue::PeekReadRaw(
+    absl::Span<const uint8_t*> slots) {
+  absl::MutexLock lock(&mutex_);
+  AwaitReadable();
+  FillFromGenerator(generator_, byte_queue_, slots.size(),
+                    [&](const Value& value) ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+                        mutex_) { WriteInternal(value); });
+  int64_t count = byte_queue_.PeekRead(slots);
+  read_slots_outstanding_ = count > 0;
+  return count;
+}
+
+void ThreadSafeJitChannelQueue::ReleaseReadRaw(
+    absl::Span<const uint8_t* const> slots) {
+  absl::MutexLock lock(&mutex_);
+  CallReadCallbacksOnSlots(slots);
+  byte_queue_.ReleaseRead(slots.size());
+  read_slots_outstanding_ = false;
+}
+
 int64_t ThreadUnsafeJitChannelQueue::GetSizeInternal() const {
   return byte_queue_.size();
 }
@@ -139,6 +404,88 @@ std::optional<Value> ThreadUnsafeJitChannelQueue::ReadInternal() {
   return value;
 }
 
+void ThreadUnsafeJitChannelQueue::ReserveWriteRaw(absl::Span<uint8_t*> slots) {
+  byte_queue_.ReserveWrite(slots);
+}
+
+void ThreadUnsafeJitChannelQueue::CommitWriteRaw(
+    absl::Span<uint8_t* const> slots) {
+  byte_queue_.CommitWrite(slots.size());
+  CallWriteCallbacksOnSlots(slots);
+}
+
+int64_t ThreadUnsafeJitChannelQueue::PeekReadRaw(
+    absl::Span<const uint8_t*> slots) {
+  FillFromGenerator(generator_, byte_queue_, slots.size(),
+                    [&](const Value& value) { WriteInternal(value); });
+  return byte_queue_.PeekRead(slots);
+}
+
+void ThreadUnsafeJitChannelQueue::ReleaseReadRaw(
+    absl::Span<const uint8_t* const> slots) {
+  CallReadCallbacksOnSlots(slots);
+  byte_queue_.ReleaseRead(slots.size());
+}
+
+LockFreeSpscJitChannelQueue::LockFreeSpscJitChannelQueue(
+    ChannelInstance* channel_instance, JitRuntime* jit_runtime)
+    : JitChannelQueue(channel_instance, jit_runtime),
+      byte_queue_(
+          jit_runtime->GetTypeByteSize(channel_instance->channel->type())) {
+  CHECK_EQ(channel_instance->channel->kind(), ChannelKind::kStreaming)
+      << "Lock-free queues only support streaming channels: "
+      << channel_instance->ToString();
+}
+
+int64_t LockFreeSpscJitChannelQueue::GetSizeInternal() const {
+  return byte_queue_.size();
+}
+
+void LockFreeSpscJitChannelQueue::WriteInternal(const Value& value) {
+  CallWriteCallbacks(value);
+  WriteValueOnQueue(value, channel()->type(), *jit_runtime_, byte_queue_);
+}
+
+std::optional<Value> LockFreeSpscJitChannelQueue::ReadInternal() {
+  std::optional<Value> value =
+      ReadValueFromQueue(channel()->type(), *jit_runtime_, byte_queue_);
+  if (value.has_value()) {
+    CallReadCallbacks(value.value());
+  }
+  return value;
+}
+
+void LockFreeSpscJitChannelQueue::ReserveWriteRaw(absl::Span<uint8_t*> slots) {
+  CheckNoGenerator();
+  byte_queue_.ReserveWrite(slots);
+}
+
+void LockFreeSpscJitChannelQueue::CommitWriteRaw(
+    absl::Span<uint8_t* const> slots) {
+  byte_queue_.CommitWrite(slots.size());
+  CallWriteCallbacksOnSlots(slots);
+}
+
+int64_t LockFreeSpscJitChannelQueue::PeekReadRaw(
+    absl::Span<const uint8_t*> slots) {
+  FillFromGenerator(generator_, byte_queue_, slots.size(),
+                    [&](const Value& value) { WriteInternal(value); });
+  return byte_queue_.PeekRead(slots);
+}
+
+void LockFreeSpscJitChannelQueue::ReleaseReadRaw(
+    absl::Span<const uint8_t* const> slots) {
+  CallReadCallbacksOnSlots(slots);
+  byte_queue_.ReleaseRead(slots.size());
+}
+
+JitChannelQueueKind LockFreeSpscWherePossible(
+    ChannelInstance* channel_instance) {
+  return channel_instance->channel->kind() == ChannelKind::kStreaming
+             ? JitChannelQueueKind::kLockFreeSpsc
+             : JitChannelQueueKind::kThreadSafe;
+}
+
 /* static */ absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
 JitChannelQueueManager::CreateThreadSafe(Package* package,
                                          std::unique_ptr<JitRuntime> runtime) {
@@ -191,6 +538,36 @@ JitChannelQueueManager::CreateThreadUnsafe(
       std::move(elaboration), std::move(queues), std::move(runtime)));
 }
 
+/* static */ absl::StatusOr<std::unique_ptr<JitChannelQueueManager>>
+JitChannelQueueManager::Create(ProcElaboration&& elaboration,
+                               std::unique_ptr<JitRuntime> runtime,
+                               const QueueKindFunction& queue_kind) {
+  std::vector<std::unique_ptr<ChannelQueue>> queues;
+  for (ChannelInstance* channel_instance : elaboration.channel_instances()) {
+    switch (queue_kind(channel_instance)) {
+      case JitChannelQueueKind::kThreadSafe:
+        queues.push_back(std::make_unique<ThreadSafeJitChannelQueue>(
+            channel_instance, runtime.get()));
+        break;
+      case JitChannelQueueKind::kThreadUnsafe:
+        queues.push_back(std::make_unique<ThreadUnsafeJitChannelQueue>(
+            channel_instance, runtime.get()));
+        break;
+      case JitChannelQueueKind::kLockFreeSpsc:
+        if (channel_instance->channel->kind() != ChannelKind::kStreaming) {
+          return absl::InvalidArgumentError(absl::StrFormat(
+              "Lock-free queues only support streaming channels: %s",
+              channel_instance->ToString()));
+        }
+        queues.push_back(std::make_unique<LockFreeSpscJitChannelQueue>(
+            channel_instance, runtime.get()));
+        break;
+    }
+  }
+  return absl::WrapUnique(new JitChannelQueueManager(
+      std::move(elaboration), std::move(queues), std::move(runtime)));
+}
+
 JitChannelQueue& JitChannelQueueManager::GetJitQueueByName(
     std::string_view channel_name, std::string_view proc_name) {
   absl::StatusOr<ChannelQueue*> channel_queue =
@@ -14,18 +14,23 @@
 #ifndef XLS_JIT_JIT_CHANNEL_QUEUE_H_
 #define XLS_JIT_JIT_CHANNEL_QUEUE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/log/check.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/package.h"
@@ -96,18 +101,38 @@ class ByteQueue {
 
   int64_t size() const { return bytes_used_ / allocated_element_size_; }
 
+  // Reserves storage for the next `slots.size()` elements written to the queue
+  // and stores a pointer to the storage of each in `slots`. The elements are
+  // added to the queue by CommitWrite; no other write may be performed in
+  // between. Single-value queues have a single slot.
+  void ReserveWrite(absl::Span<uint8_t*> slots);
+  // Adds the first `count` elements reserved by ReserveWrite to the queue.
+  void CommitWrite(int64_t count);
+
+  // Stores pointers to up to `slots.size()` elements at the front of the queue
+  // in `slots` without removing them. Returns the number of elements stored.
+  // The pointers are invalidated by the next write.
+  int64_t PeekRead(absl::Span<const uint8_t*> slots) const;
+  // Removes the first `count` elements from the queue. Reads are
+  // non-destructive for single-value queues so this is a no-op for them.
+  void ReleaseRead(int64_t count);
+
   static constexpr int64_t kInitBufferSize = 128;
 
  private:
+  // Reallocates the circular buffer to hold at least `min_byte_count` bytes
+  // of elements, moving the elements to the front of the buffer.
+  void Grow(int64_t min_byte_count);
+
   // Size of an element in the channel in units of bytes.
   int64_t channel_element_size_ = 0;
   // Allocated size of an element in the circular buffer in units of bytes. The
   // elements are aligned to the largest scalar type.
   int64_t allocated_element_size_ = 0;
-  // TODO(vmirian): 8-09-2022 Place the following guarded members on a single
-  // cache line for optimal performance.
+  // The following members are accessed on every read and write so they are
+  // placed together on a single cache line.
   // The maximum number of bytes that can hold elements in the circular buffer.
-  int64_t max_byte_count_ = 0;
+  alignas(ABSL_CACHELINE_SIZE) int64_t max_byte_count_ = 0;
   // The number of bytes used in the circular buffer.
   int64_t bytes_used_ = 0;
   // Index in the circular buffer to write values to.
@@ -120,6 +145,136 @@ class ByteQueue {
   bool is_single_value_;
 };
 
+// A lock-free queue from which raw bytes may be written or read by at most one
+// producer thread and at most one consumer thread concurrently. The queue has
+// FIFO semantics and is unbounded. Elements are stored in a linked list of
+// fixed-size blocks; the producer links a new block when the current one is
+// full and the consumer releases blocks once drained. One drained block is
+// kept for reuse so a queue in steady state does not allocate.
+//
+// The producer and consumer indices live on separate cache lines and each side
+// caches the last observed value of the other side's counter to avoid
+// contention on the shared cache lines.
+class SpscByteQueue {
+ public:
+  // `channel_element_size` is the granularity of the queue access. Each read or
+  // write to the queue handles this many bytes at a time.
+  explicit SpscByteQueue(int64_t channel_element_size);
+  ~SpscByteQueue();
+
+  SpscByteQueue(const SpscByteQueue&) = delete;
+  SpscByteQueue& operator=(const SpscByteQueue&) = delete;
+
+  int64_t element_size() const { return channel_element_size_; }
+
+  // Writes an element to the queue. Must only be called by the producer.
+  void Write(const uint8_t* data) {
+#ifdef ABSL_HAVE_MEMORY_SANITIZER
+    if (channel_element_size_ > 0) {
+      __msan_unpoison(data, channel_element_size_);
+    }
+#endif
+    if (ABSL_PREDICT_FALSE(write_offset_ == block_byte_count_)) {
+      AdvanceWriteBlock();
+    }
+    if (channel_element_size_ > 0) {
+      memcpy(write_block_->data.get() + write_offset_, data,
+             channel_element_size_);
+    }
+    write_offset_ += allocated_element_size_;
+    // Publish the element to the consumer.
+    write_count_.store(write_count_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_release);
+  }
+
+  // Reads an element from the queue. Returns false if the queue is empty. Must
+  // only be called by the consumer.
+  bool Read(uint8_t* buffer) {
+    int64_t read_count = read_count_.load(std::memory_order_relaxed);
+    if (read_count == cached_write_count_) {
+      cached_write_count_ = write_count_.load(std::memory_order_acquire);
+      if (read_count == cached_write_count_) {
+        return false;
+      }
+    }
+    if (ABSL_PREDICT_FALSE(read_offset_ == block_byte_count_)) {
+      AdvanceReadBlock();
+    }
+    if (channel_element_size_ > 0) {
+      memcpy(buffer, read_block_->data.get() + read_offset_,
+             channel_element_size_);
+    }
+    read_offset_ += allocated_element_size_;
+    read_count_.store(read_count + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns the number of elements in the queue. May be called from any
+  // thread. If the producer or consumer is concurrently active the result may
+  // be stale.
+  int64_t size() const {
+    // Load the read count first so the result is never negative.
+    int64_t read_count = read_count_.load(std::memory_order_acquire);
+    return write_count_.load(std::memory_order_acquire) - read_count;
+  }
+
+  // Reserves storage for the next `slots.size()` elements written to the queue
+  // and stores a pointer to the storage of each in `slots`. The elements are
+  // published to the consumer by CommitWrite; no other write may be performed
+  // in between. Must only be called by the producer.
+  void ReserveWrite(absl::Span<uint8_t*> slots);
+  // Publishes the elements reserved by the last ReserveWrite. `count` must be
+  // the number of reserved elements. Must only be called by the producer.
+  void CommitWrite(int64_t count) {
+    write_count_.store(write_count_.load(std::memory_order_relaxed) + count,
+                       std::memory_order_release);
+  }
+
+  // Stores pointers to up to `slots.size()` elements at the front of the queue
+  // in `slots` without removing them. Returns the number of elements stored.
+  // The pointers remain valid until the elements are released. Must only be
+  // called by the consumer.
+  int64_t PeekRead(absl::Span<const uint8_t*> slots);
+  // Removes the first `count` elements from the queue. Must only be called by
+  // the consumer.
+  void ReleaseRead(int64_t count);
+
+ private:
+  struct Block {
+    explicit Block(int64_t byte_count) : data(new uint8_t[byte_count]) {}
+
+    std::unique_ptr<uint8_t[]> data;
+    std::atomic<Block*> next = nullptr;
+  };
+
+  // Links a new block after the current write block.
+  void AdvanceWriteBlock();
+  // Moves to the next block and recycles the drained block.
+  void AdvanceReadBlock();
+
+  // Size of an element in the channel in units of bytes.
+  int64_t channel_element_size_;
+  // Allocated size of an element in a block in units of bytes. The elements
+  // are aligned to the largest scalar type.
+  int64_t allocated_element_size_;
+  // Number of bytes of element storage in each block.
+  int64_t block_byte_count_;
+
+  // Producer state.
+  alignas(ABSL_CACHELINE_SIZE) Block* write_block_;
+  int64_t write_offset_ = 0;
+  std::atomic<int64_t> write_count_ = 0;
+
+  // Consumer state.
+  alignas(ABSL_CACHELINE_SIZE) Block* read_block_;
+  int64_t read_offset_ = 0;
+  int64_t cached_write_count_ = 0;
+  std::atomic<int64_t> read_count_ = 0;
+
+  // A drained block handed from the consumer back to the producer for reuse.
+  alignas(ABSL_CACHELINE_SIZE) std::atomic<Block*> spare_block_ = nullptr;
+};
+
 // Abstract base class for channel queues which may be used by the JIT. These
 // queues support reading and writing raw bytes to the queue rather the just
 // xls::Values.
@@ -132,7 +287,41 @@ class JitChannelQueue : public ChannelQueue {
   virtual void WriteRaw(const uint8_t* data) = 0;
   virtual bool ReadRaw(uint8_t* buffer) = 0;
 
+  // Zero-copy access to the storage of the queue in batches of elements.
+  // Elements are stored in the native format of the JIT and each slot holds
+  // element_size() bytes. For bits-typed channels the native format is the
+  // packed format followed by zero padding so packed views, e.g.,
+  // PackedBitsView<N>(slot, 0), may be placed directly over the slots.
+
+  // Reserves storage for the next `slots.size()` elements written to the
+  // queue and stores a pointer to each in `slots`. The caller fills the slots
+  // with complete native values (including zero padding) and then passes the
+  // same slots to CommitWriteRaw which makes them visible to readers. The
+  // caller must be the only writer of the channel in between. Single-value
+  // channels have a single slot.
+  virtual void ReserveWriteRaw(absl::Span<uint8_t*> slots) = 0;
+  virtual void CommitWriteRaw(absl::Span<uint8_t* const> slots) = 0;
+
+  // Stores pointers to up to `slots.size()` elements at the front of the
+  // queue in `slots` and returns the number of elements stored. The elements
+  // remain in the queue until the stored prefix of `slots` is passed to
+  // ReleaseReadRaw. The thread holding the slots must release them before it
+  // writes the channel again; in the thread-safe queue, writes (and reads) on
+  // other threads wait until the slots are released, and writes wait for
+  // reserved slots to be committed.
+  virtual int64_t PeekReadRaw(absl::Span<const uint8_t*> slots) = 0;
+  virtual void ReleaseReadRaw(absl::Span<const uint8_t* const> slots) = 0;
+
+  // The size in bytes of an element of the channel in the native format.
+  int64_t element_size() const {
+    return jit_runtime_->GetTypeByteSize(channel()->type());
+  }
+
  protected:
+  // Calls the write (read) callbacks on the elements in the given slots.
+  void CallWriteCallbacksOnSlots(absl::Span<uint8_t* const> slots);
+  void CallReadCallbacksOnSlots(absl::Span<const uint8_t* const> slots);
+
   JitRuntime* jit_runtime_;
 };
 
@@ -151,6 +340,7 @@ class ThreadSafeJitChannelQueue : public JitChannelQueue {
   // Write raw bytes representing a value in LLVM's native format.
   void WriteRaw(const uint8_t* data) override {
     absl::MutexLock lock(&mutex_);
+    AwaitWritable();
     byte_queue_.Write(data);
     if (!callbacks_.empty()) {
       CallWriteCallbacks(jit_runtime_->UnpackBuffer(data, channel()->type()));
@@ -161,6 +351,7 @@ class ThreadSafeJitChannelQueue : public JitChannelQueue {
   // true if queue was not empty and data was read.
   bool ReadRaw(uint8_t* buffer) override {
     absl::MutexLock lock(&mutex_);
+    AwaitReadable();
     if (generator_.has_value()) {
       std::optional<Value> generated_value = (*generator_)();
       if (generated_value.has_value()) {
@@ -174,14 +365,39 @@ class ThreadSafeJitChannelQueue : public JitChannelQueue {
     return value_read;
   }
 
+  void ReserveWriteRaw(absl::Span<uint8_t*> slots) override;
+  void CommitWriteRaw(absl::Span<uint8_t* const> slots) override;
+  int64_t PeekReadRaw(absl::Span<const uint8_t*> slots) override;
+  void ReleaseReadRaw(absl::Span<const uint8_t* const> slots) override;
+
  protected:
   int64_t GetSizeInternal() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
   void WriteInternal(const Value& value)
-      ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) override;
   std::optional<Value> ReadInternal()
-      ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) override;
+
+  // The storage of the byte queue may move or be overwritten by a write, so
+  // writes wait until no reserved or peeked slots are outstanding. Destructive
+  // reads and peeks wait until no peeked slots are outstanding.
+  bool Writable() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return !write_slots_outstanding_ && !read_slots_outstanding_;
+  }
+  bool Readable() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return !read_slots_outstanding_;
+  }
+  void AwaitWritable() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    mutex_.Await(absl::Condition(this, &ThreadSafeJitChannelQueue::Writable));
+  }
+  void AwaitReadable() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    mutex_.Await(absl::Condition(this, &ThreadSafeJitChannelQueue::Readable));
+  }
 
   ByteQueue byte_queue_ ABSL_GUARDED_BY(mutex_);
+  // Whether slots handed out by ReserveWriteRaw (PeekReadRaw) have not been
+  // committed (released) yet.
+  bool write_slots_outstanding_ ABSL_GUARDED_BY(mutex_) = false;
+  bool read_slots_outstanding_ ABSL_GUARDED_BY(mutex_) = false;
 };
 
 // A thread-unsafe version of the JIT channel queue.
@@ -215,6 +431,11 @@ class ThreadUnsafeJitChannelQueue : public JitChannelQueue {
     return value_read;
   }
 
+  void ReserveWriteRaw(absl::Span<uint8_t*> slots) override;
+  void CommitWriteRaw(absl::Span<uint8_t* const> slots) override;
+  int64_t PeekReadRaw(absl::Span<const uint8_t*> slots) override;
+  void ReleaseReadRaw(absl::Span<const uint8_t* const> slots) override;
+
  protected:
   int64_t GetSizeInternal() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
   void WriteInternal(const Value& value) override;
@@ -223,6 +444,78 @@ class ThreadUnsafeJitChannelQueue : public JitChannelQueue {
   ByteQueue byte_queue_;
 };
 
+// A lock-free version of the JIT channel queue for streaming channels which
+// have at most one producer thread and at most one consumer thread at any
+// time, e.g., a channel between two procs or between a proc and the host. Raw
+// reads and writes do not acquire a lock. Single-value channels are not
+// supported.
+//
+// A channel with a generator attached has no separate producer: the consumer
+// writes the generated values itself, and writing the channel in any other way
+// is an error (see ChannelQueue::Write) or, for the raw writes, a CHECK
+// failure. Generators must be attached before the consumer starts.
+class LockFreeSpscJitChannelQueue : public JitChannelQueue {
+ public:
+  LockFreeSpscJitChannelQueue(ChannelInstance* channel_instance,
+                              JitRuntime* jit_runtime);
+  ~LockFreeSpscJitChannelQueue() override = default;
+
+  void WriteRaw(const uint8_t* data) override {
+    CheckNoGenerator();
+    byte_queue_.Write(data);
+    if (!callbacks_.empty()) {
+      CallWriteCallbacks(jit_runtime_->UnpackBuffer(data, channel()->type()));
+    }
+  }
+  bool ReadRaw(uint8_t* buffer) override {
+    if (generator_.has_value()) {
+      std::optional<Value> generated_value = (*generator_)();
+      if (generated_value.has_value()) {
+        WriteInternal(generated_value.value());
+      }
+    }
+    bool value_read = byte_queue_.Read(buffer);
+    if (value_read && !callbacks_.empty()) {
+      CallReadCallbacks(jit_runtime_->UnpackBuffer(buffer, channel()->type()));
+    }
+    return value_read;
+  }
+
+  void ReserveWriteRaw(absl::Span<uint8_t*> slots) override;
+  void CommitWriteRaw(absl::Span<uint8_t* const> slots) override;
+  int64_t PeekReadRaw(absl::Span<const uint8_t*> slots) override;
+  void ReleaseReadRaw(absl::Span<const uint8_t* const> slots) override;
+
+ protected:
+  int64_t GetSizeInternal() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) override;
+  void WriteInternal(const Value& value) override;
+  std::optional<Value> ReadInternal() override;
+
+  // CHECK-fails if a generator is attached, i.e., if the caller would be a
+  // second producer.
+  void CheckNoGenerator() const {
+    CHECK(!generator_.has_value())
+        << "Channel " << channel()->name()
+        << " has a generator and may not be written";
+  }
+
+  SpscByteQueue byte_queue_;
+};
+
+// The implementation of the queue used for a channel instance.
+enum class JitChannelQueueKind : int8_t {
+  // ThreadSafeJitChannelQueue.
+  kThreadSafe,
+  // ThreadUnsafeJitChannelQueue.
+  kThreadUnsafe,
+  // LockFreeSpscJitChannelQueue. Only supported for streaming channels.
+  kLockFreeSpsc,
+};
+
+// Returns kLockFreeSpsc for streaming channels and kThreadSafe otherwise.
+JitChannelQueueKind LockFreeSpscWherePossible(
+    ChannelInstance* channel_instance);
+
 // A Channel manager which holds exclusively JitChannelQueues.
 class JitChannelQueueManager : public ChannelQueueManager {
  public:
@@ -241,6 +534,14 @@ class JitChannelQueueManager : public ChannelQueueManager {
   CreateThreadUnsafe(ProcElaboration&& elaboration,
                      std::unique_ptr<JitRuntime> runtime);
 
+  // Factory which selects the queue implementation of each channel instance
+  // with `queue_kind`.
+  using QueueKindFunction =
+      std::function<JitChannelQueueKind(ChannelInstance*)>;
+  static absl::StatusOr<std::unique_ptr<JitChannelQueueManager>> Create(
+      ProcElaboration&& elaboration, std::unique_ptr<JitRuntime> runtime,
+      const QueueKindFunction& queue_kind);
+
   JitChannelQueue& GetJitQueueByName(std::string_view channel_name,
                                      std::string_view proc_name);
   JitChannelQueue& GetJitQueue(Channel* channel);
@@ -22,6 +22,7 @@
 #include "absl/log/check.h"
 #include "xls/common/benchmark_support.h"
 #include "xls/common/init_xls.h"
+#include "xls/common/thread.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel_ops.h"
 #include "xls/ir/package.h"
@@ -95,6 +96,71 @@ BENCHMARK(BM_QueueWriteThenRead<ThreadUnsafeJitChannelQueue>)
     ->ArgPair(2048, 1)
     ->ArgPair(2048, 128);
 
+BENCHMARK(BM_QueueWriteThenRead<LockFreeSpscJitChannelQueue>)
+    ->ArgPair(1, 1)
+    ->ArgPair(1, 128)
+    ->ArgPair(8, 1)
+    ->ArgPair(8, 128)
+    ->ArgPair(32, 1)
+    ->ArgPair(32, 128)
+    ->ArgPair(2048, 1)
+    ->ArgPair(2048, 128);
+
+// Benchmark evaluating streaming elements through the channel from a producer
+// thread to a consumer thread running concurrently.
+template <typename QueueT,
+          typename std::enable_if<std::is_base_of_v<JitChannelQueue, QueueT>,
+                                  QueueT>::type* = nullptr>
+static void BM_QueueProducerConsumer(benchmark::State& state) {
+  int64_t element_size_bytes = state.range(0);
+
+  Package package("benchmark");
+  auto orc_jit = OrcJit::Create().value();
+  auto jit_runtime =
+      std::make_unique<JitRuntime>(orc_jit->CreateDataLayout().value());
+  Channel* channel =
+      package
+          .CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                  package.GetBitsType(8 * element_size_bytes))
+          .value();
+  ProcElaboration elaboration =
+      ProcElaboration::ElaborateOldStylePackage(&package).value();
+
+  QueueT queue(elaboration.GetUniqueInstance(channel).value(),
+               jit_runtime.get());
+
+  int64_t send_count = state.range(1);
+  for (auto _ : state) {
+    Thread producer([&]() {
+      std::vector<uint8_t> send_buffer(element_size_bytes, 42);
+      for (int64_t i = 0; i < send_count; ++i) {
+        queue.WriteRaw(send_buffer.data());
+      }
+    });
+    std::vector<uint8_t> recv_buffer(element_size_bytes);
+    for (int64_t i = 0; i < send_count;) {
+      if (queue.ReadRaw(recv_buffer.data())) {
+        ++i;
+      }
+    }
+    producer.Join();
+  }
+  state.SetItemsProcessed(state.iterations() * send_count);
+}
+
+// The first element in the pair denotes the buffer size written/read from the
+// channel queue. The second element in the pair denotes the number of elements
+// streamed through the channel queue.
+BENCHMARK(BM_QueueProducerConsumer<ThreadSafeJitChannelQueue>)
+    ->ArgPair(8, 1 << 16)
+    ->ArgPair(2048, 1 << 12)
+    ->UseRealTime();
+
+BENCHMARK(BM_QueueProducerConsumer<LockFreeSpscJitChannelQueue>)
+    ->ArgPair(8, 1 << 16)
+    ->ArgPair(2048, 1 << 12)
+    ->UseRealTime();
+
 }  // namespace
 }  // namespace xls
 
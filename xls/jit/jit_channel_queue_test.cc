@@ -25,8 +25,12 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xls/common/pointer_utils.h"
 #include "xls/common/status/matchers.h"
+#include "xls/common/thread.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/channel_queue_test_base.h"
 #include "xls/ir/bits.h"
@@ -43,6 +47,7 @@ namespace {
 
 using ::absl_testing::StatusIs;
 using ::testing::HasSubstr;
+using ::testing::NotNull;
 
 template <typename JitQueue>
 struct JitRuntimeInfo {
@@ -84,7 +89,8 @@ template <typename QueueT>
 class JitChannelQueueTest : public ::testing::Test {};
 
 using QueueTypes =
-    ::testing::Types<ThreadSafeJitChannelQueue, ThreadUnsafeJitChannelQueue>;
+    ::testing::Types<ThreadSafeJitChannelQueue, ThreadUnsafeJitChannelQueue,
+                     LockFreeSpscJitChannelQueue>;
 TYPED_TEST_SUITE(JitChannelQueueTest, QueueTypes);
 
 // An empty tuple represents a zero width.
@@ -200,5 +206,301 @@ TYPED_TEST(JitChannelQueueTest, IotaGeneratorWithRawApi) {
                                  "a generator function")));
 }
 
+TYPED_TEST(JitChannelQueueTest, ManyElements) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<TypeParam> info(
+      elaboration.GetUniqueInstance(channel).value());
+  TypeParam& queue = *info.jit_queue;
+
+  // Interleave bursts of writes and reads so the queue grows, drains and wraps
+  // around its storage several times.
+  uint32_t next_write = 0;
+  uint32_t next_read = 0;
+  for (int64_t burst = 1; burst <= 2000; burst *= 3) {
+    for (int64_t i = 0; i < burst; ++i) {
+      queue.WriteRaw(reinterpret_cast<const uint8_t*>(&next_write));
+      ++next_write;
+    }
+    EXPECT_EQ(queue.GetSize(), next_write - next_read);
+    for (int64_t i = 0; i < burst / 2; ++i) {
+      uint32_t value;
+      EXPECT_TRUE(queue.ReadRaw(reinterpret_cast<uint8_t*>(&value)));
+      EXPECT_EQ(value, next_read++);
+    }
+  }
+  uint32_t value;
+  while (queue.ReadRaw(reinterpret_cast<uint8_t*>(&value))) {
+    EXPECT_EQ(value, next_read++);
+  }
+  EXPECT_EQ(next_read, next_write);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TYPED_TEST(JitChannelQueueTest, ReserveAndPeekSlots) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<TypeParam> info(
+      elaboration.GetUniqueInstance(channel).value());
+  TypeParam& queue = *info.jit_queue;
+  EXPECT_EQ(queue.element_size(), 4);
+
+  // Batches grow past the initial storage of the queues and leave elements
+  // behind so the slots wrap around.
+  uint32_t next_write = 0;
+  uint32_t next_read = 0;
+  for (int64_t batch = 1; batch <= 3000; batch *= 3) {
+    std::vector<uint8_t*> write_slots(batch);
+    queue.ReserveWriteRaw(absl::MakeSpan(write_slots));
+    for (uint8_t* slot : write_slots) {
+      memcpy(slot, &next_write, sizeof(next_write));
+      ++next_write;
+    }
+    EXPECT_EQ(queue.GetSize(), next_write - next_read - batch);
+    queue.CommitWriteRaw(write_slots);
+    EXPECT_EQ(queue.GetSize(), next_write - next_read);
+
+    std::vector<const uint8_t*> read_slots(batch);
+    int64_t count = queue.PeekReadRaw(absl::MakeSpan(read_slots));
+    EXPECT_EQ(count, batch);
+    // Peeking does not consume the elements.
+    EXPECT_EQ(queue.GetSize(), next_write - next_read);
+    for (int64_t i = 0; i < count / 2; ++i) {
+      uint32_t value;
+      memcpy(&value, read_slots[i], sizeof(value));
+      EXPECT_EQ(value, next_read + i);
+    }
+    queue.ReleaseReadRaw(absl::MakeConstSpan(read_slots).first(count / 2));
+    next_read += count / 2;
+    EXPECT_EQ(queue.GetSize(), next_write - next_read);
+  }
+
+  // The raw read API observes the elements written through the slots.
+  uint32_t value;
+  while (queue.ReadRaw(reinterpret_cast<uint8_t*>(&value))) {
+    EXPECT_EQ(value, next_read++);
+  }
+  EXPECT_EQ(next_read, next_write);
+  std::vector<const uint8_t*> read_slots(4);
+  EXPECT_EQ(queue.PeekReadRaw(absl::MakeSpan(read_slots)), 0);
+}
+
+TYPED_TEST(JitChannelQueueTest, PeekSlotsFromGenerator) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<TypeParam> info(
+      elaboration.GetUniqueInstance(channel).value());
+  TypeParam& queue = *info.jit_queue;
+
+  int64_t counter = 42;
+  XLS_ASSERT_OK(queue.AttachGenerator([&]() -> std::optional<Value> {
+    if (counter == 47) {
+      return std::nullopt;
+    }
+    return Value(UBits(counter++, 32));
+  }));
+
+  std::vector<const uint8_t*> slots(8);
+  ASSERT_EQ(queue.PeekReadRaw(absl::MakeSpan(slots)), 5);
+  for (int64_t i = 0; i < 5; ++i) {
+    uint32_t value;
+    memcpy(&value, slots[i], sizeof(value));
+    EXPECT_EQ(value, 42 + i);
+  }
+  queue.ReleaseReadRaw(absl::MakeConstSpan(slots).first(5));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(ThreadSafeJitChannelQueueTest, SingleValueSlot) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateSingleValueChannel("my_channel", ChannelOps::kSendReceive,
+                                       package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<ThreadSafeJitChannelQueue> info(
+      elaboration.GetUniqueInstance(channel).value());
+  ThreadSafeJitChannelQueue& queue = *info.jit_queue;
+
+  std::vector<const uint8_t*> read_slots(1);
+  EXPECT_EQ(queue.PeekReadRaw(absl::MakeSpan(read_slots)), 0);
+  for (uint32_t i = 0; i < 3; ++i) {
+    std::vector<uint8_t*> write_slots(1);
+    queue.ReserveWriteRaw(absl::MakeSpan(write_slots));
+    memcpy(write_slots[0], &i, sizeof(i));
+    queue.CommitWriteRaw(write_slots);
+  }
+  // Reads of single-value channels are non-destructive.
+  for (int64_t i = 0; i < 2; ++i) {
+    ASSERT_EQ(queue.PeekReadRaw(absl::MakeSpan(read_slots)), 1);
+    uint32_t value;
+    memcpy(&value, read_slots[0], sizeof(value));
+    EXPECT_EQ(value, 2);
+    queue.ReleaseReadRaw(read_slots);
+  }
+  EXPECT_EQ(queue.GetSize(), 1);
+}
+
+TEST(ThreadSafeJitChannelQueueTest, WritesWaitForOutstandingSlots) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<ThreadSafeJitChannelQueue> info(
+      elaboration.GetUniqueInstance(channel).value());
+  ThreadSafeJitChannelQueue& queue = *info.jit_queue;
+
+  uint32_t first = 0;
+  queue.WriteRaw(reinterpret_cast<const uint8_t*>(&first));
+  std::vector<const uint8_t*> read_slots(1);
+  ASSERT_EQ(queue.PeekReadRaw(absl::MakeSpan(read_slots)), 1);
+
+  // Enough writes to grow the storage of the queue several times; they must
+  // not move the peeked element until it is released.
+  constexpr uint32_t kCount = 10000;
+  Thread writer([&]() {
+    for (uint32_t i = 1; i < kCount; ++i) {
+      std::vector<uint8_t*> write_slots(1);
+      queue.ReserveWriteRaw(absl::MakeSpan(write_slots));
+      memcpy(write_slots[0], &i, sizeof(i));
+      queue.CommitWriteRaw(write_slots);
+    }
+  });
+  absl::SleepFor(absl::Milliseconds(50));
+  uint32_t value;
+  memcpy(&value, read_slots[0], sizeof(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_EQ(queue.GetSize(), 1);
+  queue.ReleaseReadRaw(read_slots);
+  writer.Join();
+
+  for (uint32_t i = 1; i < kCount; ++i) {
+    ASSERT_TRUE(queue.ReadRaw(reinterpret_cast<uint8_t*>(&value)));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(LockFreeSpscJitChannelQueueTest, GeneratorChannelsHaveNoOtherProducer) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<LockFreeSpscJitChannelQueue> info(
+      elaboration.GetUniqueInstance(channel).value());
+  LockFreeSpscJitChannelQueue& queue = *info.jit_queue;
+  XLS_ASSERT_OK(queue.AttachGenerator(
+      []() -> std::optional<Value> { return Value(UBits(1, 32)); }));
+
+  uint32_t value = 0;
+  EXPECT_DEATH(queue.WriteRaw(reinterpret_cast<const uint8_t*>(&value)),
+               "has a generator");
+  std::vector<uint8_t*> write_slots(1);
+  EXPECT_DEATH(queue.ReserveWriteRaw(absl::MakeSpan(write_slots)),
+               "has a generator");
+  EXPECT_THAT(queue.Write(Value(UBits(2, 32))),
+              StatusIs(absl::StatusCode::kInternal));
+
+  // The consumer produces the values itself.
+  ASSERT_TRUE(queue.ReadRaw(reinterpret_cast<uint8_t*>(&value)));
+  EXPECT_EQ(value, 1);
+}
+
+TEST(LockFreeSpscJitChannelQueueTest, ConcurrentProducerAndConsumer) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * channel,
+      package.CreateStreamingChannel("my_channel", ChannelOps::kSendReceive,
+                                     package.GetBitsType(64)));
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+
+  JitRuntimeInfo<LockFreeSpscJitChannelQueue> info(
+      elaboration.GetUniqueInstance(channel).value());
+  LockFreeSpscJitChannelQueue& queue = *info.jit_queue;
+
+  constexpr uint64_t kCount = 100000;
+  Thread producer([&]() {
+    for (uint64_t i = 0; i < kCount; ++i) {
+      queue.WriteRaw(reinterpret_cast<const uint8_t*>(&i));
+    }
+  });
+  uint64_t expected = 0;
+  while (expected < kCount) {
+    uint64_t value;
+    if (queue.ReadRaw(reinterpret_cast<uint8_t*>(&value))) {
+      ASSERT_EQ(value, expected);
+      ++expected;
+    }
+  }
+  producer.Join();
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(JitChannelQueueManagerTest, CreateWithQueueKind) {
+  Package package("test");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * streaming,
+      package.CreateStreamingChannel("streaming", ChannelOps::kSendReceive,
+                                     package.GetBitsType(32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Channel * single_value,
+      package.CreateSingleValueChannel("single_value", ChannelOps::kSendReceive,
+                                       package.GetBitsType(32)));
+  auto orc_jit = OrcJit::Create().value();
+  auto data_layout = orc_jit->CreateDataLayout().value();
+
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<JitChannelQueueManager> manager,
+      JitChannelQueueManager::Create(std::move(elaboration),
+                                     std::make_unique<JitRuntime>(data_layout),
+                                     LockFreeSpscWherePossible));
+  EXPECT_THAT(dynamic_cast<LockFreeSpscJitChannelQueue*>(
+                  &manager->GetQueue(streaming)),
+              NotNull());
+  EXPECT_THAT(dynamic_cast<ThreadSafeJitChannelQueue*>(
+                  &manager->GetQueue(single_value)),
+              NotNull());
+
+  XLS_ASSERT_OK_AND_ASSIGN(ProcElaboration elaboration2,
+                           ProcElaboration::ElaborateOldStylePackage(&package));
+  EXPECT_THAT(
+      JitChannelQueueManager::Create(
+          std::move(elaboration2), std::make_unique<JitRuntime>(data_layout),
+          [](ChannelInstance*) { return JitChannelQueueKind::kLockFreeSpsc; }),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("only support streaming channels")));
+}
+
 }  // namespace
 }  // namespace xls
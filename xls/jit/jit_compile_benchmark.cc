@@ -0,0 +1,96 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "xls/common/benchmark_support.h"
+#include "xls/common/init_xls.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/ir/benchmark_support.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/package.h"
+#include "xls/jit/function_jit.h"
+#include "xls/jit/jit_evaluator_options.h"
+
+namespace xls {
+namespace {
+
+// Leaf strategy which cycles through a fixed set of parameters so LLVM cannot
+// constant-fold the generated graph away.
+class CyclingParam final : public benchmark_support::strategy::NullaryNode {
+ public:
+  explicit CyclingParam(std::vector<BValue> params)
+      : params_(std::move(params)) {}
+
+  absl::StatusOr<BValue> GenerateNullaryNode(
+      FunctionBuilder& builder) const final {
+    return params_[next_++ % params_.size()];
+  }
+
+ private:
+  std::vector<BValue> params_;
+  mutable int64_t next_ = 0;
+};
+
+// Benchmark of compiling a function containing a balanced tree of adds of
+// depth `state.range(0)` (i.e., 2^depth nodes) using `state.range(1)` compile
+// threads.
+void BM_CompileBalancedAddTree(benchmark::State& state) {
+  int64_t depth = state.range(0);
+  int64_t compile_threads = state.range(1);
+  Package package("benchmark");
+  FunctionBuilder fb("tree", &package);
+  std::vector<BValue> params;
+  for (int64_t i = 0; i < 16; ++i) {
+    params.push_back(fb.Param(absl::StrCat("p", i), package.GetBitsType(32)));
+  }
+  CyclingParam leaves(params);
+  CHECK_OK(benchmark_support::GenerateBalancedTree(
+                fb, depth, /*fan_out=*/2,
+                benchmark_support::strategy::BinaryAdd(), leaves)
+               .status());
+  Function* function = fb.Build().value();
+  JitEvaluatorOptions jit_options =
+      JitEvaluatorOptions().set_compile_threads(compile_threads);
+  for (auto _ : state) {
+    absl::StatusOr<std::unique_ptr<FunctionJit>> jit =
+        FunctionJit::Create(function, EvaluatorOptions(), jit_options);
+    CHECK_OK(jit.status());
+    benchmark::DoNotOptimize(jit);
+  }
+  state.counters["nodes"] = function->node_count();
+}
+
+BENCHMARK(BM_CompileBalancedAddTree)
+    ->ArgsProduct({{12, 15, 17}, {1, 2, 4, 8, 16}})
+    ->ArgNames({"depth", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace xls
+
+int main(int argc, char* argv[]) {
+  xls::InitXls(argv[0], argc, argv);
+  xls::RunSpecifiedBenchmarks(/*default_spec=*/"all");
+  return 0;
+}
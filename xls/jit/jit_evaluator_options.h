@@ -83,6 +83,31 @@ class JitEvaluatorOptions {
     return generate_only_unopt_llvm_ir_;
   }
 
+  // The maximum number of threads used to compile the LLVM module of a
+  // function or proc. Large modules are split into separate modules which are
+  // optimized and compiled concurrently. If zero, DefaultThreadCount() (which
+  // follows --xls_threads) is used.
+  JitEvaluatorOptions& set_compile_threads(int64_t value) {
+    compile_threads_ = value;
+    return *this;
+  }
+  int64_t compile_threads() const { return compile_threads_; }
+
+  // Directory of a persistent cache of compiled object code shared across
+  // processes. When set, FunctionJit and ProcJit look up the object code of
+  // the function or proc in the cache before invoking LLVM, and add it to the
+  // cache after compiling it. Entries are keyed by a hash of the IR package,
+  // the evaluator options and the LLVM version and target. The cache is not
+  // used when observer callbacks or a JIT observer are requested. If empty, no
+  // cache is used.
+  JitEvaluatorOptions& set_object_cache_directory(std::string value) {
+    object_cache_directory_ = std::move(value);
+    return *this;
+  }
+  const std::string& object_cache_directory() const {
+    return object_cache_directory_;
+  }
+
   JitEvaluatorOptions& set_enable_llvm_coverage(bool value) {
     enable_llvm_coverage_ = value;
     return *this;
@@ -98,6 +123,8 @@ class JitEvaluatorOptions {
   bool generate_skeleton_ = false;
   bool generate_only_unopt_llvm_ir_ = false;
   bool enable_llvm_coverage_ = false;
+  std::string object_cache_directory_;
+  int64_t compile_threads_ = 1;
 };
 
 }  // namespace xls
@@ -0,0 +1,236 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_object_cache.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/functional/function_ref.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "llvm/include/llvm/Config/llvm-config.h"
+#include "llvm/include/llvm/ExecutionEngine/Orc/Shared/ExecutorAddress.h"
+#include "llvm/include/llvm/IR/DataLayout.h"
+#include "llvm/include/llvm/IR/LLVMContext.h"
+#include "llvm/include/llvm/Target/TargetMachine.h"
+#include "openssl/sha.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/ir/format_preference.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/package.h"
+#include "xls/jit/aot_compiler.h"
+#include "xls/jit/aot_entrypoint.h"
+#include "xls/jit/aot_entrypoint.pb.h"
+#include "xls/jit/function_base_jit.h"
+#include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/llvm_type_converter.h"
+#include "xls/jit/orc_jit.h"
+
+namespace xls {
+namespace {
+
+std::atomic<int64_t> cache_hits = 0;
+std::atomic<int64_t> cache_misses = 0;
+
+// Bump whenever the layout of cache entries or the code generated for a given
+// key changes in a way not captured by the key itself.
+constexpr std::string_view kCacheFormatVersion = "xls-jit-object-cache-v1";
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::string> JitObjectCache::ComputeKey(
+    FunctionBase* function_base, const EvaluatorOptions& options,
+    const JitEvaluatorOptions& jit_options) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<AotCompiler> compiler,
+                       AotCompiler::Create(jit_options));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<llvm::TargetMachine> target_machine,
+                       compiler->CreateTargetMachine());
+
+  std::string fingerprint = absl::StrFormat(
+      "%s\nllvm: %s\ntriple: %s\ncpu: %s\nfeatures: %s\n"
+      "opt_level: %d\nmsan: %d\nsalt: %s\n"
+      "trace_channels: %d\nformat: %s\nobservers: %d\ntrace_calls: %d\n"
+      "top: %s\n",
+      kCacheFormatVersion, LLVM_VERSION_STRING, compiler->target_triple(),
+      std::string_view(target_machine->getTargetCPU()),
+      std::string_view(target_machine->getTargetFeatureString()),
+      jit_options.opt_level(), jit_options.include_msan(),
+      jit_options.symbol_salt(), options.trace_channels(),
+      FormatPreferenceToString(options.format_preference()),
+      options.support_observers(), options.trace_calls(),
+      function_base->name());
+  // The function may invoke (or, in the case of procs, communicate with)
+  // other constructs of the package so the whole package is hashed.
+  absl::StrAppend(&fingerprint, function_base->package()->DumpIr());
+
+  std::array<uint8_t, SHA256_DIGEST_LENGTH> digest;
+  SHA256(reinterpret_cast<const uint8_t*>(fingerprint.data()),
+         fingerprint.size(), digest.data());
+  return absl::BytesToHexString(std::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+std::filesystem::path JitObjectCache::ObjectCodePath(
+    std::string_view key) const {
+  return directory_ / absl::StrCat(key, ".o");
+}
+
+std::filesystem::path JitObjectCache::EntrypointsPath(
+    std::string_view key) const {
+  return directory_ / absl::StrCat(key, ".entrypoints.pb");
+}
+
+absl::StatusOr<std::optional<JitObjectCache::Entry>> JitObjectCache::Lookup(
+    std::string_view key) const {
+  // The entrypoints file is written last so its presence indicates a complete
+  // entry.
+  absl::StatusOr<std::string> entrypoints_bytes =
+      GetFileContents(EntrypointsPath(key));
+  if (absl::IsNotFound(entrypoints_bytes.status())) {
+    return std::nullopt;
+  }
+  XLS_RETURN_IF_ERROR(entrypoints_bytes.status());
+  absl::StatusOr<std::string> object_code =
+      GetFileContents(ObjectCodePath(key));
+  if (absl::IsNotFound(object_code.status())) {
+    return std::nullopt;
+  }
+  XLS_RETURN_IF_ERROR(object_code.status());
+
+  Entry entry;
+  if (!entry.entrypoints.ParseFromString(*entrypoints_bytes)) {
+    LOG(WARNING) << "Ignoring corrupt JIT object cache entry "
+                 << EntrypointsPath(key);
+    return std::nullopt;
+  }
+  entry.object_code.assign(object_code->begin(), object_code->end());
+  return entry;
+}
+
+absl::Status JitObjectCache::Insert(std::string_view key,
+                                    const Entry& entry) const {
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(directory_));
+  XLS_RETURN_IF_ERROR(SetFileContentsAtomically(
+      ObjectCodePath(key),
+      std::string_view(reinterpret_cast<const char*>(entry.object_code.data()),
+                       entry.object_code.size())));
+  return SetFileContentsAtomically(EntrypointsPath(key),
+                                   entry.entrypoints.SerializeAsString());
+}
+
+bool UseJitObjectCache(const JitEvaluatorOptions& jit_options) {
+  // Observer callbacks are not supported by the AOT compiler which generates
+  // the cached object code.
+  return !jit_options.object_cache_directory().empty() &&
+         !jit_options.include_observer_callbacks() &&
+         jit_options.jit_observer() == nullptr &&
+         !jit_options.generate_skeleton() &&
+         !jit_options.generate_only_unopt_llvm_ir();
+}
+
+JitObjectCacheStats GetJitObjectCacheStats() {
+  return JitObjectCacheStats{
+      .hits = cache_hits.load(std::memory_order_relaxed),
+      .misses = cache_misses.load(std::memory_order_relaxed)};
+}
+
+absl::StatusOr<CachedJitObjectCode> LoadOrCompileCachedObjectCode(
+    FunctionBase* function_base, const EvaluatorOptions& options,
+    const JitEvaluatorOptions& jit_options,
+    absl::FunctionRef<absl::StatusOr<JitObjectCode>(
+        const JitEvaluatorOptions& aot_options)>
+        compile) {
+  XLS_RET_CHECK(UseJitObjectCache(jit_options));
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<OrcJit> orc_jit,
+                       OrcJit::Create(jit_options.opt_level()));
+  // The object code is linked into this binary so msan instrumentation must
+  // match the binary rather than the requested options.
+  JitEvaluatorOptions aot_options = jit_options;
+  aot_options.set_include_msan(orc_jit->include_msan());
+
+  JitObjectCache cache(jit_options.object_cache_directory());
+  XLS_ASSIGN_OR_RETURN(
+      std::string key,
+      JitObjectCache::ComputeKey(function_base, options, aot_options));
+  XLS_ASSIGN_OR_RETURN(std::optional<JitObjectCache::Entry> entry,
+                       cache.Lookup(key));
+  if (entry.has_value()) {
+    VLOG(2) << absl::StreamFormat("JIT object cache hit for `%s`: %s",
+                                  function_base->name(), key);
+    cache_hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    VLOG(2) << absl::StreamFormat("JIT object cache miss for `%s`: %s",
+                                  function_base->name(), key);
+    cache_misses.fetch_add(1, std::memory_order_relaxed);
+    XLS_ASSIGN_OR_RETURN(JitObjectCode object_code, compile(aot_options));
+    XLS_RET_CHECK_EQ(object_code.entrypoints.size(), 1);
+    llvm::LLVMContext context;
+    LlvmTypeConverter type_converter(&context, object_code.data_layout);
+    entry.emplace();
+    entry->object_code = std::move(object_code.object_code);
+    *entry->entrypoints.mutable_data_layout() =
+        object_code.data_layout.getStringRepresentation();
+    XLS_ASSIGN_OR_RETURN(
+        *entry->entrypoints.add_entrypoint(),
+        GenerateAotEntrypointProto(object_code.package
+                                       ? object_code.package.get()
+                                       : function_base->package(),
+                                   object_code.entrypoints.front(),
+                                   aot_options.include_msan(), type_converter));
+    if (absl::Status status = cache.Insert(key, *entry); !status.ok()) {
+      LOG(WARNING) << absl::StreamFormat(
+          "Unable to add `%s` to the JIT object cache in %s: %s",
+          function_base->name(), cache.directory().string(),
+          status.ToString());
+    }
+  }
+  XLS_RET_CHECK_EQ(entry->entrypoints.entrypoint_size(), 1);
+
+  XLS_RETURN_IF_ERROR(orc_jit->AddObjectCode(entry->object_code, key));
+  CachedJitObjectCode result;
+  result.entrypoint = std::move(*entry->entrypoints.mutable_entrypoint(0));
+  result.data_layout = entry->entrypoints.data_layout();
+  XLS_ASSIGN_OR_RETURN(
+      llvm::orc::ExecutorAddr function_address,
+      orc_jit->LoadSymbol(result.entrypoint.function_symbol()));
+  result.function = absl::bit_cast<JitFunctionType>(function_address);
+  if (result.entrypoint.has_packed_function_symbol()) {
+    XLS_ASSIGN_OR_RETURN(
+        llvm::orc::ExecutorAddr packed_function_address,
+        orc_jit->LoadSymbol(result.entrypoint.packed_function_symbol()));
+    result.packed_function =
+        absl::bit_cast<JitFunctionType>(packed_function_address);
+  }
+  result.orc_jit = std::move(orc_jit);
+  return result;
+}
+
+}  // namespace xls
@@ -0,0 +1,113 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_JIT_OBJECT_CACHE_H_
+#define XLS_JIT_JIT_OBJECT_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/ir/function_base.h"
+#include "xls/jit/aot_entrypoint.pb.h"
+#include "xls/jit/function_base_jit.h"
+#include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/orc_jit.h"
+
+namespace xls {
+
+// A persistent on-disk cache of object code generated by the JIT. Each entry
+// holds the object code of a single function or proc compiled for the host
+// along with the AOT metadata describing how to call it. Entries are written
+// atomically so the cache may be shared by concurrently running processes.
+class JitObjectCache {
+ public:
+  struct Entry {
+    std::vector<uint8_t> object_code;
+    AotPackageEntrypointsProto entrypoints;
+  };
+
+  explicit JitObjectCache(std::filesystem::path directory)
+      : directory_(std::move(directory)) {}
+
+  // Returns the cache key for the given function or proc compiled with the
+  // given options. The key covers the entire IR package as well as everything
+  // which affects code generation such as the LLVM version and target.
+  static absl::StatusOr<std::string> ComputeKey(
+      FunctionBase* function_base, const EvaluatorOptions& options,
+      const JitEvaluatorOptions& jit_options);
+
+  // Returns the entry with the given key or std::nullopt if the cache has no
+  // (valid) entry for the key.
+  absl::StatusOr<std::optional<Entry>> Lookup(std::string_view key) const;
+
+  // Adds the given entry to the cache, replacing any existing entry with the
+  // same key.
+  absl::Status Insert(std::string_view key, const Entry& entry) const;
+
+  const std::filesystem::path& directory() const { return directory_; }
+
+ private:
+  std::filesystem::path ObjectCodePath(std::string_view key) const;
+  std::filesystem::path EntrypointsPath(std::string_view key) const;
+
+  std::filesystem::path directory_;
+};
+
+// Object code of a function or proc linked into an OrcJit.
+struct CachedJitObjectCode {
+  // The JIT holding the linked code. Must outlive any use of the function
+  // pointers below.
+  std::unique_ptr<OrcJit> orc_jit;
+  AotEntrypointProto entrypoint;
+  std::string data_layout;
+  JitFunctionType function;
+  std::optional<JitFunctionType> packed_function;
+};
+
+// Counts of the calls to LoadOrCompileCachedObjectCode in this process which
+// were served from the cache (`hits`) or had to compile (`misses`).
+struct JitObjectCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+};
+JitObjectCacheStats GetJitObjectCacheStats();
+
+// Returns true if the JIT object cache can be used with the given options.
+bool UseJitObjectCache(const JitEvaluatorOptions& jit_options);
+
+// Returns the object code of `function_base` linked into a new OrcJit. The
+// object code is read from the cache in `jit_options.object_cache_directory()`
+// if present. Otherwise `compile` is invoked to compile it ahead-of-time for
+// the host with the given AOT options and the result is added to the cache.
+// Failures to write the cache are logged and otherwise ignored.
+absl::StatusOr<CachedJitObjectCode> LoadOrCompileCachedObjectCode(
+    FunctionBase* function_base, const EvaluatorOptions& options,
+    const JitEvaluatorOptions& jit_options,
+    absl::FunctionRef<absl::StatusOr<JitObjectCode>(
+        const JitEvaluatorOptions& aot_options)>
+        compile);
+
+}  // namespace xls
+
+#endif  // XLS_JIT_JIT_OBJECT_CACHE_H_
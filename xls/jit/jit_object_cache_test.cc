@@ -0,0 +1,160 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/jit_object_cache.h"
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/ir/value_view.h"
+#include "xls/jit/function_base_jit.h"
+#include "xls/jit/function_jit.h"
+#include "xls/jit/jit_evaluator_options.h"
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::testing::Ne;
+
+class JitObjectCacheTest : public IrTestBase {
+ protected:
+  // Builds `x * y + constant` in a new package.
+  absl::StatusOr<Function*> BuildMulAdd(Package* p, int64_t constant) {
+    FunctionBuilder fb(TestName(), p);
+    BValue x = fb.Param("x", p->GetBitsType(32));
+    BValue y = fb.Param("y", p->GetBitsType(32));
+    return fb.BuildWithReturnValue(
+        fb.Add(fb.UMul(x, y), fb.Literal(UBits(constant, 32))));
+  }
+};
+
+TEST_F(JitObjectCacheTest, SecondCreateUsesCachedObjectCode) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  JitEvaluatorOptions jit_options;
+  jit_options.set_object_cache_directory((temp_dir.path() / "cache").string());
+
+  JitObjectCacheStats initial_stats = GetJitObjectCacheStats();
+  auto p1 = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f1, BuildMulAdd(p1.get(), 1));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<FunctionJit> jit1,
+      FunctionJit::Create(f1, EvaluatorOptions(), jit_options));
+  EXPECT_EQ(GetJitObjectCacheStats().hits, initial_stats.hits);
+  EXPECT_EQ(GetJitObjectCacheStats().misses, initial_stats.misses + 1);
+  std::vector<Value> args = {Value(UBits(6, 32)), Value(UBits(7, 32))};
+  EXPECT_THAT(DropInterpreterEvents(jit1->Run(args)),
+              IsOkAndHolds(Value(UBits(43, 32))));
+
+  // The entry is keyed on the IR so an identical function in another package
+  // hits the cache.
+  auto p2 = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f2, BuildMulAdd(p2.get(), 1));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string key1,
+      JitObjectCache::ComputeKey(f1, EvaluatorOptions(), jit_options));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string key2,
+      JitObjectCache::ComputeKey(f2, EvaluatorOptions(), jit_options));
+  EXPECT_EQ(key1, key2);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<FunctionJit> jit2,
+      FunctionJit::Create(f2, EvaluatorOptions(), jit_options));
+  EXPECT_EQ(GetJitObjectCacheStats().hits, initial_stats.hits + 1);
+  EXPECT_EQ(GetJitObjectCacheStats().misses, initial_stats.misses + 1);
+  // A hit never compiles.
+  XLS_EXPECT_OK(LoadOrCompileCachedObjectCode(
+      f2, EvaluatorOptions(), jit_options,
+      [](const JitEvaluatorOptions&) -> absl::StatusOr<JitObjectCode> {
+        return absl::InternalError("Unexpected compilation");
+      }));
+  EXPECT_THAT(DropInterpreterEvents(jit2->Run(args)),
+              IsOkAndHolds(Value(UBits(43, 32))));
+
+  uint32_t x = 3;
+  uint32_t y = 5;
+  uint32_t result = 0;
+  XLS_ASSERT_OK(jit2->RunWithPackedViews(
+      PackedBitsView<32>(reinterpret_cast<uint8_t*>(&x), 0),
+      PackedBitsView<32>(reinterpret_cast<uint8_t*>(&y), 0),
+      PackedBitsView<32>(reinterpret_cast<uint8_t*>(&result), 0)));
+  EXPECT_EQ(result, 16);
+}
+
+TEST_F(JitObjectCacheTest, KeyDependsOnIrAndOptions) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, BuildMulAdd(p.get(), 1));
+  auto other_p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * other_f, BuildMulAdd(other_p.get(), 2));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      JitObjectCache::ComputeKey(f, EvaluatorOptions(), JitEvaluatorOptions()));
+  EXPECT_THAT(JitObjectCache::ComputeKey(other_f, EvaluatorOptions(),
+                                         JitEvaluatorOptions()),
+              IsOkAndHolds(Ne(key)));
+  EXPECT_THAT(
+      JitObjectCache::ComputeKey(f, EvaluatorOptions(),
+                                 JitEvaluatorOptions().set_opt_level(1)),
+      IsOkAndHolds(Ne(key)));
+  EXPECT_THAT(
+      JitObjectCache::ComputeKey(f, EvaluatorOptions().set_trace_calls(true),
+                                 JitEvaluatorOptions()),
+      IsOkAndHolds(Ne(key)));
+}
+
+TEST_F(JitObjectCacheTest, LookupAndInsert) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  JitObjectCache cache(temp_dir.path() / "cache");
+  EXPECT_THAT(cache.Lookup("abc"), IsOkAndHolds(std::nullopt));
+
+  JitObjectCache::Entry entry;
+  entry.object_code = {1, 2, 3};
+  entry.entrypoints.set_data_layout("e-m:e");
+  XLS_ASSERT_OK(cache.Insert("abc", entry));
+  XLS_ASSERT_OK_AND_ASSIGN(std::optional<JitObjectCache::Entry> found,
+                           cache.Lookup("abc"));
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->object_code, entry.object_code);
+  EXPECT_EQ(found->entrypoints.data_layout(), "e-m:e");
+
+  // An entry with a corrupt entrypoints file is treated as a miss.
+  XLS_ASSERT_OK(SetFileContents(
+      temp_dir.path() / "cache" / "abc.entrypoints.pb", "\xff\xff\xff"));
+  EXPECT_THAT(cache.Lookup("abc"), IsOkAndHolds(std::nullopt));
+}
+
+}  // namespace
+}  // namespace xls
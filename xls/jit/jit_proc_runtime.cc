@@ -38,6 +38,7 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/channel_queue.h"
 #include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/parallel_proc_runtime.h"
 #include "xls/interpreter/proc_evaluator.h"
 #include "xls/interpreter/serial_proc_runtime.h"
 #include "xls/ir/package.h"
@@ -53,6 +54,7 @@
 #include "xls/jit/llvm_compiler.h"
 #include "xls/jit/observer.h"
 #include "xls/jit/proc_jit.h"
+#include "xls/jit/tiered_proc_evaluator.h"
 
 namespace xls {
 namespace {
@@ -233,8 +235,15 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateAotRuntime(
   return std::move(proc_runtime);
 }
 
-absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
-    ProcElaboration elaboration, const EvaluatorOptions& options) {
+// Creates a runtime of type `RuntimeT` composed of ProcJits (or, if `tiered`
+// is true, TieredProcEvaluators). `queue_kind` selects the channel queue
+// implementation of each channel instance and `create_runtime` constructs the
+// runtime from the evaluators and the queue manager.
+template <typename RuntimeT, typename CreateFn>
+absl::StatusOr<std::unique_ptr<RuntimeT>> CreateRuntime(
+    ProcElaboration elaboration, const EvaluatorOptions& options,
+    const JitChannelQueueManager::QueueKindFunction& queue_kind,
+    CreateFn create_runtime, bool tiered = false) {
   // We use the compiler to know the data layout.
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<OrcJit> comp,
@@ -246,32 +255,71 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateRuntime(
   // receive only queue for every receive only channel.
   XLS_ASSIGN_OR_RETURN(
       std::unique_ptr<JitChannelQueueManager> queue_manager,
-      JitChannelQueueManager::CreateThreadSafe(
-          std::move(elaboration), std::make_unique<JitRuntime>(layout)));
+      JitChannelQueueManager::Create(std::move(elaboration),
+                                     std::make_unique<JitRuntime>(layout),
+                                     queue_kind));
 
   // Create a ProcJit for each Proc.
   std::vector<std::unique_ptr<ProcEvaluator>> proc_jits;
+  JitEvaluatorOptions jit_options =
+      JitEvaluatorOptions().set_include_observer_callbacks(
+          options.support_observers());
   for (Proc* proc : queue_manager->elaboration().procs()) {
+    if (tiered) {
+      XLS_ASSIGN_OR_RETURN(
+          std::unique_ptr<TieredProcEvaluator> evaluator,
+          TieredProcEvaluator::Create(proc, queue_manager.get(), options,
+                                      jit_options));
+      proc_jits.push_back(std::move(evaluator));
+      continue;
+    }
     XLS_ASSIGN_OR_RETURN(
         std::unique_ptr<ProcJit> proc_jit,
         ProcJit::Create(proc, &queue_manager->runtime(), queue_manager.get(),
-                        options,
-                        JitEvaluatorOptions().set_include_observer_callbacks(
-                            options.support_observers())));
+                        options, jit_options));
     proc_jits.push_back(std::move(proc_jit));
   }
 
   // Create a runtime.
   XLS_ASSIGN_OR_RETURN(
-      std::unique_ptr<SerialProcRuntime> proc_runtime,
-      SerialProcRuntime::Create(std::move(proc_jits), std::move(queue_manager),
-                                options));
+      std::unique_ptr<RuntimeT> proc_runtime,
+      create_runtime(std::move(proc_jits), std::move(queue_manager)));
 
   XLS_RETURN_IF_ERROR(InsertInitialChannelValues(
       proc_runtime->elaboration(), proc_runtime->queue_manager()));
   return std::move(proc_runtime);
 }
 
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateSerialRuntime(
+    ProcElaboration elaboration, const EvaluatorOptions& options,
+    bool tiered = false) {
+  return CreateRuntime<SerialProcRuntime>(
+      std::move(elaboration), options,
+      [](ChannelInstance*) { return JitChannelQueueKind::kThreadSafe; },
+      [&](std::vector<std::unique_ptr<ProcEvaluator>>&& proc_jits,
+          std::unique_ptr<ChannelQueueManager>&& queue_manager) {
+        return SerialProcRuntime::Create(std::move(proc_jits),
+                                         std::move(queue_manager), options);
+      },
+      tiered);
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>> CreateParallelRuntime(
+    ProcElaboration elaboration, const EvaluatorOptions& options,
+    int64_t thread_count) {
+  // Each streaming channel instance is written by a single proc instance and
+  // read by a single proc instance, and the runtime never ticks a proc
+  // instance on two threads at once, so the lock-free queues suffice.
+  return CreateRuntime<ParallelProcRuntime>(
+      std::move(elaboration), options, LockFreeSpscWherePossible,
+      [&](std::vector<std::unique_ptr<ProcEvaluator>>&& proc_jits,
+          std::unique_ptr<ChannelQueueManager>&& queue_manager) {
+        return ParallelProcRuntime::Create(std::move(proc_jits),
+                                           std::move(queue_manager), options,
+                                           thread_count);
+      });
+}
+
 }  // namespace
 
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateJitSerialProcRuntime(
@@ -282,14 +330,53 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateJitSerialProcRuntime(
   }
   XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
                        ProcElaboration::ElaborateOldStylePackage(package));
-  return CreateRuntime(std::move(elaboration), options);
+  return CreateSerialRuntime(std::move(elaboration), options);
 }
 
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateJitSerialProcRuntime(
     Proc* top, const EvaluatorOptions& options) {
   XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
                        ProcElaboration::Elaborate(top));
-  return CreateRuntime(std::move(elaboration), options);
+  return CreateSerialRuntime(std::move(elaboration), options);
+}
+
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>>
+CreateTieredJitSerialProcRuntime(Package* package,
+                                 const EvaluatorOptions& options) {
+  if (package->ChannelsAreProcScoped()) {
+    XLS_ASSIGN_OR_RETURN(Proc * top, package->GetTopAsProc());
+    return CreateTieredJitSerialProcRuntime(top, options);
+  }
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::ElaborateOldStylePackage(package));
+  return CreateSerialRuntime(std::move(elaboration), options, /*tiered=*/true);
+}
+
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>>
+CreateTieredJitSerialProcRuntime(Proc* top, const EvaluatorOptions& options) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::Elaborate(top));
+  return CreateSerialRuntime(std::move(elaboration), options, /*tiered=*/true);
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateJitParallelProcRuntime(Package* package, const EvaluatorOptions& options,
+                             int64_t thread_count) {
+  if (package->ChannelsAreProcScoped()) {
+    XLS_ASSIGN_OR_RETURN(Proc * top, package->GetTopAsProc());
+    return CreateJitParallelProcRuntime(top, options, thread_count);
+  }
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::ElaborateOldStylePackage(package));
+  return CreateParallelRuntime(std::move(elaboration), options, thread_count);
+}
+
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateJitParallelProcRuntime(Proc* top, const EvaluatorOptions& options,
+                             int64_t thread_count) {
+  XLS_ASSIGN_OR_RETURN(ProcElaboration elaboration,
+                       ProcElaboration::Elaborate(top));
+  return CreateParallelRuntime(std::move(elaboration), options, thread_count);
 }
 
 absl::StatusOr<JitObjectCode> CreateProcAotObjectCode(
@@ -15,12 +15,14 @@
 #ifndef XLS_JIT_JIT_PROC_RUNTIME_H_
 #define XLS_JIT_JIT_PROC_RUNTIME_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/parallel_proc_runtime.h"
 #include "xls/interpreter/serial_proc_runtime.h"
 #include "xls/ir/package.h"
 #include "xls/ir/xls_ir_interface.pb.h"
@@ -41,6 +43,37 @@ absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateJitSerialProcRuntime(
 absl::StatusOr<std::unique_ptr<SerialProcRuntime>> CreateJitSerialProcRuntime(
     Proc* top, const EvaluatorOptions& options = EvaluatorOptions());
 
+// Create a SerialProcRuntime which starts out interpreting each proc while the
+// procs are JIT compiled in background threads. Each proc switches to the
+// compiled code once it is available (see TieredProcEvaluator). Useful for
+// short simulations where compilation time dominates. Works with old- or
+// new-style procs.
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>>
+CreateTieredJitSerialProcRuntime(
+    Package* package, const EvaluatorOptions& options = EvaluatorOptions());
+
+// Create a tiered SerialProcRuntime constructed from the elaboration of the
+// given proc. Requires new-style (proc-scoped channel) procs.
+absl::StatusOr<std::unique_ptr<SerialProcRuntime>>
+CreateTieredJitSerialProcRuntime(
+    Proc* top, const EvaluatorOptions& options = EvaluatorOptions());
+
+// Create a ParallelProcRuntime composed of ProcJits which ticks independent
+// procs concurrently on up to `thread_count` threads (zero means the number of
+// available CPUs). Works with old- or new-style procs.
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateJitParallelProcRuntime(
+    Package* package, const EvaluatorOptions& options = EvaluatorOptions(),
+    int64_t thread_count = 0);
+
+// Create a ParallelProcRuntime composed of ProcJits. Constructed from the
+// elaboration of the given proc. Requires new-style (proc-scoped channel)
+// procs.
+absl::StatusOr<std::unique_ptr<ParallelProcRuntime>>
+CreateJitParallelProcRuntime(
+    Proc* top, const EvaluatorOptions& options = EvaluatorOptions(),
+    int64_t thread_count = 0);
+
 struct ProcAotEntrypoints {
   // What proc these entrypoints are associated with.
   PackageInterfaceProto::Proc proc_interface_proto;
@@ -14,11 +14,13 @@
 
 #include "xls/jit/orc_jit.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "absl/log/log.h"
 #include "absl/log/vlog_is_on.h"
@@ -27,8 +29,12 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "llvm/include/llvm/ADT/SmallVector.h"
+#include "llvm/include/llvm/ADT/StringRef.h"
 #include "llvm/include/llvm/Analysis/CGSCCPassManager.h"
+#include "llvm/include/llvm/Bitcode/BitcodeReader.h"
+#include "llvm/include/llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/AbsoluteSymbols.h"  // IWYU pragma: keep
 #include "llvm/include/llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/Core.h"
@@ -49,7 +55,9 @@
 #include "llvm/include/llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/include/llvm/IR/BasicBlock.h"
 #include "llvm/include/llvm/IR/DataLayout.h"
+#include "llvm/include/llvm/IR/Function.h"
 #include "llvm/include/llvm/IR/Instruction.h"
+#include "llvm/include/llvm/IR/LLVMContext.h"
 #include "llvm/include/llvm/IR/LegacyPassManager.h"
 #include "llvm/include/llvm/IR/Module.h"
 #include "llvm/include/llvm/IRPrinter/IRPrintingPasses.h"
@@ -60,8 +68,10 @@
 #include "llvm/include/llvm/Support/MemoryBuffer.h"
 #include "llvm/include/llvm/Support/raw_ostream.h"
 #include "llvm/include/llvm/Transforms/Instrumentation/MemorySanitizer.h"
+#include "llvm/include/llvm/Transforms/Utils/SplitModule.h"
 #include "xls/common/logging/log_lines.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/jit/jit_clang_builtins.h"
 #include "xls/jit/jit_emulated_tls.h"  // NOLINT: Used with MSAN
 #include "xls/jit/llvm_compiler.h"
@@ -70,6 +80,11 @@
 namespace xls {
 
 namespace {
+
+// Minimum number of LLVM functions in each module when splitting a module for
+// concurrent compilation. Smaller modules do not amortize the cost of
+// serializing the module and starting a thread.
+constexpr int64_t kMinFunctionsPerSplitModule = 256;
 // TODO: move to ExecutorProcessControl-based APIs.
 class UnsupportedExecutorProcessControl
     : public llvm::orc::ExecutorProcessControl {
@@ -113,7 +128,7 @@ class UnsupportedExecutorProcessControl
 }  // namespace
 
 OrcJit::OrcJit(int64_t opt_level, bool include_msan,
-               bool include_observer_callbacks)
+               bool include_observer_callbacks, int64_t compile_threads)
     : LlvmCompiler(opt_level, include_msan, include_observer_callbacks,
                    /*include_llvm_coverage=*/false),
       context_(std::make_unique<llvm::LLVMContext>()),
@@ -122,7 +137,8 @@ OrcJit::OrcJit(int64_t opt_level, bool include_msan,
                     [](const llvm::MemoryBuffer&) {
                       return std::make_unique<llvm::SectionMemoryManager>();
                     }),
-      dylib_(execution_session_.createBareJITDylib("main")) {}
+      dylib_(execution_session_.createBareJITDylib("main")),
+      compile_threads_(compile_threads) {}
 
 OrcJit::~OrcJit() {
   if (auto err = execution_session_.endSession()) {
@@ -183,15 +199,19 @@ llvm::Expected<llvm::orc::ThreadSafeModule> OrcJit::Optimizer(
 }
 
 absl::StatusOr<std::unique_ptr<OrcJit>> OrcJit::Create(
-    int64_t opt_level, bool include_observer_callbacks, JitObserver* observer) {
+    int64_t opt_level, bool include_observer_callbacks, JitObserver* observer,
+    int64_t compile_threads) {
   LlvmCompiler::InitializeLlvm();
 #ifdef ABSL_HAVE_MEMORY_SANITIZER
   constexpr bool kHasMsan = true;
 #else
   constexpr bool kHasMsan = false;
 #endif
-  std::unique_ptr<OrcJit> jit = absl::WrapUnique(
-      new OrcJit(opt_level, kHasMsan, include_observer_callbacks));
+  if (compile_threads == 0) {
+    compile_threads = DefaultThreadCount();
+  }
+  std::unique_ptr<OrcJit> jit = absl::WrapUnique(new OrcJit(
+      opt_level, kHasMsan, include_observer_callbacks, compile_threads));
   jit->SetJitObserver(observer);
   XLS_RETURN_IF_ERROR(jit->Init());
   return std::move(jit);
@@ -287,8 +307,106 @@ absl::Status OrcJit::InitInternal() {
   return absl::OkStatus();
 }
 
+int64_t OrcJit::GetSplitModuleCount(const llvm::Module& module) const {
+  // Observers are notified of the entire module.
+  if (compile_threads_ <= 1 || jit_observer_ != nullptr) {
+    return 1;
+  }
+  int64_t function_count = 0;
+  for (const llvm::Function& function : module.functions()) {
+    if (!function.isDeclaration()) {
+      ++function_count;
+    }
+  }
+  return std::clamp<int64_t>(function_count / kMinFunctionsPerSplitModule, 1,
+                             compile_threads_);
+}
+
+absl::StatusOr<llvm::SmallVector<char, 0>> OrcJit::OptimizeAndEmitObjectCode(
+    const llvm::SmallVector<char, 0>& bitcode,
+    llvm::TargetMachine& target_machine) {
+  // LLVM contexts are not thread-safe so each split module is parsed into its
+  // own context.
+  llvm::LLVMContext context;
+  llvm::Expected<std::unique_ptr<llvm::Module>> module = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()),
+                            "split_module"),
+      context);
+  if (!module) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to parse split module: %s",
+                        llvm::toString(module.takeError())));
+  }
+  if (llvm::Error error = PerformStandardOptimization(module->get())) {
+    return absl::InternalError(
+        absl::StrFormat("Error optimizing split module: %s",
+                        llvm::toString(std::move(error))));
+  }
+  // The ostream must outlive the pass manager which flushes it on
+  // destruction.
+  llvm::SmallVector<char, 0> object_code;
+  llvm::raw_svector_ostream ostream(object_code);
+  {
+    llvm::legacy::PassManager mpm;
+    if (target_machine.addPassesToEmitFile(mpm, ostream, nullptr,
+                                           llvm::CodeGenFileType::ObjectFile)) {
+      return absl::InternalError("Unable to add passes for object code");
+    }
+    mpm.run(**module);
+  }
+  return object_code;
+}
+
+absl::Status OrcJit::CompileModuleInParallel(
+    std::unique_ptr<llvm::Module>&& module, int64_t split_count) {
+  VLOG(2) << absl::StreamFormat(
+      "Compiling module in %d parts on separate threads", split_count);
+  VLOG(2) << "Unoptimized module IR:";
+  XLS_VLOG_LINES(2, DumpLlvmModuleToString(module.get()));
+
+  // Local symbols are preserved so that functions which reference the same
+  // private functions or globals (e.g., a partition function and the node
+  // functions it calls) remain in the same module and may be inlined.
+  std::vector<llvm::SmallVector<char, 0>> split_bitcode;
+  llvm::SplitModule(
+      *module, split_count,
+      [&](std::unique_ptr<llvm::Module> split_module) {
+        llvm::raw_svector_ostream ostream(split_bitcode.emplace_back());
+        llvm::WriteBitcodeToFile(*split_module, ostream);
+      },
+      /*PreserveLocals=*/true);
+  module.reset();
+
+  std::vector<std::unique_ptr<llvm::TargetMachine>> target_machines;
+  for (int64_t i = 0; i < split_bitcode.size(); ++i) {
+    XLS_ASSIGN_OR_RETURN(target_machines.emplace_back(),
+                         CreateTargetMachine());
+  }
+  std::vector<absl::StatusOr<llvm::SmallVector<char, 0>>> object_code(
+      split_bitcode.size());
+  XLS_RETURN_IF_ERROR(DefaultThreadPool().ParallelFor(
+      split_bitcode.size(), [&](int64_t i) {
+        object_code[i] =
+            OptimizeAndEmitObjectCode(split_bitcode[i], *target_machines[i]);
+        return absl::OkStatus();
+      }));
+
+  for (int64_t i = 0; i < object_code.size(); ++i) {
+    XLS_RETURN_IF_ERROR(object_code[i].status());
+    XLS_RETURN_IF_ERROR(AddObjectCode(
+        absl::MakeConstSpan(
+            reinterpret_cast<const uint8_t*>(object_code[i]->data()),
+            object_code[i]->size()),
+        absl::StrFormat("split_module_%d", i)));
+  }
+  return absl::OkStatus();
+}
+
 absl::Status OrcJit::CompileModule(std::unique_ptr<llvm::Module>&& module) {
   XLS_RETURN_IF_ERROR(VerifyModule(*module));
+  if (int64_t split_count = GetSplitModuleCount(*module); split_count > 1) {
+    return CompileModuleInParallel(std::move(module), split_count);
+  }
   llvm::Error error = transform_layer_->add(
       dylib_, llvm::orc::ThreadSafeModule(std::move(module), context_));
   if (error) {
@@ -298,6 +416,22 @@ absl::Status OrcJit::CompileModule(std::unique_ptr<llvm::Module>&& module) {
   return absl::OkStatus();
 }
 
+absl::Status OrcJit::AddObjectCode(absl::Span<const uint8_t> object_code,
+                                  std::string_view name) {
+  std::unique_ptr<llvm::MemoryBuffer> buffer =
+      llvm::MemoryBuffer::getMemBufferCopy(
+          llvm::StringRef(reinterpret_cast<const char*>(object_code.data()),
+                          object_code.size()),
+          name);
+  llvm::Error error = object_layer_.add(dylib_, std::move(buffer));
+  if (error) {
+    return absl::UnknownError(absl::StrFormat(
+        "Error adding object code `%s`: %s", name,
+        llvm::toString(std::move(error))));
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<llvm::orc::ExecutorAddr> OrcJit::LoadSymbol(
     std::string_view function_name) {
 #ifdef __APPLE__
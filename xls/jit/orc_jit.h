@@ -21,6 +21,8 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/IRTransformLayer.h"
@@ -28,6 +30,7 @@
 #include "llvm/include/llvm/ExecutionEngine/Orc/Shared/ExecutorAddress.h"
 #include "llvm/include/llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/include/llvm/IR/DataLayout.h"
+#include "llvm/include/llvm/IR/Module.h"
 #include "llvm/include/llvm/Support/Error.h"
 #include "llvm/include/llvm/Support/raw_ostream.h"
 #include "llvm/include/llvm/Target/TargetMachine.h"
@@ -50,10 +53,15 @@ class OrcJit : public LlvmCompiler {
   // compiler should use the 3-argument version above. Passing nullopt to
   // emit_msan directs the jit to use MSAN if the running binary is MSAN and
   // vice-versa.
+  //
+  // `compile_threads` is the maximum number of threads used to optimize and
+  // generate code for a module. Large modules are split into that many
+  // separate modules which are compiled concurrently on DefaultThreadPool()
+  // and then linked. If zero, DefaultThreadCount() is used.
   static absl::StatusOr<std::unique_ptr<OrcJit>> Create(
       int64_t opt_level = kDefaultOptLevel,
       bool include_observer_callbacks = false,
-      JitObserver* jit_observer = nullptr);
+      JitObserver* jit_observer = nullptr, int64_t compile_threads = 1);
 
   void SetJitObserver(JitObserver* o) { jit_observer_ = o; }
 
@@ -62,6 +70,12 @@ class OrcJit : public LlvmCompiler {
   // Compiles the given LLVM module into the JIT's execution session.
   absl::Status CompileModule(std::unique_ptr<llvm::Module>&& module) override;
 
+  // Links the given relocatable object file (e.g., as produced by the
+  // AotCompiler for the host) into the JIT's execution session. Symbols
+  // defined by the object can then be retrieved with LoadSymbol.
+  absl::Status AddObjectCode(absl::Span<const uint8_t> object_code,
+                             std::string_view name);
+
   // Returns the address of the given JIT'ed function.
   absl::StatusOr<llvm::orc::ExecutorAddr> LoadSymbol(
       std::string_view function_name);
@@ -79,7 +93,26 @@ class OrcJit : public LlvmCompiler {
   absl::Status InitInternal() override;
 
  private:
-  OrcJit(int64_t opt_level, bool include_msan, bool include_observer_callbacks);
+  OrcJit(int64_t opt_level, bool include_msan, bool include_observer_callbacks,
+         int64_t compile_threads);
+
+  // Returns the number of modules into which the given module should be split
+  // for concurrent compilation. A return value of one indicates the module
+  // should be compiled on the calling thread in one piece.
+  int64_t GetSplitModuleCount(const llvm::Module& module) const;
+
+  // Splits the module into `split_count` modules, each in its own LLVM
+  // context, which are optimized and compiled to object code concurrently.
+  // The resulting object files are linked into the JIT's execution session.
+  absl::Status CompileModuleInParallel(std::unique_ptr<llvm::Module>&& module,
+                                       int64_t split_count);
+
+  // Optimizes the module serialized as `bitcode` and returns the generated
+  // object code. Thread-safe as long as each caller passes a distinct target
+  // machine.
+  absl::StatusOr<llvm::SmallVector<char, 0>> OptimizeAndEmitObjectCode(
+      const llvm::SmallVector<char, 0>& bitcode,
+      llvm::TargetMachine& target_machine);
 
   // Method which optimizes the given module. Used within the JIT to form an IR
   // transform layer.
@@ -96,6 +129,7 @@ class OrcJit : public LlvmCompiler {
   std::unique_ptr<llvm::orc::IRTransformLayer> transform_layer_;
 
   JitObserver* jit_observer_ = nullptr;
+  int64_t compile_threads_;
 };
 
 }  // namespace xls
@@ -33,6 +33,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "llvm/include/llvm/IR/DataLayout.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
 #include "xls/interpreter/evaluator_options.h"
@@ -46,12 +47,14 @@
 #include "xls/ir/proc_elaboration.h"
 #include "xls/ir/state_element.h"
 #include "xls/ir/value.h"
+#include "xls/jit/aot_compiler.h"
 #include "xls/jit/aot_entrypoint.pb.h"
 #include "xls/jit/function_base_jit.h"
 #include "xls/jit/jit_buffer.h"
 #include "xls/jit/jit_callbacks.h"
 #include "xls/jit/jit_channel_queue.h"
 #include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/jit_object_cache.h"
 #include "xls/jit/jit_runtime.h"
 #include "xls/jit/llvm_compiler.h"
 #include "xls/jit/observer.h"
@@ -340,28 +343,80 @@ absl::Status InitializeChannelQueues(
   return jit;
 }
 
-absl::StatusOr<std::unique_ptr<ProcJit>> ProcJit::Create(
-    Proc* proc, JitRuntime* jit_runtime, JitChannelQueueManager* queue_mgr,
-    const EvaluatorOptions& options, const JitEvaluatorOptions& jit_options) {
+/* static */ absl::StatusOr<ProcJit::CompiledProc> ProcJit::Compile(
+    Proc* proc, const EvaluatorOptions& options,
+    const JitEvaluatorOptions& jit_options) {
+  if (UseJitObjectCache(jit_options)) {
+    XLS_ASSIGN_OR_RETURN(
+        CachedJitObjectCode cached,
+        LoadOrCompileCachedObjectCode(
+            proc, options, jit_options,
+            [&](const JitEvaluatorOptions& aot_options)
+                -> absl::StatusOr<JitObjectCode> {
+              XLS_ASSIGN_OR_RETURN(std::unique_ptr<AotCompiler> comp,
+                                   AotCompiler::Create(aot_options));
+              XLS_ASSIGN_OR_RETURN(llvm::DataLayout data_layout,
+                                   comp->CreateDataLayout());
+              XLS_ASSIGN_OR_RETURN(
+                  JittedFunctionBase jfb,
+                  JittedFunctionBase::Build(proc, *comp, options,
+                                            aot_options.symbol_salt()));
+              XLS_ASSIGN_OR_RETURN(std::vector<uint8_t> object_code,
+                                   std::move(comp)->GetObjectCode());
+              JitObjectCode result{.object_code = std::move(object_code),
+                                   .data_layout = data_layout};
+              result.entrypoints.push_back(FunctionEntrypoint{
+                  .function = proc, .jit_info = std::move(jfb)});
+              return result;
+            }));
+    XLS_ASSIGN_OR_RETURN(
+        JittedFunctionBase jitted_function_base,
+        JittedFunctionBase::BuildFromAot(cached.entrypoint, cached.function,
+                                         cached.packed_function));
+    return CompiledProc{.orc_jit = std::move(cached.orc_jit),
+                        .jitted_function_base = std::move(jitted_function_base),
+                        .has_observer_callbacks = false};
+  }
+
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<OrcJit> orc_jit,
                        OrcJit::Create(jit_options.opt_level(),
                                       jit_options.include_observer_callbacks(),
-                                      jit_options.jit_observer()));
-  auto jit = absl::WrapUnique(
-      new ProcJit(proc, jit_runtime, queue_mgr, std::move(orc_jit),
-                  jit_options.include_observer_callbacks(), options));
-  XLS_ASSIGN_OR_RETURN(
-      jit->jitted_function_base_,
-      JittedFunctionBase::Build(proc, jit->GetOrcJit(), options,
-                                jit_options.symbol_salt()));
-  XLS_RET_CHECK(jit->jitted_function_base_.InputsAndOutputsAreEquivalent());
+                                      jit_options.jit_observer(),
+                                      jit_options.compile_threads()));
+  XLS_ASSIGN_OR_RETURN(JittedFunctionBase jitted_function_base,
+                       JittedFunctionBase::Build(proc, *orc_jit, options,
+                                                 jit_options.symbol_salt()));
+  return CompiledProc{
+      .orc_jit = std::move(orc_jit),
+      .jitted_function_base = std::move(jitted_function_base),
+      .has_observer_callbacks = jit_options.include_observer_callbacks()};
+}
 
+/* static */ absl::StatusOr<std::unique_ptr<ProcJit>>
+ProcJit::CreateFromCompiled(Proc* proc, JitRuntime* jit_runtime,
+                            JitChannelQueueManager* queue_mgr,
+                            CompiledProc compiled,
+                            const EvaluatorOptions& options) {
+  auto jit = absl::WrapUnique(new ProcJit(proc, jit_runtime, queue_mgr,
+                                          std::move(compiled.orc_jit),
+                                          compiled.has_observer_callbacks,
+                                          options));
+  jit->jitted_function_base_ = std::move(compiled.jitted_function_base);
+  XLS_RET_CHECK(jit->jitted_function_base_.InputsAndOutputsAreEquivalent());
   XLS_RETURN_IF_ERROR(InitializeChannelQueues(
       proc, queue_mgr, jit->jitted_function_base_, jit->channel_queues_));
-
   return jit;
 }
 
+absl::StatusOr<std::unique_ptr<ProcJit>> ProcJit::Create(
+    Proc* proc, JitRuntime* jit_runtime, JitChannelQueueManager* queue_mgr,
+    const EvaluatorOptions& options, const JitEvaluatorOptions& jit_options) {
+  XLS_ASSIGN_OR_RETURN(CompiledProc compiled,
+                       Compile(proc, options, jit_options));
+  return CreateFromCompiled(proc, jit_runtime, queue_mgr, std::move(compiled),
+                            options);
+}
+
 std::unique_ptr<ProcContinuation> ProcJit::NewContinuation(
     ProcInstance* proc_instance) const {
   CHECK_EQ(proc_instance->proc(), proc());
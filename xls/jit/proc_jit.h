@@ -47,6 +47,26 @@ class ProcJit : public ProcEvaluator {
       const EvaluatorOptions& options = EvaluatorOptions(),
       const JitEvaluatorOptions& jit_options = JitEvaluatorOptions());
 
+  // The host-compiled code of a proc, not yet bound to any channel queues.
+  // The code refers to the proc only by node ids and channel names so it may
+  // be compiled from a copy of the proc which has the same node ids (e.g., one
+  // parsed from the proc's IR text) unless it includes observer callbacks,
+  // which embed node pointers.
+  struct CompiledProc {
+    std::unique_ptr<OrcJit> orc_jit;
+    JittedFunctionBase jitted_function_base;
+    bool has_observer_callbacks = false;
+  };
+  static absl::StatusOr<CompiledProc> Compile(
+      Proc* proc, const EvaluatorOptions& options = EvaluatorOptions(),
+      const JitEvaluatorOptions& jit_options = JitEvaluatorOptions());
+
+  // Returns a ProcJit which evaluates `proc` with the code in `compiled`.
+  static absl::StatusOr<std::unique_ptr<ProcJit>> CreateFromCompiled(
+      Proc* proc, JitRuntime* jit_runtime, JitChannelQueueManager* queue_mgr,
+      CompiledProc compiled,
+      const EvaluatorOptions& options = EvaluatorOptions());
+
   static absl::StatusOr<std::unique_ptr<ProcJit>> CreateFromAot(
       Proc* proc, JitRuntime* jit_runtime, JitChannelQueueManager* queue_mgr,
       const AotEntrypointProto& entrypoint, JitFunctionType unpacked,
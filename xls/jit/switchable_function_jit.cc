@@ -23,16 +23,20 @@
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
 #include "absl/types/span.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/interpreter/bytecode_interpreter.h"
 #include "xls/interpreter/evaluator_options.h"
 #include "xls/interpreter/ir_interpreter.h"
 #include "xls/ir/events.h"
 #include "xls/ir/function.h"
 #include "xls/ir/node.h"
 #include "xls/ir/nodes.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/jit/background_compile.h"
 #include "xls/jit/function_jit.h"
 #include "xls/jit/jit_evaluator_options.h"
 #include "xls/jit/observer.h"
@@ -69,6 +73,64 @@ SwitchableFunctionJit::CreateInterpreter(Function* xls_function) {
       new SwitchableFunctionJit(xls_function, /*use_jit=*/false, nullptr));
 }
 
+absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>>
+SwitchableFunctionJit::CreateBytecodeInterpreter(Function* xls_function) {
+  auto interpreter = std::unique_ptr<SwitchableFunctionJit>(
+      new SwitchableFunctionJit(xls_function, /*use_jit=*/false, nullptr));
+  XLS_ASSIGN_OR_RETURN(interpreter->bytecode_,
+                       BytecodeFunction::Compile(xls_function));
+  return interpreter;
+}
+
+absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>>
+SwitchableFunctionJit::CreateTiered(Function* xls_function, int64_t opt_level,
+                                    JitObserver* observer) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<SwitchableFunctionJit> tiered,
+                       CreateBytecodeInterpreter(xls_function));
+  auto compile = std::make_shared<BackgroundCompile>();
+  XLS_ASSIGN_OR_RETURN(
+      compile->package,
+      CopyPackageForBackgroundCompile(xls_function->package()));
+  XLS_ASSIGN_OR_RETURN(Function * compiled_function,
+                       compile->package->GetFunction(xls_function->name()));
+  if (observer != nullptr) {
+    compile->jit_observer = std::make_unique<DetachableJitObserver>(observer);
+  }
+  tiered->compile_ = compile;
+  RunInBackground([compile, compiled_function, opt_level]() {
+    absl::StatusOr<std::unique_ptr<FunctionJit>> jit = FunctionJit::Create(
+        compiled_function, EvaluatorOptions(),
+        JitEvaluatorOptions()
+            .set_opt_level(opt_level)
+            .set_include_observer_callbacks(false)
+            .set_jit_observer(compile->jit_observer.get()));
+    if (jit.ok()) {
+      compile->jit = *std::move(jit);
+    } else {
+      LOG(WARNING) << "Unable to JIT compile function `"
+                   << compiled_function->name()
+                   << "`, continuing with the interpreter: " << jit.status();
+      compile->status = jit.status();
+    }
+    compile->done.Notify();
+  });
+  return tiered;
+}
+
+SwitchableFunctionJit::~SwitchableFunctionJit() {
+  if (compile_ != nullptr && compile_->jit_observer != nullptr) {
+    compile_->jit_observer->Detach();
+  }
+}
+
+absl::Status SwitchableFunctionJit::WaitForJit() {
+  if (compile_ == nullptr) {
+    return absl::OkStatus();
+  }
+  compile_->done.WaitForNotification();
+  return compile_->status;
+}
+
 absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>>
 SwitchableFunctionJit::Create(Function* xls_function, ExecutionType execution,
                               int64_t opt_level, JitObserver* observer) {
@@ -80,9 +142,14 @@ SwitchableFunctionJit::Create(Function* xls_function, ExecutionType execution,
   switch (execution) {
     case ExecutionType::kInterpreter:
       return SwitchableFunctionJit::CreateInterpreter(xls_function);
+    case ExecutionType::kBytecodeInterpreter:
+      return SwitchableFunctionJit::CreateBytecodeInterpreter(xls_function);
     case ExecutionType::kJit:
       return SwitchableFunctionJit::CreateJit(xls_function, opt_level,
                                               observer);
+    case ExecutionType::kTiered:
+      return SwitchableFunctionJit::CreateTiered(xls_function, opt_level,
+                                                 observer);
     case ExecutionType::kDefault:
       LOG(FATAL) << "Unreachable";
   }
@@ -135,8 +202,11 @@ absl::StatusOr<InterpreterResult<Value>> Interpret(
 
 absl::StatusOr<InterpreterResult<Value>> SwitchableFunctionJit::Run(
     absl::Span<const Value> args) {
-  if (use_jit_) {
-    return function_jit_->Run(args);
+  if (FunctionJit* jit = GetJit(); jit != nullptr) {
+    return jit->Run(args);
+  }
+  if (bytecode_ != nullptr) {
+    return bytecode_->Run(args);
   }
   XLS_ASSIGN_OR_RETURN(auto node_args, ToValueMap(args, function()));
   return Interpret(std::move(node_args), function());
@@ -144,8 +214,11 @@ absl::StatusOr<InterpreterResult<Value>> SwitchableFunctionJit::Run(
 
 absl::StatusOr<InterpreterResult<Value>> SwitchableFunctionJit::Run(
     const absl::flat_hash_map<std::string, Value>& kwargs) {
-  if (use_jit_) {
-    return function_jit_->Run(kwargs);
+  if (FunctionJit* jit = GetJit(); jit != nullptr) {
+    return jit->Run(kwargs);
+  }
+  if (bytecode_ != nullptr) {
+    return bytecode_->RunKwargs(kwargs);
   }
   XLS_ASSIGN_OR_RETURN(auto node_args, ToValueMap(kwargs, function()));
   return Interpret(std::move(node_args), function());
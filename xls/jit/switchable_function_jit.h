@@ -22,11 +22,16 @@
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
 #include "absl/types/span.h"
+#include "xls/interpreter/bytecode_interpreter.h"
 #include "xls/ir/events.h"
 #include "xls/ir/function.h"
+#include "xls/ir/package.h"
 #include "xls/ir/value.h"
+#include "xls/jit/background_compile.h"
 #include "xls/jit/function_jit.h"
 #include "xls/jit/observer.h"
 
@@ -36,6 +41,13 @@ enum class ExecutionType {
   kDefault,
   kJit,
   kInterpreter,
+  // Interpret the function after lowering it to bytecode once, see
+  // BytecodeFunction.
+  kBytecodeInterpreter,
+  // Start executing with the bytecode interpreter immediately while the JIT
+  // compiles the function in a background thread, then switch to the compiled
+  // code.
+  kTiered,
 };
 
 // A wrapper for the jit structures that can be turned off at build time if
@@ -51,6 +63,18 @@ class SwitchableFunctionJit {
       JitObserver* observer = nullptr);
   static absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>>
   CreateInterpreter(Function* xls_function);
+  static absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>>
+  CreateBytecodeInterpreter(Function* xls_function);
+  // Returns an object which evaluates the function with the bytecode
+  // interpreter until the host-compiled version, which is built in a
+  // background thread, becomes available. Invocations after compilation
+  // completes use the compiled version. If compilation fails the interpreter
+  // continues to be used. The background compilation reads its own copy of the
+  // function's package (so the JIT's `function()` is the copy) and destroying
+  // the returned object does not wait for it.
+  static absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>> CreateTiered(
+      Function* xls_function, int64_t opt_level = 3,
+      JitObserver* observer = nullptr);
   static absl::StatusOr<std::unique_ptr<SwitchableFunctionJit>> Create(
       Function* xls_function, ExecutionType execution = ExecutionType::kDefault,
       int64_t opt_level = 3, JitObserver* observer = nullptr);
@@ -67,13 +91,21 @@ class SwitchableFunctionJit {
   // Returns the function that the JIT executes.
   Function* function() { return xls_function_; }
 
+  // Returns the JIT used to evaluate the function, if any. In tiered mode this
+  // is std::nullopt until background compilation completes.
   std::optional<FunctionJit*> function_jit() {
-    if (use_jit_) {
-      return function_jit_.get();
+    if (FunctionJit* jit = GetJit(); jit != nullptr) {
+      return jit;
     }
     return std::nullopt;
   }
 
+  // Blocks until background compilation (if any) completes and returns its
+  // status.
+  absl::Status WaitForJit();
+
+  ~SwitchableFunctionJit();
+
  private:
   explicit SwitchableFunctionJit(Function* xls_function, bool use_jit,
                                  std::unique_ptr<FunctionJit>&& jit)
@@ -81,9 +113,38 @@ class SwitchableFunctionJit {
         use_jit_(use_jit),
         function_jit_(std::move(jit)) {}
 
+  // State shared with the background compilation in tiered mode, which may
+  // outlive this object.
+  struct BackgroundCompile {
+    // The copy of the function's package which is compiled.
+    std::unique_ptr<Package> package;
+    std::unique_ptr<DetachableJitObserver> jit_observer;
+    // Written before `done` is notified.
+    std::unique_ptr<FunctionJit> jit;
+    absl::Status status;
+    absl::Notification done;
+  };
+
+  // Returns the JIT to evaluate the function with or nullptr if the function
+  // should be interpreted.
+  FunctionJit* GetJit() const {
+    if (use_jit_) {
+      return function_jit_.get();
+    }
+    return compile_ != nullptr && compile_->done.HasBeenNotified()
+               ? compile_->jit.get()
+               : nullptr;
+  }
+
   Function* xls_function_;
   bool use_jit_;
   std::unique_ptr<FunctionJit> function_jit_;
+  // If set, the function is interpreted with this rather than the
+  // IrInterpreter.
+  std::unique_ptr<BytecodeFunction> bytecode_;
+
+  // Set in tiered mode.
+  std::shared_ptr<BackgroundCompile> compile_;
 };
 }  // namespace xls
 
@@ -14,12 +14,17 @@
 
 #include "xls/jit/switchable_function_jit.h"
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xls/common/status/matchers.h"
 #include "xls/ir/bits.h"
+#include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
 #include "xls/ir/package.h"
@@ -53,6 +58,21 @@ TEST_F(SwitchableFunctionJitTest, CanExecuteInterpreter) {
             Value::Tuple({Value(UBits(12, 8)), Value(UBits(32, 8))}));
 }
 
+TEST_F(SwitchableFunctionJitTest, CanExecuteBytecodeInterpreter) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(auto f, TestFunction(p.get()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto interp,
+      SwitchableFunctionJit::Create(f, ExecutionType::kBytecodeInterpreter));
+  EXPECT_FALSE(interp->function_jit().has_value());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto result,
+      interp->Run(std::vector<Value>{Value(UBits(8, 8)), Value(UBits(4, 8))}));
+  EXPECT_EQ(result.value,
+            Value::Tuple({Value(UBits(12, 8)), Value(UBits(32, 8))}));
+}
+
 TEST_F(SwitchableFunctionJitTest, CanExecuteJit) {
   auto p = CreatePackage();
   XLS_ASSERT_OK_AND_ASSIGN(auto f, TestFunction(p.get()));
@@ -79,5 +99,53 @@ TEST_F(SwitchableFunctionJitTest, CanExecuteDefault) {
             Value::Tuple({Value(UBits(12, 8)), Value(UBits(32, 8))}));
 }
 
+TEST_F(SwitchableFunctionJitTest, CanExecuteTiered) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(auto f, TestFunction(p.get()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto runner, SwitchableFunctionJit::Create(f, ExecutionType::kTiered));
+  // Results are the same regardless of whether compilation has completed.
+  std::vector<Value> args = {Value(UBits(8, 8)), Value(UBits(4, 8))};
+  Value expected = Value::Tuple({Value(UBits(12, 8)), Value(UBits(32, 8))});
+  XLS_ASSERT_OK_AND_ASSIGN(auto result, runner->Run(args));
+  EXPECT_EQ(result.value, expected);
+
+  XLS_ASSERT_OK(runner->WaitForJit());
+  EXPECT_TRUE(runner->function_jit().has_value());
+  XLS_ASSERT_OK_AND_ASSIGN(result, runner->Run(args));
+  EXPECT_EQ(result.value, expected);
+}
+
+TEST_F(SwitchableFunctionJitTest, TieredDestructionDoesNotWaitForJit) {
+  // A function which takes a while to compile.
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  BValue x = fb.Param("x", p->GetBitsType(64));
+  BValue result = x;
+  for (int64_t i = 0; i < 2000; ++i) {
+    result = fb.Add(fb.UMul(result, x), fb.Literal(UBits(i, 64)));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  absl::Time start = absl::Now();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SwitchableFunctionJit> runner,
+      SwitchableFunctionJit::Create(f, ExecutionType::kTiered));
+  XLS_ASSERT_OK(runner->WaitForJit());
+  absl::Duration compile_time = absl::Now() - start;
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      runner, SwitchableFunctionJit::Create(f, ExecutionType::kTiered));
+  start = absl::Now();
+  runner.reset();
+  absl::Duration destruction_time = absl::Now() - start;
+  EXPECT_LT(destruction_time, compile_time / 2);
+
+  // The compilation does not use the function, which may be destroyed while
+  // it is running.
+  p.reset();
+}
+
 }  // namespace
 }  // namespace xls
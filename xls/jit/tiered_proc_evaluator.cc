@@ -0,0 +1,216 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/tiered_proc_evaluator.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/observer.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_interpreter.h"
+#include "xls/ir/events.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/ir/value.h"
+#include "xls/jit/background_compile.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/proc_jit.h"
+
+namespace xls {
+namespace {
+
+// Continuation which wraps a continuation of the interpreter and, once the
+// proc has been switched to the JIT, a continuation of the ProcJit.
+class TieredProcContinuation : public ProcContinuation {
+ public:
+  TieredProcContinuation(ProcInstance* proc_instance,
+                         std::unique_ptr<ProcContinuation> interpreted)
+      : ProcContinuation(proc_instance), active_(std::move(interpreted)) {}
+
+  std::vector<Value> GetState() const override { return active_->GetState(); }
+  absl::Status SetState(std::vector<Value> v) override {
+    return active_->SetState(std::move(v));
+  }
+  const InterpreterEvents& GetEvents() const override {
+    return active_->GetEvents();
+  }
+  InterpreterEvents& GetEvents() override { return active_->GetEvents(); }
+  void ClearEvents() override { active_->ClearEvents(); }
+  bool AtStartOfTick() const override { return active_->AtStartOfTick(); }
+
+  absl::Status SetObserver(EvaluationObserver* observer) override {
+    XLS_RETURN_IF_ERROR(active_->SetObserver(observer));
+    return ProcContinuation::SetObserver(observer);
+  }
+  void ClearObserver() override {
+    active_->ClearObserver();
+    ProcContinuation::ClearObserver();
+  }
+  bool SupportsObservers() const override {
+    return active_->SupportsObservers();
+  }
+
+  bool jitted() const { return jitted_; }
+  ProcContinuation& active() { return *active_; }
+
+  // Replaces the interpreter continuation with `jitted`, transferring the
+  // proc state, events and observer. Must only be called at the start of a
+  // tick. Returns false (leaving this continuation unchanged) if the observer
+  // cannot be transferred.
+  absl::StatusOr<bool> SwitchTo(std::unique_ptr<ProcContinuation> jitted) {
+    XLS_RET_CHECK(!jitted_);
+    XLS_RET_CHECK(active_->AtStartOfTick());
+    if (std::optional<EvaluationObserver*> observer = GetObserver();
+        observer.has_value()) {
+      if (!jitted->SupportsObservers()) {
+        return false;
+      }
+      XLS_RETURN_IF_ERROR(jitted->SetObserver(*observer));
+    }
+    XLS_RETURN_IF_ERROR(jitted->SetState(active_->GetState()));
+    jitted->GetEvents().AppendFrom(active_->GetEvents());
+    active_ = std::move(jitted);
+    jitted_ = true;
+    return true;
+  }
+
+ private:
+  std::unique_ptr<ProcContinuation> active_;
+  bool jitted_ = false;
+};
+
+}  // namespace
+
+/* static */ absl::StatusOr<std::unique_ptr<TieredProcEvaluator>>
+TieredProcEvaluator::Create(Proc* proc, JitChannelQueueManager* queue_mgr,
+                            const EvaluatorOptions& options,
+                            const JitEvaluatorOptions& jit_options) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<ProcInterpreter> interpreter,
+                       ProcInterpreter::Create(proc, queue_mgr, options));
+  auto evaluator = absl::WrapUnique(new TieredProcEvaluator(
+      proc, queue_mgr, std::move(interpreter), options));
+  auto compile = std::make_shared<BackgroundCompile>();
+  Proc* compiled_proc = proc;
+  if (!jit_options.include_observer_callbacks()) {
+    XLS_ASSIGN_OR_RETURN(compile->package,
+                         CopyPackageForBackgroundCompile(proc->package()));
+    XLS_ASSIGN_OR_RETURN(compiled_proc,
+                         compile->package->GetProc(proc->name()));
+  }
+  JitEvaluatorOptions compile_options = jit_options;
+  if (jit_options.jit_observer() != nullptr) {
+    compile->jit_observer =
+        std::make_unique<DetachableJitObserver>(jit_options.jit_observer());
+    compile_options.set_jit_observer(compile->jit_observer.get());
+  }
+  evaluator->compile_ = compile;
+  RunInBackground([compile, compiled_proc, options, compile_options]() {
+    compile->compiled =
+        ProcJit::Compile(compiled_proc, options, compile_options);
+    compile->done.Notify();
+  });
+  return evaluator;
+}
+
+TieredProcEvaluator::~TieredProcEvaluator() {
+  if (compile_->jit_observer != nullptr) {
+    compile_->jit_observer->Detach();
+  }
+  if (compile_->package == nullptr) {
+    // The compilation reads the proc which may be destroyed after this.
+    compile_->done.WaitForNotification();
+  }
+}
+
+ProcJit* TieredProcEvaluator::jit() const {
+  if (ProcJit* jit = jit_.load(std::memory_order_acquire); jit != nullptr) {
+    return jit;
+  }
+  if (!compile_->done.HasBeenNotified()) {
+    return nullptr;
+  }
+  absl::MutexLock lock(&mu_);
+  if (!compile_finished_) {
+    compile_finished_ = true;
+    absl::StatusOr<std::unique_ptr<ProcJit>> jit =
+        compile_->compiled.ok()
+            ? ProcJit::CreateFromCompiled(proc(), &queue_mgr_->runtime(),
+                                          queue_mgr_,
+                                          *std::move(compile_->compiled),
+                                          options())
+            : compile_->compiled.status();
+    if (jit.ok()) {
+      owned_jit_ = *std::move(jit);
+      jit_.store(owned_jit_.get(), std::memory_order_release);
+    } else {
+      LOG(WARNING) << "Unable to JIT compile proc `" << proc()->name()
+                   << "`, continuing with the interpreter: " << jit.status();
+      compile_status_ = jit.status();
+    }
+  }
+  return owned_jit_.get();
+}
+
+absl::Status TieredProcEvaluator::WaitForJit() const {
+  compile_->done.WaitForNotification();
+  jit();
+  absl::MutexLock lock(&mu_);
+  return compile_status_;
+}
+
+std::unique_ptr<ProcContinuation> TieredProcEvaluator::NewContinuation(
+    ProcInstance* proc_instance) const {
+  CHECK_EQ(proc_instance->proc(), proc());
+  return std::make_unique<TieredProcContinuation>(
+      proc_instance, interpreter_->NewContinuation(proc_instance));
+}
+
+absl::StatusOr<TickResult> TieredProcEvaluator::Tick(
+    ProcContinuation& continuation) const {
+  TieredProcContinuation* cont =
+      dynamic_cast<TieredProcContinuation*>(&continuation);
+  XLS_RET_CHECK_NE(cont, nullptr) << "TieredProcEvaluator requires a "
+                                     "continuation of type "
+                                     "TieredProcContinuation";
+  if (cont->jitted()) {
+    return jit()->Tick(cont->active());
+  }
+  // The interpreter and the JIT have different execution points within a tick
+  // so only switch between ticks.
+  if (ProcJit* jit = this->jit(); jit != nullptr && cont->AtStartOfTick()) {
+    XLS_ASSIGN_OR_RETURN(
+        bool switched,
+        cont->SwitchTo(jit->NewContinuation(cont->proc_instance())));
+    if (switched) {
+      return jit->Tick(cont->active());
+    }
+  }
+  return interpreter_->Tick(cont->active());
+}
+
+}  // namespace xls
@@ -0,0 +1,111 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_JIT_TIERED_PROC_EVALUATOR_H_
+#define XLS_JIT_TIERED_PROC_EVALUATOR_H_
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_interpreter.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/proc_elaboration.h"
+#include "xls/jit/background_compile.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/proc_jit.h"
+
+namespace xls {
+
+// A proc evaluator which starts out interpreting the proc while a ProcJit for
+// the proc is compiled in a background thread. Once compilation completes,
+// each continuation switches to the compiled code at the start of its next
+// tick, carrying over the proc state and recorded events. If compilation
+// fails the proc continues to be interpreted.
+//
+// Continuations with an observer set are switched only if the JIT was
+// compiled with observer callbacks (i.e., `options.support_observers()`).
+//
+// The background compilation reads its own copy of the proc's package so the
+// evaluator may be destroyed without waiting for it. The exception is
+// compiling with observer callbacks, which embed node pointers in the compiled
+// code: the original proc is compiled and destruction waits for compilation
+// to complete.
+class TieredProcEvaluator : public ProcEvaluator {
+ public:
+  static absl::StatusOr<std::unique_ptr<TieredProcEvaluator>> Create(
+      Proc* proc, JitChannelQueueManager* queue_mgr,
+      const EvaluatorOptions& options = EvaluatorOptions(),
+      const JitEvaluatorOptions& jit_options = JitEvaluatorOptions());
+
+  ~TieredProcEvaluator() override;
+
+  std::unique_ptr<ProcContinuation> NewContinuation(
+      ProcInstance* proc_instance) const override;
+  absl::StatusOr<TickResult> Tick(
+      ProcContinuation& continuation) const override;
+
+  // Blocks until background compilation completes and returns its status.
+  absl::Status WaitForJit() const;
+
+  // Returns the ProcJit if compilation has completed successfully, nullptr
+  // otherwise.
+  ProcJit* jit() const;
+
+ private:
+  // State shared with the background compilation, which may outlive the
+  // evaluator.
+  struct BackgroundCompile {
+    // The copy of the proc's package which is compiled. Null if the original
+    // proc is compiled.
+    std::unique_ptr<Package> package;
+    std::unique_ptr<DetachableJitObserver> jit_observer;
+    // Written before `done` is notified.
+    absl::StatusOr<ProcJit::CompiledProc> compiled;
+    absl::Notification done;
+  };
+
+  TieredProcEvaluator(Proc* proc, JitChannelQueueManager* queue_mgr,
+                      std::unique_ptr<ProcInterpreter> interpreter,
+                      const EvaluatorOptions& options)
+      : ProcEvaluator(proc, options),
+        queue_mgr_(queue_mgr),
+        interpreter_(std::move(interpreter)) {}
+
+  JitChannelQueueManager* queue_mgr_;
+  std::unique_ptr<ProcInterpreter> interpreter_;
+  std::shared_ptr<BackgroundCompile> compile_;
+
+  // Once background compilation completes the first caller of `jit()` builds
+  // the ProcJit from the compiled code.
+  mutable absl::Mutex mu_;
+  mutable bool compile_finished_ ABSL_GUARDED_BY(mu_) = false;
+  mutable std::unique_ptr<ProcJit> owned_jit_ ABSL_GUARDED_BY(mu_);
+  mutable absl::Status compile_status_ ABSL_GUARDED_BY(mu_);
+  // Set to `owned_jit_` once it is built.
+  mutable std::atomic<ProcJit*> jit_ = nullptr;
+};
+
+}  // namespace xls
+
+#endif  // XLS_JIT_TIERED_PROC_EVALUATOR_H_
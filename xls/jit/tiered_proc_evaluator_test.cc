@@ -0,0 +1,154 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/jit/tiered_proc_evaluator.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/log/check.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xls/common/status/matchers.h"
+#include "xls/interpreter/channel_queue.h"
+#include "xls/interpreter/evaluator_options.h"
+#include "xls/interpreter/proc_evaluator.h"
+#include "xls/interpreter/proc_evaluator_test_base.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/function_builder.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/proc.h"
+#include "xls/ir/value.h"
+#include "xls/jit/jit_channel_queue.h"
+#include "xls/jit/jit_evaluator_options.h"
+#include "xls/jit/jit_runtime.h"
+#include "xls/jit/orc_jit.h"
+
+namespace xls {
+namespace {
+
+using ::testing::ElementsAre;
+
+JitRuntime* GetJitRuntime() {
+  static auto orc_jit = OrcJit::Create().value();
+  static auto jit_runtime =
+      std::make_unique<JitRuntime>(orc_jit->CreateDataLayout().value());
+  return jit_runtime.get();
+}
+
+// If `kWaitForJit` is true the proc is only ever evaluated with the JIT,
+// otherwise evaluation switches to the JIT whenever compilation happens to
+// complete.
+template <bool kWaitForJit>
+std::unique_ptr<ProcEvaluator> EvaluatorFromProc(
+    Proc* proc, ChannelQueueManager* queue_manager) {
+  JitChannelQueueManager* jit_queue_manager =
+      dynamic_cast<JitChannelQueueManager*>(queue_manager);
+  CHECK(jit_queue_manager != nullptr);
+  std::unique_ptr<TieredProcEvaluator> evaluator =
+      TieredProcEvaluator::Create(
+          proc, jit_queue_manager, EvaluatorOptions(),
+          JitEvaluatorOptions().set_include_observer_callbacks(true))
+          .value();
+  if (kWaitForJit) {
+    CHECK_OK(evaluator->WaitForJit());
+  }
+  return evaluator;
+}
+
+std::unique_ptr<ChannelQueueManager> QueueManagerForPackage(Package* package) {
+  return JitChannelQueueManager::CreateThreadSafe(
+             package,
+             std::make_unique<JitRuntime>(GetJitRuntime()->data_layout()))
+      .value();
+}
+
+// Instantiate and run all the tests in proc_evaluator_test_base.cc.
+INSTANTIATE_TEST_SUITE_P(
+    TieredProcEvaluatorTest, ProcEvaluatorTestBase,
+    testing::Values(ProcEvaluatorTestParam(EvaluatorFromProc<false>,
+                                           QueueManagerForPackage,
+                                           /*supports_observers=*/true),
+                    ProcEvaluatorTestParam(EvaluatorFromProc<true>,
+                                           QueueManagerForPackage,
+                                           /*supports_observers=*/true)));
+
+class TieredProcEvaluatorTest : public IrTestBase {};
+
+TEST_F(TieredProcEvaluatorTest, StateCarriesOverToJit) {
+  auto package = CreatePackage();
+  ProcBuilder pb("counter", package.get());
+  BValue counter = pb.ReadStateElement("cnt", Value(UBits(0, 32)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Proc * proc, pb.Build({pb.Add(counter, pb.Literal(UBits(3, 32)))}));
+  XLS_ASSERT_OK(package->SetTop(proc));
+
+  std::unique_ptr<ChannelQueueManager> queue_manager =
+      QueueManagerForPackage(package.get());
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TieredProcEvaluator> evaluator,
+      TieredProcEvaluator::Create(
+          proc, dynamic_cast<JitChannelQueueManager*>(queue_manager.get())));
+  std::unique_ptr<ProcContinuation> continuation = evaluator->NewContinuation(
+      queue_manager->elaboration().GetUniqueInstance(proc).value());
+
+  XLS_ASSERT_OK(evaluator->Tick(*continuation).status());
+  XLS_ASSERT_OK(evaluator->Tick(*continuation).status());
+  XLS_ASSERT_OK(evaluator->WaitForJit());
+  EXPECT_NE(evaluator->jit(), nullptr);
+  XLS_ASSERT_OK(evaluator->Tick(*continuation).status());
+  EXPECT_THAT(continuation->GetState(), ElementsAre(Value(UBits(9, 32))));
+}
+
+TEST_F(TieredProcEvaluatorTest, DestructionDoesNotWaitForJit) {
+  // A proc which takes a while to compile.
+  auto package = CreatePackage();
+  ProcBuilder pb("slow_to_compile", package.get());
+  BValue x = pb.ReadStateElement("x", Value(UBits(1, 64)));
+  BValue next = x;
+  for (int64_t i = 0; i < 2000; ++i) {
+    next = pb.Add(pb.UMul(next, x), pb.Literal(UBits(i, 64)));
+  }
+  XLS_ASSERT_OK_AND_ASSIGN(Proc * proc, pb.Build({next}));
+  XLS_ASSERT_OK(package->SetTop(proc));
+  std::unique_ptr<ChannelQueueManager> queue_manager =
+      QueueManagerForPackage(package.get());
+  JitChannelQueueManager* jit_queue_manager =
+      dynamic_cast<JitChannelQueueManager*>(queue_manager.get());
+
+  absl::Time start = absl::Now();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TieredProcEvaluator> evaluator,
+      TieredProcEvaluator::Create(proc, jit_queue_manager));
+  XLS_ASSERT_OK(evaluator->WaitForJit());
+  absl::Duration compile_time = absl::Now() - start;
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      evaluator, TieredProcEvaluator::Create(proc, jit_queue_manager));
+  start = absl::Now();
+  evaluator.reset();
+  absl::Duration destruction_time = absl::Now() - start;
+  EXPECT_LT(destruction_time, compile_time / 2);
+
+  // The compilation does not use the proc or the queue manager, both of which
+  // may be destroyed while it is running.
+  queue_manager.reset();
+  package.reset();
+}
+
+}  // namespace
+}  // namespace xls
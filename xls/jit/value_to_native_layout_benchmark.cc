@@ -77,8 +77,29 @@ static void BM_NativeLayoutToValue(benchmark::State& state) {
   }
 }
 
+// Converts from the native layout and keeps copies of the resulting Value, as
+// evaluators do when recording node values, then releases them.
+static void BM_NativeLayoutToValueAndCopy(benchmark::State& state) {
+  constexpr int64_t kCopies = 8;
+  Package package("BM");
+  Type* type = Parser::ParseType(kValueTypes[state.range(0)], &package).value();
+  TypeLayout type_layout = CreateTypeLayout(type);
+  std::vector<uint8_t> buffer(type_layout.size(), 0);
+  std::vector<Value> copies;
+  copies.reserve(kCopies);
+  for (auto _ : state) {
+    Value value = type_layout.NativeLayoutToValue(buffer.data());
+    for (int64_t i = 0; i < kCopies; ++i) {
+      copies.push_back(value);
+    }
+    benchmark::DoNotOptimize(copies.data());
+    copies.clear();
+  }
+}
+
 BENCHMARK(BM_ValueToNativeLayout)->DenseRange(0, kNumTypes - 1);
 BENCHMARK(BM_NativeLayoutToValue)->DenseRange(0, kNumTypes - 1);
+BENCHMARK(BM_NativeLayoutToValueAndCopy)->DenseRange(0, kNumTypes - 1);
 
 }  // namespace
 }  // namespace xls
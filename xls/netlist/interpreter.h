@@ -14,8 +14,8 @@
 #ifndef XLS_NETLIST_INTERPRETER_H_
 #define XLS_NETLIST_INTERPRETER_H_
 
-#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <optional>
@@ -34,10 +34,11 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
-#include "xls/common/thread.h"
+#include "xls/common/thread_pool.h"
 #include "xls/netlist/cell_library.h"
 #include "xls/netlist/function_parser.h"
 #include "xls/netlist/netlist.h"
@@ -56,30 +57,17 @@ using NetRef2Value = AbstractNetRef2Value<bool>;
 template <typename EvalT = bool>
 class AbstractInterpreter {
  public:
+  // If `num_threads` is nonzero, up to that many cells at a time are
+  // interpreted concurrently on DefaultThreadPool(), whose size follows
+  // --xls_threads.
   explicit AbstractInterpreter(rtl::AbstractNetlist<EvalT>* netlist, EvalT zero,
                                EvalT one, size_t num_threads = 0)
       : netlist_(netlist),
         zero_(std::move(zero)),
         one_(std::move(one)),
-        num_available_threads_(0),
-        threads_should_exit_(false) {
-    for (int c = 0; c < num_threads; ++c) {
-      threads_.push_back(std::move(
-          std::make_unique<xls::Thread>([this]() { CHECK_OK(ThreadBody()); })));
-    }
-  }
-
-  ~AbstractInterpreter() {
-    if (threads_.empty() == false) {
-      // Wake up threads
-      input_queue_guard_.lock();
-      threads_should_exit_.store(true);
-      input_queue_cond_.SignalAll();
-      input_queue_guard_.unlock();
-      // Wait for exit
-      for (auto& t : threads_) {
-        t->Join();
-      }
+        max_dispatched_cells_(num_threads) {
+    if (num_threads > 0) {
+      thread_pool_ = &DefaultThreadPool();
     }
   }
 
@@ -137,46 +125,42 @@ class AbstractInterpreter {
       const rtl::AbstractCell<EvalT>& cell, const std::string& pin_name,
       const AbstractNetRef2Value<EvalT>& inputs);
 
-  absl::Status ThreadBody();
-
-  rtl::AbstractNetlist<EvalT>* netlist_;
-  EvalT zero_;
-  EvalT one_;
-
-  // Queue entries for both the input and output queues.  Going in, wires
-  // holds the inputs.  Going out, wires holds the results of InterpretCell.
+  // Results of InterpretCell for cells dispatched to the thread pool by one
+  // InterpretModule() invocation. Each invocation (including those for nested
+  // modules, which may run on the pool themselves) has its own queue.
   struct QueueEntry {
     const rtl::AbstractCell<EvalT>* cell;
     AbstractNetRef2Value<EvalT> wires;
   };
+  struct OutputQueue {
+    absl::Mutex mu;
+    std::queue<QueueEntry> entries ABSL_GUARDED_BY(mu);
+  };
 
-  // The absl::Mutex input_queue_guard is used to both protect the input queue
-  // shared by all the worker threads, as well as a conditional variable for the
-  // threads to block on while waiting for input.
-  absl::Mutex input_queue_guard_;  // protects input_queue_
-  absl::CondVar input_queue_cond_;
-  std::queue<QueueEntry> input_queue_ ABSL_GUARDED_BY(input_queue_guard_);
+  // Interprets `cell` on the thread pool and pushes the result onto
+  // `output_queue`.
+  void DispatchCell(const rtl::AbstractCell<EvalT>* cell,
+                    AbstractNetRef2Value<EvalT> inputs,
+                    OutputQueue* output_queue);
+
+  // Waits until `output_queue` is non-empty and returns its entries. Runs
+  // queued tasks of the thread pool while waiting: this may itself be running
+  // on the pool (interpreting a nested module) and must not starve it.
+  std::queue<QueueEntry> TakeOutputs(OutputQueue* output_queue);
+
+  rtl::AbstractNetlist<EvalT>* netlist_;
+  EvalT zero_;
+  EvalT one_;
 
   static bool queue_has_data(std::queue<QueueEntry>* queue) {
     return !queue->empty();
   }
 
-  // The absl::Mutex output_queue_guard is used to both protect the output queue
-  // shared by all the worker threads, as well as a conditional variable for the
-  // InterpretModule() to wait on for processed cells.
-  absl::Mutex output_queue_guard_;  // protects output_queue_
-  std::queue<QueueEntry> output_queue_ ABSL_GUARDED_BY(output_queue_guard_);
-
-  // Thread pool.
-  std::vector<std::unique_ptr<xls::Thread>> threads_;
-
-  // Keeps track of threads blocked on the input_queue_, ready to get a
-  // dispatch.  The counter is atomic by itself, but it also needs to be updated
-  // in sync with a thread blocking on the input queue, which is why it's also
-  // guarded by a mutex.  The atomicity is to ensure memory ordering.
-  std::atomic_size_t num_available_threads_ ABSL_GUARDED_BY(input_queue_guard_);
-  // Set to shut down thread pool.
-  std::atomic_bool threads_should_exit_ ABSL_GUARDED_BY(input_queue_guard_);
+  // Pool on which cells are interpreted; null if interpreting on the calling
+  // thread only.
+  ThreadPool* thread_pool_ = nullptr;
+  // The maximum number of cells dispatched to the pool at a time.
+  int64_t max_dispatched_cells_;
 };
 
 using Interpreter = AbstractInterpreter<>;
@@ -296,23 +280,20 @@ AbstractInterpreter<EvalT>::InterpretModule(
   // as num_pending_outputs > 0, it means we expect to get that many
   // additional wires activated.  Thus we exit the loop only when active_wires
   // is empty and there are no pending outputs.
+  OutputQueue output_queue;
   size_t num_pending_outputs = 0;
   while (!active_wires.empty() || num_pending_outputs > 0) {
     // Drain the output queue as much as we can until we get some active wires,
     // so that we can proceed.
     while (active_wires.empty()) {
-      output_queue_guard_.LockWhen(
-          absl::Condition(queue_has_data, &output_queue_));
-      while (!output_queue_.empty()) {
-        QueueEntry entry = std::move(output_queue_.front());
-        output_queue_.pop();
-        output_queue_guard_.unlock();
+      std::queue<QueueEntry> entries = TakeOutputs(&output_queue);
+      while (!entries.empty()) {
+        QueueEntry entry = std::move(entries.front());
+        entries.pop();
         num_pending_outputs--;
         UpdateProcessedState(processed_cells, active_wires, outputs, module,
                              dump_cell_set, entry.cell, entry.wires);
-        output_queue_guard_.lock();
       }
-      output_queue_guard_.unlock();
     }
 
     rtl::AbstractNetRef<EvalT> wire = active_wires.front();
@@ -331,29 +312,26 @@ AbstractInterpreter<EvalT>::InterpretModule(
         // process InterpretCell only if the cell is itself a Module, there is
         // only one worker thread left, and all other threads are processing
         // modules as well.
-        bool dispatched = false;
-        if (!threads_.empty()) {
-          input_queue_guard_.lock();
-          if (num_available_threads_ > 0) {
-            QueueEntry entry;
-            entry.cell = cell;
-            entry.wires = std::move(processed_cell_state->inputs);
-            input_queue_.push(std::move(entry));
-            input_queue_cond_.Signal();
-            num_available_threads_--;
-            num_pending_outputs++;
-            dispatched = true;
-            VLOG(2) << "Dispatched cell: " << cell->name();
-          }
-          input_queue_guard_.unlock();
-        }
-
-        if (!dispatched) {
+        if (thread_pool_ != nullptr &&
+            static_cast<int64_t>(num_pending_outputs) <
+                max_dispatched_cells_) {
+          DispatchCell(cell, std::move(processed_cell_state->inputs),
+                       &output_queue);
+          num_pending_outputs++;
+          VLOG(2) << "Dispatched cell: " << cell->name();
+        } else {
           VLOG(2) << "Processing locally cell: " << cell->name();
-          XLS_ASSIGN_OR_RETURN(
-              auto results, InterpretCell(cell, processed_cell_state->inputs));
+          absl::StatusOr<AbstractNetRef2Value<EvalT>> results =
+              InterpretCell(cell, processed_cell_state->inputs);
+          if (!results.ok()) {
+            // The dispatched cells refer to `output_queue`.
+            while (num_pending_outputs > 0) {
+              num_pending_outputs -= TakeOutputs(&output_queue).size();
+            }
+            return results.status();
+          }
           UpdateProcessedState(processed_cells, active_wires, outputs, module,
-                               dump_cell_set, cell, results);
+                               dump_cell_set, cell, *results);
         }
       }
     }
@@ -498,31 +476,39 @@ AbstractInterpreter<EvalT>::InterpretCell(
 }
 
 template <typename EvalT>
-absl::Status AbstractInterpreter<EvalT>::ThreadBody() {
+void AbstractInterpreter<EvalT>::DispatchCell(
+    const rtl::AbstractCell<EvalT>* cell, AbstractNetRef2Value<EvalT> inputs,
+    OutputQueue* output_queue) {
+  thread_pool_->Schedule([this, cell, inputs = std::move(inputs),
+                          output_queue]() {
+    absl::StatusOr<AbstractNetRef2Value<EvalT>> results =
+        InterpretCell(cell, inputs);
+    CHECK_OK(results.status());
+    absl::MutexLock lock(&output_queue->mu);
+    output_queue->entries.push(
+        QueueEntry{.cell = cell, .wires = *std::move(results)});
+  });
+}
+
+template <typename EvalT>
+std::queue<typename AbstractInterpreter<EvalT>::QueueEntry>
+AbstractInterpreter<EvalT>::TakeOutputs(OutputQueue* output_queue) {
+  std::queue<QueueEntry> entries;
   while (true) {
-    input_queue_guard_.lock();
-    num_available_threads_++;
-    while (input_queue_.empty() && threads_should_exit_ == false) {
-      input_queue_cond_.Wait(&input_queue_guard_);
+    {
+      absl::MutexLock lock(&output_queue->mu);
+      entries.swap(output_queue->entries);
     }
-    if (threads_should_exit_) {
-      input_queue_guard_.unlock();
-      break;
+    if (!entries.empty()) {
+      return entries;
+    }
+    if (!thread_pool_->TryRunOneTask()) {
+      absl::MutexLock lock(&output_queue->mu);
+      output_queue->mu.AwaitWithTimeout(
+          absl::Condition(queue_has_data, &output_queue->entries),
+          absl::Milliseconds(1));
     }
-    QueueEntry entry = input_queue_.front();
-    input_queue_.pop();
-    input_queue_guard_.unlock();
-
-    XLS_ASSIGN_OR_RETURN(auto results,
-                         InterpretCell(entry.cell, std::move(entry.wires)));
-
-    entry.wires = std::move(results);
-    output_queue_guard_.lock();
-    output_queue_.push(entry);
-    output_queue_guard_.unlock();
   }
-
-  return absl::OkStatus();
 }
 
 template <typename EvalT>
@@ -2366,6 +2366,11 @@ absl::StatusOr<bool> MatchArithPatterns(int64_t opt_level, Node* n,
 
 }  // namespace
 
+absl::StatusOr<bool> ArithSimplifyNode(int64_t opt_level, Node* n,
+                                       const QueryEngine& query_engine) {
+  return MatchArithPatterns(opt_level, n, query_engine);
+}
+
 RedundancyGuard ArithSimplificationPass::GetRedundancyGuard(
     const OptimizationPassOptions& options,
     OptimizationContext& context) const {
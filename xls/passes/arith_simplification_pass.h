@@ -15,12 +15,15 @@
 #ifndef XLS_PASSES_ARITH_SIMPLIFICATION_PASS_H_
 #define XLS_PASSES_ARITH_SIMPLIFICATION_PASS_H_
 
+#include <cstdint>
 #include <string_view>
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
+#include "xls/passes/query_engine.h"
 
 namespace xls {
 
@@ -175,12 +178,20 @@ class ArithSimplificationPass : public OptimizationFunctionBasePass {
       const OptimizationPassOptions& options,
       OptimizationContext& context) const override;
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
 };
 
+// Applies the simplifications of ArithSimplificationPass at the given
+// optimization level to the single node `n`. Returns true if the IR was
+// modified.
+absl::StatusOr<bool> ArithSimplifyNode(int64_t opt_level, Node* n,
+                                       const QueryEngine& query_engine);
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_ARITH_SIMPLIFICATION_PASS_H_
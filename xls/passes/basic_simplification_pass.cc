@@ -772,6 +772,8 @@ absl::StatusOr<bool> MatchPatterns(Node* n) {
 
 }  // namespace
 
+absl::StatusOr<bool> BasicSimplifyNode(Node* n) { return MatchPatterns(n); }
+
 absl::StatusOr<bool> BasicSimplificationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const OptimizationPassOptions& options,
     PassResults* results, OptimizationContext& context) const {
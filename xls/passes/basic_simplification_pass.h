@@ -19,6 +19,7 @@
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
 
@@ -135,12 +136,18 @@ class BasicSimplificationPass : public OptimizationFunctionBasePass {
     return RedundancyGuard::CanSkip();
   }
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
 };
 
+// Applies the simplifications of BasicSimplificationPass to the single node
+// `n`. Returns true if the IR was modified.
+absl::StatusOr<bool> BasicSimplifyNode(Node* n);
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_BASIC_SIMPLIFICATION_PASS_H_
@@ -160,6 +160,8 @@ class BitSliceSimplificationPass : public OptimizationFunctionBasePass {
       const OptimizationPassOptions& options,
       OptimizationContext& context) const override;
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
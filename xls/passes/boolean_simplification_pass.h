@@ -151,6 +151,8 @@ class BooleanSimplificationPass : public OptimizationFunctionBasePass {
     return RedundancyGuard::CanSkip();
   }
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
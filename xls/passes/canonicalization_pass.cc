@@ -181,6 +181,8 @@ absl::StatusOr<bool> MaybeCanonicalizeClamp(Node* n,
   return false;
 }
 
+}  // namespace
+
 // CanonicalizeNodes performs simple canonicalization of expressions,
 // such as moving a literal in an associative expression to the right.
 // Being able to rely on the shape of such nodes greatly simplifies
@@ -378,8 +380,6 @@ absl::StatusOr<bool> CanonicalizeNode(Node* n) {
   return false;
 }
 
-}  // namespace
-
 absl::StatusOr<bool> CanonicalizationPass::RunOnFunctionBaseInternal(
     FunctionBase* func, const OptimizationPassOptions& options,
     PassResults* results, OptimizationContext& context) const {
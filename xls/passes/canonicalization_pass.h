@@ -21,6 +21,7 @@
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
 
@@ -177,12 +178,18 @@ class CanonicalizationPass : public OptimizationFunctionBasePass {
     return RedundancyGuard::CanSkip();
   }
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
       PassResults* results, OptimizationContext& context) const override;
 };
 
+// Applies the canonicalizations of CanonicalizationPass to the single node `n`.
+// Returns true if the IR was modified.
+absl::StatusOr<bool> CanonicalizeNode(Node* n);
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_CANONICALIZATION_PASS_H_
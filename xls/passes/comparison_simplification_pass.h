@@ -157,6 +157,8 @@ class ComparisonSimplificationPass : public OptimizationFunctionBasePass {
     return RedundancyGuard::CanSkip();
   }
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
       FunctionBase* f, const OptimizationPassOptions& options,
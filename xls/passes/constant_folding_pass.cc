@@ -37,7 +37,7 @@ namespace xls {
 namespace {
 
 // Check if we can do constant folding on this node.
-bool NodeIsConstantFoldable(Node* node, QueryEngine& query_engine) {
+bool NodeIsConstantFoldable(Node* node, const QueryEngine& query_engine) {
   if (node->users().empty() && !node->function_base()->HasImplicitUse(node)) {
     // If the node has no users, replacing it with a literal is pointless.
     return false;
@@ -62,6 +62,25 @@ bool NodeIsConstantFoldable(Node* node, QueryEngine& query_engine) {
 
 }  // namespace
 
+absl::StatusOr<bool> ConstantFoldNode(Node* node,
+                                      const QueryEngine& query_engine) {
+  // Fold any non-side-effecting op with constant parameters. Avoid any types
+  // with tokens because literal tokens are not allowed.
+  // TODO(meheff): 2019/6/26 Consider not folding loops with large trip counts
+  // to avoid hanging at compile time.
+  if (!NodeIsConstantFoldable(node, query_engine)) {
+    return false;
+  }
+  VLOG(2) << "Folding: " << *node;
+  std::vector<Value> operand_values;
+  for (Node* operand : node->operands()) {
+    operand_values.push_back(*query_engine.KnownValue(operand));
+  }
+  XLS_ASSIGN_OR_RETURN(Value result, InterpretNode(node, operand_values));
+  XLS_RETURN_IF_ERROR(node->ReplaceUsesWithNew<Literal>(result).status());
+  return true;
+}
+
 absl::StatusOr<bool> ConstantFoldingPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const OptimizationPassOptions& options,
     PassResults* results, OptimizationContext& context) const {
@@ -70,20 +89,9 @@ absl::StatusOr<bool> ConstantFoldingPass::RunOnFunctionBaseInternal(
   bool changed = false;
   XLS_ASSIGN_OR_RETURN(std::vector<Node*> topo_sort_nodes, context.TopoSort(f));
   for (Node* node : topo_sort_nodes) {
-    // Fold any non-side-effecting op with constant parameters. Avoid any types
-    // with tokens because literal tokens are not allowed.
-    // TODO(meheff): 2019/6/26 Consider not folding loops with large trip counts
-    // to avoid hanging at compile time.
-    if (NodeIsConstantFoldable(node, query_engine)) {
-      VLOG(2) << "Folding: " << *node;
-      std::vector<Value> operand_values;
-      for (Node* operand : node->operands()) {
-        operand_values.push_back(*query_engine.KnownValue(operand));
-      }
-      XLS_ASSIGN_OR_RETURN(Value result, InterpretNode(node, operand_values));
-      XLS_RETURN_IF_ERROR(node->ReplaceUsesWithNew<Literal>(result).status());
-      changed = true;
-    }
+    XLS_ASSIGN_OR_RETURN(bool node_changed,
+                         ConstantFoldNode(node, query_engine));
+    changed |= node_changed;
   }
 
   return changed;
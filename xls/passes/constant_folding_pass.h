@@ -19,8 +19,10 @@
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
+#include "xls/passes/query_engine.h"
 
 namespace xls {
 
@@ -129,6 +131,11 @@ class ConstantFoldingPass : public OptimizationFunctionBasePass {
       PassResults* results, OptimizationContext& context) const override;
 };
 
+// Replaces the uses of `node` with a literal if all of its operands are known
+// constants according to `query_engine`. Returns true if the IR was modified.
+absl::StatusOr<bool> ConstantFoldNode(Node* node,
+                                      const QueryEngine& query_engine);
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_CONSTANT_FOLDING_PASS_H_
@@ -32,22 +32,22 @@
 
 namespace xls {
 
+bool IsDeletableNode(Node* n) {
+  // Don't remove invokes, they will be removed by inlining. The invoked
+  // functions could have side effects, so DCE shouldn't remove them.
+  //
+  // TODO: google/xls#1806 -  consider making invokes side-effecting if we can
+  // deal with FFI well.
+  return !n->function_base()->HasImplicitUse(n) && !n->Is<Invoke>() &&
+         (!OpIsSideEffecting(n->op()) || n->Is<Gate>());
+}
+
 absl::StatusOr<bool> DeadCodeEliminationPass::RunOnFunctionBaseInternal(
     FunctionBase* f, const OptimizationPassOptions& options,
     PassResults* results, OptimizationContext& context) const {
-  auto is_deletable = [](Node* n) {
-    // Don't remove invokes, they will be removed by inlining. The invoked
-    // functions could have side effects, so DCE shouldn't remove them.
-    //
-    // TODO: google/xls#1806 -  consider making invokes side-effecting if we can
-    // deal with FFI well.
-    return !n->function_base()->HasImplicitUse(n) && !n->Is<Invoke>() &&
-           (!OpIsSideEffecting(n->op()) || n->Is<Gate>());
-  };
-
   std::deque<Node*> worklist;
   for (Node* n : f->nodes()) {
-    if (n->users().empty() && is_deletable(n)) {
+    if (n->users().empty() && IsDeletableNode(n)) {
       worklist.push_back(n);
     }
   }
@@ -62,7 +62,7 @@ absl::StatusOr<bool> DeadCodeEliminationPass::RunOnFunctionBaseInternal(
     ForEachUnique(
         node->operands(),
         [&](Node* operand) {
-          if (HasSingleUse(operand) && is_deletable(operand)) {
+          if (HasSingleUse(operand) && IsDeletableNode(operand)) {
             worklist.push_back(operand);
           }
         },
@@ -75,7 +75,7 @@ absl::StatusOr<bool> DeadCodeEliminationPass::RunOnFunctionBaseInternal(
   VLOG(2) << "Removed " << removed_count << " dead nodes";
   // Use this pass to clean up context once we've removed nodes.
   if (removed_count > 0) {
-    XLS_RETURN_IF_ERROR(context.CollectGarbage());
+    XLS_RETURN_IF_ERROR(context.CollectGarbage(f));
   }
   return removed_count > 0;
 }
@@ -21,6 +21,7 @@
 
 #include "absl/status/statusor.h"
 #include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/pass_base.h"
 
@@ -154,6 +155,8 @@ class DeadCodeEliminationPass : public OptimizationFunctionBasePass {
     return RedundancyGuard::CanSkip();
   }
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   // Iterate all nodes, mark and eliminate the unvisited nodes.
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
@@ -161,6 +164,9 @@ class DeadCodeEliminationPass : public OptimizationFunctionBasePass {
       PassResults* results, OptimizationContext& context) const override;
 };
 
+// Returns true if DCE may remove `n` once it has no users.
+bool IsDeletableNode(Node* n);
+
 }  // namespace xls
 
 #endif  // XLS_PASSES_DCE_PASS_H_
@@ -120,6 +120,8 @@ class IdentityRemovalPass : public OptimizationFunctionBasePass {
     return RedundancyGuard::CanSkip();
   }
 
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
  protected:
   // Iterate all nodes and eliminate identities.
   absl::StatusOr<bool> RunOnFunctionBaseInternal(
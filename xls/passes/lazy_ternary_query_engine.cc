@@ -593,15 +593,12 @@ bool IsExpensiveToEvaluate(Node* node,
   static constexpr int64_t kIndexBitLimit = 10;
   // How many bits of output we allow for complex evaluations.
   static constexpr int64_t kComplexEvaluationLimit = 256;
+  // How many bits of the value being shifted we allow for shifts.
+  static constexpr int64_t kShiftEvaluationLimit = 4096;
   // How many bits of data we are willing to keep track of for compound
   // data-types.
   static constexpr int64_t kCompoundDataTypeSizeLimit = 65536;
-  // Shifts are quadratic in the width of the value being shifted, so wide
-  // shifts are very slow to evaluate in the abstract evaluator.
   bool is_complex_evaluation = node->OpIn({
-      Op::kShrl,
-      Op::kShll,
-      Op::kShra,
       Op::kBitSliceUpdate,
       Op::kDynamicBitSlice,
   });
@@ -609,6 +606,13 @@ bool IsExpensiveToEvaluate(Node* node,
     return node->operand(0)->GetType()->GetFlatBitCount() >
            kComplexEvaluationLimit;
   }
+  // Shifts by an unknown amount are quadratic in the width of the value being
+  // shifted but are evaluated a word at a time so we can afford much wider
+  // ones.
+  if (node->OpIn({Op::kShrl, Op::kShll, Op::kShra})) {
+    return node->operand(0)->GetType()->GetFlatBitCount() >
+           kShiftEvaluationLimit;
+  }
   // Compound data types can get enormous. Put a limit on how much data we are
   // willing to carry around.
   if (!node->GetType()->IsBits() &&
@@ -14,6 +14,8 @@
 
 #include "xls/passes/optimization_pass.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <iterator>
@@ -21,6 +23,7 @@
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -29,9 +32,11 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "xls/common/math_util.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread_pool.h"
 #include "xls/ir/change_listener.h"
 #include "xls/ir/function_base.h"
 #include "xls/ir/node.h"
@@ -40,6 +45,14 @@
 #include "xls/ir/topo_sort.h"
 
 namespace xls {
+namespace {
+
+// Number of node ids reserved for each FunctionBase while a pass runs on
+// several FunctionBases concurrently. The ids are only used for the duration
+// of the pass; nodes are renumbered densely afterwards.
+constexpr int64_t kNodeIdBlockSize = int64_t{1} << 32;
+
+}  // namespace
 
 std::string_view RamKindToString(RamKind kind) {
   switch (kind) {
@@ -129,6 +142,7 @@ absl::StatusOr<std::vector<RamRewrite>> RamRewritesFromProto(
 }
 
 absl::Status OptimizationContext::CollectGarbage() {
+  absl::MutexLock lock(&mu_);
   for (auto& [f, query_engines] : shared_query_engines_) {
     for (auto& [_, qe] : query_engines) {
       XLS_RETURN_IF_ERROR(qe.CollectGarbage());
@@ -137,20 +151,34 @@ absl::Status OptimizationContext::CollectGarbage() {
   return absl::OkStatus();
 }
 
+absl::Status OptimizationContext::CollectGarbage(FunctionBase* f) {
+  absl::flat_hash_map<ConstructorArguments, SharableQueryEngine>*
+      query_engines;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = shared_query_engines_.find(f);
+    if (it == shared_query_engines_.end()) {
+      return absl::OkStatus();
+    }
+    query_engines = &it->second;
+  }
+  for (auto& [_, qe] : *query_engines) {
+    XLS_RETURN_IF_ERROR(qe.CollectGarbage());
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<const std::vector<Node*>&>
 OptimizationContext::ReverseTopoSortReference(FunctionBase* f) {
-  auto it = reverse_topo_sort_.find(f);
-  if (it == reverse_topo_sort_.end()) {
-    XLS_ASSIGN_OR_RETURN(std::vector<Node*> sorted, xls::ReverseTopoSort(f));
-    bool inserted = false;
-    std::tie(it, inserted) =
-        reverse_topo_sort_.emplace(f, InvalidatingVector(this, f, sorted));
-    XLS_RET_CHECK(inserted);
+  InvalidatingVector* sorted;
+  {
+    absl::MutexLock lock(&mu_);
+    sorted = &reverse_topo_sort_.try_emplace(f, this, f).first->second;
   }
-  if (it->second->empty() && f->node_count() > 0) {
-    XLS_ASSIGN_OR_RETURN(*it->second, xls::ReverseTopoSort(f));
+  if ((*sorted)->empty() && f->node_count() > 0) {
+    XLS_ASSIGN_OR_RETURN(**sorted, xls::ReverseTopoSort(f));
   }
-  return *it->second;
+  return **sorted;
 }
 
 absl::StatusOr<std::vector<Node*>> OptimizationContext::ReverseTopoSort(
@@ -204,4 +232,83 @@ absl::StatusOr<bool> OptimizationFunctionBasePass::TransformNodesToFixedPoint(
   return changed;
 }
 
+absl::StatusOr<bool> OptimizationFunctionBasePass::RunInternal(
+    Package* p, const OptimizationPassOptions& options, PassResults* results,
+    OptimizationContext& context) const {
+  std::vector<FunctionBase*> function_bases = p->GetFunctionBases();
+  int64_t thread_count = options.function_base_threads == 0
+                             ? DefaultThreadCount()
+                             : options.function_base_threads;
+  thread_count =
+      std::min(thread_count, static_cast<int64_t>(function_bases.size()));
+  if (thread_count <= 1 || !RunsFunctionBasesIndependently()) {
+    return FunctionBasePass::RunInternal(p, options, results, context);
+  }
+
+  // Nodes created for FunctionBase `i` take their ids from block `i + 1`
+  // above the ids currently in use, so the ids never depend on which thread
+  // got to which FunctionBase first. Block zero is left free for the
+  // renumbering below.
+  const int64_t first_id = p->next_node_id();
+  auto block_start = [&](int64_t i) {
+    return first_id + (i + 1) * kNodeIdBlockSize;
+  };
+  struct FunctionBaseRun {
+    absl::StatusOr<bool> changed = false;
+    TransformMetrics metrics;
+    // The number of ids handed out from the block, including those of nodes
+    // which were created and then removed.
+    int64_t consumed_ids = 0;
+  };
+  std::vector<FunctionBaseRun> runs(function_bases.size());
+  std::atomic<int64_t> next_index = 0;
+  auto run_function_bases = [&]() {
+    for (int64_t i = next_index.fetch_add(1);
+         i < static_cast<int64_t>(function_bases.size());
+         i = next_index.fetch_add(1)) {
+      Package::NodeIdBlockScope block(p, block_start(i),
+                                      block_start(i) + kNodeIdBlockSize);
+      runs[i].changed = RunOnFunctionBaseInternal(function_bases[i], options,
+                                                  results, context);
+      runs[i].metrics = block.metrics();
+      runs[i].consumed_ids = block.next_id() - block.first_id();
+    }
+  };
+  // Each of the `thread_count` tasks claims FunctionBases until none are left,
+  // so at most that many run at once.
+  XLS_RETURN_IF_ERROR(
+      DefaultThreadPool().ParallelFor(thread_count, [&](int64_t) {
+        run_function_bases();
+        return absl::OkStatus();
+      }));
+
+  // A serial run hands out the ids of FunctionBase `i` in creation order
+  // starting after the ids consumed by the FunctionBases before it, so shift
+  // each block down to that offset. Ids of nodes which were created and then
+  // removed stay consumed, which makes this exactly the numbering a serial run
+  // would have produced. The new ids are below every block which is not yet
+  // renumbered.
+  int64_t next_id = first_id;
+  for (int64_t i = 0; i < static_cast<int64_t>(function_bases.size()); ++i) {
+    p->transform_metrics() = p->transform_metrics() + runs[i].metrics;
+    for (Node* node : function_bases[i]->nodes()) {
+      if (node->id() >= block_start(i)) {
+        node->SetId(next_id + (node->id() - block_start(i)));
+      }
+    }
+    next_id += runs[i].consumed_ids;
+  }
+  p->set_next_node_id(next_id);
+
+  bool changed = false;
+  for (FunctionBaseRun& run : runs) {
+    XLS_ASSIGN_OR_RETURN(bool function_changed, std::move(run.changed));
+    if (function_changed) {
+      GcAfterFunctionBaseChange(p, context);
+    }
+    changed = changed || function_changed;
+  }
+  return changed;
+}
+
 }  // namespace xls
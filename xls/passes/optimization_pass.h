@@ -33,6 +33,7 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/hash/hash.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -40,6 +41,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
@@ -193,6 +195,14 @@ struct OptimizationPassOptions : public PassOptionsBase {
   // Optimize for best case throughput, even at the cost of area.
   bool optimize_for_best_case_throughput = false;
 
+  // The maximum number of threads used to run a function-scoped pass over the
+  // functions, procs and blocks of a package. Only passes which report
+  // RunsFunctionBasesIndependently() are run concurrently. The resulting IR
+  // (including node ids) is identical for every value. The passes run on
+  // DefaultThreadPool(). If zero, DefaultThreadCount() is used, which follows
+  // --xls_threads.
+  int64_t function_base_threads = 1;
+
   // Enable resource sharing to reduce area
   bool enable_resource_sharing = false;
 
@@ -207,11 +217,19 @@ struct OptimizationPassOptions : public PassOptionsBase {
   }
 };
 
+// Caches analyses of the FunctionBases in a package across passes.
+//
+// Requests for *different* FunctionBases may be made concurrently from
+// different threads. Requests for a single FunctionBase must come from one
+// thread at a time, as must CollectGarbage(), ListQueryEngines() and
+// Abandon().
 class OptimizationContext {
  public:
   // Try to reduce memory use by asking query engines to perform full garbage
   // collection.
   absl::Status CollectGarbage();
+  // As above but only for the query engines of `f`.
+  absl::Status CollectGarbage(FunctionBase* f);
 
   // Create or get a shared node data constructed using the given args. All args
   // must live at least as long as the entire compilation (including keeping
@@ -228,7 +246,7 @@ class OptimizationContext {
              std::copyable<std::tuple<Args...>>)
   absl::StatusOr<AnalysisT*> SharedNodeData(FunctionBase* f, Args... args) {
     ConstructorArguments key(typeid(AnalysisT), args...);
-    auto& instance_analyses = shared_lazy_node_data_[f];
+    auto& instance_analyses = LockedGet(shared_lazy_node_data_, f);
     auto it = instance_analyses.find(key);
     if (it == instance_analyses.end()) {
       auto analysis = std::make_shared<AnalysisT>(args...);
@@ -261,7 +279,7 @@ class OptimizationContext {
   QueryEngineT* SharedQueryEngine(FunctionBase* f, Args... args) {
     ConstructorArguments key(typeid(QueryEngineT), args...);
     absl::flat_hash_map<ConstructorArguments, SharableQueryEngine>&
-        f_query_engines = shared_query_engines_[f];
+        f_query_engines = LockedGet(shared_query_engines_, f);
     auto it = f_query_engines.find(key);
     if (it == f_query_engines.end()) {
       bool inserted = false;
@@ -291,6 +309,7 @@ class OptimizationContext {
   }
 
   std::vector<QueryEngine*> ListQueryEngines() {
+    absl::MutexLock lock(&mu_);
     std::vector<QueryEngine*> query_engines;
     for (auto& [f, f_query_engines] : shared_query_engines_) {
       query_engines.reserve(query_engines.size() + f_query_engines.size());
@@ -302,6 +321,7 @@ class OptimizationContext {
   }
 
   void Abandon(FunctionBase* f) {
+    absl::MutexLock lock(&mu_);
     shared_query_engines_.erase(f);
     shared_lazy_node_data_.erase(f);
     reverse_topo_sort_.erase(f);
@@ -314,6 +334,15 @@ class OptimizationContext {
   absl::StatusOr<const std::vector<Node*>&> ReverseTopoSortReference(
       FunctionBase* f);
 
+  // Returns the (possibly newly created) per-FunctionBase entry of `map`. The
+  // outer maps are node_hash_maps so the returned reference stays valid while
+  // other threads add entries for other FunctionBases.
+  template <typename V>
+  V& LockedGet(absl::node_hash_map<FunctionBase*, V>& map, FunctionBase* f) {
+    absl::MutexLock lock(&mu_);
+    return map[f];
+  }
+
   class InvalidatingVector : public ChangeListener {
    public:
     explicit InvalidatingVector(OptimizationContext* owner, FunctionBase* f,
@@ -391,9 +420,17 @@ class OptimizationContext {
   //
   // NB The function is currently in its destructor.
   void HandleFunctionBaseDeleted(FunctionBase* f) {
+    absl::MutexLock lock(&mu_);
     reverse_topo_sort_.erase(f);
   }
-  absl::flat_hash_map<FunctionBase*, InvalidatingVector> reverse_topo_sort_;
+
+  // Guards the structure (but not the per-FunctionBase contents) of the maps
+  // below.
+  absl::Mutex mu_;
+
+  // node_hash_map so that the listeners registered with each FunctionBase do
+  // not move when entries for other FunctionBases are added.
+  absl::node_hash_map<FunctionBase*, InvalidatingVector> reverse_topo_sort_;
 
   // Helper class to hide the actual constructor arguments needed to create an
   // analysis.
@@ -527,10 +564,10 @@ class OptimizationContext {
         qe_;
   };
 
-  absl::flat_hash_map<FunctionBase*, absl::flat_hash_map<ConstructorArguments,
+  absl::node_hash_map<FunctionBase*, absl::flat_hash_map<ConstructorArguments,
                                                          SharableQueryEngine>>
       shared_query_engines_;
-  absl::flat_hash_map<FunctionBase*,
+  absl::node_hash_map<FunctionBase*,
                       absl::flat_hash_map<ConstructorArguments,
                                           std::shared_ptr<ChangeListener>>>
       shared_lazy_node_data_;
@@ -809,7 +846,19 @@ class OptimizationFunctionBasePass
  public:
   using FunctionBasePass::FunctionBasePass;
 
+  // Returns true if RunOnFunctionBaseInternal only reads and modifies the
+  // FunctionBase it is given (creating nodes and types is fine), never looks
+  // at other FunctionBases (e.g. the callees of invokes) and does not write
+  // to PassResults. Such passes are run on the FunctionBases of a package
+  // concurrently when OptimizationPassOptions::function_base_threads allows.
+  virtual bool RunsFunctionBasesIndependently() const { return false; }
+
  protected:
+  absl::StatusOr<bool> RunInternal(Package* p,
+                                   const OptimizationPassOptions& options,
+                                   PassResults* results,
+                                   OptimizationContext& context) const override;
+
   // TransformNodesToFixedPoint returns true iff any invocations of simplify_f
   // returned true.
   absl::StatusOr<bool> TransformNodesToFixedPoint(
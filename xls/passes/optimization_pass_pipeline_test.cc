@@ -15,6 +15,7 @@
 #include "xls/passes/optimization_pass_pipeline.h"
 
 #include <cstdint>
+#include <filesystem>  // NOLINT
 #include <memory>
 #include <string>
 #include <string_view>
@@ -22,26 +23,34 @@
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
 #include "xls/common/fuzzing/fuzztest.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/get_runfile_path.h"
 #include "xls/common/status/matchers.h"
 #include "xls/examples/sample_packages.h"
 #include "xls/fuzzer/ir_fuzzer/ir_fuzz_domain.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_matcher.h"
 #include "xls/ir/ir_test_base.h"
+#include "xls/ir/node_allocator.h"
 #include "xls/ir/nodes.h"
 #include "xls/ir/op.h"
 #include "xls/ir/package.h"
 #include "xls/ir/value.h"
 #include "xls/passes/optimization_pass.h"
+#include "xls/passes/optimization_pass_pipeline.pb.h"
+#include "xls/passes/optimization_pass_registry.h"
 #include "xls/passes/pass_base.h"
+#include "xls/passes/pass_pipeline.pb.h"
 #include "xls/solvers/ir_equivalence_testutils.h"
 
 namespace m = ::xls::op_matchers;
@@ -52,6 +61,7 @@ namespace {
 constexpr absl::Duration kProverTimeout = absl::Seconds(10);
 
 using ::absl_testing::IsOkAndHolds;
+using ::testing::HasSubstr;
 using ::xls::solvers::ScopedVerifyEquivalence;
 
 class OptimizationPipelineTest : public IrTestBase {
@@ -192,6 +202,46 @@ TEST_F(OptimizationPipelineTest, DoubleNeg) {
   EXPECT_THAT(f->return_value(), m::Param());
 }
 
+TEST_F(OptimizationPipelineTest, WorklistSimpPipeline) {
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::filesystem::path path,
+      GetXlsRunfilePath("xls/passes/worklist_simp_pipeline.txtpb"));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      OptimizationPipelineProto pipeline_proto,
+      ParseTextProtoFile<OptimizationPipelineProto>(path));
+  OptimizationPassRegistry registry =
+      GetOptimizationRegistry().OverridableClone();
+  XLS_ASSERT_OK(registry.RegisterPipelineProto(pipeline_proto, path.string()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<OptimizationCompoundPass> pipeline,
+      TryCreateOptimizationPassPipeline(/*debug_optimizations=*/false,
+                                        registry));
+  XLS_ASSERT_OK_AND_ASSIGN(PassPipelineProto::Element pipeline_element,
+                           pipeline->ToProto());
+  EXPECT_THAT(pipeline_element.DebugString(), HasSubstr("worklist_simp"));
+
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x:bits[8]) -> bits[8] {
+        neg1: bits[8] = neg(x)
+        neg2: bits[8] = neg(neg1)
+        lit1: bits[8] = literal(value=1)
+        lit2: bits[8] = literal(value=2)
+        sum: bits[8] = add(lit1, lit2)
+        ret res: bits[8] = add(sum, neg2)
+     }
+  )",
+                                                       p.get()));
+  ScopedVerifyEquivalence stays_equivalent(f, kProverTimeout);
+  PassResults results;
+  OptimizationContext context;
+  ASSERT_THAT(
+      pipeline->Run(p.get(), OptimizationPassOptions(), &results, context),
+      IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(),
+              m::Add(m::Param("x"), m::Literal(UBits(3, 8))));
+}
+
 TEST_F(OptimizationPipelineTest, AssociateAdd) {
   TestAssociativeWithConstants("add", Op::kAdd, 7 + 12);
 }
@@ -403,5 +453,27 @@ TEST_F(OptimizationPipelineTest, ArrayUpdateOptimizationsConverge) {
   DefaultPipelineFinishes(std::move(p));
 }
 
+// Benchmark of the default optimization pipeline (as run by opt_main) on a
+// balanced tree of adds of literals of depth `state.range(0)` which is
+// constant folded away, creating and removing many nodes.
+void BM_OptimizeBalancedAddTree(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    Package p("benchmark");
+    XLS_ASSERT_OK(benchmark_support::GenerateBalancedTree(
+                      &p, state.range(0), /*fan_out=*/2,
+                      benchmark_support::strategy::BinaryAdd(),
+                      benchmark_support::strategy::DistinctLiteral())
+                      .status());
+    state.ResumeTiming();
+    XLS_ASSERT_OK(RunOptimizationPassPipeline(&p).status());
+  }
+  state.counters["node_slab_bytes"] = NodeAllocator::SlabBytes();
+}
+
+BENCHMARK(BM_OptimizeBalancedAddTree)
+    ->DenseRange(8, 14, 2)
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace
 }  // namespace xls
@@ -275,6 +275,124 @@ TEST(PassesTest, RunWithFailingNestedInvariantChecker) {
                                  "pass 'nested pass']")));
 }
 
+// Pass which adds a few nodes to every FunctionBase and which may be run on
+// several FunctionBases concurrently.
+class IndependentNodeAdderPass : public OptimizationFunctionBasePass {
+ public:
+  IndependentNodeAdderPass()
+      : OptimizationFunctionBasePass("independent_node_adder",
+                                     "Independent node adder") {}
+  ~IndependentNodeAdderPass() override = default;
+
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    // Use a width which differs between functions so type creation is
+    // exercised from multiple threads too.
+    int64_t width = f->node_count() + 1;
+    XLS_ASSIGN_OR_RETURN(
+        Node * a, f->MakeNode<Literal>(SourceInfo(), Value(UBits(1, width))));
+    XLS_ASSIGN_OR_RETURN(
+        Node * b, f->MakeNode<Literal>(SourceInfo(), Value(UBits(2, width))));
+    XLS_RETURN_IF_ERROR(f->MakeNode<NaryOp>(SourceInfo(),
+                                            std::vector<Node*>{a, b}, Op::kAnd)
+                            .status());
+    return true;
+  }
+};
+
+TEST(PassesTest, ParallelFunctionBasesMatchSerial) {
+  std::string ir = "package p\n";
+  for (int64_t i = 0; i < 16; ++i) {
+    absl::StrAppendFormat(&ir, R"(
+fn f%d(x: bits[8] id=%d) -> bits[8] {
+  ret neg.%d: bits[8] = neg(x, id=%d)
+}
+)",
+                          i, 2 * i + 1, 2 * i + 2, 2 * i + 2);
+  }
+  auto optimize = [&](int64_t threads) -> absl::StatusOr<std::string> {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p, Parser::ParsePackage(ir));
+    OptimizationCompoundPass pass_mgr("TOP", "Top level pass manager");
+    pass_mgr.Add<IndependentNodeAdderPass>();
+    pass_mgr.Add<IndependentNodeAdderPass>();
+    OptimizationPassOptions options;
+    options.function_base_threads = threads;
+    PassResults results;
+    OptimizationContext context;
+    XLS_ASSIGN_OR_RETURN(bool changed,
+                         pass_mgr.Run(p.get(), options, &results, context));
+    XLS_RET_CHECK(changed);
+    XLS_RET_CHECK_EQ(p->transform_metrics().nodes_added, 16 * 2 * 3);
+    XLS_RET_CHECK_EQ(p->next_node_id(), 2 * 16 + 16 * 2 * 3 + 1);
+    return p->DumpIr();
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(std::string serial, optimize(1));
+  EXPECT_THAT(optimize(4), IsOkAndHolds(serial));
+  EXPECT_THAT(optimize(0), IsOkAndHolds(serial));
+}
+
+// Pass which creates and removes a number of temporary nodes, which differs
+// between FunctionBases, before adding a node to every FunctionBase. May be
+// run on several FunctionBases concurrently.
+class IndependentNodeChurnPass : public OptimizationFunctionBasePass {
+ public:
+  IndependentNodeChurnPass()
+      : OptimizationFunctionBasePass("independent_node_churn",
+                                     "Independent node churn") {}
+  ~IndependentNodeChurnPass() override = default;
+
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override {
+    int64_t temporaries = f->name().size() % 3 + 1;
+    for (int64_t i = 0; i < temporaries; ++i) {
+      XLS_ASSIGN_OR_RETURN(
+          Node * temporary,
+          f->MakeNode<Literal>(SourceInfo(), Value(UBits(i, 8))));
+      XLS_RETURN_IF_ERROR(f->RemoveNode(temporary));
+    }
+    XLS_RETURN_IF_ERROR(
+        f->MakeNode<Literal>(SourceInfo(), Value(UBits(42, 8))).status());
+    return true;
+  }
+};
+
+TEST(PassesTest, ParallelFunctionBasesWithRemovedNodesMatchSerial) {
+  std::string ir = "package p\n";
+  for (int64_t i = 0; i < 16; ++i) {
+    absl::StrAppendFormat(&ir, R"(
+fn f%d(x: bits[8] id=%d) -> bits[8] {
+  ret neg.%d: bits[8] = neg(x, id=%d)
+}
+)",
+                          i, 2 * i + 1, 2 * i + 2, 2 * i + 2);
+  }
+  auto optimize = [&](int64_t threads) -> absl::StatusOr<std::string> {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> p, Parser::ParsePackage(ir));
+    OptimizationCompoundPass pass_mgr("TOP", "Top level pass manager");
+    pass_mgr.Add<IndependentNodeChurnPass>();
+    pass_mgr.Add<IndependentNodeAdderPass>();
+    pass_mgr.Add<IndependentNodeChurnPass>();
+    OptimizationPassOptions options;
+    options.function_base_threads = threads;
+    PassResults results;
+    OptimizationContext context;
+    XLS_RETURN_IF_ERROR(
+        pass_mgr.Run(p.get(), options, &results, context).status());
+    return absl::StrCat(p->DumpIr(), "next_node_id: ", p->next_node_id());
+  };
+  XLS_ASSERT_OK_AND_ASSIGN(std::string serial, optimize(1));
+  EXPECT_THAT(optimize(4), IsOkAndHolds(serial));
+  EXPECT_THAT(optimize(0), IsOkAndHolds(serial));
+}
+
 // Pass which adds a function of a particular name
 class FunctionAdderPass : public OptimizationPass {
  public:
@@ -927,7 +927,7 @@ class FunctionBasePass : public PassBase<OptionsT, ContextT...> {
   // RunOnFunctionBase.
   absl::StatusOr<bool> RunInternal(Package* p, const OptionsT& options,
                                    PassResults* results,
-                                   ContextT&... context) const final {
+                                   ContextT&... context) const override {
     bool changed = false;
     for (FunctionBase* f : p->GetFunctionBases()) {
       XLS_ASSIGN_OR_RETURN(
@@ -15,12 +15,27 @@
 #ifndef XLS_PASSES_TERNARY_EVALUATOR_H_
 #define XLS_PASSES_TERNARY_EVALUATOR_H_
 
+#include <cstdint>
+#include <vector>
+
+#include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "xls/ir/abstract_evaluator.h"
+#include "xls/ir/packed_ternary.h"
 #include "xls/ir/ternary.h"
 
 namespace xls {
 
+// An abstract evaluator over ternary values.
+//
+// The vector operations whose generic bit-at-a-time implementations are
+// expensive on wide values (bitwise operations, adds, subtracts, shifts and
+// unsigned comparisons) are evaluated on PackedTernaryVectors instead when
+// their operands are wider than kPackedMinBitCount, which process a machine
+// word of bits at a time. Narrower operands are not worth the conversion and
+// use the generic implementations, except that adds and subtracts use the
+// same carry analysis as the packed form on a single word. The results are
+// never less precise than those of the generic implementations.
 class TernaryEvaluator
     : public AbstractEvaluator<TernaryValue, TernaryEvaluator> {
  public:
@@ -61,6 +76,148 @@ class TernaryEvaluator
     }
     return TernaryValue::kUnknown;
   }
+
+  // Operands of at most this many bits are not converted to the packed form.
+  static constexpr int64_t kPackedMinBitCount = 32;
+
+  Vector BitwiseNot(const Span& input) {
+    if (input.size() <= kPackedMinBitCount) {
+      return Base::BitwiseNot(input);
+    }
+    return packed_ternary_ops::Not(PackedTernaryVector::FromTernary(input))
+        .ToTernary();
+  }
+  Vector BitwiseAnd(SpanOfSpan inputs) {
+    if (IsNarrow(inputs)) {
+      return Base::BitwiseAnd(inputs);
+    }
+    return PackedNaryOp(inputs, packed_ternary_ops::And);
+  }
+  Vector BitwiseOr(SpanOfSpan inputs) {
+    if (IsNarrow(inputs)) {
+      return Base::BitwiseOr(inputs);
+    }
+    return PackedNaryOp(inputs, packed_ternary_ops::Or);
+  }
+  Vector BitwiseXor(SpanOfSpan inputs) {
+    if (IsNarrow(inputs)) {
+      return Base::BitwiseXor(inputs);
+    }
+    return PackedNaryOp(inputs, packed_ternary_ops::Xor);
+  }
+  Vector BitwiseAnd(Span a, Span b) { return BitwiseAnd({a, b}); }
+  Vector BitwiseOr(Span a, Span b) { return BitwiseOr({a, b}); }
+  Vector BitwiseXor(Span a, Span b) { return BitwiseXor({a, b}); }
+
+  Vector Add(Span a, Span b) {
+    if (a.size() <= kPackedMinBitCount) {
+      return NarrowAddWithCarryIn(a, b, /*invert_b=*/false,
+                                  /*carry_in=*/false);
+    }
+    return packed_ternary_ops::Add(PackedTernaryVector::FromTernary(a),
+                                   PackedTernaryVector::FromTernary(b))
+        .ToTernary();
+  }
+  Vector Sub(Span a, Span b) {
+    if (a.size() <= kPackedMinBitCount) {
+      return NarrowAddWithCarryIn(a, b, /*invert_b=*/true, /*carry_in=*/true);
+    }
+    return packed_ternary_ops::Sub(PackedTernaryVector::FromTernary(a),
+                                   PackedTernaryVector::FromTernary(b))
+        .ToTernary();
+  }
+
+  Vector ShiftRightLogical(Span input, Span amount) {
+    return packed_ternary_ops::ShiftRightLogical(
+               PackedTernaryVector::FromTernary(input),
+               PackedTernaryVector::FromTernary(amount))
+        .ToTernary();
+  }
+  Vector ShiftRightArith(Span input, Span amount) {
+    return packed_ternary_ops::ShiftRightArith(
+               PackedTernaryVector::FromTernary(input),
+               PackedTernaryVector::FromTernary(amount))
+        .ToTernary();
+  }
+  Vector ShiftLeftLogical(Span input, Span amount) {
+    return packed_ternary_ops::ShiftLeftLogical(
+               PackedTernaryVector::FromTernary(input),
+               PackedTernaryVector::FromTernary(amount))
+        .ToTernary();
+  }
+
+  TernaryValue Equals(Span a, Span b) const {
+    if (a.size() <= kPackedMinBitCount) {
+      return Base::Equals(a, b);
+    }
+    return packed_ternary_ops::Equals(PackedTernaryVector::FromTernary(a),
+                                      PackedTernaryVector::FromTernary(b));
+  }
+  TernaryValue ULessThan(Span a, Span b) const {
+    if (a.size() <= kPackedMinBitCount) {
+      return Base::ULessThan(a, b);
+    }
+    return packed_ternary_ops::ULessThan(PackedTernaryVector::FromTernary(a),
+                                         PackedTernaryVector::FromTernary(b));
+  }
+
+ private:
+  using Base = AbstractEvaluator<TernaryValue, TernaryEvaluator>;
+
+  static bool IsNarrow(SpanOfSpan inputs) {
+    CHECK(!inputs.empty());
+    return inputs[0].size() <= kPackedMinBitCount;
+  }
+
+  template <typename F>
+  Vector PackedNaryOp(SpanOfSpan inputs, F op) {
+    CHECK(!inputs.empty());
+    PackedTernaryVector result = PackedTernaryVector::FromTernary(inputs[0]);
+    for (Span input : inputs.subspan(1)) {
+      result = op(result, PackedTernaryVector::FromTernary(input));
+    }
+    return result.ToTernary();
+  }
+
+  // Computes `a + (invert_b ? ~b : b) + carry_in` for operands of at most 64
+  // bits with the carry analysis of packed_ternary_ops::Add: the carry into a
+  // position is known if the sums of the smallest and of the largest operand
+  // values agree on it.
+  static Vector NarrowAddWithCarryIn(Span a, Span b, bool invert_b,
+                                     bool carry_in) {
+    CHECK_EQ(a.size(), b.size());
+    CHECK_LE(a.size(), 64);
+    uint64_t a_known = 0;
+    uint64_t a_value = 0;
+    uint64_t b_known = 0;
+    uint64_t b_value = 0;
+    for (int64_t i = 0; i < a.size(); ++i) {
+      uint64_t bit = uint64_t{1} << i;
+      if (ternary_ops::IsKnown(a[i])) {
+        a_known |= bit;
+        a_value |= a[i] == TernaryValue::kKnownOne ? bit : 0;
+      }
+      if (ternary_ops::IsKnown(b[i])) {
+        b_known |= bit;
+        b_value |= (b[i] == TernaryValue::kKnownOne) != invert_b ? bit : 0;
+      }
+    }
+    uint64_t max_a = a_value | ~a_known;
+    uint64_t max_b = b_value | ~b_known;
+    uint64_t min_sum = a_value + b_value + (carry_in ? 1 : 0);
+    uint64_t max_sum = max_a + max_b + (carry_in ? 1 : 0);
+    uint64_t carry_known_zero = ~(max_sum ^ max_a ^ max_b);
+    uint64_t carry_known_one = min_sum ^ a_value ^ b_value;
+    uint64_t known = a_known & b_known & (carry_known_zero | carry_known_one);
+    Vector result(a.size(), TernaryValue::kUnknown);
+    for (int64_t i = 0; i < a.size(); ++i) {
+      if ((known >> i) & 1) {
+        result[i] = ((min_sum >> i) & 1) ? TernaryValue::kKnownOne
+                                         : TernaryValue::kKnownZero;
+      }
+    }
+    return result;
+  }
 };
 
 }  // namespace xls
@@ -110,21 +110,23 @@ bool IsExpensiveToEvaluate(
         Node*, SharedLeafTypeTree<TernaryEvaluator::Vector>>& known_bits) {
   // How many bits of output we allow for complex evaluations.
   static constexpr int64_t kComplexEvaluationLimit = 256;
+  // How many bits of output we allow for shifts.
+  static constexpr int64_t kShiftEvaluationLimit = 4096;
   // How many bits of data we are willing to keep track of for compound
   // data-types.
   static constexpr int64_t kCompoundDataTypeSizeLimit = 65536;
-  // Shifts are quadratic in the width of the operand so wide shifts are very
-  // slow to evaluate in the abstract evaluator.
   bool is_complex_evaluation = node->OpIn({
-      Op::kShrl,
-      Op::kShll,
-      Op::kShra,
       Op::kBitSliceUpdate,
       Op::kInvoke,
   });
   if (is_complex_evaluation) {
     return node->GetType()->GetFlatBitCount() > kComplexEvaluationLimit;
   }
+  // Shifts by an unknown amount are quadratic in the width of the operand but
+  // are evaluated a word at a time so we can afford much wider ones.
+  if (node->OpIn({Op::kShrl, Op::kShll, Op::kShra})) {
+    return node->GetType()->GetFlatBitCount() > kShiftEvaluationLimit;
+  }
   // Compound data types can get enormous. Put a limit on how much data we are
   // willing to carry around.
   if (!node->GetType()->IsBits() &&
@@ -1865,9 +1865,40 @@ void BM_ArrayIndexExactTree(benchmark::State& state) {
   }
 }
 
+// A chain of adds, subtracts, shifts and compares as found in datapaths, from
+// narrow control logic up to the wide datapaths of e.g. bignum arithmetic. The
+// upper half of each input is known to be zero so the analysis has information
+// to propagate.
+void BM_Datapath(benchmark::State& state) {
+  int64_t width = state.range(0);
+  auto p = std::make_unique<VerifiedPackage>("wide_datapath");
+  FunctionBuilder fb("wide_datapath", p.get());
+  BValue mask =
+      fb.Literal(bits_ops::ZeroExtend(Bits::AllOnes(width / 2), width));
+  BValue x = fb.And(fb.Param("x", p->GetBitsType(width)), mask);
+  BValue y = fb.And(fb.Param("y", p->GetBitsType(width)), mask);
+  BValue amount = fb.Param("amount", p->GetBitsType(8));
+  std::vector<BValue> flags;
+  for (int64_t i = 0; i < 32; ++i) {
+    BValue sum = fb.Add(x, y);
+    BValue diff = fb.Subtract(sum, fb.Shrl(y, amount));
+    flags.push_back(fb.ULt(sum, diff));
+    y = x;
+    x = fb.Concat({fb.BitSlice(diff, 0, width - 1), fb.Literal(UBits(0, 1))});
+  }
+  fb.Tuple({x, fb.Concat(flags)});
+  XLS_ASSERT_OK_AND_ASSIGN(auto* f, fb.Build());
+  for (auto _ : state) {
+    TernaryQueryEngine tqe;
+    XLS_ASSERT_OK_AND_ASSIGN(auto r, tqe.Populate(f));
+    benchmark::DoNotOptimize(r);
+  }
+}
+
 BENCHMARK(BM_ArrayIndexExactDeep)->DenseRange(2, 14, 1);
 BENCHMARK(BM_ArrayIndexExactShallow)->DenseRange(2, 14, 1);
 BENCHMARK(BM_ArrayIndexExactTree)->DenseRange(2, 12, 1);
+BENCHMARK(BM_Datapath)->Range(8, 4096);
 
 void CheckEngineConsistency(FuzzPackageWithArgs a) {
   CheckTernaryEngineConsistency<TernaryQueryEngine>(a);
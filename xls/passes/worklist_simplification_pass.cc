@@ -0,0 +1,213 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/worklist_simplification_pass.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/change_listener.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/node.h"
+#include "xls/ir/proc.h"
+#include "xls/passes/arith_simplification_pass.h"
+#include "xls/passes/basic_simplification_pass.h"
+#include "xls/passes/canonicalization_pass.h"
+#include "xls/passes/constant_folding_pass.h"
+#include "xls/passes/dce_pass.h"
+#include "xls/passes/optimization_pass.h"
+#include "xls/passes/pass_base.h"
+#include "xls/passes/query_engine.h"
+#include "xls/passes/stateless_query_engine.h"
+
+namespace xls {
+
+namespace {
+
+// A FIFO of nodes to simplify which is kept up to date by listening to changes
+// of the function: any node a rewrite may have made simplifiable is
+// (re-)enqueued. Each node is in the queue at most once.
+class SimplificationWorklist : public ChangeListener {
+ public:
+  explicit SimplificationWorklist(FunctionBase* f) : f_(f) {
+    f_->RegisterChangeListener(this);
+  }
+  ~SimplificationWorklist() override { f_->UnregisterChangeListener(this); }
+
+  SimplificationWorklist(const SimplificationWorklist&) = delete;
+  SimplificationWorklist& operator=(const SimplificationWorklist&) = delete;
+
+  void Add(Node* node) {
+    if (queued_.insert(node).second) {
+      queue_.push_back(node);
+    }
+  }
+
+  // Returns the next node to simplify or nullptr if the worklist is empty.
+  Node* Pop() {
+    // Deleted nodes are dropped from `queued_` but not from `queue_`, skip them
+    // here. If the storage of a deleted node has been reused by a new node then
+    // that node is in `queued_` and is simply visited early.
+    while (!queue_.empty()) {
+      Node* node = queue_.front();
+      queue_.pop_front();
+      if (queued_.erase(node) > 0) {
+        return node;
+      }
+    }
+    return nullptr;
+  }
+
+  // Starts tracking whether `node` is deleted. Only one node is tracked at a
+  // time.
+  void Watch(Node* node) {
+    watched_ = node;
+    watched_deleted_ = false;
+  }
+  bool WatchedNodeDeleted() const { return watched_deleted_; }
+
+  void NodeAdded(Node* node) override { Add(node); }
+  void NodeDeleted(Node* node) override {
+    queued_.erase(node);
+    if (node == watched_) {
+      watched_deleted_ = true;
+    }
+  }
+
+  // The patterns of the rewrites look through operands, so a node whose
+  // operands changed may enable rewrites of its users too.
+  void OperandChanged(Node* node, Node* old_operand,
+                      absl::Span<const int64_t> operand_nos) override {
+    AddWithUsers(node);
+  }
+  void OperandRemoved(Node* node, Node* old_operand) override {
+    AddWithUsers(node);
+  }
+  void OperandAdded(Node* node) override { AddWithUsers(node); }
+
+  // A node which lost a user may now be dead, and its remaining users may now
+  // match patterns which require a single use of their operand.
+  void UserRemoved(Node* node, Node* old_user) override { AddWithUsers(node); }
+
+  void ReturnValueChanged(Function* function_base,
+                          Node* old_return_value) override {
+    Add(old_return_value);
+    Add(function_base->return_value());
+  }
+  void NextStateElementChanged(Proc* proc, int64_t state_index,
+                               Node* old_next_state_element) override {
+    Add(old_next_state_element);
+  }
+
+ private:
+  void AddWithUsers(Node* node) {
+    Add(node);
+    for (Node* user : node->users()) {
+      Add(user);
+    }
+  }
+
+  FunctionBase* f_;
+  std::deque<Node*> queue_;
+  absl::flat_hash_set<Node*> queued_;
+  Node* watched_ = nullptr;
+  bool watched_deleted_ = false;
+};
+
+// Applies the first of the node-local rewrites which changes the IR, in the
+// order the individual passes appear in the simplification pipeline. Returns
+// true if the IR was modified.
+absl::StatusOr<bool> RewriteNode(Node* n, int64_t opt_level,
+                                 const QueryEngine& query_engine) {
+  XLS_ASSIGN_OR_RETURN(bool changed, ConstantFoldNode(n, query_engine));
+  if (changed) {
+    return true;
+  }
+  XLS_ASSIGN_OR_RETURN(changed, CanonicalizeNode(n));
+  if (changed) {
+    return true;
+  }
+  XLS_ASSIGN_OR_RETURN(changed, BasicSimplifyNode(n));
+  if (changed) {
+    return true;
+  }
+  return ArithSimplifyNode(opt_level, n, query_engine);
+}
+
+}  // namespace
+
+absl::StatusOr<bool> WorklistSimplificationPass::RunOnFunctionBaseInternal(
+    FunctionBase* f, const OptimizationPassOptions& options,
+    PassResults* results, OptimizationContext& context) const {
+  StatelessQueryEngine query_engine;
+  SimplificationWorklist worklist(f);
+  // Visiting operands before their users lets constants propagate forward in
+  // a single pass over the graph.
+  XLS_ASSIGN_OR_RETURN(std::vector<Node*> topo_sort_nodes, context.TopoSort(f));
+  for (Node* node : topo_sort_nodes) {
+    worklist.Add(node);
+  }
+
+  int64_t visited_count = 0;
+  int64_t removed_count = 0;
+  int64_t rewritten_count = 0;
+  for (Node* node = worklist.Pop(); node != nullptr; node = worklist.Pop()) {
+    ++visited_count;
+    if (node->IsDead()) {
+      // Dead nodes are never rewritten: the rewrites would only add more dead
+      // nodes.
+      if (IsDeletableNode(node)) {
+        for (Node* operand : node->operands()) {
+          worklist.Add(operand);
+        }
+        VLOG(3) << "Removing dead node " << node->ToString();
+        XLS_RETURN_IF_ERROR(f->RemoveNode(node));
+        ++removed_count;
+      }
+      continue;
+    }
+    worklist.Watch(node);
+    XLS_ASSIGN_OR_RETURN(bool node_changed,
+                         RewriteNode(node, options.opt_level, query_engine));
+    if (node_changed) {
+      ++rewritten_count;
+      // Most rewrites re-enqueue the node through the listener but some (e.g.
+      // in-place changes of attributes) do not.
+      if (!worklist.WatchedNodeDeleted()) {
+        worklist.Add(node);
+      }
+    }
+  }
+  worklist.Watch(nullptr);
+
+  VLOG(2) << absl::StreamFormat(
+      "Worklist simplification of %s visited %d nodes (%d initially), "
+      "rewrote %d and removed %d",
+      f->name(), visited_count, topo_sort_nodes.size(), rewritten_count,
+      removed_count);
+  if (removed_count > 0) {
+    XLS_RETURN_IF_ERROR(context.CollectGarbage(f));
+  }
+  return rewritten_count > 0 || removed_count > 0;
+}
+
+}  // namespace xls
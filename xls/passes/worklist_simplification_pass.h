@@ -0,0 +1,63 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_PASSES_WORKLIST_SIMPLIFICATION_PASS_H_
+#define XLS_PASSES_WORKLIST_SIMPLIFICATION_PASS_H_
+
+#include <string_view>
+
+#include "absl/status/statusor.h"
+#include "xls/ir/function_base.h"
+#include "xls/passes/optimization_pass.h"
+#include "xls/passes/pass_base.h"
+
+namespace xls {
+
+// Applies the node-local rewrites of DCE, constant folding, canonicalization,
+// basic simplification and arithmetic simplification to a fixed point using a
+// single worklist.
+//
+// Running those passes in a fixed-point loop re-visits every node of the
+// function on every sweep even when only a handful of nodes changed in the
+// previous one. This pass instead seeds a worklist with every node in
+// topological order and, using a ChangeListener on the function, re-enqueues
+// only the nodes a rewrite could have affected: nodes which were added, nodes
+// whose operands changed (and their users), and nodes which lost a user and so
+// may have become dead. The pass stops when no rewrite applies to any node,
+// i.e. at a fixed point of all five passes, with work proportional to the
+// number of changes rather than to the number of sweeps times the size of the
+// graph.
+//
+// The default pipeline does not use this pass. worklist_simp_pipeline.txtpb is
+// an opt-in variant of it whose standard simplification pass does.
+class WorklistSimplificationPass : public OptimizationFunctionBasePass {
+ public:
+  static constexpr std::string_view kName = "worklist_simp";
+  WorklistSimplificationPass()
+      : OptimizationFunctionBasePass(kName, "Worklist Simplifications") {}
+  ~WorklistSimplificationPass() override = default;
+
+  bool IsIdempotent() const override { return true; }
+
+  bool RunsFunctionBasesIndependently() const override { return true; }
+
+ protected:
+  absl::StatusOr<bool> RunOnFunctionBaseInternal(
+      FunctionBase* f, const OptimizationPassOptions& options,
+      PassResults* results, OptimizationContext& context) const override;
+};
+
+}  // namespace xls
+
+#endif  // XLS_PASSES_WORKLIST_SIMPLIFICATION_PASS_H_
@@ -0,0 +1,271 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/passes/worklist_simplification_pass.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "benchmark/benchmark.h"
+#include "xls/common/fuzzing/fuzztest.h"
+#include "absl/status/statusor.h"
+#include "xls/common/status/matchers.h"
+#include "xls/fuzzer/ir_fuzzer/ir_fuzz_domain.h"
+#include "xls/fuzzer/ir_fuzzer/ir_fuzz_test_library.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/benchmark_support.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_matcher.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/ir_test_base.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/passes/arith_simplification_pass.h"
+#include "xls/passes/basic_simplification_pass.h"
+#include "xls/passes/canonicalization_pass.h"
+#include "xls/passes/constant_folding_pass.h"
+#include "xls/passes/dce_pass.h"
+#include "xls/passes/optimization_pass.h"
+#include "xls/passes/pass_base.h"
+
+namespace m = ::xls::op_matchers;
+
+namespace xls {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+
+class WorklistSimplificationPassTest : public IrTestBase {
+ protected:
+  absl::StatusOr<bool> Run(Function* f) {
+    PassResults results;
+    OptimizationContext context;
+    return WorklistSimplificationPass().RunOnFunctionBase(
+        f, OptimizationPassOptions(), &results, context);
+  }
+};
+
+TEST_F(WorklistSimplificationPassTest, NoChange) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x: bits[8], y: bits[8]) -> bits[8] {
+        ret add.1: bits[8] = add(x, y)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(false));
+  EXPECT_EQ(f->node_count(), 3);
+}
+
+TEST_F(WorklistSimplificationPassTest, FoldsConstantChain) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f() -> bits[8] {
+        literal.1: bits[8] = literal(value=2)
+        literal.2: bits[8] = literal(value=3)
+        add.3: bits[8] = add(literal.1, literal.2)
+        umul.4: bits[8] = umul(add.3, literal.2)
+        ret not.5: bits[8] = not(umul.4)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_EQ(f->node_count(), 1);
+  EXPECT_THAT(f->return_value(), m::Literal(UBits(0xf0, 8)));
+}
+
+TEST_F(WorklistSimplificationPassTest, RemovesDeadCode) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x: bits[8], y: bits[8]) -> bits[8] {
+        add.1: bits[8] = add(x, y)
+        neg.2: bits[8] = neg(add.1)
+        ret sub.3: bits[8] = sub(x, y)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_EQ(f->node_count(), 3);
+  EXPECT_THAT(f->return_value(), m::Sub(m::Param("x"), m::Param("y")));
+}
+
+TEST_F(WorklistSimplificationPassTest, CanonicalizesCommutativeLiteral) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x: bits[8]) -> bits[8] {
+        literal.1: bits[8] = literal(value=3)
+        ret and.2: bits[8] = and(literal.1, x)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::And(m::Param("x"), m::Literal(3)));
+  EXPECT_EQ(f->node_count(), 3);
+}
+
+TEST_F(WorklistSimplificationPassTest, RewritesEnableFurtherRewrites) {
+  // Folding the literals exposes `x & 0`, whose simplification to zero in turn
+  // exposes `0 | y`, leaving only `y`.
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x: bits[8], y: bits[8]) -> bits[8] {
+        literal.1: bits[8] = literal(value=5)
+        literal.2: bits[8] = literal(value=5)
+        xor.3: bits[8] = xor(literal.1, literal.2)
+        and.4: bits[8] = and(x, xor.3)
+        or.5: bits[8] = or(and.4, y)
+        ret not.6: bits[8] = not(or.5)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::Not(m::Param("y")));
+  EXPECT_EQ(f->node_count(), 3);
+}
+
+TEST_F(WorklistSimplificationPassTest, DoubleNegation) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x: bits[8]) -> bits[8] {
+        not.1: bits[8] = not(x)
+        not.2: bits[8] = not(not.1)
+        not.3: bits[8] = not(not.2)
+        ret not.4: bits[8] = not(not.3)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::Param("x"));
+  EXPECT_EQ(f->node_count(), 1);
+}
+
+TEST_F(WorklistSimplificationPassTest, Idempotent) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, ParseFunction(R"(
+     fn f(x: bits[8], y: bits[8]) -> bits[8] {
+        literal.1: bits[8] = literal(value=0)
+        add.2: bits[8] = add(literal.1, x)
+        umul.3: bits[8] = umul(add.2, y)
+        ret sub.4: bits[8] = sub(umul.3, literal.1)
+     }
+  )",
+                                                       p.get()));
+  EXPECT_THAT(Run(f), IsOkAndHolds(true));
+  EXPECT_THAT(f->return_value(), m::UMul(m::Param("x"), m::Param("y")));
+  EXPECT_THAT(Run(f), IsOkAndHolds(false));
+}
+
+// Returns the passes whose node-local rewrites the worklist pass applies, run
+// to a fixed point one pass at a time.
+std::unique_ptr<OptimizationFixedPointCompoundPass> PerPassFixedPoint() {
+  auto pass = std::make_unique<OptimizationFixedPointCompoundPass>(
+      "per_pass_simp", "Per-pass simplifications");
+  pass->Add<DeadCodeEliminationPass>();
+  pass->Add<ConstantFoldingPass>();
+  pass->Add<CanonicalizationPass>();
+  pass->Add<BasicSimplificationPass>();
+  pass->Add<ArithSimplificationPass>();
+  return pass;
+}
+
+void IrFuzzWorklistSimplification(FuzzPackageWithArgs fuzz_package_with_args) {
+  WorklistSimplificationPass pass;
+  OptimizationPassChangesOutputs(std::move(fuzz_package_with_args), pass);
+}
+FUZZ_TEST(IrFuzzTest, IrFuzzWorklistSimplification)
+    .WithDomains(IrFuzzDomainWithArgs(/*arg_set_count=*/10));
+
+// The worklist pass must reach a fixed point of the individual passes and
+// compute the same results as their fixed point.
+void IrFuzzWorklistMatchesPerPassFixedPoint(
+    FuzzPackageWithArgs fuzz_package_with_args) {
+  Package* p = fuzz_package_with_args.fuzz_package.p.get();
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> per_pass_p,
+                           Parser::ParsePackage(p->DumpIr()));
+
+  PassResults results;
+  OptimizationContext context;
+  XLS_ASSERT_OK(WorklistSimplificationPass()
+                    .Run(p, OptimizationPassOptions(), &results, context)
+                    .status());
+  std::unique_ptr<OptimizationFixedPointCompoundPass> per_pass =
+      PerPassFixedPoint();
+  XLS_ASSERT_OK(per_pass
+                    ->Run(per_pass_p.get(), OptimizationPassOptions(),
+                          &results, context)
+                    .status());
+  // Running the individual passes after the worklist pass changes nothing.
+  std::string worklist_ir = p->DumpIr();
+  EXPECT_THAT(per_pass->Run(p, OptimizationPassOptions(), &results, context),
+              IsOkAndHolds(false))
+      << worklist_ir;
+
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, p->GetFunction(kFuzzTestName));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * per_pass_f,
+                           per_pass_p->GetFunction(kFuzzTestName));
+  for (const std::vector<Value>& args : fuzz_package_with_args.arg_sets) {
+    XLS_ASSERT_OK_AND_ASSIGN(Value worklist_result,
+                             DropInterpreterEvents(InterpretFunction(f, args)));
+    XLS_ASSERT_OK_AND_ASSIGN(
+        Value per_pass_result,
+        DropInterpreterEvents(InterpretFunction(per_pass_f, args)));
+    EXPECT_EQ(worklist_result, per_pass_result);
+  }
+}
+FUZZ_TEST(IrFuzzTest, IrFuzzWorklistMatchesPerPassFixedPoint)
+    .WithDomains(IrFuzzDomainWithArgs(/*arg_set_count=*/10));
+
+// Simplifies a balanced tree of adds of literals of depth `state.range(0)`,
+// which constant folds away entirely, with either the worklist pass or the
+// per-pass fixed point.
+template <bool kWorklist>
+void BM_SimplifyBalancedAddTree(benchmark::State& state) {
+  std::unique_ptr<OptimizationPass> pass;
+  if (kWorklist) {
+    pass = std::make_unique<WorklistSimplificationPass>();
+  } else {
+    pass = PerPassFixedPoint();
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    Package p("benchmark");
+    XLS_ASSERT_OK(benchmark_support::GenerateBalancedTree(
+                      &p, state.range(0), /*fan_out=*/2,
+                      benchmark_support::strategy::BinaryAdd(),
+                      benchmark_support::strategy::DistinctLiteral())
+                      .status());
+    PassResults results;
+    OptimizationContext context;
+    state.ResumeTiming();
+    XLS_ASSERT_OK(
+        pass->Run(&p, OptimizationPassOptions(), &results, context).status());
+  }
+}
+
+BENCHMARK(BM_SimplifyBalancedAddTree</*kWorklist=*/true>)
+    ->DenseRange(8, 14, 2)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SimplifyBalancedAddTree</*kWorklist=*/false>)
+    ->DenseRange(8, 14, 2)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace xls
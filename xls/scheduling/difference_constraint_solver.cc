@@ -0,0 +1,271 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/difference_constraint_solver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "ortools/math_opt/cpp/math_opt.h"
+#include "xls/common/status/status_macros.h"
+
+namespace xls {
+
+namespace math_opt = ::operations_research::math_opt;
+
+namespace {
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+// The largest magnitude of a bound (divided by the coefficients) of a
+// difference constraint; together with kMaxValue, this keeps the path lengths
+// from overflowing.
+constexpr double kMaxWeight = static_cast<double>(int64_t{1} << 31);
+
+// Path lengths beyond this are only possible on positive cycles.
+constexpr int64_t kMaxValue = int64_t{1} << 62;
+
+constexpr int64_t kUnreached = std::numeric_limits<int64_t>::min();
+
+// The linear constraint `lower ≤ Σ coefficient·variable ≤ upper`.
+struct Row {
+  math_opt::LinearConstraint constraint;
+  double lower;
+  double upper;
+  std::vector<std::pair<math_opt::Variable, double>> terms;
+};
+
+// An arc of the constraint graph, standing for the constraint
+// `value[to] ≥ value[from] + weight`.
+struct Arc {
+  int64_t to;
+  int64_t weight;
+};
+
+// Returns whether a variable with the given coefficient in `row` can satisfy
+// `row` by growing, whatever the other variables are.
+bool CanSatisfyByGrowing(double coefficient, const Row& row) {
+  return coefficient > 0.0 ? row.upper == kInfinity : row.lower == -kInfinity;
+}
+
+}  // namespace
+
+absl::StatusOr<std::optional<math_opt::VariableMap<double>>>
+SolveDifferenceConstraints(const math_opt::Model& model) {
+  std::vector<Row> rows;
+  for (math_opt::LinearConstraint constraint : model.LinearConstraints()) {
+    Row row{.constraint = constraint,
+            .lower = constraint.lower_bound(),
+            .upper = constraint.upper_bound()};
+    if (row.lower == -kInfinity && row.upper == kInfinity) {
+      // Constrains nothing, e.g. a relaxed timing constraint.
+      continue;
+    }
+    for (math_opt::Variable variable : model.RowNonzeros(constraint)) {
+      double coefficient = constraint.coefficient(variable);
+      if (coefficient != 0.0) {
+        row.terms.push_back({variable, coefficient});
+      }
+    }
+    rows.push_back(std::move(row));
+  }
+
+  absl::flat_hash_set<math_opt::Variable> absorbing;
+  for (math_opt::Variable variable : model.Variables()) {
+    if (variable.upper_bound() == kInfinity) {
+      absorbing.insert(variable);
+    }
+  }
+  for (const Row& row : rows) {
+    for (const auto& [variable, coefficient] : row.terms) {
+      if (!CanSatisfyByGrowing(coefficient, row)) {
+        absorbing.erase(variable);
+      }
+    }
+  }
+
+  // Node 0 of the constraint graph stands for the constant zero; the other
+  // nodes stand for the non-absorbing variables.
+  std::vector<math_opt::Variable> variables;
+  absl::flat_hash_map<math_opt::Variable, int64_t> node_of;
+  std::vector<std::vector<Arc>> arcs(1);
+  // Adds the constraint `value[to] - value[from] ≥ bound`.
+  auto add_lower_bound = [&](int64_t to, int64_t from,
+                             double bound) -> absl::Status {
+    if (bound == -kInfinity) {
+      return absl::OkStatus();
+    }
+    if (std::fabs(bound) > kMaxWeight || bound != std::floor(bound)) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Bound %f is not a small integer; not a difference constraint",
+          bound));
+    }
+    arcs[from].push_back(Arc{.to = to, .weight = static_cast<int64_t>(bound)});
+    return absl::OkStatus();
+  };
+  for (math_opt::Variable variable : model.Variables()) {
+    if (absorbing.contains(variable)) {
+      continue;
+    }
+    int64_t node = arcs.size();
+    node_of.emplace(variable, node);
+    variables.push_back(variable);
+    arcs.emplace_back();
+    XLS_RETURN_IF_ERROR(add_lower_bound(node, 0, variable.lower_bound()));
+    XLS_RETURN_IF_ERROR(add_lower_bound(0, node, -variable.upper_bound()));
+  }
+
+  for (const Row& row : rows) {
+    if (absl::c_any_of(row.terms, [&](const auto& term) {
+          return absorbing.contains(term.first);
+        })) {
+      continue;
+    }
+    if (row.terms.empty()) {
+      if (row.lower > 0.0 || row.upper < 0.0) {
+        return std::nullopt;
+      }
+    } else if (row.terms.size() == 1) {
+      auto [variable, coefficient] = row.terms.front();
+      int64_t node = node_of.at(variable);
+      double lower = row.lower / coefficient;
+      double upper = row.upper / coefficient;
+      if (coefficient < 0.0) {
+        std::swap(lower, upper);
+      }
+      XLS_RETURN_IF_ERROR(add_lower_bound(node, 0, lower));
+      XLS_RETURN_IF_ERROR(add_lower_bound(0, node, -upper));
+    } else if (row.terms.size() == 2 &&
+               row.terms[0].second == -row.terms[1].second) {
+      // a·(x - y) with a > 0.
+      auto [x, a] = row.terms[0];
+      math_opt::Variable y = row.terms[1].first;
+      if (a < 0.0) {
+        std::swap(x, y);
+        a = -a;
+      }
+      int64_t x_node = node_of.at(x);
+      int64_t y_node = node_of.at(y);
+      XLS_RETURN_IF_ERROR(add_lower_bound(x_node, y_node, row.lower / a));
+      XLS_RETURN_IF_ERROR(add_lower_bound(y_node, x_node, -(row.upper / a)));
+    } else {
+      return absl::UnimplementedError(
+          absl::StrFormat("Constraint %s is not a difference constraint",
+                          row.constraint.name()));
+    }
+  }
+
+  // Longest paths from the zero node, with the queue-based Bellman-Ford
+  // algorithm. A path with as many arcs as there are nodes contains a cycle,
+  // which must be positive if it lengthened the path, and so does a path of
+  // positive length back to the zero node; either way the constraints are
+  // infeasible. The variables are numbered in creation order, which for the
+  // SDC scheduler is topological, so in practice most nodes settle after a
+  // single update.
+  const int64_t node_count = arcs.size();
+  std::vector<int64_t> value(node_count, kUnreached);
+  std::vector<int64_t> arc_count(node_count, 0);
+  std::vector<bool> queued(node_count, false);
+  std::deque<int64_t> queue;
+  value[0] = 0;
+  queue.push_back(0);
+  queued[0] = true;
+  while (!queue.empty()) {
+    int64_t from = queue.front();
+    queue.pop_front();
+    queued[from] = false;
+    for (const Arc& arc : arcs[from]) {
+      int64_t candidate = value[from] + arc.weight;
+      if (value[arc.to] != kUnreached && candidate <= value[arc.to]) {
+        continue;
+      }
+      arc_count[arc.to] = arc_count[from] + 1;
+      if (arc.to == 0 || candidate > kMaxValue ||
+          arc_count[arc.to] >= node_count) {
+        return std::nullopt;
+      }
+      value[arc.to] = candidate;
+      if (!queued[arc.to]) {
+        queued[arc.to] = true;
+        queue.push_back(arc.to);
+      }
+    }
+  }
+
+  math_opt::VariableMap<double> result;
+  result.reserve(variables.size());
+  for (int64_t i = 0; i < variables.size(); ++i) {
+    int64_t variable_value = value[i + 1];
+    if (variable_value == kUnreached) {
+      return absl::UnimplementedError(absl::StrFormat(
+          "Variable %s is unbounded below", variables[i].name()));
+    }
+    result.emplace(variables[i], static_cast<double>(variable_value));
+  }
+
+  // Each absorbing variable takes the smallest value its constraints allow,
+  // provided the other variables in them all have values by now.
+  absl::flat_hash_map<math_opt::Variable, double> absorbing_value;
+  absl::flat_hash_set<math_opt::Variable> undetermined;
+  for (math_opt::Variable variable : absorbing) {
+    absorbing_value.emplace(variable, variable.lower_bound());
+  }
+  for (const Row& row : rows) {
+    for (const auto& [variable, coefficient] : row.terms) {
+      if (!absorbing.contains(variable)) {
+        continue;
+      }
+      double rest = 0.0;
+      bool determined = true;
+      for (const auto& [other, other_coefficient] : row.terms) {
+        if (other == variable) {
+          continue;
+        }
+        auto it = result.find(other);
+        if (it == result.end()) {
+          determined = false;
+          break;
+        }
+        rest += other_coefficient * it->second;
+      }
+      if (!determined) {
+        undetermined.insert(variable);
+        continue;
+      }
+      double bound = coefficient > 0.0 ? row.lower : row.upper;
+      double& variable_value = absorbing_value.at(variable);
+      variable_value = std::max(variable_value, (bound - rest) / coefficient);
+    }
+  }
+  for (const auto& [variable, variable_value] : absorbing_value) {
+    if (!undetermined.contains(variable) && variable_value != -kInfinity) {
+      result.emplace(variable, variable_value);
+    }
+  }
+  return result;
+}
+
+}  // namespace xls
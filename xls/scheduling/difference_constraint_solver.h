@@ -0,0 +1,57 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SCHEDULING_DIFFERENCE_CONSTRAINT_SOLVER_H_
+#define XLS_SCHEDULING_DIFFERENCE_CONSTRAINT_SOLVER_H_
+
+#include <optional>
+
+#include "absl/status/statusor.h"
+#include "ortools/math_opt/cpp/math_opt.h"
+
+namespace xls {
+
+// Solves the constraints of `model` without a general LP solver, provided they
+// form a system of difference constraints: every linear constraint is either a
+// bound on a single variable or of the form
+//
+//   l ≤ a·(x - y) ≤ u
+//
+// with integral l/a and u/a, and all variable bounds are integral. The
+// objective of `model` is ignored.
+//
+// Variables with no upper bound which only appear in constraints they can
+// satisfy on their own by growing (for instance the lifetime variables of the
+// SDC scheduler) are "absorbing": their constraints may involve any number of
+// variables, and are only used to give each absorbing variable the smallest
+// value they allow once the other variables are solved. An absorbing variable
+// sharing a constraint with another absorbing variable, or with no lower bound
+// at all, is left out of the result.
+//
+// The constraints are solved as longest paths in the constraint graph. The
+// result is the least solution, in which every variable takes the smallest
+// value it has in any solution, so it also minimizes any objective with
+// non-negative weights on the (non-absorbing) variables; for SDC scheduling,
+// that is everything scheduled as soon as possible and the shortest pipeline.
+//
+// Returns std::nullopt if the constraints are infeasible, and an
+// UnimplementedError if they are not of the form above or if some variable is
+// unbounded below (in which case there is no least solution).
+absl::StatusOr<
+    std::optional<operations_research::math_opt::VariableMap<double>>>
+SolveDifferenceConstraints(const operations_research::math_opt::Model& model);
+
+}  // namespace xls
+
+#endif  // XLS_SCHEDULING_DIFFERENCE_CONSTRAINT_SOLVER_H_
@@ -0,0 +1,159 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/scheduling/difference_constraint_solver.h"
+
+#include <limits>
+#include <optional>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "ortools/math_opt/cpp/math_opt.h"
+#include "xls/common/status/matchers.h"
+
+namespace xls {
+namespace {
+
+namespace math_opt = ::operations_research::math_opt;
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::testing::Eq;
+using ::testing::Optional;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+TEST(DifferenceConstraintSolverTest, LeastSolution) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  math_opt::Variable z = model.AddContinuousVariable(2.0, 100.0, "z");
+  model.AddLinearConstraint(y - x >= 3.0);
+  model.AddLinearConstraint(z - y <= 0.0);
+  model.AddLinearConstraint(2.0 * x - 2.0 * z >= -4.0);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::optional<math_opt::VariableMap<double>> solution,
+      SolveDifferenceConstraints(model));
+  ASSERT_TRUE(solution.has_value());
+  // z ≥ 2 forces x ≥ z - 2 = 0 and y ≥ max(x + 3, z) = 3.
+  EXPECT_EQ(solution->at(x), 0.0);
+  EXPECT_EQ(solution->at(y), 3.0);
+  EXPECT_EQ(solution->at(z), 2.0);
+}
+
+TEST(DifferenceConstraintSolverTest, CycleOfConstraints) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  model.AddLinearConstraint(y - x >= 2.0);
+  model.AddLinearConstraint(y - x <= 5.0);
+  model.AddLinearConstraint(x >= 4.0);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::optional<math_opt::VariableMap<double>> solution,
+      SolveDifferenceConstraints(model));
+  ASSERT_TRUE(solution.has_value());
+  EXPECT_EQ(solution->at(x), 4.0);
+  EXPECT_EQ(solution->at(y), 6.0);
+}
+
+TEST(DifferenceConstraintSolverTest, Infeasible) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  model.AddLinearConstraint(y - x >= 2.0);
+  model.AddLinearConstraint(x - y >= -1.0);
+
+  EXPECT_THAT(SolveDifferenceConstraints(model),
+              IsOkAndHolds(Eq(std::nullopt)));
+}
+
+TEST(DifferenceConstraintSolverTest, InfeasibleUpperBound) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 3.0, "y");
+  model.AddLinearConstraint(y - x >= 2.0);
+  model.AddLinearConstraint(x >= 2.0);
+
+  EXPECT_THAT(SolveDifferenceConstraints(model),
+              IsOkAndHolds(Eq(std::nullopt)));
+}
+
+TEST(DifferenceConstraintSolverTest, AbsorbingVariables) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  math_opt::Variable lifetime =
+      model.AddContinuousVariable(0.0, kInfinity, "lifetime");
+  math_opt::Variable last = model.AddContinuousVariable(0.0, kInfinity, "last");
+  math_opt::Variable a = model.AddContinuousVariable(0.0, kInfinity, "a");
+  math_opt::Variable b = model.AddContinuousVariable(0.0, kInfinity, "b");
+  model.AddLinearConstraint(y - x >= 1.0);
+  model.AddLinearConstraint(lifetime + x - y >= 0.0);
+  model.AddLinearConstraint(x - last <= 0.0);
+  model.AddLinearConstraint(y - last <= 0.0);
+  model.AddLinearConstraint(a + b - x >= 1.0);
+  model.Minimize(x + y + lifetime);
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::optional<math_opt::VariableMap<double>> solution,
+      SolveDifferenceConstraints(model));
+  ASSERT_TRUE(solution.has_value());
+  EXPECT_EQ(solution->at(x), 0.0);
+  EXPECT_EQ(solution->at(y), 1.0);
+  EXPECT_EQ(solution->at(lifetime), 1.0);
+  EXPECT_EQ(solution->at(last), 1.0);
+  EXPECT_FALSE(solution->contains(a));
+  EXPECT_FALSE(solution->contains(b));
+}
+
+TEST(DifferenceConstraintSolverTest, FreeConstraintsAreIgnored) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  math_opt::LinearConstraint c = model.AddLinearConstraint(y - x >= 1.0);
+  model.set_lower_bound(c, -kInfinity);
+
+  EXPECT_THAT(SolveDifferenceConstraints(model),
+              IsOkAndHolds(Optional(
+                  UnorderedElementsAre(Pair(x, 0.0), Pair(y, 0.0)))));
+}
+
+TEST(DifferenceConstraintSolverTest, NotDifferenceConstraints) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(0.0, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  model.AddLinearConstraint(2.0 * y - x >= 1.0);
+
+  EXPECT_THAT(SolveDifferenceConstraints(model),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST(DifferenceConstraintSolverTest, UnboundedBelow) {
+  math_opt::Model model;
+  math_opt::Variable x = model.AddContinuousVariable(-kInfinity, 100.0, "x");
+  math_opt::Variable y = model.AddContinuousVariable(0.0, 100.0, "y");
+  model.AddLinearConstraint(y - x >= 1.0);
+
+  EXPECT_THAT(SolveDifferenceConstraints(model),
+              StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+}  // namespace
+}  // namespace xls
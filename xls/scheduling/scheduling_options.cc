@@ -388,6 +388,10 @@ absl::StatusOr<SchedulingOptions> OptionsFromFlagProto(
             proto.solve_parameters()));
     scheduling_options.set_solve_parameters(std::move(solve_parameters));
   }
+  if (proto.has_use_difference_constraint_solver()) {
+    scheduling_options.use_difference_constraint_solver(
+        proto.use_difference_constraint_solver());
+  }
 
   if (proto.has_default_arc_worst_case_throughput()) {
     scheduling_options.default_arc_worst_case_throughput(
@@ -414,6 +414,7 @@ class SchedulingOptions {
         sdc_solution_tolerance_(kDefaultSdcSolutionTolerance),
         solver_type_(operations_research::math_opt::SolverType::kGlop),
         solve_parameters_(),
+        use_difference_constraint_solver_(true),
         default_arc_worst_case_throughput_(std::nullopt),
         arc_worst_case_throughput_(),
         merge_on_mutual_exclusion_(true) {}
@@ -781,6 +782,20 @@ class SchedulingOptions {
     return solve_parameters_;
   }
 
+  // Whether the SDC scheduler solves feasibility checks and pipeline-length
+  // minimization as systems of difference constraints (longest paths) rather
+  // than with the LP solver. The LP solver is still used for the register
+  // minimization objective, and whenever the model is not a system of
+  // difference constraints (e.g. with slack variables for explaining
+  // infeasibility).
+  SchedulingOptions& use_difference_constraint_solver(bool value) {
+    use_difference_constraint_solver_ = value;
+    return *this;
+  }
+  bool use_difference_constraint_solver() const {
+    return use_difference_constraint_solver_;
+  }
+
   SchedulingOptions& default_arc_worst_case_throughput(int64_t value) {
     default_arc_worst_case_throughput_ = value;
     return *this;
@@ -847,6 +862,7 @@ class SchedulingOptions {
   double sdc_solution_tolerance_;
   ::operations_research::math_opt::SolverType solver_type_;
   ::operations_research::math_opt::SolveParameters solve_parameters_;
+  bool use_difference_constraint_solver_;
   std::optional<int64_t> default_arc_worst_case_throughput_;
   absl::flat_hash_map<std::pair<std::string, std::string>, int64_t>
       arc_worst_case_throughput_;
@@ -50,6 +50,7 @@
 #include "xls/ir/op.h"
 #include "xls/ir/state_element.h"
 #include "xls/ir/type.h"
+#include "xls/scheduling/difference_constraint_solver.h"
 #include "xls/scheduling/schedule_bounds.h"
 #include "xls/scheduling/schedule_graph.h"
 #include "xls/scheduling/schedule_util.h"
@@ -902,11 +903,15 @@ absl::Status SDCSchedulingModel::ScheduleDeadAfterSynthesisNodes(
 }
 
 void SDCSchedulingModel::SetClockPeriod(int64_t clock_period_ps) {
-  absl::flat_hash_map<Node*, std::vector<Node*>> prev_delay_constraints =
-      std::move(delay_constraints_);
-  delay_constraints_ = ComputeCombinationalDelayConstraints(
-      graph_, clock_period_ps, distances_to_node_, delay_map_);
+  if (clock_period_ps_ == clock_period_ps) {
+    return;
+  }
+  clock_period_ps_ = clock_period_ps;
+  absl::flat_hash_map<Node*, std::vector<Node*>> delay_constraints =
+      ComputeCombinationalDelayConstraints(graph_, clock_period_ps,
+                                           distances_to_node_, delay_map_);
 
+  absl::flat_hash_set<std::pair<Node*, Node*>> required;
   for (const ScheduleNode& schedule_node : graph_.nodes()) {
     Node* source = schedule_node.node;
     if (IsUntimed(source)) {
@@ -915,28 +920,13 @@ void SDCSchedulingModel::SetClockPeriod(int64_t clock_period_ps) {
     if (schedule_node.is_dead_after_synthesis) {
       continue;
     }
-    if (!prev_delay_constraints.empty()) {
-      // Check over all the prior constraints, dropping any that are obsolete.
-      absl::flat_hash_set<Node*> new_targets(
-          delay_constraints_.at(source).begin(),
-          delay_constraints_.at(source).end());
-      for (Node* target : prev_delay_constraints.at(source)) {
-        if (new_targets.contains(target)) {
-          continue;
-        }
-
-        // No longer related; remove constraint.
-        auto it = timing_constraint_.find(std::make_pair(source, target));
-        model_.DeleteLinearConstraint(it->second);
-        timing_constraint_.erase(it);
-      }
-    }
-
-    // Add all new constraints, avoiding duplicates for any that already
-    // exist.
-    for (Node* target : delay_constraints_.at(source)) {
+    for (Node* target : delay_constraints.at(source)) {
       auto key = std::make_pair(source, target);
-      if (timing_constraint_.contains(key)) {
+      required.insert(key);
+      auto it = timing_constraint_.find(key);
+      if (it != timing_constraint_.end()) {
+        // Previously relaxed (or already enforced); enforce it.
+        model_.set_lower_bound(it->second, 1.0);
         continue;
       }
 
@@ -948,6 +938,15 @@ void SDCSchedulingModel::SetClockPeriod(int64_t clock_period_ps) {
           key, DiffAtLeastConstraint(target, source, 1, "timing"));
     }
   }
+
+  // Relax, rather than delete, the constraints which are not required at this
+  // clock period: the model keeps its structure and the incremental solver can
+  // start from the basis of the previous solve.
+  for (auto& [key, constraint] : timing_constraint_) {
+    if (!required.contains(key)) {
+      model_.set_lower_bound(constraint, -kInfinity);
+    }
+  }
 }
 
 absl::Status SDCSchedulingModel::SetWorstCaseThroughput(
@@ -1309,6 +1308,8 @@ absl::StatusOr<std::unique_ptr<SDCScheduler>> SDCScheduler::Create(
       options.solve_parameters(), std::nullopt, std::move(delay_map),
       options.arc_worst_case_throughput(),
       options.default_arc_worst_case_throughput()));
+  scheduler->SetUseDifferenceConstraintSolver(
+      options.use_difference_constraint_solver());
   XLS_RETURN_IF_ERROR(scheduler->Initialize());
   return std::move(scheduler);
 }
@@ -1375,6 +1376,28 @@ absl::Status SDCScheduler::BuildError(
                    math_opt::EnumToString(result.termination.reason)));
 }
 
+absl::StatusOr<std::optional<math_opt::VariableMap<double>>>
+SDCScheduler::SolveLeastSchedule(SchedulingFailureBehavior failure_behavior) {
+  if (!use_difference_constraint_solver_) {
+    return std::nullopt;
+  }
+  absl::StatusOr<std::optional<math_opt::VariableMap<double>>> least =
+      SolveDifferenceConstraints(model_.UnderlyingModel());
+  if (absl::IsUnimplemented(least.status())) {
+    VLOG(3) << "Falling back to the LP solver: " << least.status();
+    return std::nullopt;
+  }
+  XLS_RETURN_IF_ERROR(least.status());
+  if (!least->has_value() && !failure_behavior.explain_infeasibility) {
+    return absl::InternalError(
+        absl::StrCat("The problem does not have an optimal solution; solver "
+                     "terminated with ",
+                     math_opt::EnumToString(
+                         math_opt::TerminationReason::kInfeasible)));
+  }
+  return *std::move(least);
+}
+
 absl::StatusOr<ScheduleCycleMap> SDCScheduler::Schedule(
     std::optional<int64_t> pipeline_stages, int64_t clock_period_ps,
     SchedulingFailureBehavior failure_behavior,
@@ -1400,7 +1423,21 @@ absl::StatusOr<ScheduleCycleMap> SDCScheduler::Schedule(
   }
 
   model_.SetPipelineLength(pipeline_stages);
-  if (!pipeline_stages.has_value() && !check_feasibility_) {
+
+  // The least solution of the constraints is a feasible schedule with the
+  // shortest pipeline, so these cases don't need the LP solver at all.
+  std::optional<math_opt::VariableMap<double>> least;
+  if (check_feasibility_ || !pipeline_stages.has_value()) {
+    XLS_ASSIGN_OR_RETURN(least, SolveLeastSchedule(failure_behavior));
+  }
+  if (least.has_value()) {
+    if (check_feasibility_) {
+      return model_.ExtractResult(*least);
+    }
+    XLS_ASSIGN_OR_RETURN(const int64_t min_pipeline_length,
+                         model_.ExtractPipelineLength(*least));
+    model_.SetPipelineLength(min_pipeline_length);
+  } else if (!pipeline_stages.has_value() && !check_feasibility_) {
     // Find the minimum feasible pipeline length.
     model_.MinimizePipelineLength();
     XLS_ASSIGN_OR_RETURN(
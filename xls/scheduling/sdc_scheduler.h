@@ -212,8 +212,8 @@ class SDCSchedulingModel {
   // data-dependence graph.
   operations_research::math_opt::Variable cycle_at_sinknode_;
 
-  // A cache of the delay constraints.
-  absl::flat_hash_map<Node*, std::vector<Node*>> delay_constraints_;
+  // The clock period the timing constraints are currently set up for.
+  std::optional<int64_t> clock_period_ps_;
 
   absl::flat_hash_map<std::pair<Node*, Node*>,
                       operations_research::math_opt::LinearConstraint>
@@ -227,7 +227,9 @@ class SDCSchedulingModel {
       io_constraints_;
 
   // A map from Node* pairs (a, b) to the LinearConstraint (if present)
-  // guaranteeing that a is in a stage strictly before b.
+  // guaranteeing that a is in a stage strictly before b. Constraints which are
+  // not required at the current clock period are kept with no lower bound, so
+  // moving between clock periods only changes constraint bounds.
   absl::flat_hash_map<std::pair<Node*, Node*>,
                       operations_research::math_opt::LinearConstraint>
       timing_constraint_;
@@ -300,6 +302,17 @@ class SDCScheduler final : public Scheduler {
   }
   bool check_feasibility() const { return check_feasibility_; }
 
+  // If set to true then feasibility checks and pipeline length minimization
+  // are solved as longest paths in the constraint graph, falling back to the
+  // LP solver only when the model is not a system of difference constraints.
+  // Defaults to true.
+  void SetUseDifferenceConstraintSolver(bool use_difference_constraint_solver) {
+    use_difference_constraint_solver_ = use_difference_constraint_solver;
+  }
+  bool use_difference_constraint_solver() const {
+    return use_difference_constraint_solver_;
+  }
+
  private:
   SDCScheduler(
       const ScheduleGraph& graph, double sdc_solution_tolerance,
@@ -318,6 +331,15 @@ class SDCScheduler final : public Scheduler {
       const operations_research::math_opt::SolveResult& result,
       SchedulingFailureBehavior failure_behavior);
 
+  // Solves the current model with SolveDifferenceConstraints, returning its
+  // least solution. Returns std::nullopt if the LP solver should be used
+  // instead: if the difference-constraint solver is disabled or does not
+  // support the model, or if the model is infeasible and `failure_behavior`
+  // asks for an explanation.
+  absl::StatusOr<std::optional<
+      operations_research::math_opt::VariableMap<double>>>
+  SolveLeastSchedule(SchedulingFailureBehavior failure_behavior);
+
   DelayMap delay_map_;
   ::operations_research::math_opt::SolverType solver_type_;
   ::operations_research::math_opt::SolveParameters solve_parameters_;
@@ -325,6 +347,7 @@ class SDCScheduler final : public Scheduler {
   std::unique_ptr<operations_research::math_opt::IncrementalSolver> solver_;
   std::optional<double> dynamic_throughput_objective_weight_;
   bool check_feasibility_ = false;
+  bool use_difference_constraint_solver_ = true;
 };
 
 }  // namespace xls
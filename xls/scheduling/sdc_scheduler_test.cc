@@ -14,21 +14,28 @@
 
 #include "xls/scheduling/sdc_scheduler.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <utility>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/status/statusor.h"
+#include "benchmark/benchmark.h"
 #include "xls/common/status/matchers.h"
 #include "xls/estimators/delay_model/delay_estimator.h"
+#include "xls/ir/benchmark_support.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/channel.h"
 #include "xls/ir/channel_ops.h"
+#include "xls/ir/function.h"
 #include "xls/ir/function_builder.h"
 #include "xls/ir/ir_test_base.h"
+#include "xls/ir/node.h"
 #include "xls/ir/value.h"
 #include "xls/scheduling/schedule_graph.h"
 #include "xls/scheduling/scheduling_options.h"
@@ -46,6 +53,14 @@ class TestDelayEstimator : public DelayEstimator {
 
 class SDCSchedulerTest : public IrTestBase {};
 
+int64_t PipelineLength(const ScheduleCycleMap& cycle_map) {
+  int64_t last_cycle = 0;
+  for (const auto& [node, cycle] : cycle_map) {
+    last_cycle = std::max(last_cycle, cycle);
+  }
+  return last_cycle + 1;
+}
+
 TEST_F(SDCSchedulerTest, SimpleFunction) {
   auto p = CreatePackage();
   FunctionBuilder fb(TestName(), p.get());
@@ -201,5 +216,139 @@ TEST_F(SDCSchedulerTest, DecoupledThroughputConstraintsEnforced) {
       2);
 }
 
+TEST_F(SDCSchedulerTest, RescheduleWithDifferentClockPeriods) {
+  auto p = CreatePackage();
+  FunctionBuilder fb(TestName(), p.get());
+  auto x = fb.Param("x", p->GetBitsType(32));
+  auto neg = fb.Negate(fb.Negate(fb.Negate(fb.Negate(x))));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * f, fb.Build());
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ScheduleGraph graph,
+      ScheduleGraph::Create(f, /*dead_after_synthesis=*/{}));
+  TestDelayEstimator delay_estimator;
+  SchedulingOptions options;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto scheduler, SDCScheduler::Create(graph, delay_estimator, options));
+
+  // Moving back and forth between clock periods (as the clock period search
+  // does) must give the same schedules as scheduling from scratch.
+  for (auto [clock_period_ps, last_cycle] :
+       {std::pair{1, 4}, {5, 0}, {2, 2}, {1, 4}, {3, 1}}) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        ScheduleCycleMap cycle_map,
+        scheduler->Schedule(/*pipeline_stages=*/std::nullopt, clock_period_ps,
+                            SchedulingFailureBehavior{}));
+    EXPECT_EQ(cycle_map.at(x.node()), 0);
+    EXPECT_EQ(cycle_map.at(neg.node()), last_cycle)
+        << "clock period: " << clock_period_ps;
+  }
+
+  // Infeasible probes leave the model usable.
+  EXPECT_THAT(scheduler->Schedule(
+                  /*pipeline_stages=*/2, /*clock_period_ps=*/2,
+                  SchedulingFailureBehavior{.explain_infeasibility = false}),
+              absl_testing::StatusIs(absl::StatusCode::kInternal));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ScheduleCycleMap cycle_map,
+      scheduler->Schedule(
+          /*pipeline_stages=*/2, /*clock_period_ps=*/3,
+          SchedulingFailureBehavior{.explain_infeasibility = false}));
+  EXPECT_EQ(cycle_map.at(neg.node()), 1);
+}
+
+TEST_F(SDCSchedulerTest, DifferenceConstraintSolverMatchesLp) {
+  auto p = CreatePackage();
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f, benchmark_support::GenerateFullyConnectedLayerGraph(
+                        p.get(), /*depth=*/6, /*width=*/3,
+                        benchmark_support::strategy::BinaryAdd(),
+                        benchmark_support::strategy::DistinctLiteral()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ScheduleGraph graph,
+      ScheduleGraph::Create(f, /*dead_after_synthesis=*/{}));
+  TestDelayEstimator delay_estimator;
+  SchedulingOptions options;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto native, SDCScheduler::Create(graph, delay_estimator, options));
+  options.use_difference_constraint_solver(false);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto lp, SDCScheduler::Create(graph, delay_estimator, options));
+
+  for (int64_t clock_period_ps : {1, 2, 3, 7}) {
+    for (bool check_feasibility : {false, true}) {
+      native->SetCheckFeasibility(check_feasibility);
+      lp->SetCheckFeasibility(check_feasibility);
+      XLS_ASSERT_OK_AND_ASSIGN(
+          ScheduleCycleMap native_cycle_map,
+          native->Schedule(/*pipeline_stages=*/std::nullopt, clock_period_ps,
+                           SchedulingFailureBehavior{}));
+      XLS_ASSERT_OK_AND_ASSIGN(
+          ScheduleCycleMap lp_cycle_map,
+          lp->Schedule(/*pipeline_stages=*/std::nullopt, clock_period_ps,
+                       SchedulingFailureBehavior{}));
+      if (!check_feasibility) {
+        EXPECT_EQ(PipelineLength(native_cycle_map),
+                  PipelineLength(lp_cycle_map))
+            << "clock period: " << clock_period_ps;
+      }
+      for (Node* node : f->nodes()) {
+        for (Node* operand : node->operands()) {
+          EXPECT_LE(native_cycle_map.at(operand), native_cycle_map.at(node));
+        }
+      }
+    }
+  }
+
+  // A pipeline length shorter than the minimum is rejected the same way.
+  native->SetCheckFeasibility(true);
+  EXPECT_THAT(native->Schedule(
+                  /*pipeline_stages=*/1, /*clock_period_ps=*/1,
+                  SchedulingFailureBehavior{.explain_infeasibility = false}),
+              absl_testing::StatusIs(absl::StatusCode::kInternal));
+}
+
+// Schedules a dense graph of depth `state.range(0)`; `state.range(1)` selects
+// the solver, 0 for the LP solver alone and 1 for the difference-constraint
+// solver.
+void RunSDCScheduleBenchmark(benchmark::State& state, bool check_feasibility) {
+  std::unique_ptr<VerifiedPackage> p =
+      std::make_unique<VerifiedPackage>("dense_graph_pkg");
+  XLS_ASSERT_OK_AND_ASSIGN(
+      Function * f, benchmark_support::GenerateFullyConnectedLayerGraph(
+                        p.get(), /*depth=*/state.range(0), /*width=*/4,
+                        benchmark_support::strategy::BinaryAdd(),
+                        benchmark_support::strategy::DistinctLiteral()));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      ScheduleGraph graph,
+      ScheduleGraph::Create(f, /*dead_after_synthesis=*/{}));
+  TestDelayEstimator delay_estimator;
+  SchedulingOptions options;
+  options.use_difference_constraint_solver(state.range(1) != 0);
+  XLS_ASSERT_OK_AND_ASSIGN(
+      auto scheduler, SDCScheduler::Create(graph, delay_estimator, options));
+  scheduler->SetCheckFeasibility(check_feasibility);
+  for (auto _ : state) {
+    XLS_ASSERT_OK_AND_ASSIGN(
+        ScheduleCycleMap cycle_map,
+        scheduler->Schedule(/*pipeline_stages=*/std::nullopt,
+                            /*clock_period_ps=*/3,
+                            SchedulingFailureBehavior{}));
+    benchmark::DoNotOptimize(cycle_map);
+  }
+}
+
+void BM_SDCFeasibility(benchmark::State& state) {
+  RunSDCScheduleBenchmark(state, /*check_feasibility=*/true);
+}
+
+void BM_SDCMinimizeRegisters(benchmark::State& state) {
+  RunSDCScheduleBenchmark(state, /*check_feasibility=*/false);
+}
+
+BENCHMARK(BM_SDCFeasibility)->ArgsProduct({{8, 64, 512}, {0, 1}});
+BENCHMARK(BM_SDCMinimizeRegisters)->ArgsProduct({{8, 64, 512}, {0, 1}});
+
 }  // namespace
 }  // namespace xls
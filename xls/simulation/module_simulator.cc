@@ -15,7 +15,10 @@
 #include "xls/simulation/module_simulator.h"
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,15 +31,18 @@
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/log/vlog_is_on.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/module_signature.pb.h"
 #include "xls/common/status/ret_check.h"
 #include "xls/common/status/status_macros.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/value.h"
 #include "xls/ir/value_flattening.h"
@@ -44,6 +50,7 @@
 #include "xls/simulation/module_testbench.h"
 #include "xls/simulation/module_testbench_thread.h"
 #include "xls/simulation/testbench_signal_capture.h"
+#include "xls/simulation/testbench_stream.h"
 #include "xls/tools/eval_utils.h"
 
 namespace xls {
@@ -382,6 +389,26 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
                            verilog_text_, file_type_, signature_, simulator_,
                            /*reset_dut=*/true, includes_));
 
+  // For simulators which cache compiled models the testbench reads the input
+  // values from streams rather than having them written into its text, so the
+  // model depends only on the design and the number of inputs. The batch is
+  // padded to a power of two with copies of its last input to bound the number
+  // of distinct testbenches; the outputs of the padding are discarded.
+  bool stream_inputs = simulator_->CachesCompiledModels();
+  const int64_t input_count =
+      stream_inputs ? static_cast<int64_t>(std::bit_ceil(inputs.size()))
+                    : static_cast<int64_t>(inputs.size());
+  absl::flat_hash_map<std::string, const TestbenchStream*> input_streams;
+  if (stream_inputs) {
+    for (const PortProto& input : signature_.data_inputs()) {
+      if (input.width() > 0) {
+        XLS_ASSIGN_OR_RETURN(
+            input_streams[input.name()],
+            tb->CreateInputStream(input.name(), input.width()));
+      }
+    }
+  }
+
   // Drive any control signals to an unasserted state so the all control inputs
   // are non-X when the device comes out of reset.
   std::vector<DutInput> dut_inputs = DeassertControlSignals();
@@ -396,14 +423,21 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
   // Drive data inputs. Values are flattened before using.
   auto drive_data = [&](int64_t index) {
     for (const PortProto& input : signature_.data_inputs()) {
-      seq_block.Set(input.name(), inputs[index].at(input.name()));
+      if (input_streams.contains(input.name())) {
+        seq_block.ReadFromStreamAndSet(input.name(),
+                                       input_streams.at(input.name()));
+      } else {
+        seq_block.Set(input.name(),
+                      inputs[std::min<int64_t>(index, inputs.size() - 1)].at(
+                          input.name()));
+      }
     }
   };
 
   // Lambda which captures outputs into a map. Use std::unique_ptr for pointer
   // stability necessary for ModuleTestbench::Capture().
   using OutputMap = absl::flat_hash_map<std::string, std::unique_ptr<Bits>>;
-  std::vector<OutputMap> stable_outputs(inputs.size());
+  std::vector<OutputMap> stable_outputs(input_count);
   auto capture_outputs = [&](int64_t index, EndOfCycleEvent& event) {
     OutputMap& outputs = stable_outputs[index];
     for (const PortProto& output : signature_.data_outputs()) {
@@ -413,7 +447,7 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
   };
 
   if (signature_.proto().has_fixed_latency()) {
-    for (int64_t i = 0; i < inputs.size(); ++i) {
+    for (int64_t i = 0; i < input_count; ++i) {
       drive_data(i);
       // Fixed latency interface: just wait for compute to complete.
       seq_block.AdvanceNCycles(signature_.proto().fixed_latency().latency());
@@ -452,7 +486,7 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
         }
       }
     };
-    while (cycle < inputs.size()) {
+    while (cycle < input_count) {
       drive_data(cycle);
       if (pipeline_control.has_value() && pipeline_control->has_valid()) {
         seq_block.Set(pipeline_control->valid().input_name(), 1);
@@ -485,7 +519,7 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
     if (cycle < latency) {
       seq_block.AdvanceNCycles(latency - cycle);
     }
-    while (captured_outputs < inputs.size()) {
+    while (captured_outputs < input_count) {
       EndOfCycleEvent& event = seq_block.AtEndOfCycle();
       maybe_expect_output_valid(/*expect_x=*/false, /*expected_value=*/true,
                                 event);
@@ -498,7 +532,7 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
     maybe_expect_output_valid(/*expect_x=*/false, /*expected_value=*/false,
                               event);
   } else if (signature_.proto().has_combinational()) {
-    for (int64_t i = 0; i < inputs.size(); ++i) {
+    for (int64_t i = 0; i < input_count; ++i) {
       drive_data(i);
       capture_outputs(i, seq_block.AtEndOfCycle());
     }
@@ -507,7 +541,29 @@ ModuleSimulator::RunBatched(absl::Span<const BitsMap> inputs) const {
         "Unsupported interface: ", signature_.proto().interface_oneof_case()));
   }
 
-  XLS_RETURN_IF_ERROR(tb->Run());
+  if (stream_inputs) {
+    // Each stream produces the batch (padded as above) in order.
+    absl::flat_hash_map<std::string, std::function<std::optional<Bits>()>>
+        producer_functions;
+    for (const auto& [name, _] : input_streams) {
+      producer_functions[name] = [&inputs, input_count, name = name,
+                                  index = int64_t{0}]() mutable
+          -> std::optional<Bits> {
+        if (index == input_count) {
+          return std::nullopt;
+        }
+        const BitsMap& input =
+            inputs[std::min<int64_t>(index++, inputs.size() - 1)];
+        return input.at(name);
+      };
+    }
+    absl::flat_hash_map<std::string, TestbenchStreamThread::Producer>
+        producers(producer_functions.begin(), producer_functions.end());
+    XLS_RETURN_IF_ERROR(
+        tb->RunWithStreamingIo(producers, /*output_consumers=*/{}));
+  } else {
+    XLS_RETURN_IF_ERROR(tb->Run());
+  }
 
   // Transfer outputs to an ArgumentSet for return.
   std::vector<BitsMap> outputs(inputs.size());
@@ -561,6 +617,210 @@ absl::StatusOr<std::vector<Value>> ModuleSimulator::RunBatched(
   return outputs;
 }
 
+absl::StatusOr<std::unique_ptr<ModuleSimulationSession>>
+ModuleSimulator::StartSession() const {
+  if (!signature_.proto().has_clock_name() &&
+      !signature_.proto().has_combinational()) {
+    return absl::InvalidArgumentError("Expected clock in signature");
+  }
+  if (signature_.data_inputs().empty() || signature_.data_outputs().empty()) {
+    return absl::InvalidArgumentError(
+        "Simulation sessions require at least one data input and output");
+  }
+
+  XLS_ASSIGN_OR_RETURN(
+      std::unique_ptr<ModuleTestbench> tb,
+      ModuleTestbench::CreateFromVerilogText(
+          verilog_text_, file_type_, signature_, simulator_,
+          /*reset_dut=*/true, includes_,
+          /*simulation_cycle_limit=*/std::nullopt));
+
+  std::vector<DutInput> dut_inputs = DeassertControlSignals();
+  absl::flat_hash_map<std::string, const TestbenchStream*> input_streams;
+  for (const PortProto& input : signature_.data_inputs()) {
+    dut_inputs.push_back(DutInput{input.name(), IsX()});
+    XLS_ASSIGN_OR_RETURN(input_streams[input.name()],
+                         tb->CreateInputStream(input.name(), input.width()));
+  }
+  absl::flat_hash_map<std::string, const TestbenchStream*> output_streams;
+  for (const PortProto& output : signature_.data_outputs()) {
+    XLS_ASSIGN_OR_RETURN(output_streams[output.name()],
+                         tb->CreateOutputStream(output.name(), output.width()));
+  }
+
+  XLS_ASSIGN_OR_RETURN(ModuleTestbenchThread * tbt,
+                       tb->CreateThread("input driver", dut_inputs));
+  SequentialBlock& seq_block = tbt->MainBlock();
+
+  int64_t latency = 0;
+  bool hold_inputs = false;
+  if (signature_.proto().has_fixed_latency()) {
+    latency = signature_.proto().fixed_latency().latency();
+    // The input data cannot be changed in the same cycle that the output is
+    // being read so hold for one more cycle while output is read.
+    hold_inputs = true;
+  } else if (signature_.proto().has_pipeline()) {
+    latency = signature_.proto().pipeline().latency();
+    if (signature_.proto().pipeline().has_pipeline_control()) {
+      const PipelineControl& pipeline_control =
+          signature_.proto().pipeline().pipeline_control();
+      if (pipeline_control.has_manual()) {
+        seq_block.Set(pipeline_control.manual().input_name(),
+                      Bits::AllOnes(latency));
+      }
+      if (pipeline_control.has_valid()) {
+        seq_block.Set(pipeline_control.valid().input_name(), 1);
+      }
+    }
+  } else if (!signature_.proto().has_combinational()) {
+    return absl::UnimplementedError(absl::StrCat(
+        "Unsupported interface: ", signature_.proto().interface_oneof_case()));
+  }
+
+  // Evaluate one input vector per iteration. The loop ends when the input
+  // streams are closed.
+  SequentialBlock& loop = seq_block.RepeatForever();
+  for (const PortProto& input : signature_.data_inputs()) {
+    loop.ReadFromStreamAndSet(input.name(), input_streams.at(input.name()));
+  }
+  if (latency > 0) {
+    loop.AdvanceNCycles(latency);
+  }
+  EndOfCycleEvent& event = loop.AtEndOfCycle();
+  for (const PortProto& output : signature_.data_outputs()) {
+    event.CaptureAndWriteToStream(output.name(),
+                                  output_streams.at(output.name()));
+  }
+  if (hold_inputs) {
+    loop.NextCycle();
+  }
+
+  auto session = absl::WrapUnique(
+      new ModuleSimulationSession(signature_, std::move(tb)));
+  session->Start();
+  return session;
+}
+
+ModuleSimulationSession::~ModuleSimulationSession() {
+  absl::Status status = Finish();
+  if (!status.ok()) {
+    VLOG(1) << "Simulation session ended with error: " << status;
+  }
+}
+
+void ModuleSimulationSession::Start() {
+  {
+    absl::MutexLock lock(&mutex_);
+    for (const PortProto& input : signature_.data_inputs()) {
+      pending_inputs_[input.name()];
+    }
+    for (const PortProto& output : signature_.data_outputs()) {
+      outputs_[output.name()];
+    }
+  }
+  for (const PortProto& input : signature_.data_inputs()) {
+    producers_[input.name()] = [this,
+                                name = input.name()]() -> std::optional<Bits> {
+      absl::MutexLock lock(&mutex_);
+      std::deque<Bits>& queue = pending_inputs_.at(name);
+      auto available = [&]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+        return closed_ || !queue.empty();
+      };
+      mutex_.Await(absl::Condition(&available));
+      if (queue.empty()) {
+        return std::nullopt;
+      }
+      Bits value = std::move(queue.front());
+      queue.pop_front();
+      return value;
+    };
+  }
+  for (const PortProto& output : signature_.data_outputs()) {
+    consumers_[output.name()] = [this, name = output.name()](
+                                    const Bits& value) -> absl::Status {
+      absl::MutexLock lock(&mutex_);
+      outputs_.at(name).push_back(value);
+      return absl::OkStatus();
+    };
+  }
+  simulation_thread_ = std::make_unique<Thread>([this]() {
+    absl::flat_hash_map<std::string, TestbenchStreamThread::Producer> producers(
+        producers_.begin(), producers_.end());
+    absl::flat_hash_map<std::string, TestbenchStreamThread::Consumer> consumers(
+        consumers_.begin(), consumers_.end());
+    absl::Status status = testbench_->RunWithStreamingIo(producers, consumers);
+    absl::MutexLock lock(&mutex_);
+    simulation_status_ = status;
+  });
+}
+
+absl::StatusOr<std::vector<ModuleSimulationSession::BitsMap>>
+ModuleSimulationSession::RunBatched(absl::Span<const BitsMap> inputs) {
+  for (const BitsMap& input : inputs) {
+    XLS_RETURN_IF_ERROR(signature_.ValidateInputs(input));
+  }
+  absl::MutexLock lock(&mutex_);
+  if (closed_ || simulation_status_.has_value()) {
+    return absl::FailedPreconditionError("Simulation session has ended");
+  }
+  for (const BitsMap& input : inputs) {
+    for (const PortProto& port : signature_.data_inputs()) {
+      pending_inputs_.at(port.name()).push_back(input.at(port.name()));
+    }
+  }
+  auto done = [&]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    if (simulation_status_.has_value()) {
+      return true;
+    }
+    for (const auto& [_, values] : outputs_) {
+      if (values.size() < inputs.size()) {
+        return false;
+      }
+    }
+    return true;
+  };
+  mutex_.Await(absl::Condition(&done));
+  if (simulation_status_.has_value()) {
+    // Outputs written before the simulation ended may still be complete.
+    for (const auto& [_, values] : outputs_) {
+      if (values.size() < inputs.size()) {
+        XLS_RETURN_IF_ERROR(*simulation_status_);
+        return absl::InternalError(
+            "Simulation ended before producing all outputs");
+      }
+    }
+  }
+
+  std::vector<BitsMap> outputs(inputs.size());
+  for (auto& [name, values] : outputs_) {
+    for (int64_t i = 0; i < inputs.size(); ++i) {
+      outputs[i][name] = std::move(values.front());
+      values.pop_front();
+    }
+  }
+  return outputs;
+}
+
+absl::StatusOr<ModuleSimulationSession::BitsMap>
+ModuleSimulationSession::RunFunction(const BitsMap& inputs) {
+  XLS_ASSIGN_OR_RETURN(std::vector<BitsMap> outputs, RunBatched({inputs}));
+  XLS_RET_CHECK_EQ(outputs.size(), 1);
+  return std::move(outputs[0]);
+}
+
+absl::Status ModuleSimulationSession::Finish() {
+  {
+    absl::MutexLock lock(&mutex_);
+    closed_ = true;
+  }
+  if (simulation_thread_ != nullptr) {
+    simulation_thread_->Join();
+    simulation_thread_.reset();
+  }
+  absl::MutexLock lock(&mutex_);
+  return simulation_status_.value_or(absl::OkStatus());
+}
+
 absl::StatusOr<std::string> ModuleSimulator::GenerateProcTestbenchVerilog(
     const absl::flat_hash_map<std::string, std::vector<Bits>>& channel_inputs,
     const absl::flat_hash_map<std::string, int64_t>& output_channel_counts,
@@ -16,17 +16,23 @@
 #define XLS_SIMULATION_MODULE_SIMULATOR_H_
 
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xls/codegen/module_signature.h"
 #include "xls/codegen/vast/vast.h"
+#include "xls/common/thread.h"
 #include "xls/ir/bits.h"
 #include "xls/ir/value.h"
 #include "xls/simulation/module_testbench.h"
@@ -76,6 +82,8 @@ struct ReadyValidHoldoffs {
   absl::flat_hash_map<std::string, std::vector<int64_t>> ready_holdoffs;
 };
 
+class ModuleSimulationSession;
+
 // Abstraction for simulating a module described by a SignatureProto using a
 // testbench run under the Verilog simulator.
 class ModuleSimulator {
@@ -107,10 +115,19 @@ class ModuleSimulator {
 
   // Runs the given batch of argument values through the module with a single
   // invocation of the Verilog simulator. Generally, this is much faster than
-  // running via separate calls to Run.
+  // running via separate calls to Run. If the simulator caches compiled models
+  // the testbench reads the inputs from streams so that batches of similar
+  // size reuse one model.
   absl::StatusOr<std::vector<BitsMap>> RunBatched(
       absl::Span<const BitsMap> inputs) const;
 
+  // Starts a long-lived simulation of the module which evaluates inputs on
+  // demand; see ModuleSimulationSession. Use this rather than RunBatched when
+  // inputs arrive in many small batches. Supports the same interfaces as
+  // RunBatched. The session must not outlive this ModuleSimulator's simulator.
+  absl::StatusOr<std::unique_ptr<ModuleSimulationSession>> StartSession()
+      const;
+
   // Overloads which accept Values rather than Bits.
   absl::StatusOr<Value> RunFunction(
       const absl::flat_hash_map<std::string, Value>& inputs) const;
@@ -166,6 +183,66 @@ class ModuleSimulator {
   absl::Span<const VerilogInclude> includes_;
 };
 
+// A running simulation of a module with a function-like interface which
+// evaluates inputs as they are submitted. The testbench is generated and the
+// simulator is started once. The testbench loops forever reading each input
+// vector from named pipes (see TestbenchStream) and writing the outputs back,
+// so many small RunBatched calls share one simulator invocation instead of
+// each paying for simulator start-up and compilation. Inputs are evaluated
+// one at a time, so a pipelined module is not kept full.
+//
+// Created by ModuleSimulator::StartSession. A session is not thread-safe.
+// Destroying the session ends the simulation.
+class ModuleSimulationSession {
+ public:
+  using BitsMap = ModuleSimulator::BitsMap;
+
+  ~ModuleSimulationSession();
+
+  // Evaluates the given inputs in the running simulation and returns the
+  // outputs by port name. Returns an error if the simulation has ended.
+  absl::StatusOr<std::vector<BitsMap>> RunBatched(
+      absl::Span<const BitsMap> inputs);
+  absl::StatusOr<BitsMap> RunFunction(const BitsMap& inputs);
+
+  // Ends the simulation and returns the status of the simulator run. After
+  // this is called RunBatched returns an error.
+  absl::Status Finish();
+
+ private:
+  friend class ModuleSimulator;
+
+  ModuleSimulationSession(const ModuleSignature& signature,
+                          std::unique_ptr<ModuleTestbench> testbench)
+      : signature_(signature), testbench_(std::move(testbench)) {}
+
+  // Starts the thread running the simulator.
+  void Start();
+
+  ModuleSignature signature_;
+  std::unique_ptr<ModuleTestbench> testbench_;
+
+  absl::Mutex mutex_;
+  // Input values waiting to be read by the testbench and output values written
+  // by the testbench, indexed by data port name.
+  absl::flat_hash_map<std::string, std::deque<Bits>> pending_inputs_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, std::deque<Bits>> outputs_
+      ABSL_GUARDED_BY(mutex_);
+  // Whether Finish has been called, closing the input streams.
+  bool closed_ ABSL_GUARDED_BY(mutex_) = false;
+  // The result of the simulator run once it has ended.
+  std::optional<absl::Status> simulation_status_ ABSL_GUARDED_BY(mutex_);
+
+  // The producers and consumers of the testbench streams. These must outlive
+  // the simulation thread which refers to them.
+  absl::flat_hash_map<std::string, std::function<std::optional<Bits>()>>
+      producers_;
+  absl::flat_hash_map<std::string, std::function<absl::Status(const Bits&)>>
+      consumers_;
+  std::unique_ptr<Thread> simulation_thread_;
+};
+
 }  // namespace verilog
 }  // namespace xls
 
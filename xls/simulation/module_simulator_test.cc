@@ -15,6 +15,7 @@
 #include "xls/simulation/module_simulator.h"
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -367,6 +368,46 @@ TEST_P(ModuleSimulatorTest, CombinationalBatched) {
   EXPECT_THAT(outputs[2], ElementsAre(Pair("out", UBits(100, 8))));
 }
 
+TEST_P(ModuleSimulatorTest, FixedLatencySession) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeFixedLatencyModule());
+  ModuleSimulator simulator =
+      NewModuleSimulator(verilog_signature.first, verilog_signature.second);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ModuleSimulationSession> session,
+                           simulator.StartSession());
+
+  using BitsMap = ModuleSimulator::BitsMap;
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::vector<BitsMap> outputs,
+      session->RunBatched(
+          {BitsMap{{"x", UBits(44, 8)}}, BitsMap{{"x", UBits(123, 8)}}}));
+  EXPECT_EQ(outputs.size(), 2);
+  EXPECT_THAT(outputs[0], ElementsAre(Pair("out", UBits(88, 8))));
+  EXPECT_THAT(outputs[1], ElementsAre(Pair("out", UBits(246, 8))));
+
+  // Later calls are served by the same simulator invocation.
+  EXPECT_THAT(session->RunFunction(BitsMap{{"x", UBits(7, 8)}}),
+              IsOkAndHolds(ElementsAre(Pair("out", UBits(14, 8)))));
+  XLS_EXPECT_OK(session->Finish());
+  EXPECT_THAT(session->RunFunction(BitsMap{{"x", UBits(7, 8)}}),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_P(ModuleSimulatorTest, CombinationalSession) {
+  XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeCombinationalModule());
+  ModuleSimulator simulator =
+      NewModuleSimulator(verilog_signature.first, verilog_signature.second);
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ModuleSimulationSession> session,
+                           simulator.StartSession());
+
+  using BitsMap = ModuleSimulator::BitsMap;
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_THAT(
+        session->RunFunction(
+            BitsMap{{"x", UBits(i + 3, 8)}, {"y", UBits(3, 8)}}),
+        IsOkAndHolds(ElementsAre(Pair("out", UBits(i, 8)))));
+  }
+}
+
 TEST_P(ModuleSimulatorTest, ReadyValidBatched) {
   XLS_ASSERT_OK_AND_ASSIGN(auto verilog_signature, MakeReadyValidModule());
   ModuleSimulator simulator =
@@ -739,7 +739,7 @@ absl::Status ModuleTestbench::RunWithStreamingIo(
   XLS_VLOG_LINES(3, verilog_text);
 
   XLS_ASSIGN_OR_RETURN(TempDirectory temp_dir, TempDirectory::Create());
-  std::vector<VerilogSimulator::MacroDefinition> macro_definitions;
+  std::vector<VerilogSimulator::PlusArg> plusargs;
 
   std::vector<TestbenchStreamThread> stream_threads;
   stream_threads.reserve(streams_.size());
@@ -753,15 +753,15 @@ absl::Status ModuleTestbench::RunWithStreamingIo(
     } else {
       stream_threads.back().RunOutputStream(output_consumers.at(stream->name));
     }
-    macro_definitions.push_back(VerilogSimulator::MacroDefinition{
-        stream->path_macro_name,
-        absl::StrFormat("\"%s\"", stream_path.string())});
+    plusargs.push_back(VerilogSimulator::PlusArg{stream->path_plusarg_name,
+                                                 stream_path.string()});
   }
   VLOG(1) << "Starting simulation.";
   std::pair<std::string, std::string> stdout_stderr;
   XLS_ASSIGN_OR_RETURN(
       stdout_stderr,
-      simulator_->Run(verilog_text, file_type_, macro_definitions, includes_));
+      simulator_->Run(verilog_text, file_type_, /*macro_definitions=*/{},
+                      includes_, plusargs));
 
   VLOG(1) << "Simulation done.";
 
@@ -776,7 +776,7 @@ absl::Status ModuleTestbench::RunWithStreamingIo(
   return CaptureOutputsAndCheckExpectations(stdout_str);
 }
 
-static std::string GetPipePathMacroName(std::string_view stream_name) {
+static std::string GetPipePathPlusargName(std::string_view stream_name) {
   return absl::StrFormat("__%s_PIPE_PATH", absl::AsciiStrToUpper(stream_name));
 }
 
@@ -790,7 +790,7 @@ absl::StatusOr<const TestbenchStream*> ModuleTestbench::CreateInputStream(
   streams_.push_back(absl::WrapUnique(
       new TestbenchStream{.name = std::string{name},
                           .direction = TestbenchStreamDirection::kInput,
-                          .path_macro_name = GetPipePathMacroName(name),
+                          .path_plusarg_name = GetPipePathPlusargName(name),
                           .width = width}));
   return streams_.back().get();
 }
@@ -805,7 +805,7 @@ absl::StatusOr<const TestbenchStream*> ModuleTestbench::CreateOutputStream(
   streams_.push_back(absl::WrapUnique(
       new TestbenchStream{.name = std::string{name},
                           .direction = TestbenchStreamDirection::kOutput,
-                          .path_macro_name = GetPipePathMacroName(name),
+                          .path_plusarg_name = GetPipePathPlusargName(name),
                           .width = width}));
   return streams_.back().get();
 }
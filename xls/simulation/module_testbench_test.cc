@@ -1024,15 +1024,8 @@ TEST_P(ModuleTestbenchTest, StreamingIo) {
   }
 
   XLS_ASSERT_OK_AND_ASSIGN(std::string generated, tb->GenerateVerilog());
-  ExpectVerilogEqualToGoldenFile(
-      GoldenFilePath(kTestName, kTestdataPath), generated,
-      /*macro_definitions=*/
-      {
-          VerilogSimulator::MacroDefinition{input_stream->path_macro_name,
-                                            "\"/tmp/my_input\""},
-          VerilogSimulator::MacroDefinition{output_stream->path_macro_name,
-                                            "\"/tmp/my_output\""},
-      });
+  ExpectVerilogEqualToGoldenFile(GoldenFilePath(kTestName, kTestdataPath),
+                                 generated);
 
   XLS_ASSERT_OK(tb->RunWithStreamingIo(
       {{input_stream->name, SequentialProducer(kWidth, kInputCount)}},
@@ -98,7 +98,8 @@ class IcarusVerilogSimulator : public VerilogSimulator {
   absl::StatusOr<std::pair<std::string, std::string>> Run(
       std::string_view text, FileType file_type,
       absl::Span<const MacroDefinition> macro_definitions,
-      absl::Span<const VerilogInclude> includes) const override {
+      absl::Span<const VerilogInclude> includes,
+      absl::Span<const PlusArg> plusargs) const override {
     if (file_type == FileType::kSystemVerilog) {
       return absl::UnimplementedError(
           "iverilog does not support SystemVerilog");
@@ -118,7 +119,12 @@ class IcarusVerilogSimulator : public VerilogSimulator {
     AppendMacroDefinitionsToArgs(macro_definitions, args);
     XLS_RETURN_IF_ERROR(InvokeIverilog(args).status());
 
-    return InvokeVvp({temp_out.path().string()});
+    std::vector<std::string> vvp_args = {temp_out.path().string()};
+    for (const PlusArg& plusarg : plusargs) {
+      vvp_args.push_back(
+          absl::StrFormat("+%s=%s", plusarg.name, plusarg.value));
+    }
+    return InvokeVvp(vvp_args);
   }
 
   absl::Status RunSyntaxChecking(
@@ -0,0 +1,359 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A VerilogSimulator which compiles the Verilog (design and testbench) into a
+// C++ model with Verilator and runs the resulting binary. Compilation is by far
+// the most expensive step, so compiled models are cached on disk keyed by a
+// digest of everything which affects compilation. Run-time inputs (the paths
+// of stream pipes) are passed as plusargs, and ModuleSimulator streams the
+// stimulus of batched runs to simulators which cache models, so repeated
+// simulations of a design only pay for the simulation itself.
+
+#include "xls/simulation/simulators/verilator_simulator.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/flags/flag.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "openssl/sha.h"
+#include "xls/codegen/vast/vast.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/module_initializer.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/subprocess.h"
+#include "xls/simulation/verilog_include.h"
+#include "xls/simulation/verilog_simulator.h"
+
+ABSL_FLAG(std::string, verilator_path, "verilator",
+          "Path of the verilator binary used by the `verilator` Verilog "
+          "simulator. Requires Verilator 5 or newer.");
+ABSL_FLAG(int64_t, verilator_threads, 1,
+          "Number of threads of the models built by the `verilator` Verilog "
+          "simulator. Values above one only pay off for large designs.");
+ABSL_FLAG(std::string, verilator_cache_dir, "",
+          "Directory in which the `verilator` Verilog simulator caches "
+          "compiled models. If empty a directory under the system temporary "
+          "directory is used.");
+ABSL_FLAG(int64_t, verilator_cache_max_models, 64,
+          "Maximum number of compiled models kept in the cache of the "
+          "`verilator` Verilog simulator. The least recently used models are "
+          "removed beyond this.");
+
+namespace xls {
+namespace verilog {
+namespace {
+
+// Name of the simulation binary within a cached model directory.
+constexpr std::string_view kModelBinaryName = "sim";
+
+// Name of the directory within the cache directory in which models are built.
+constexpr std::string_view kBuildDirName = "build";
+
+// Age after which a directory in the build directory is considered to be left
+// behind by a crashed build.
+constexpr std::chrono::hours kStaleBuildAge(24);
+
+std::filesystem::path GetCacheDir() {
+  std::string cache_dir = absl::GetFlag(FLAGS_verilator_cache_dir);
+  if (!cache_dir.empty()) {
+    return std::filesystem::absolute(cache_dir);
+  }
+  return std::filesystem::temp_directory_path() / "xls_verilator_cache";
+}
+
+std::vector<std::string> VerilatorArgs(
+    FileType file_type,
+    absl::Span<const VerilogSimulator::MacroDefinition> macro_definitions,
+    const std::filesystem::path& source_dir) {
+  std::vector<std::string> args = {
+      absl::GetFlag(FLAGS_verilator_path),
+      "--assert",
+      "--quiet-exit",
+      "-Wno-fatal",
+      "-Wno-lint",
+      "-Wno-style",
+      absl::StrCat("-I", source_dir.string()),
+      absl::StrFormat("-D%s", VerilogSimulator::kSimulationMacroName),
+      absl::StrFormat("-D%s", VerilogSimulator::kAssertOnMacroName),
+  };
+  if (file_type == FileType::kVerilog) {
+    args.push_back("--default-language");
+    args.push_back("1364-2005");
+  }
+  for (const VerilogSimulator::MacroDefinition& macro : macro_definitions) {
+    if (macro.value.has_value()) {
+      args.push_back(absl::StrFormat("-D%s=%s", macro.name, *macro.value));
+    } else {
+      args.push_back(absl::StrFormat("-D%s", macro.name));
+    }
+  }
+  return args;
+}
+
+// Returns the arguments which build a model from sources written into the
+// `src` subdirectory of the build directory. The arguments only use relative
+// paths so they are the same for every build of the model.
+std::vector<std::string> ModelBuildArgs(
+    FileType file_type,
+    absl::Span<const VerilogSimulator::MacroDefinition> macro_definitions,
+    const std::filesystem::path& top_name) {
+  std::vector<std::string> args =
+      VerilatorArgs(file_type, macro_definitions, "src");
+  args.push_back("--binary");
+  args.push_back("-j");
+  args.push_back("0");
+  int64_t threads = absl::GetFlag(FLAGS_verilator_threads);
+  if (threads > 1) {
+    args.push_back("--threads");
+    args.push_back(absl::StrCat(threads));
+  }
+  args.push_back("-o");
+  args.push_back(std::string{kModelBinaryName});
+  args.push_back((std::filesystem::path("src") / top_name).string());
+  return args;
+}
+
+std::filesystem::path TopFileName(FileType file_type) {
+  return file_type == FileType::kSystemVerilog ? "top.sv" : "top.v";
+}
+
+// Writes the top file and includes into `dir`, returning the path of the top
+// file.
+absl::StatusOr<std::filesystem::path> WriteSources(
+    const std::filesystem::path& dir, const std::filesystem::path& top_name,
+    std::string_view text, absl::Span<const VerilogInclude> includes) {
+  for (const VerilogInclude& include : includes) {
+    std::filesystem::path path = dir / include.relative_path;
+    XLS_RETURN_IF_ERROR(RecursivelyCreateDir(path.parent_path()));
+    XLS_RETURN_IF_ERROR(SetFileContents(path, include.verilog_text));
+  }
+  std::filesystem::path top_path = dir / top_name;
+  XLS_RETURN_IF_ERROR(SetFileContents(top_path, text));
+  return top_path;
+}
+
+// Removes the least recently used models beyond --verilator_cache_max_models
+// and any build directories left behind by crashed builds. Errors are ignored
+// as other processes may be using or pruning the cache concurrently.
+void PruneCache(const std::filesystem::path& cache_dir) {
+  std::error_code ec;
+  std::vector<std::pair<std::filesystem::file_time_type,
+                        std::filesystem::path>>
+      models;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(cache_dir, ec)) {
+    if (entry.path().filename() == kBuildDirName) {
+      continue;
+    }
+    std::filesystem::file_time_type time = entry.last_write_time(ec);
+    if (!ec) {
+      models.push_back({time, entry.path()});
+    }
+  }
+  int64_t max_models =
+      std::max<int64_t>(absl::GetFlag(FLAGS_verilator_cache_max_models), 1);
+  if (models.size() > max_models) {
+    std::sort(models.begin(), models.end(),
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (int64_t i = max_models; i < models.size(); ++i) {
+      VLOG(1) << "Removing cached Verilator model " << models[i].second;
+      std::filesystem::remove_all(models[i].second, ec);
+    }
+  }
+
+  std::filesystem::file_time_type stale_before =
+      std::filesystem::file_time_type::clock::now() - kStaleBuildAge;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(cache_dir / kBuildDirName, ec)) {
+    std::filesystem::file_time_type time = entry.last_write_time(ec);
+    if (!ec && time < stale_before) {
+      std::filesystem::remove_all(entry.path(), ec);
+    }
+  }
+}
+
+class VerilatorSimulator : public VerilogSimulator {
+ public:
+  absl::StatusOr<std::pair<std::string, std::string>> Run(
+      std::string_view text, FileType file_type,
+      absl::Span<const MacroDefinition> macro_definitions,
+      absl::Span<const VerilogInclude> includes,
+      absl::Span<const PlusArg> plusargs) const override {
+    XLS_ASSIGN_OR_RETURN(
+        std::filesystem::path model,
+        GetOrBuildModel(text, file_type, macro_definitions, includes));
+    std::vector<std::string> args = {model.string()};
+    for (const PlusArg& plusarg : plusargs) {
+      args.push_back(absl::StrFormat("+%s=%s", plusarg.name, plusarg.value));
+    }
+    return SubprocessResultToStrings(
+        SubprocessErrorAsStatus(InvokeSubprocess(args)));
+  }
+
+  absl::Status RunSyntaxChecking(
+      std::string_view text, FileType file_type,
+      absl::Span<const MacroDefinition> macro_definitions,
+      absl::Span<const VerilogInclude> includes) const override {
+    XLS_ASSIGN_OR_RETURN(TempDirectory temp_dir, TempDirectory::Create());
+    XLS_ASSIGN_OR_RETURN(
+        std::filesystem::path top_path,
+        WriteSources(temp_dir.path(), TopFileName(file_type), text, includes));
+    std::vector<std::string> args =
+        VerilatorArgs(file_type, macro_definitions, temp_dir.path());
+    args.push_back("--lint-only");
+    args.push_back("--timing");
+    args.push_back(top_path.string());
+    return SubprocessErrorAsStatus(InvokeSubprocess(args)).status();
+  }
+
+  bool DoesSupportSystemVerilog() const override { return true; }
+  bool DoesSupportAssertions() const override { return true; }
+  bool CachesCompiledModels() const override { return true; }
+
+ private:
+  // Returns the output of `verilator --version` for the configured binary.
+  absl::StatusOr<std::string> GetVerilatorVersion() const {
+    std::string path = absl::GetFlag(FLAGS_verilator_path);
+    absl::MutexLock lock(&mutex_);
+    if (!version_.has_value() || version_->first != path) {
+      XLS_ASSIGN_OR_RETURN(
+          SubprocessResult result,
+          SubprocessErrorAsStatus(InvokeSubprocess({path, "--version"})));
+      version_ = {path, result.stdout_content};
+    }
+    return version_->second;
+  }
+
+  // Returns the path of the simulation binary for the given sources, compiling
+  // it if no cached model exists. Concurrent builds of the same model (from
+  // other threads or processes) are benign: each builds in a private directory
+  // which is then renamed into place, and the loser discards its copy.
+  absl::StatusOr<std::filesystem::path> GetOrBuildModel(
+      std::string_view text, FileType file_type,
+      absl::Span<const MacroDefinition> macro_definitions,
+      absl::Span<const VerilogInclude> includes) const {
+    XLS_ASSIGN_OR_RETURN(std::string version, GetVerilatorVersion());
+    std::filesystem::path cache_dir = GetCacheDir();
+    std::filesystem::path model_dir =
+        cache_dir / VerilatorModelKey(text, file_type, macro_definitions,
+                                      includes, version);
+    std::filesystem::path model_binary = model_dir / kModelBinaryName;
+    if (std::filesystem::exists(model_binary)) {
+      VLOG(1) << "Using cached Verilator model " << model_dir;
+      // Mark the model as recently used so pruning keeps it.
+      std::error_code ec;
+      std::filesystem::last_write_time(
+          model_dir, std::filesystem::file_time_type::clock::now(), ec);
+      return model_binary;
+    }
+
+    // Build inside the cache directory so the final rename stays within one
+    // file system.
+    std::filesystem::path top_name = TopFileName(file_type);
+    XLS_RETURN_IF_ERROR(RecursivelyCreateDir(cache_dir / kBuildDirName));
+    XLS_ASSIGN_OR_RETURN(
+        TempDirectory build_dir,
+        TempDirectory::Create((cache_dir / kBuildDirName).string()));
+    XLS_RETURN_IF_ERROR(
+        WriteSources(build_dir.path() / "src", top_name, text, includes)
+            .status());
+    std::vector<std::string> args =
+        ModelBuildArgs(file_type, macro_definitions, top_name);
+    args.push_back("--Mdir");
+    args.push_back(".");
+    VLOG(1) << "Building Verilator model " << model_dir;
+    XLS_RETURN_IF_ERROR(
+        SubprocessErrorAsStatus(InvokeSubprocess(args, build_dir.path()))
+            .status());
+
+    // If the rename fails another build won the race and ours is discarded
+    // when `build_dir` goes out of scope.
+    std::error_code ec;
+    std::filesystem::rename(build_dir.path(), model_dir, ec);
+    if (!ec) {
+      std::move(build_dir).Release();
+      std::filesystem::last_write_time(
+          model_dir, std::filesystem::file_time_type::clock::now(), ec);
+      PruneCache(cache_dir);
+    } else if (!std::filesystem::exists(model_binary)) {
+      return absl::InternalError(
+          absl::StrFormat("Unable to move Verilator model into %s: %s",
+                          model_dir, ec.message()));
+    }
+    return model_binary;
+  }
+
+  mutable absl::Mutex mutex_;
+  // The Verilator binary path and its version output.
+  mutable std::optional<std::pair<std::string, std::string>> version_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+XLS_REGISTER_MODULE_INITIALIZER(verilator_simulator, {
+  CHECK_OK(GetVerilogSimulatorManagerSingleton().RegisterVerilogSimulator(
+      "verilator", []() -> absl::StatusOr<std::unique_ptr<VerilogSimulator>> {
+        return std::make_unique<VerilatorSimulator>();
+      }));
+});
+
+}  // namespace
+
+std::string VerilatorModelKey(
+    std::string_view text, FileType file_type,
+    absl::Span<const VerilogSimulator::MacroDefinition> macro_definitions,
+    absl::Span<const VerilogInclude> includes,
+    std::string_view verilator_version) {
+  std::string key;
+  auto append = [&](std::string_view s) {
+    absl::StrAppend(&key, s.size(), ":", s);
+  };
+  append(verilator_version);
+  for (const std::string& arg : ModelBuildArgs(file_type, macro_definitions,
+                                               TopFileName(file_type))) {
+    append(arg);
+  }
+  append(text);
+  for (const VerilogInclude& include : includes) {
+    append(include.relative_path.string());
+    append(include.verilog_text);
+  }
+  std::array<char, SHA256_DIGEST_LENGTH> digest;
+  SHA256(reinterpret_cast<const uint8_t*>(key.data()), key.size(),
+         reinterpret_cast<uint8_t*>(digest.data()));
+  return absl::BytesToHexString({digest.data(), digest.size()});
+}
+
+}  // namespace verilog
+}  // namespace xls
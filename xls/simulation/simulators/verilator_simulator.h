@@ -0,0 +1,42 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_SIMULATION_SIMULATORS_VERILATOR_SIMULATOR_H_
+#define XLS_SIMULATION_SIMULATORS_VERILATOR_SIMULATOR_H_
+
+#include <string>
+#include <string_view>
+
+#include "absl/types/span.h"
+#include "xls/codegen/vast/vast.h"
+#include "xls/simulation/verilog_include.h"
+#include "xls/simulation/verilog_simulator.h"
+
+namespace xls {
+namespace verilog {
+
+// Returns the key under which the `verilator` simulator caches the model
+// compiled from the given Verilog: a digest of the sources, the compile flags
+// and the Verilator version. Run-time inputs such as plusargs (e.g., the paths
+// of stream pipes) are not part of the key. Exposed for testing.
+std::string VerilatorModelKey(
+    std::string_view text, FileType file_type,
+    absl::Span<const VerilogSimulator::MacroDefinition> macro_definitions,
+    absl::Span<const VerilogInclude> includes,
+    std::string_view verilator_version);
+
+}  // namespace verilog
+}  // namespace xls
+
+#endif  // XLS_SIMULATION_SIMULATORS_VERILATOR_SIMULATOR_H_
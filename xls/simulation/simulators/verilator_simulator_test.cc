@@ -0,0 +1,278 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/simulation/simulators/verilator_simulator.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/reflection.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/types/span.h"
+#include "xls/codegen/module_signature.h"
+#include "xls/codegen/vast/vast.h"
+#include "xls/common/file/named_pipe.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/common/status/ret_check.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/common/subprocess.h"
+#include "xls/ir/bits.h"
+#include "xls/simulation/module_simulator.h"
+#include "xls/simulation/verilog_include.h"
+#include "xls/simulation/verilog_simulator.h"
+#include "re2/re2.h"
+
+ABSL_DECLARE_FLAG(std::string, verilator_path);
+ABSL_DECLARE_FLAG(std::string, verilator_cache_dir);
+ABSL_DECLARE_FLAG(int64_t, verilator_cache_max_models);
+
+namespace xls {
+namespace verilog {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+using ::testing::SizeIs;
+
+using BitsMap = ModuleSimulator::BitsMap;
+
+constexpr std::string_view kIdentityText = R"(
+module identity(
+  input wire clk,
+  input wire [7:0] x,
+  output wire [7:0] out
+);
+  assign out = x;
+endmodule
+)";
+
+absl::StatusOr<ModuleSignature> IdentitySignature() {
+  ModuleSignatureBuilder b("identity");
+  b.WithCombinationalInterface();
+  b.AddDataInputAsBits("x", 8);
+  b.AddDataOutputAsBits("out", 8);
+  return b.Build();
+}
+
+// A VerilogSimulator which records the Verilator model key and the plusargs of
+// each run, and simulates the `identity` module: the value captured from `out`
+// in each cycle is the value read from the stream of `x` in that cycle.
+class KeyRecordingSimulator : public VerilogSimulator {
+ public:
+  absl::StatusOr<std::pair<std::string, std::string>> Run(
+      std::string_view text, FileType file_type,
+      absl::Span<const MacroDefinition> macro_definitions,
+      absl::Span<const VerilogInclude> includes,
+      absl::Span<const PlusArg> plusargs) const override {
+    keys_.push_back(VerilatorModelKey(text, file_type, macro_definitions,
+                                      includes, "verilator-version"));
+    absl::flat_hash_map<std::string, std::string>& paths =
+        plusargs_.emplace_back();
+    for (const PlusArg& plusarg : plusargs) {
+      paths[plusarg.name] = plusarg.value;
+    }
+    XLS_RET_CHECK(paths.contains("__X_PIPE_PATH"));
+
+    XLS_ASSIGN_OR_RETURN(FileLineReader reader,
+                         FileLineReader::Create(paths.at("__X_PIPE_PATH")));
+    std::vector<std::string> values;
+    while (true) {
+      XLS_ASSIGN_OR_RETURN(std::optional<std::string> line, reader.ReadLine());
+      if (!line.has_value()) {
+        break;
+      }
+      values.push_back(*std::move(line));
+    }
+    // The testbench displays each captured value of `out` along with the id
+    // of the capture, in cycle order.
+    std::string stdout_str;
+    std::string_view piece(text);
+    std::string instance;
+    int64_t cycle = 0;
+    while (RE2::FindAndConsume(&piece, R"(OUTPUT out = 8'h%0x \(#(\d+)\))",
+                               &instance)) {
+      XLS_RET_CHECK_LT(cycle, values.size());
+      absl::StrAppend(&stdout_str, "  ", cycle, " OUTPUT out = 8'h",
+                      values[cycle], " (#", instance, ")\n");
+      ++cycle;
+    }
+    XLS_RET_CHECK_EQ(cycle, values.size());
+    return std::make_pair(stdout_str, std::string());
+  }
+
+  absl::Status RunSyntaxChecking(
+      std::string_view text, FileType file_type,
+      absl::Span<const MacroDefinition> macro_definitions,
+      absl::Span<const VerilogInclude> includes) const override {
+    return absl::OkStatus();
+  }
+
+  bool DoesSupportSystemVerilog() const override { return true; }
+  bool DoesSupportAssertions() const override { return true; }
+  bool CachesCompiledModels() const override { return true; }
+
+  const std::vector<std::string>& keys() const { return keys_; }
+  const std::vector<absl::flat_hash_map<std::string, std::string>>& plusargs()
+      const {
+    return plusargs_;
+  }
+
+ private:
+  mutable std::vector<std::string> keys_;
+  mutable std::vector<absl::flat_hash_map<std::string, std::string>> plusargs_;
+};
+
+TEST(VerilatorSimulatorTest, ModelKeyIgnoresStimulusAndPipePaths) {
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, IdentitySignature());
+  KeyRecordingSimulator simulator;
+  ModuleSimulator module_simulator(signature, kIdentityText,
+                                   FileType::kSystemVerilog, &simulator);
+
+  EXPECT_THAT(module_simulator.RunBatched({BitsMap{{"x", UBits(1, 8)}},
+                                           BitsMap{{"x", UBits(2, 8)}},
+                                           BitsMap{{"x", UBits(3, 8)}}}),
+              IsOkAndHolds(ElementsAre(ElementsAre(Pair("out", UBits(1, 8))),
+                                       ElementsAre(Pair("out", UBits(2, 8))),
+                                       ElementsAre(Pair("out", UBits(3, 8))))));
+  EXPECT_THAT(
+      module_simulator.RunBatched(
+          {BitsMap{{"x", UBits(42, 8)}}, BitsMap{{"x", UBits(7, 8)}},
+           BitsMap{{"x", UBits(9, 8)}}, BitsMap{{"x", UBits(10, 8)}}}),
+      IsOkAndHolds(ElementsAre(ElementsAre(Pair("out", UBits(42, 8))),
+                               ElementsAre(Pair("out", UBits(7, 8))),
+                               ElementsAre(Pair("out", UBits(9, 8))),
+                               ElementsAre(Pair("out", UBits(10, 8))))));
+
+  // Each run streamed its inputs through its own pipe, and both batches are
+  // padded to the same size, so both runs share one model.
+  ASSERT_THAT(simulator.keys(), SizeIs(2));
+  EXPECT_EQ(simulator.keys()[0], simulator.keys()[1]);
+  ASSERT_THAT(simulator.plusargs(), SizeIs(2));
+  EXPECT_NE(simulator.plusargs()[0].at("__X_PIPE_PATH"),
+            simulator.plusargs()[1].at("__X_PIPE_PATH"));
+}
+
+TEST(VerilatorSimulatorTest, ModelKeyCoversDesignFlagsAndVersion) {
+  std::string key = VerilatorModelKey(kIdentityText, FileType::kSystemVerilog,
+                                      /*macro_definitions=*/{},
+                                      /*includes=*/{}, "v5.020");
+  EXPECT_EQ(key, VerilatorModelKey(kIdentityText, FileType::kSystemVerilog,
+                                   /*macro_definitions=*/{},
+                                   /*includes=*/{}, "v5.020"));
+  std::string inverter_text =
+      absl::StrReplaceAll(kIdentityText, {{"out = x", "out = ~x"}});
+  EXPECT_NE(key, VerilatorModelKey(inverter_text, FileType::kSystemVerilog,
+                                   /*macro_definitions=*/{},
+                                   /*includes=*/{}, "v5.020"));
+  EXPECT_NE(key, VerilatorModelKey(kIdentityText, FileType::kVerilog,
+                                   /*macro_definitions=*/{},
+                                   /*includes=*/{}, "v5.020"));
+  EXPECT_NE(key, VerilatorModelKey(
+                     kIdentityText, FileType::kSystemVerilog,
+                     {VerilogSimulator::MacroDefinition{"FOO", std::nullopt}},
+                     /*includes=*/{}, "v5.020"));
+  EXPECT_NE(key, VerilatorModelKey(kIdentityText, FileType::kSystemVerilog,
+                                   /*macro_definitions=*/{},
+                                   /*includes=*/{}, "v5.030"));
+}
+
+// Tests which run Verilator itself. They are skipped if --verilator_path does
+// not name a working Verilator binary.
+class VerilatorSimulatorRunTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!SubprocessErrorAsStatus(
+             InvokeSubprocess({absl::GetFlag(FLAGS_verilator_path),
+                               "--version"}))
+             .ok()) {
+      GTEST_SKIP() << "Verilator is not available";
+    }
+    XLS_ASSERT_OK_AND_ASSIGN(cache_dir_, TempDirectory::Create());
+    absl::SetFlag(&FLAGS_verilator_cache_dir, cache_dir_->path().string());
+    XLS_ASSERT_OK_AND_ASSIGN(simulator_,
+                             GetVerilogSimulatorManagerSingleton()
+                                 .GetVerilogSimulator("verilator"));
+  }
+
+  // Returns the number of models in the cache directory.
+  int64_t CachedModelCount() const {
+    int64_t count = 0;
+    for (const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator(cache_dir_->path())) {
+      if (entry.path().filename() != "build") {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  absl::FlagSaver flag_saver_;
+  std::optional<TempDirectory> cache_dir_;
+  std::unique_ptr<VerilogSimulator> simulator_;
+};
+
+TEST_F(VerilatorSimulatorRunTest, BatchesWithDifferentStimulusShareModel) {
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, IdentitySignature());
+  ModuleSimulator module_simulator(signature, kIdentityText,
+                                   FileType::kSystemVerilog, simulator_.get());
+
+  EXPECT_THAT(module_simulator.RunBatched({BitsMap{{"x", UBits(1, 8)}},
+                                           BitsMap{{"x", UBits(2, 8)}}}),
+              IsOkAndHolds(ElementsAre(ElementsAre(Pair("out", UBits(1, 8))),
+                                       ElementsAre(Pair("out", UBits(2, 8))))));
+  EXPECT_EQ(CachedModelCount(), 1);
+  EXPECT_THAT(module_simulator.RunBatched({BitsMap{{"x", UBits(42, 8)}},
+                                           BitsMap{{"x", UBits(7, 8)}}}),
+              IsOkAndHolds(ElementsAre(ElementsAre(Pair("out", UBits(42, 8))),
+                                       ElementsAre(Pair("out", UBits(7, 8))))));
+  EXPECT_EQ(CachedModelCount(), 1);
+}
+
+TEST_F(VerilatorSimulatorRunTest, CacheIsBounded) {
+  absl::SetFlag(&FLAGS_verilator_cache_max_models, 1);
+  XLS_ASSERT_OK_AND_ASSIGN(ModuleSignature signature, IdentitySignature());
+  std::string inverter_text =
+      absl::StrReplaceAll(kIdentityText, {{"out = x", "out = ~x"}});
+  ModuleSimulator identity(signature, kIdentityText, FileType::kSystemVerilog,
+                           simulator_.get());
+  ModuleSimulator inverter(signature, inverter_text, FileType::kSystemVerilog,
+                           simulator_.get());
+
+  EXPECT_THAT(identity.RunFunction(BitsMap{{"x", UBits(3, 8)}}),
+              IsOkAndHolds(ElementsAre(Pair("out", UBits(3, 8)))));
+  EXPECT_THAT(inverter.RunFunction(BitsMap{{"x", UBits(3, 8)}}),
+              IsOkAndHolds(ElementsAre(Pair("out", UBits(0xfc, 8)))));
+  EXPECT_EQ(CachedModelCount(), 1);
+}
+
+}  // namespace
+}  // namespace verilog
+}  // namespace xls
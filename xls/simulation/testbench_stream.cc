@@ -61,26 +61,53 @@ namespace verilog {
       m->AddReg(absl::StrFormat("__%s_error_str", stream.name),
                 m->file()->BitVectorType(kStringSize * 8, SourceInfo()),
                 SourceInfo()));
+  constexpr int64_t kPathSize = 1024;
+  XLS_ASSIGN_OR_RETURN(
+      emitter.path_,
+      m->AddReg(absl::StrFormat("__%s_path", stream.name),
+                m->file()->BitVectorType(kPathSize * 8, SourceInfo()),
+                SourceInfo()));
   return emitter;
 }
 
 void VastStreamEmitter::EmitOpen(StatementBlock* block) const {
   // Emit code:
   //
-  //   fd = $fopen(`__PIPE_NAME, "<mode>");
+  //   if (!$value$plusargs("<PLUSARG_NAME>=%s", path)) begin
+  //      $display("FAILED: ...);
+  //      $finish;
+  //   end
+  //   fd = $fopen(path, "<mode>");
   //   if (fd == 0) begin
   //      errno = $ferror(fd, error_string);
   //      $display("FAILED: ...);
   //      $finish;
   //   end
-  SystemFunctionCall* fopen_call = block->file()->Make<SystemFunctionCall>(
-      SourceInfo(), "fopen",
+  SystemFunctionCall* plusargs_call = block->file()->Make<SystemFunctionCall>(
+      SourceInfo(), "value$plusargs",
       std::vector<Expression*>{
-          block->file()->Make<MacroRef>(SourceInfo(), stream_.path_macro_name),
           block->file()->Make<QuotedString>(
               SourceInfo(),
-              stream_.direction == TestbenchStreamDirection::kInput ? "r"
-                                                                    : "w")});
+              absl::StrFormat("%s=%%s", stream_.path_plusarg_name)),
+          path_});
+  Conditional* missing_path = block->Add<Conditional>(
+      SourceInfo(), block->file()->LogicalNot(plusargs_call, SourceInfo()));
+  missing_path->consequent()->Add<Display>(
+      SourceInfo(),
+      std::vector<Expression*>{block->file()->Make<QuotedString>(
+          SourceInfo(),
+          absl::StrFormat("FAILED: no path for stream `%s`; expected plusarg "
+                          "+%s=<path>",
+                          stream_.name, stream_.path_plusarg_name))});
+  missing_path->consequent()->Add<Finish>(SourceInfo());
+  SystemFunctionCall* fopen_call = block->file()->Make<SystemFunctionCall>(
+      SourceInfo(), "fopen",
+      std::vector<Expression*>{
+          path_, block->file()->Make<QuotedString>(
+                     SourceInfo(),
+                     stream_.direction == TestbenchStreamDirection::kInput
+                         ? "r"
+                         : "w")});
   block->Add<BlockingAssignment>(SourceInfo(), file_descriptor_, fopen_call);
   Conditional* conditional = block->Add<Conditional>(
       SourceInfo(),
@@ -112,6 +139,14 @@ void VastStreamEmitter::EmitRead(StatementBlock* block, LogicRef* lhs) const {
   //     $display("FAILED: ...");
   //     $finish;
   //   end
+  //   if (cnt < 0) begin
+  //     $display("...");
+  //     $finish;
+  //   end
+  //
+  // $fscanf returns EOF (-1) once the writer has closed the stream, which ends
+  // the simulation. This lets testbenches loop forever over a stream whose
+  // length is not known when the testbench is generated.
   SystemFunctionCall* call = block->file()->Make<SystemFunctionCall>(
       SourceInfo(), "fscanf",
       std::vector<Expression*>{
@@ -129,6 +164,18 @@ void VastStreamEmitter::EmitRead(StatementBlock* block, LogicRef* lhs) const {
           absl::StrFormat("FAILED: $fscanf of file for stream `%s` failed.",
                           stream_.name))});
   conditional->consequent()->Add<Finish>(SourceInfo());
+  Conditional* eof_conditional = block->Add<Conditional>(
+      SourceInfo(),
+      block->file()->LessThan(count_,
+                              block->file()->PlainLiteral(0, SourceInfo()),
+                              SourceInfo()));
+  eof_conditional->consequent()->Add<Display>(
+      SourceInfo(),
+      std::vector<Expression*>{block->file()->Make<QuotedString>(
+          SourceInfo(),
+          absl::StrFormat("Stream `%s` closed; ending simulation.",
+                          stream_.name))});
+  eof_conditional->consequent()->Add<Finish>(SourceInfo());
 }
 
 void VastStreamEmitter::EmitWrite(StatementBlock* block,
@@ -137,6 +184,10 @@ void VastStreamEmitter::EmitWrite(StatementBlock* block,
   //
   //   $fwriteh(fd, <value>);
   //   $fwrite(fd, "\n");
+  //   $fflush(fd);
+  //
+  // The flush makes each value visible to the reader as soon as it is written
+  // so the reader can interleave its inputs with the simulation's outputs.
   block->Add<SystemTaskCall>(SourceInfo(), "fwriteh",
                              std::vector<Expression*>{file_descriptor_, value});
   block->Add<SystemTaskCall>(
@@ -144,6 +195,8 @@ void VastStreamEmitter::EmitWrite(StatementBlock* block,
       std::vector<Expression*>{
           file_descriptor_,
           block->file()->Make<QuotedString>(SourceInfo(), R"(\n)")});
+  block->Add<SystemTaskCall>(SourceInfo(), "fflush",
+                             std::vector<Expression*>{file_descriptor_});
 }
 
 void VastStreamEmitter::EmitClose(StatementBlock* block) const {
@@ -184,8 +237,13 @@ void TestbenchStreamThread::RunInputStream(
                                  stream_.name,
                                  BitsToString(*bits, FormatPreference::kHex));
       CHECK_EQ(bits->bit_count(), stream_.width);
+      // Flush each value so a testbench waiting on it is not stalled behind
+      // the stdio buffer.
       absl::Status write_status =
           writer->WriteLine(BitsToString(*bits, FormatPreference::kPlainHex));
+      if (write_status.ok()) {
+        write_status = writer->Flush();
+      }
       if (!write_status.ok()) {
         VLOG(1) << absl::StrFormat("Writing value to stream `%s` failed: %s",
                                    stream_.name, write_status.message());
@@ -43,10 +43,11 @@ struct TestbenchStream {
   std::string name;
   TestbenchStreamDirection direction;
 
-  // The macro name referring to the path of the underlying named pipe. The
-  // named pipe path is represented in the verilog as a macro to enable run-time
-  // binding of the named pipe path.
-  std::string path_macro_name;
+  // The name of the plusarg which gives the path of the underlying named pipe,
+  // i.e., the simulation is run with `+<path_plusarg_name>=<path>`. The path is
+  // read at run time with $value$plusargs so the generated Verilog (and any
+  // model compiled from it) does not depend on where the pipe lives.
+  std::string path_plusarg_name;
 
   // The width of the data to read/write to the testbench.
   int64_t width;
@@ -80,6 +81,7 @@ class VastStreamEmitter {
   LogicRef* count_;
   LogicRef* errno_;
   LogicRef* error_string_;
+  LogicRef* path_;
 };
 
 // A wrapper around a thread which read/writes data via a stream to/from a
@@ -105,6 +105,13 @@ absl::StatusOr<std::pair<std::string, std::string>> VerilogSimulator::Run(
   return Run(text, file_type, macro_definitions, /*includes=*/{});
 }
 
+absl::StatusOr<std::pair<std::string, std::string>> VerilogSimulator::Run(
+    std::string_view text, FileType file_type,
+    absl::Span<const MacroDefinition> macro_definitions,
+    absl::Span<const VerilogInclude> includes) const {
+  return Run(text, file_type, macro_definitions, includes, /*plusargs=*/{});
+}
+
 absl::Status VerilogSimulator::RunSyntaxChecking(std::string_view text,
                                                  FileType file_type) const {
   return RunSyntaxChecking(text, file_type, /*macro_definitions=*/{},
@@ -57,6 +57,14 @@ class VerilogSimulator {
     std::string name;
     std::optional<std::string> value;
   };
+  // A run-time argument of the simulation, read by the Verilog with
+  // $value$plusargs("NAME=%s", ...). Unlike macro definitions, plusargs do not
+  // change the compiled design so they may differ between runs of a cached
+  // model.
+  struct PlusArg {
+    std::string name;
+    std::string value;
+  };
   static constexpr std::string_view kSimulationMacroName = "SIMULATION";
   static constexpr std::string_view kAssertOnMacroName = "ASSERT_ON";
 
@@ -67,10 +75,15 @@ class VerilogSimulator {
   absl::StatusOr<std::pair<std::string, std::string>> Run(
       std::string_view text, FileType file_type,
       absl::Span<const MacroDefinition> macro_definitions) const;
+  absl::StatusOr<std::pair<std::string, std::string>> Run(
+      std::string_view text, FileType file_type,
+      absl::Span<const MacroDefinition> macro_definitions,
+      absl::Span<const VerilogInclude> includes) const;
   virtual absl::StatusOr<std::pair<std::string, std::string>> Run(
       std::string_view text, FileType file_type,
       absl::Span<const MacroDefinition> macro_definitions,
-      absl::Span<const VerilogInclude> includes) const = 0;
+      absl::Span<const VerilogInclude> includes,
+      absl::Span<const PlusArg> plusargs) const = 0;
 
   // Runs the simulator to check the Verilog syntax. Does not run simulation.
   absl::Status RunSyntaxChecking(std::string_view text,
@@ -87,6 +100,11 @@ class VerilogSimulator {
   virtual bool DoesSupportSystemVerilog() const = 0;
   virtual bool DoesSupportAssertions() const = 0;
 
+  // Whether the simulator reuses the model compiled from a Verilog text across
+  // runs. Stimulus for such simulators is best supplied at run time (e.g.,
+  // through testbench streams) so that it does not change the Verilog text.
+  virtual bool CachesCompiledModels() const { return false; }
+
   // Signals for potential bugs in simulators.
 
   // Whether the simulator correctly handles overflowing signed mod operations
@@ -45,6 +45,7 @@
 #include "xls/passes/pass_metrics.pb.h"
 #include "xls/passes/query_engine_checker.h"
 #include "xls/passes/verifier_checker.h"
+#include "xls/tools/opt_cache.h"
 #include "xls/tools/opt_flags.pb.h"
 
 namespace xls::tools {
@@ -93,6 +94,9 @@ absl::StatusOr<OptOptions> OptOptionsFromFlagsProto(
     options.bisect_limit = proto.passes_bisect_limit();
   }
   POPULATE(debug_optimizations)
+  POPULATE(function_base_threads)
+  POPULATE(opt_cache_dir)
+  POPULATE(opt_cache_functions)
 
   // NOTE: passes_bisect_limit_is_error is not populated in OptOptions as it is
   // handled outside calls to OptimizeIrForTop() that use the OptOptions struct.
@@ -203,6 +207,7 @@ absl::Status OptimizeIrForTop(Package* package, const OptOptions& options,
   pass_options.enable_resource_sharing = options.enable_resource_sharing;
   pass_options.force_resource_sharing = options.force_resource_sharing;
   pass_options.bisect_limit = options.bisect_limit;
+  pass_options.function_base_threads = options.function_base_threads;
   PassResults results;
   OptimizationContext context;
   XLS_RETURN_IF_ERROR(
@@ -217,9 +222,14 @@ absl::StatusOr<std::string> OptimizeIrForTop(std::string_view ir,
                                              const OptOptions& options,
                                              OptMetadata* metadata) {
   XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
-                       Parser::ParsePackage(ir, options.ir_path));
-  XLS_RETURN_IF_ERROR(OptimizeIrForTop(package.get(), options, metadata));
-  return package->DumpIr();
+                       Parser::ParsePackageConcurrently(
+                           ir, options.function_base_threads, options.ir_path));
+  if (!UseOptCache(options)) {
+    XLS_RETURN_IF_ERROR(OptimizeIrForTop(package.get(), options, metadata));
+    return package->DumpIr();
+  }
+
+  return OptimizeIrWithCache(package.get(), options, metadata);
 }
 
 }  // namespace xls::tools
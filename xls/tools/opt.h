@@ -71,6 +71,13 @@ struct OptOptions {
   std::optional<PassPipelineProto> pass_pipeline = std::nullopt;
   std::optional<int64_t> bisect_limit;
   bool debug_optimizations = false;
+  int64_t function_base_threads = 1;
+  // If non-empty, the directory of the persistent optimized IR cache (see
+  // OptCache). Only used by the IR text overload of OptimizeIrForTop.
+  std::string opt_cache_dir;
+  // If true, the cache also holds the optimized IR of each callee of the top
+  // on its own (see OptimizeIrWithCache).
+  bool opt_cache_functions = false;
   std::optional<std::string> delay_model = std::nullopt;
 };
 
@@ -0,0 +1,509 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/opt_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/base/no_destructor.h"
+#include "openssl/sha.h"
+#include "xls/common/build_embed.h"
+#include "xls/common/file/filesystem.h"
+#include "xls/common/status/status_macros.h"
+#include "xls/ir/call_graph.h"
+#include "xls/ir/channel.h"
+#include "xls/ir/fileno.h"
+#include "xls/ir/function.h"
+#include "xls/ir/function_base.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/node.h"
+#include "xls/ir/nodes.h"
+#include "xls/ir/op.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/passes/optimization_pass.h"
+#include "xls/passes/optimization_pass_pipeline.h"
+#include "xls/passes/pass_metrics.pb.h"
+#include "xls/passes/pass_pipeline.pb.h"
+#include "xls/tools/opt.h"
+
+namespace xls::tools {
+namespace {
+
+// Bump whenever the layout of cache entries or the IR produced for a given key
+// changes in a way not captured by the key itself.
+constexpr std::string_view kCacheFormatVersion = "xls-opt-cache-v2";
+
+std::string RamConfigFingerprint(const RamConfig& config) {
+  std::string initial_value = "none";
+  if (config.initial_value.has_value()) {
+    initial_value = absl::StrJoin(*config.initial_value, ",",
+                                  [](std::string* out, const Value& value) {
+                                    absl::StrAppend(out, value.ToString());
+                                  });
+  }
+  return absl::StrFormat(
+      "{kind: %s, depth: %d, word_partition_size: %d, initial_value: [%s]}",
+      RamKindToString(config.kind), config.depth,
+      config.word_partition_size.value_or(-1), initial_value);
+}
+
+// Returns a string covering every option which affects the optimized IR.
+std::string OptionsFingerprint(const OptOptions& options) {
+  std::string out = absl::StrFormat(
+      "opt_level: %d\ntop: %s\nskip_passes: %s\n"
+      "convert_array_index_to_select: %d\nsplit_next_value_selects: %d\n"
+      "use_context_narrowing_analysis: %d\n"
+      "optimize_for_best_case_throughput: %d\n"
+      "enable_resource_sharing: %d\nforce_resource_sharing: %d\n"
+      "area_model: %s\ndelay_model: %s\nbisect_limit: %d\n"
+      "debug_optimizations: %d\nopt_cache_functions: %d\n",
+      options.opt_level, options.top, absl::StrJoin(options.skip_passes, ","),
+      options.convert_array_index_to_select.value_or(-1),
+      options.split_next_value_selects.value_or(-1),
+      options.use_context_narrowing_analysis,
+      options.optimize_for_best_case_throughput,
+      options.enable_resource_sharing, options.force_resource_sharing,
+      options.area_model, options.delay_model.value_or("none"),
+      options.bisect_limit.value_or(-1), options.debug_optimizations,
+      options.opt_cache_functions);
+  for (const RamRewrite& rewrite : options.ram_rewrites) {
+    std::vector<std::pair<std::string, std::string>> channels(
+        rewrite.from_channels_logical_to_physical.begin(),
+        rewrite.from_channels_logical_to_physical.end());
+    std::sort(channels.begin(), channels.end());
+    absl::StrAppendFormat(
+        &out, "ram_rewrite: %s -> %s prefix: %s proc: %s channels: %s\n",
+        RamConfigFingerprint(rewrite.from_config),
+        RamConfigFingerprint(rewrite.to_config), rewrite.to_name_prefix,
+        rewrite.proc_name.value_or("none"),
+        absl::StrJoin(channels, ",", absl::PairFormatter("=")));
+  }
+  if (options.custom_registry.has_value()) {
+    absl::StrAppend(&out, "custom_registry: ",
+                    options.custom_registry->SerializeAsString(), "\n");
+  }
+  if (options.pass_pipeline.has_value()) {
+    absl::StrAppend(&out, "pass_pipeline: ",
+                    options.pass_pipeline->SerializeAsString(), "\n");
+  }
+  return out;
+}
+
+// Returns true if only the top function and its callees can affect the result
+// of optimizing the package. This is the case when the default pipeline is run
+// on a function as its first pass is dead function elimination.
+bool OnlyCalleesOfTopMatter(FunctionBase* top, const OptOptions& options) {
+  return top->IsFunction() && !options.custom_registry.has_value() &&
+         !options.pass_pipeline.has_value() && options.skip_passes.empty() &&
+         !options.bisect_limit.has_value();
+}
+
+std::string Sha256Hex(std::string_view data) {
+  std::array<uint8_t, SHA256_DIGEST_LENGTH> digest;
+  SHA256(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+         digest.data());
+  return absl::BytesToHexString(std::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+// Returns a string identifying the XLS build running the optimizer: a digest of
+// the running executable, the embedded build label and the default pass
+// pipeline. Entries written by other builds therefore never match.
+absl::StatusOr<std::string> ComputeBuildFingerprint() {
+  std::string label = GetBuildEmbedLabel();
+  absl::StatusOr<std::string> executable = GetFileContents("/proc/self/exe");
+  if (!executable.ok() && label.empty()) {
+    return absl::UnavailableError(
+        absl::StrFormat("Unable to identify the XLS build: %s",
+                        executable.status().message()));
+  }
+  XLS_ASSIGN_OR_RETURN(PassPipelineProto::Element pipeline,
+                       CreateOptimizationPassPipeline()->ToProto());
+  return absl::StrFormat(
+      "build_label: %s\nexecutable: %s\npipeline: %s\n", label,
+      executable.ok() ? Sha256Hex(*executable) : "unknown",
+      Sha256Hex(pipeline.SerializeAsString()));
+}
+
+// As above but only computed once per process.
+const absl::StatusOr<std::string>& BuildFingerprint() {
+  static const absl::NoDestructor<absl::StatusOr<std::string>> kFingerprint(
+      ComputeBuildFingerprint());
+  return *kFingerprint;
+}
+
+bool IsIrNameChar(char c) {
+  return absl::ascii_isalnum(c) || c == '_' || c == '.';
+}
+
+// Returns the IR of `function_base` with node ids, which depend on the rest of
+// the package, replaced by the position of the node in the function.
+std::string StructuralIr(FunctionBase* function_base) {
+  absl::flat_hash_map<std::string, std::string> canonical_names;
+  int64_t index = 0;
+  for (Node* node : function_base->nodes()) {
+    if (!node->HasAssignedName()) {
+      canonical_names[node->GetName()] = absl::StrCat("%", index);
+    }
+    ++index;
+  }
+  std::string ir = function_base->DumpIr();
+  std::string result;
+  result.reserve(ir.size());
+  int64_t i = 0;
+  while (i < ir.size()) {
+    if (!IsIrNameChar(ir[i])) {
+      result.push_back(ir[i++]);
+      continue;
+    }
+    int64_t end = i;
+    while (end < ir.size() && IsIrNameChar(ir[end])) {
+      ++end;
+    }
+    std::string_view token(ir.data() + i, end - i);
+    if (token == "id" && end < ir.size() && ir[end] == '=') {
+      result.append("id=_");
+      ++end;
+      while (end < ir.size() && absl::ascii_isdigit(ir[end])) {
+        ++end;
+      }
+    } else if (auto it = canonical_names.find(token);
+               it != canonical_names.end()) {
+      result.append(it->second);
+    } else {
+      result.append(token);
+    }
+    i = end;
+  }
+  return result;
+}
+
+// Redirects every call of `old_function` to `new_function` and removes
+// `old_function`, whose name `new_function` takes.
+absl::Status ReplaceFunction(Function* old_function, Function* new_function) {
+  for (Node* node : GetNodesWhichCall(old_function)) {
+    FunctionBase* caller = node->function_base();
+    Node* replacement;
+    switch (node->op()) {
+      case Op::kInvoke: {
+        XLS_ASSIGN_OR_RETURN(replacement,
+                             caller->MakeNode<Invoke>(
+                                 node->loc(), node->operands(), new_function));
+        break;
+      }
+      case Op::kMap: {
+        XLS_ASSIGN_OR_RETURN(replacement,
+                             caller->MakeNode<Map>(node->loc(),
+                                                   node->operand(0),
+                                                   new_function));
+        break;
+      }
+      case Op::kCountedFor: {
+        CountedFor* counted_for = node->As<CountedFor>();
+        XLS_ASSIGN_OR_RETURN(
+            replacement,
+            caller->MakeNode<CountedFor>(
+                node->loc(), counted_for->initial_value(),
+                counted_for->invariant_args(), counted_for->trip_count(),
+                counted_for->stride(), new_function));
+        break;
+      }
+      case Op::kDynamicCountedFor: {
+        DynamicCountedFor* counted_for = node->As<DynamicCountedFor>();
+        XLS_ASSIGN_OR_RETURN(
+            replacement,
+            caller->MakeNode<DynamicCountedFor>(
+                node->loc(), counted_for->initial_value(),
+                counted_for->trip_count(), counted_for->stride(),
+                counted_for->invariant_args(), new_function));
+        break;
+      }
+      default:
+        return absl::InternalError(
+            absl::StrFormat("Unexpected call of function `%s`: %s",
+                            old_function->name(), node->ToString()));
+    }
+    std::optional<std::string> name;
+    if (node->HasAssignedName()) {
+      name = node->GetName();
+    }
+    XLS_RETURN_IF_ERROR(node->ReplaceUsesWith(replacement));
+    XLS_RETURN_IF_ERROR(caller->RemoveNode(node));
+    if (name.has_value()) {
+      replacement->SetName(*name);
+    }
+  }
+  std::string name = old_function->name();
+  XLS_RETURN_IF_ERROR(old_function->package()->RemoveFunction(old_function));
+  new_function->SetName(name);
+  return absl::OkStatus();
+}
+
+// Replaces `function` with its optimized IR, which is taken from the entry
+// with the given key or produced by optimizing `function` on its own (and added
+// to the cache).
+absl::Status ReplaceWithOptimizedFunction(Function* function,
+                                          std::string_view key,
+                                          const OptOptions& options,
+                                          const OptCache& cache) {
+  Package* package = function->package();
+  XLS_ASSIGN_OR_RETURN(std::optional<OptCache::Entry> entry,
+                       cache.Lookup(key));
+  if (entry.has_value()) {
+    VLOG(2) << "Optimized IR cache hit for function " << function->name()
+            << ": " << key;
+  } else {
+    VLOG(2) << "Optimized IR cache miss for function " << function->name()
+            << ": " << key;
+    Package function_package(package->name());
+    for (const auto& [fileno, filename] : package->fileno_to_name()) {
+      function_package.SetFileno(fileno, filename);
+    }
+    XLS_ASSIGN_OR_RETURN(Function * clone,
+                         CloneFunctionAndItsDependencies(
+                             function, function->name(), &function_package));
+    XLS_RETURN_IF_ERROR(function_package.SetTop(clone));
+    OptOptions function_options = options;
+    function_options.top = function->name();
+    OptMetadata function_metadata;
+    XLS_RETURN_IF_ERROR(OptimizeIrForTop(&function_package, function_options,
+                                         &function_metadata));
+    entry = OptCache::Entry{
+        .optimized_ir = function_package.DumpIr(),
+        .metrics = std::move(function_metadata.metrics)};
+    if (absl::Status status = cache.Insert(key, *entry); !status.ok()) {
+      LOG(WARNING) << absl::StreamFormat(
+          "Unable to add optimized IR to the cache in %s: %s",
+          cache.directory().string(), status.ToString());
+    }
+  }
+
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> optimized_package,
+                       Parser::ParsePackage(entry->optimized_ir));
+  XLS_ASSIGN_OR_RETURN(Function * optimized,
+                       optimized_package->GetTopAsFunction());
+  // Anything the optimized function still calls has already been replaced in
+  // `package` by a function of the same name.
+  absl::flat_hash_map<const Function*, Function*> call_remapping;
+  for (FunctionBase* callee : GetDependentFunctions(optimized)) {
+    if (callee != optimized) {
+      XLS_ASSIGN_OR_RETURN(call_remapping[callee->AsFunctionOrDie()],
+                           package->GetFunction(callee->name()));
+    }
+  }
+  XLS_ASSIGN_OR_RETURN(
+      Function * replacement,
+      optimized->Clone(absl::StrCat(function->name(), "__opt_cache"), package,
+                       call_remapping));
+  return ReplaceFunction(function, replacement);
+}
+
+}  // namespace
+
+/* static */ absl::StatusOr<OptCache::Keys> OptCache::ComputeKeys(
+    Package* package, const OptOptions& options) {
+  XLS_ASSIGN_OR_RETURN(FunctionBase * top, FindTop(package, options.top));
+
+  XLS_ASSIGN_OR_RETURN(std::string build_fingerprint, BuildFingerprint());
+
+  Keys keys;
+  if (!options.opt_cache_functions || !OnlyCalleesOfTopMatter(top, options)) {
+    keys.package = Sha256Hex(absl::StrCat(
+        kCacheFormatVersion, "\n", build_fingerprint,
+        OptionsFingerprint(options), "top: ", top->name(), "\n",
+        package->DumpIr()));
+    return keys;
+  }
+
+  // The file table is printed as-is in optimized IR so it is part of every key.
+  std::string files_fingerprint;
+  std::vector<std::pair<int32_t, std::string>> files;
+  for (const auto& [fileno, filename] : package->fileno_to_name()) {
+    files.push_back({static_cast<int32_t>(fileno), filename});
+  }
+  std::sort(files.begin(), files.end());
+  for (const auto& [fileno, filename] : files) {
+    absl::StrAppendFormat(&files_fingerprint, "file_number %d \"%s\"\n",
+                          fileno, filename);
+  }
+
+  // The key of a function covers the keys of everything it calls. Functions
+  // are optimized on their own with the function as the top so the top option
+  // is not part of their keys.
+  OptOptions function_options = options;
+  function_options.top.clear();
+  std::string function_prefix =
+      absl::StrCat(kCacheFormatVersion, "\nfunction\n", build_fingerprint,
+                   OptionsFingerprint(function_options), files_fingerprint);
+  std::string top_key;
+  for (FunctionBase* function_base : GetDependentFunctions(top)) {
+    std::string fingerprint =
+        absl::StrCat(function_prefix, StructuralIr(function_base));
+    for (FunctionBase* callee : GetDependentFunctions(function_base)) {
+      if (callee != function_base) {
+        absl::StrAppend(&fingerprint, "callee ", callee->name(), " ",
+                        keys.functions.at(callee->AsFunctionOrDie()), "\n");
+      }
+    }
+    std::string key = Sha256Hex(fingerprint);
+    if (function_base == top) {
+      top_key = std::move(key);
+    } else {
+      keys.functions[function_base->AsFunctionOrDie()] = std::move(key);
+    }
+  }
+
+  // Everything printed outside of function bodies is part of the package key.
+  std::string fingerprint = absl::StrCat(
+      kCacheFormatVersion, "\n", build_fingerprint,
+      OptionsFingerprint(options), "package ", package->name(), "\n",
+      files_fingerprint);
+  for (Channel* channel : package->channels()) {
+    absl::StrAppend(&fingerprint, channel->ToString(), "\n");
+  }
+  absl::StrAppend(&fingerprint, "top ", top_key, "\n");
+  keys.package = Sha256Hex(fingerprint);
+  return keys;
+}
+
+/* static */ absl::StatusOr<std::string> OptCache::ComputeKey(
+    Package* package, const OptOptions& options) {
+  XLS_ASSIGN_OR_RETURN(Keys keys, ComputeKeys(package, options));
+  return std::move(keys.package);
+}
+
+std::filesystem::path OptCache::IrPath(std::string_view key) const {
+  return directory_ / absl::StrCat(key, ".opt.ir");
+}
+
+std::filesystem::path OptCache::MetricsPath(std::string_view key) const {
+  return directory_ / absl::StrCat(key, ".metrics.pb");
+}
+
+absl::StatusOr<std::optional<OptCache::Entry>> OptCache::Lookup(
+    std::string_view key) const {
+  // The metrics file is written last so its presence indicates a complete
+  // entry.
+  absl::StatusOr<std::string> metrics_bytes = GetFileContents(MetricsPath(key));
+  if (absl::IsNotFound(metrics_bytes.status())) {
+    return std::nullopt;
+  }
+  XLS_RETURN_IF_ERROR(metrics_bytes.status());
+  absl::StatusOr<std::string> optimized_ir = GetFileContents(IrPath(key));
+  if (absl::IsNotFound(optimized_ir.status())) {
+    return std::nullopt;
+  }
+  XLS_RETURN_IF_ERROR(optimized_ir.status());
+
+  Entry entry;
+  if (!entry.metrics.ParseFromString(*metrics_bytes)) {
+    LOG(WARNING) << "Ignoring corrupt optimized IR cache entry "
+                 << MetricsPath(key);
+    return std::nullopt;
+  }
+  entry.optimized_ir = *std::move(optimized_ir);
+  return entry;
+}
+
+absl::Status OptCache::Insert(std::string_view key, const Entry& entry) const {
+  XLS_RETURN_IF_ERROR(RecursivelyCreateDir(directory_));
+  XLS_RETURN_IF_ERROR(
+      SetFileContentsAtomically(IrPath(key), entry.optimized_ir));
+  return SetFileContentsAtomically(MetricsPath(key),
+                                   entry.metrics.SerializeAsString());
+}
+
+bool UseOptCache(const OptOptions& options) {
+  // Registry decorators are arbitrary code which can't be part of the key and
+  // IR dumps are only produced by actually running the passes.
+  if (options.opt_cache_dir.empty() ||
+      options.registry_decorator.has_value() ||
+      !options.ir_dump_path.empty()) {
+    return false;
+  }
+  if (!BuildFingerprint().ok()) {
+    LOG_FIRST_N(WARNING, 1) << "Not using the optimized IR cache: "
+                            << BuildFingerprint().status();
+    return false;
+  }
+  return true;
+}
+
+absl::StatusOr<std::string> OptimizeIrWithCache(Package* package,
+                                                const OptOptions& options,
+                                                OptMetadata* metadata) {
+  OptCache cache(options.opt_cache_dir);
+  XLS_ASSIGN_OR_RETURN(OptCache::Keys keys,
+                       OptCache::ComputeKeys(package, options));
+  XLS_ASSIGN_OR_RETURN(std::optional<OptCache::Entry> entry,
+                       cache.Lookup(keys.package));
+  if (entry.has_value()) {
+    VLOG(2) << "Optimized IR cache hit: " << keys.package;
+    if (metadata != nullptr) {
+      metadata->metrics = std::move(entry->metrics);
+    }
+    return std::move(entry->optimized_ir);
+  }
+  VLOG(2) << "Optimized IR cache miss: " << keys.package;
+
+  if (!keys.functions.empty()) {
+    XLS_ASSIGN_OR_RETURN(FunctionBase * top, FindTop(package, options.top));
+    // Callees come first so each function is optimized with its callees
+    // already replaced.
+    for (FunctionBase* function_base : GetDependentFunctions(top)) {
+      if (function_base == top) {
+        continue;
+      }
+      Function* function = function_base->AsFunctionOrDie();
+      XLS_RETURN_IF_ERROR(ReplaceWithOptimizedFunction(
+          function, keys.functions.at(function), options, cache));
+    }
+  }
+
+  OptMetadata run_metadata;
+  XLS_RETURN_IF_ERROR(OptimizeIrForTop(package, options, &run_metadata));
+  OptCache::Entry new_entry{.optimized_ir = package->DumpIr(),
+                            .metrics = std::move(run_metadata.metrics)};
+  if (absl::Status status = cache.Insert(keys.package, new_entry);
+      !status.ok()) {
+    LOG(WARNING) << absl::StreamFormat(
+        "Unable to add optimized IR to the cache in %s: %s",
+        cache.directory().string(), status.ToString());
+  }
+  if (metadata != nullptr) {
+    metadata->metrics = new_entry.metrics;
+  }
+  return std::move(new_entry.optimized_ir);
+}
+
+}  // namespace xls::tools
@@ -0,0 +1,123 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef XLS_TOOLS_OPT_CACHE_H_
+#define XLS_TOOLS_OPT_CACHE_H_
+
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xls/ir/function.h"
+#include "xls/ir/package.h"
+#include "xls/passes/pass_metrics.pb.h"
+#include "xls/tools/opt.h"
+
+namespace xls::tools {
+
+// A persistent on-disk cache of optimized IR. Each entry holds the optimized
+// IR of a package along with the pass metrics of the run which produced it.
+// Entries are written atomically so the cache may be shared by concurrently
+// running processes.
+//
+// Keys cover the XLS build which computes them so entries written by a
+// different build of the optimizer are never used.
+class OptCache {
+ public:
+  struct Entry {
+    std::string optimized_ir;
+    PassPipelineMetricsProto metrics;
+  };
+
+  explicit OptCache(std::filesystem::path directory)
+      : directory_(std::move(directory)) {}
+
+  struct Keys {
+    // The key of optimizing the entire package.
+    std::string package;
+    // The key of optimizing each function which the top (transitively)
+    // invokes as a top on its own. Only set when callees of the top are
+    // cached separately (see ComputeKeys).
+    absl::flat_hash_map<Function*, std::string> functions;
+  };
+
+  // Returns the cache keys for optimizing `package` with the given options.
+  // This sets the top of the package if `options.top` is given. Every key
+  // covers the options, the XLS build (a digest of the running executable and
+  // its build label) and the default pass pipeline.
+  //
+  // By default the package key covers the IR of the entire package as
+  // printed, so a hit returns exactly the IR the pipeline would produce.
+  //
+  // If `options.opt_cache_functions` is set and the default pipeline is run on
+  // a function, dead function elimination removes everything the top function
+  // does not (transitively) invoke before any other pass runs. In that case the
+  // key of the package only covers the top function and its callees so edits
+  // elsewhere in the package still hit the cache. Each function is hashed by
+  // structure, ignoring node ids, and its key covers the keys of its callees
+  // so unchanged call-graph subtrees keep their keys.
+  static absl::StatusOr<Keys> ComputeKeys(Package* package,
+                                          const OptOptions& options);
+
+  // Returns the key of the package computed by ComputeKeys.
+  static absl::StatusOr<std::string> ComputeKey(Package* package,
+                                                const OptOptions& options);
+
+  // Returns the entry with the given key or std::nullopt if the cache has no
+  // (valid) entry for the key.
+  absl::StatusOr<std::optional<Entry>> Lookup(std::string_view key) const;
+
+  // Adds the given entry to the cache, replacing any existing entry with the
+  // same key.
+  absl::Status Insert(std::string_view key, const Entry& entry) const;
+
+  const std::filesystem::path& directory() const { return directory_; }
+
+ private:
+  std::filesystem::path IrPath(std::string_view key) const;
+  std::filesystem::path MetricsPath(std::string_view key) const;
+
+  std::filesystem::path directory_;
+};
+
+// Returns true if the optimized IR cache can be used with the given options.
+// Returns false (and logs a warning) if the XLS build can't be identified.
+bool UseOptCache(const OptOptions& options);
+
+// Optimizes the package with the given options using the cache in
+// `options.opt_cache_dir`. By default the result is identical to the IR
+// produced without the cache and a miss costs a single run of the pipeline.
+//
+// If `options.opt_cache_functions` is set then, on a miss of the package key,
+// each function which the top invokes is replaced with its optimized IR,
+// bottom-up, before the pipeline runs on the top. The optimized IR of a
+// function is taken from the cache if present; otherwise it is produced by
+// optimizing the function (with its already optimized callees) on its own and
+// added to the cache. A change to one function therefore only reoptimizes it
+// and its callers, but a cold run optimizes each callee on its own in addition
+// to the full run on the top. The result is equivalent to, but need not be
+// identical to, the IR produced without the cache. The returned metrics are
+// those of the final run on the top.
+absl::StatusOr<std::string> OptimizeIrWithCache(Package* package,
+                                                const OptOptions& options,
+                                                OptMetadata* metadata);
+
+}  // namespace xls::tools
+
+#endif  // XLS_TOOLS_OPT_CACHE_H_
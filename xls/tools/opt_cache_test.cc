@@ -0,0 +1,285 @@
+// Copyright 2026 The XLS Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "xls/tools/opt_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "xls/common/file/temp_directory.h"
+#include "xls/common/status/matchers.h"
+#include "xls/interpreter/function_interpreter.h"
+#include "xls/ir/bits.h"
+#include "xls/ir/events.h"
+#include "xls/ir/function.h"
+#include "xls/ir/ir_parser.h"
+#include "xls/ir/package.h"
+#include "xls/ir/value.h"
+#include "xls/tools/opt.h"
+
+namespace xls::tools {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::testing::_;
+using ::testing::Eq;
+using ::testing::Ne;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+// `top` invokes `callee`; `unrelated` is not reachable from `top`. Adding
+// nodes to `unrelated` shifts the node ids of `top`.
+std::string MakeIr(int64_t callee_constant, int64_t unrelated_constant,
+                   int64_t unrelated_extra_nodes = 0) {
+  std::string extra_nodes;
+  for (int64_t i = 0; i < unrelated_extra_nodes; ++i) {
+    absl::StrAppendFormat(&extra_nodes,
+                          "  add.%d: bits[32] = add(x, x, id=%d)\n", 7 + i,
+                          7 + i);
+  }
+  int64_t top_id = 7 + unrelated_extra_nodes;
+  return absl::StrFormat(R"(package test
+
+fn callee(x: bits[32] id=1) -> bits[32] {
+  literal.2: bits[32] = literal(value=%d, id=2)
+  ret add.3: bits[32] = add(x, literal.2, id=3)
+}
+
+fn unrelated(x: bits[32] id=4) -> bits[32] {
+  literal.5: bits[32] = literal(value=%d, id=5)
+%s  ret umul.6: bits[32] = umul(x, literal.5, id=6)
+}
+
+top fn top(x: bits[32] id=%d) -> bits[32] {
+  invoke.%d: bits[32] = invoke(x, to_apply=callee, id=%d)
+  ret neg.%d: bits[32] = neg(invoke.%d, id=%d)
+}
+)",
+                         callee_constant, unrelated_constant, extra_nodes,
+                         top_id, top_id + 1, top_id + 1, top_id + 2,
+                         top_id + 1, top_id + 2);
+}
+
+// Returns the result of the top function of `ir` for the given argument.
+absl::StatusOr<Value> Evaluate(std::string_view ir, int64_t x) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir));
+  XLS_ASSIGN_OR_RETURN(Function * top, package->GetTopAsFunction());
+  XLS_ASSIGN_OR_RETURN(InterpreterResult<Value> result,
+                       InterpretFunction(top, {Value(UBits(x, 32))}));
+  return result.value;
+}
+
+absl::StatusOr<std::string> ComputeKey(std::string_view ir,
+                                       const OptOptions& options) {
+  XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> package,
+                       Parser::ParsePackage(ir));
+  return OptCache::ComputeKey(package.get(), options);
+}
+
+TEST(OptCacheTest, KeyCoversEntirePackage) {
+  OptOptions options;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(MakeIr(1, 2)));
+  XLS_ASSERT_OK_AND_ASSIGN(OptCache::Keys keys,
+                           OptCache::ComputeKeys(package.get(), options));
+  EXPECT_TRUE(keys.functions.empty());
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2), options),
+              IsOkAndHolds(Eq(keys.package)));
+  EXPECT_THAT(ComputeKey(MakeIr(1, 3), options),
+              IsOkAndHolds(Ne(keys.package)));
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2, /*unrelated_extra_nodes=*/5), options),
+              IsOkAndHolds(Ne(keys.package)));
+}
+
+TEST(OptCacheTest, FunctionKeyOnlyCoversCalleesOfTop) {
+  OptOptions options;
+  options.opt_cache_functions = true;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key, ComputeKey(MakeIr(1, 2), options));
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2), options), IsOkAndHolds(Eq(key)));
+  EXPECT_THAT(ComputeKey(MakeIr(1, 3), options), IsOkAndHolds(Eq(key)));
+  EXPECT_THAT(ComputeKey(MakeIr(4, 2), options), IsOkAndHolds(Ne(key)));
+
+  // With a custom pipeline dead functions may survive so the whole package is
+  // covered.
+  OptOptions custom_options = options;
+  custom_options.skip_passes = {"dfe"};
+  XLS_ASSERT_OK_AND_ASSIGN(std::string custom_key,
+                           ComputeKey(MakeIr(1, 2), custom_options));
+  EXPECT_NE(custom_key, key);
+  EXPECT_THAT(ComputeKey(MakeIr(1, 3), custom_options),
+              IsOkAndHolds(Ne(custom_key)));
+}
+
+TEST(OptCacheTest, FunctionKeyIgnoresNodeIdsOfUnrelatedFunctions) {
+  OptOptions options;
+  options.opt_cache_functions = true;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key, ComputeKey(MakeIr(1, 2), options));
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2, /*unrelated_extra_nodes=*/5), options),
+              IsOkAndHolds(Eq(key)));
+}
+
+TEST(OptCacheTest, FunctionKeysCoverCallees) {
+  OptOptions options;
+  options.opt_cache_functions = true;
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(MakeIr(1, 2)));
+  XLS_ASSERT_OK_AND_ASSIGN(OptCache::Keys keys,
+                           OptCache::ComputeKeys(package.get(), options));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, package->GetFunction("callee"));
+  EXPECT_THAT(keys.functions, UnorderedElementsAre(Pair(callee, _)));
+
+  // The key of the callee only depends on the callee.
+  XLS_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Package> shifted_package,
+      Parser::ParsePackage(MakeIr(1, 3, /*unrelated_extra_nodes=*/5)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      OptCache::Keys shifted_keys,
+      OptCache::ComputeKeys(shifted_package.get(), options));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * shifted_callee,
+                           shifted_package->GetFunction("callee"));
+  EXPECT_EQ(shifted_keys.functions.at(shifted_callee),
+            keys.functions.at(callee));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> changed_package,
+                           Parser::ParsePackage(MakeIr(4, 2)));
+  XLS_ASSERT_OK_AND_ASSIGN(
+      OptCache::Keys changed_keys,
+      OptCache::ComputeKeys(changed_package.get(), options));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * changed_callee,
+                           changed_package->GetFunction("callee"));
+  EXPECT_NE(changed_keys.functions.at(changed_callee),
+            keys.functions.at(callee));
+}
+
+TEST(OptCacheTest, KeyCoversOptions) {
+  OptOptions options;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key, ComputeKey(MakeIr(1, 2), options));
+  options.opt_level = 1;
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2), options), IsOkAndHolds(Ne(key)));
+
+  OptOptions function_options;
+  function_options.opt_cache_functions = true;
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2), function_options),
+              IsOkAndHolds(Ne(key)));
+
+  // The thread count does not change the optimized IR.
+  OptOptions threaded_options;
+  threaded_options.function_base_threads = 4;
+  EXPECT_THAT(ComputeKey(MakeIr(1, 2), threaded_options),
+              IsOkAndHolds(Eq(key)));
+}
+
+TEST(OptCacheTest, CachedIrIsIdenticalToUncachedIr) {
+  XLS_ASSERT_OK_AND_ASSIGN(std::string uncached,
+                           OptimizeIrForTop(MakeIr(1, 2), OptOptions()));
+
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  OptOptions options;
+  options.opt_cache_dir = (temp_dir.path() / "cache").string();
+  EXPECT_THAT(OptimizeIrForTop(MakeIr(1, 2), options),
+              IsOkAndHolds(Eq(uncached)));
+  EXPECT_THAT(OptimizeIrForTop(MakeIr(1, 2), options),
+              IsOkAndHolds(Eq(uncached)));
+}
+
+TEST(OptCacheTest, SecondRunUsesCachedIr) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  OptOptions options;
+  options.opt_cache_dir = (temp_dir.path() / "cache").string();
+
+  OptMetadata metadata;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string optimized,
+                           OptimizeIrForTop(MakeIr(1, 2), options, &metadata));
+  EXPECT_GT(metadata.metrics.total_passes(), 0);
+  EXPECT_THAT(Evaluate(optimized, 5), IsOkAndHolds(Value(SBits(-6, 32))));
+
+  XLS_ASSERT_OK_AND_ASSIGN(std::string key, ComputeKey(MakeIr(1, 2), options));
+  OptCache cache(options.opt_cache_dir);
+  XLS_ASSERT_OK_AND_ASSIGN(std::optional<OptCache::Entry> entry,
+                           cache.Lookup(key));
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->optimized_ir, optimized);
+
+  // Replace the entry to show that the next run is served from the cache.
+  entry->optimized_ir = "cached";
+  XLS_ASSERT_OK(cache.Insert(key, *entry));
+  OptMetadata cached_metadata;
+  EXPECT_THAT(OptimizeIrForTop(MakeIr(1, 2), options, &cached_metadata),
+              IsOkAndHolds("cached"));
+  EXPECT_EQ(cached_metadata.metrics.total_passes(),
+            metadata.metrics.total_passes());
+
+  // With function caching a package whose unreachable function differs (and
+  // has more nodes) has the same key.
+  options.opt_cache_functions = true;
+  XLS_ASSERT_OK_AND_ASSIGN(std::string function_key,
+                           ComputeKey(MakeIr(1, 2), options));
+  XLS_ASSERT_OK(cache.Insert(function_key, *entry));
+  EXPECT_THAT(OptimizeIrForTop(MakeIr(1, 3, /*unrelated_extra_nodes=*/5),
+                               options),
+              IsOkAndHolds("cached"));
+}
+
+TEST(OptCacheTest, UnchangedCalleesAreReused) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  OptOptions options;
+  options.opt_cache_functions = true;
+  options.opt_cache_dir = (temp_dir.path() / "cache").string();
+  XLS_ASSERT_OK(OptimizeIrForTop(MakeIr(1, 2), options).status());
+
+  // The first run added an entry for the callee on its own.
+  XLS_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Package> package,
+                           Parser::ParsePackage(MakeIr(1, 2)));
+  XLS_ASSERT_OK_AND_ASSIGN(OptCache::Keys keys,
+                           OptCache::ComputeKeys(package.get(), options));
+  XLS_ASSERT_OK_AND_ASSIGN(Function * callee, package->GetFunction("callee"));
+  OptCache cache(options.opt_cache_dir);
+  XLS_ASSERT_OK_AND_ASSIGN(std::optional<OptCache::Entry> callee_entry,
+                           cache.Lookup(keys.functions.at(callee)));
+  ASSERT_TRUE(callee_entry.has_value());
+
+  // Replace the callee entry with one which adds 10 rather than 1 to show that
+  // a package whose top differs uses it.
+  callee_entry->optimized_ir = R"(package test
+
+top fn callee(x: bits[32] id=1) -> bits[32] {
+  literal.2: bits[32] = literal(value=10, id=2)
+  ret add.3: bits[32] = add(x, literal.2, id=3)
+}
+)";
+  XLS_ASSERT_OK(cache.Insert(keys.functions.at(callee), *callee_entry));
+  std::string ir = MakeIr(1, 2);
+  ir.replace(ir.find("neg("), 3, "not");
+  XLS_ASSERT_OK_AND_ASSIGN(std::string optimized,
+                           OptimizeIrForTop(ir, options));
+  EXPECT_THAT(Evaluate(optimized, 5), IsOkAndHolds(Value(UBits(~15u, 32))));
+}
+
+TEST(OptCacheTest, LookupOfMissingEntry) {
+  XLS_ASSERT_OK_AND_ASSIGN(TempDirectory temp_dir, TempDirectory::Create());
+  OptCache cache(temp_dir.path());
+  EXPECT_THAT(cache.Lookup("0123"), IsOkAndHolds(Eq(std::nullopt)));
+}
+
+}  // namespace
+}  // namespace xls::tools
@@ -126,6 +126,24 @@ ABSL_FLAG(bool, debug_optimizations, false,
           "If passed, run additional strict correctness-checking passes; this "
           "slows down the optimization significantly, and is mostly intended "
           "for internal XLS debugging.");
+ABSL_FLAG(int64_t, function_base_threads, 1,
+          "Maximum number of threads used to parse the input IR and to run "
+          "function-scoped passes on the functions, procs and blocks of the "
+          "package concurrently. The optimized IR is the same for every "
+          "value. If zero, the value of --xls_threads is used.");
+ABSL_FLAG(std::optional<std::string>, opt_cache_dir, std::nullopt,
+          "If set, optimized IR is cached in this directory keyed by a hash "
+          "of the input IR, the optimization options and the XLS build, and "
+          "later runs with the same inputs reuse it instead of running the "
+          "pipeline. The cached IR is identical to the IR produced without "
+          "the cache.");
+ABSL_FLAG(bool, opt_cache_functions, false,
+          "If set with --opt_cache_dir, functions optimized with the default "
+          "pipeline are keyed on the top function and its callees only, and "
+          "each callee is cached on its own so unchanged callees are not "
+          "reoptimized. A cold run then optimizes each callee separately in "
+          "addition to the top, and the result is equivalent to but not "
+          "necessarily identical to the IR produced without the cache.");
 
 ABSL_FLAG(std::string, opt_options_proto, "",
           "Path to a protobuf containing all opt args.");
@@ -236,6 +254,9 @@ absl::StatusOr<bool> SetOptionsFromFlags(OptFlagsProto& proto) {
   POPULATE_FLAG(passes_bisect_limit_is_error)
   POPULATE_OPTIONAL_FLAG(pass_metrics_path)
   POPULATE_FLAG(debug_optimizations)
+  POPULATE_FLAG(function_base_threads)
+  POPULATE_OPTIONAL_FLAG(opt_cache_dir)
+  POPULATE_FLAG(opt_cache_functions)
   std::optional<std::string> passes_binproto =
       absl::GetFlag(FLAGS_passes_proto);
   std::optional<std::string> passes_textproto =
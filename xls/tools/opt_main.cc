@@ -44,6 +44,8 @@
 #include "xls/common/status/status_macros.h"
 #include "xls/dev_tools/dev_passes/pass_overrides.h"
 #include "xls/dev_tools/tool_timeout.h"
+#include "xls/ir/ir_binary_format.h"
+#include "xls/ir/ir_parser.h"
 #include "xls/ir/package.h"
 #include "xls/passes/optimization_pass.h"
 #include "xls/passes/optimization_pass_pipeline.h"
@@ -71,6 +73,9 @@ Example invocation:
 
 ABSL_FLAG(std::string, output_path, "-",
           "Output path for the optimized IR file; '-' denotes stdout.");
+ABSL_FLAG(bool, output_binary_ir, false,
+          "If true, emit the optimized IR in the binary IR format rather than "
+          "as text. Tools which parse IR accept either format.");
 ABSL_FLAG(std::optional<std::string>, alsologto, std::nullopt,
           "Path to write logs to, in addition to stderr.");
 
@@ -230,6 +235,11 @@ absl::Status RealMain(std::string_view input_path) {
   XLS_ASSIGN_OR_RETURN(std::string optimized_ir,
                        OptimizeIrForTop(ir, options, &metadata));
   VLOG(2) << "Ran " << metadata.metrics.total_passes() << " passes";
+  if (absl::GetFlag(FLAGS_output_binary_ir)) {
+    XLS_ASSIGN_OR_RETURN(std::unique_ptr<Package> optimized_package,
+                         Parser::ParsePackage(optimized_ir));
+    XLS_ASSIGN_OR_RETURN(optimized_ir, PackageToBinaryIr(*optimized_package));
+  }
   if (opt_flags.has_pass_metrics_path()) {
     std::string tf;
     XLS_RET_CHECK(google::protobuf::TextFormat::PrintToString(metadata.metrics, &tf));
@@ -73,6 +73,24 @@ class OptMainTest(parameterized.TestCase):
     # The add with zero should be eliminated.
     self.assertIn('ret x', optimized_ir)
 
+  def test_output_binary_ir(self):
+    ir_file = self.create_tempfile(content=ADD_ZERO_IR)
+
+    binary_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, '--output_binary_ir', ir_file.full_path]
+    )
+    self.assertTrue(binary_ir.startswith(b'\x89XLSIR\r\n'))
+
+    # The binary IR is accepted as input and matches the text output.
+    binary_ir_file = self.create_tempfile(content=binary_ir, mode='wb')
+    reoptimized_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, binary_ir_file.full_path]
+    ).decode('utf-8')
+    optimized_ir = subprocess.check_output(
+        [OPT_MAIN_PATH, ir_file.full_path]
+    ).decode('utf-8')
+    self.assertEqual(reoptimized_ir, optimized_ir)
+
   def test_with_vlog(self):
     # Checks that enabling vlog doesn't crash.
     ir_file = self.create_tempfile(content=ADD_ZERO_IR)
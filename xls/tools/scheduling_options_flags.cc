@@ -323,6 +323,11 @@ ABSL_FLAG(operations_research::math_opt::SolverType, solver_type,
           "The solver to use for scheduling.");
 ABSL_FLAG(std::string, solve_parameters_proto, "",
           "Path to a protobuf containing all solver parameters.");
+ABSL_FLAG(bool, use_difference_constraint_solver, true,
+          "If true, the SDC scheduler solves feasibility checks and pipeline "
+          "length minimization as longest paths in the constraint graph, and "
+          "only uses the LP solver (--solver_type) for the register "
+          "objective.");
 ABSL_FLAG(std::optional<int64_t>, default_arc_worst_case_throughput,
           std::nullopt,
           "Allow scheduling a pipeline with feedback arc worst-case throughput "
@@ -466,6 +471,7 @@ static absl::StatusOr<bool> SetOptionsFromFlags(
   POPULATE_FLAG(multi_proc);
   POPULATE_FLAG(merge_on_mutual_exclusion);
   POPULATE_FLAG(sdc_solution_tolerance);
+  POPULATE_FLAG(use_difference_constraint_solver);
   {
     any_flags_set |=
         FLAGS_default_arc_worst_case_throughput.IsSpecifiedOnCommandLine();